@@ -0,0 +1,94 @@
+/**
+ * @file benchmark_main.cpp
+ * @brief Entry point of kuukan_benchmarks with allocation counting
+ *
+ * Replaces the global operator new to count heap allocations, and runs the
+ * registered benchmarks through OverheadReporter so that the overhead
+ * ratios reach both the console and the `--benchmark_out` file. The file
+ * is written as JSON unless `--benchmark_out_format` selects another
+ * format, in which case the library's own reporter (without ratios) is
+ * used.
+ *
+ * @code{.sh}
+ * ./kuukan_benchmarks --benchmark_out=kuukan.json --benchmark_filter='dense_.*'
+ * @endcode
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+#include "benchmark_support.hpp"
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+
+void* counted_allocation(std::size_t bytes, std::size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    void* pointer = alignment <= alignof(std::max_align_t)
+        ? std::malloc(bytes)
+        : std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+} // namespace
+
+std::uint64_t kuukan::bench::allocation_count() noexcept {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t bytes) {
+    return counted_allocation(bytes, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    return counted_allocation(bytes, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+int main(int argc, char** argv) {
+    bool file_output = false;
+    bool json_file = true;
+    bool json_display = false;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+        if (argument.starts_with("--benchmark_out=")) {
+            file_output = true;
+        } else if (argument.starts_with("--benchmark_out_format=")) {
+            json_file = argument == "--benchmark_out_format=json";
+        } else if (argument.starts_with("--benchmark_format=")) {
+            json_display = argument == "--benchmark_format=json";
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    kuukan::bench::OverheadReporter<benchmark::ConsoleReporter> console;
+    kuukan::bench::OverheadReporter<benchmark::JSONReporter> json_console;
+    kuukan::bench::OverheadReporter<benchmark::JSONReporter> json_out;
+    benchmark::BenchmarkReporter* display = json_display
+        ? static_cast<benchmark::BenchmarkReporter*>(&json_console)
+        : static_cast<benchmark::BenchmarkReporter*>(&console);
+    if (file_output && json_file) {
+        benchmark::RunSpecifiedBenchmarks(display, &json_out);
+    } else {
+        benchmark::RunSpecifiedBenchmarks(display);
+    }
+    benchmark::Shutdown();
+    return 0;
+}
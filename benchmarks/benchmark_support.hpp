@@ -0,0 +1,114 @@
+/**
+ * @file benchmark_support.hpp
+ * @brief Shared helpers of the kuukan benchmark suite
+ *
+ * Every measurement is registered as a pair of benchmarks named
+ * `<suite>/raw/<args>` and `<suite>/kuukan/<args>`, the first a hand-written loop over
+ * plain arrays and the second the same computation through kuukan spaces.
+ * OverheadReporter matches the two runs of each pair and attaches the
+ * abstraction-overhead ratio (kuukan time over raw time) to the kuukan run
+ * (and 1 to the raw run), so it appears both on the console and in the JSON
+ * output.
+ *
+ * Allocations are counted by the replacement operator new of
+ * `benchmark_main.cpp` and reported per iteration by AllocationCounter.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace kuukan::bench {
+
+/// @brief Number of heap allocations made by all threads so far
+std::uint64_t allocation_count() noexcept;
+
+/**
+ * @brief Reports the heap allocations of a benchmark loop per iteration
+ *
+ * Construct right before the timing loop and call report after it.
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() noexcept : start_(allocation_count()) {}
+
+    /// @brief Set the `allocs_per_op` counter of state
+    void report(benchmark::State& state) const {
+        state.counters["allocs_per_op"] = benchmark::Counter(
+            static_cast<double>(allocation_count() - start_), benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    std::uint64_t start_;
+};
+
+/// @brief count uniformly distributed values in [-1, 1], reproducible from seed
+inline std::vector<double> random_values(std::size_t count, std::uint64_t seed) {
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<double> values(count);
+    for (double& value : values) {
+        value = distribution(engine);
+    }
+    return values;
+}
+
+/**
+ * @brief Set the throughput counters of state
+ *
+ * @param items Elements (or distances, or points) produced per iteration
+ * @param bytes Bytes read and written per iteration
+ */
+inline void set_throughput(benchmark::State& state, std::size_t items, std::size_t bytes) {
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * items));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+}
+
+/**
+ * @brief Reporter decorator that adds the `overhead` counter to kuukan runs
+ *
+ * @tparam Base The reporter to forward to (ConsoleReporter or JSONReporter)
+ *
+ * A run named `<suite>/kuukan/<args>` is compared with the run named
+ * `<suite>/raw/<args>` when that one was reported earlier, which holds for
+ * the default registration order (raw first).
+ */
+template <typename Base>
+class OverheadReporter : public Base {
+public:
+    using Base::Base;
+
+    void ReportRuns(const std::vector<benchmark::BenchmarkReporter::Run>& runs) override {
+        std::vector<benchmark::BenchmarkReporter::Run> annotated = runs;
+        for (benchmark::BenchmarkReporter::Run& run : annotated) {
+            const std::string name = run.benchmark_name();
+            if (const std::size_t raw = name.find(raw_tag); raw != std::string::npos) {
+                raw_times_[name] = run.GetAdjustedRealTime();
+                run.counters["overhead"] = benchmark::Counter(1.0);
+            } else if (const std::size_t kuukan = name.find(kuukan_tag); kuukan != std::string::npos) {
+                const std::string key = std::string(name).replace(kuukan, kuukan_tag.size(), raw_tag);
+                const auto found = raw_times_.find(key);
+                if (found != raw_times_.end() && found->second > 0) {
+                    run.counters["overhead"] = benchmark::Counter(run.GetAdjustedRealTime() / found->second);
+                }
+            }
+        }
+        Base::ReportRuns(annotated);
+    }
+
+private:
+    static constexpr std::string_view raw_tag    = "/raw/";
+    static constexpr std::string_view kuukan_tag = "/kuukan/";
+
+    std::map<std::string, double> raw_times_;
+};
+
+} // namespace kuukan::bench
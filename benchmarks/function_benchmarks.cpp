@@ -0,0 +1,113 @@
+/**
+ * @file function_benchmarks.cpp
+ * @brief Function-space evaluation against raw loops
+ *
+ * A CompiledFunction for 0.5 x^2 + sin(x) is evaluated over arrays of
+ * points next to the same expression written as a loop, and a
+ * ChebyshevFunction is evaluated next to a hand-written Clenshaw
+ * recurrence over its coefficients.
+ */
+
+#include <cmath>
+#include <span>
+
+#include <kuukan/kuukan.hpp>
+
+#include "benchmark_support.hpp"
+
+namespace {
+
+using Compiled  = kuukan::CompiledFunction<double>;
+using Chebyshev = kuukan::ChebyshevFunction<double, 32>;
+
+void apply_point_counts(benchmark::internal::Benchmark* benchmark) {
+    benchmark->RangeMultiplier(16)->Range(64, 1 << 16);
+}
+
+// compiled expression 0.5 x^2 + sin(x)
+
+void raw_compiled(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> points = kuukan::bench::random_values(n, 1);
+    std::vector<double> values(n);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            values[i] = 0.5 * points[i] * points[i] + std::sin(points[i]);
+        }
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 2 * n * sizeof(double));
+}
+
+void kuukan_compiled(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> points = kuukan::bench::random_values(n, 1);
+    std::vector<double> values(n);
+    const Compiled x = Compiled::variable();
+    const Compiled f = Compiled::apply(kuukan::FunctionOpcode::axpy, Compiled::product(x, x), Compiled::sin(x), 0.5);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        f.evaluate(std::span<const double>(points), std::span<double>(values));
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 2 * n * sizeof(double));
+}
+
+// Chebyshev expansion with 32 coefficients
+
+Chebyshev make_chebyshev() {
+    return Chebyshev::interpolate([](double x) { return std::exp(-x) * std::sin(4 * x); });
+}
+
+void raw_chebyshev(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> points = kuukan::bench::random_values(n, 1);
+    std::vector<double> values(n);
+    const Chebyshev f = make_chebyshev();
+    double coefficients[Chebyshev::order];
+    std::copy_n(f.coefficients.data(), Chebyshev::order, coefficients);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            const double t = points[i];
+            double next = 0, after_next = 0;
+            for (std::size_t k = Chebyshev::order - 1; k >= 1; --k) {
+                const double current = coefficients[k] + 2 * t * next - after_next;
+                after_next = next;
+                next = current;
+            }
+            values[i] = coefficients[0] + t * next - after_next;
+        }
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 2 * n * sizeof(double));
+}
+
+void kuukan_chebyshev(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> points = kuukan::bench::random_values(n, 1);
+    std::vector<double> values(n);
+    const Chebyshev f = make_chebyshev();
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        f.evaluate(std::span<const double>(points), std::span<double>(values));
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 2 * n * sizeof(double));
+}
+
+} // namespace
+
+BENCHMARK(raw_compiled)->Name("compiled_function_evaluate/raw")->Apply(apply_point_counts);
+BENCHMARK(kuukan_compiled)->Name("compiled_function_evaluate/kuukan")->Apply(apply_point_counts);
+BENCHMARK(raw_chebyshev)->Name("chebyshev_evaluate/raw")->Apply(apply_point_counts);
+BENCHMARK(kuukan_chebyshev)->Name("chebyshev_evaluate/kuukan")->Apply(apply_point_counts);
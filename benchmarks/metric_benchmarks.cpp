@@ -0,0 +1,232 @@
+/**
+ * @file metric_benchmarks.cpp
+ * @brief Pairwise distances and index queries against raw loops
+ *
+ * pairwise_distances is compared with a double loop over row-major point
+ * arrays, on one thread so that the ratio measures tiling and the
+ * abstraction rather than parallelism. VPTree k-nearest-neighbour queries
+ * are compared with the brute-force scan a caller would otherwise write, so
+ * their ratio is the speedup (below one) of the index. HNSWIndex queries
+ * (approximate, default beam width) are compared with the same scan on
+ * high-dimensional points, where the VP-tree prunes little.
+ *
+ * The cached-norm suite measures a query batch against a reference set
+ * whose squared norms were computed once, outside the timed loop, both
+ * by hand and through NormCache.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <utility>
+
+#include <kuukan/kuukan.hpp>
+
+#include "benchmark_support.hpp"
+
+namespace {
+
+using Space   = kuukan::DenseNormedSpace<double, std::dynamic_extent, kuukan::DenseL2Norm>;
+using Element = Space::element_type;
+using InnerSpace = kuukan::DenseInnerProductSpace<double>;
+
+/// @brief count points of the given dimension, as elements and as one row-major array
+struct PointSet {
+    std::vector<Element> elements;
+    std::vector<double>  flat;
+};
+
+PointSet make_points(std::size_t count, std::size_t dimension, std::uint64_t seed) {
+    PointSet points{{}, kuukan::bench::random_values(count * dimension, seed)};
+    points.elements.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        Element element(dimension, 0.0);
+        std::copy_n(points.flat.data() + index * dimension, dimension, element.data());
+        points.elements.push_back(std::move(element));
+    }
+    return points;
+}
+
+double raw_distance(const double* x, const double* y, std::size_t dimension) {
+    double sum = 0;
+    for (std::size_t i = 0; i < dimension; ++i) {
+        const double difference = x[i] - y[i];
+        sum += difference * difference;
+    }
+    return std::sqrt(sum);
+}
+
+// pairwise distances, count x count
+
+void raw_pairwise(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const PointSet lhs = make_points(count, dimension, 1);
+    const PointSet rhs = make_points(count, dimension, 2);
+    std::vector<double> out(count * count);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        for (std::size_t row = 0; row < count; ++row) {
+            for (std::size_t column = 0; column < count; ++column) {
+                out[row * count + column] = raw_distance(lhs.flat.data() + row * dimension,
+                                                         rhs.flat.data() + column * dimension, dimension);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, count * count, count * count * sizeof(double));
+}
+
+void kuukan_pairwise(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const PointSet lhs = make_points(count, dimension, 1);
+    const PointSet rhs = make_points(count, dimension, 2);
+    std::vector<double> out(count * count);
+    kuukan::PairwiseOptions options;
+    options.thread_count = 1;
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        kuukan::pairwise_distances(Space{}, std::span<const Element>(lhs.elements),
+                                   std::span<const Element>(rhs.elements), std::span<double>(out), options);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, count * count, count * count * sizeof(double));
+}
+
+// pairwise distances of query_batch queries against count references with cached norms
+
+constexpr std::size_t query_batch = 16;
+
+double raw_dot(const double* x, const double* y, std::size_t dimension) {
+    double sum = 0;
+    for (std::size_t i = 0; i < dimension; ++i) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+void raw_pairwise_cached(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const PointSet queries = make_points(query_batch, dimension, 1);
+    const PointSet references = make_points(count, dimension, 2);
+    std::vector<double> reference_norms(count);
+    for (std::size_t column = 0; column < count; ++column) {
+        const double* y = references.flat.data() + column * dimension;
+        reference_norms[column] = raw_dot(y, y, dimension);
+    }
+    std::vector<double> out(query_batch * count);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        for (std::size_t row = 0; row < query_batch; ++row) {
+            const double* x = queries.flat.data() + row * dimension;
+            const double row_norm = raw_dot(x, x, dimension);
+            for (std::size_t column = 0; column < count; ++column) {
+                const double squared = row_norm + reference_norms[column]
+                                     - 2 * raw_dot(x, references.flat.data() + column * dimension, dimension);
+                out[row * count + column] = std::sqrt(std::max(squared, 0.0));
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, query_batch * count, query_batch * count * sizeof(double));
+}
+
+void kuukan_pairwise_cached(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const PointSet queries = make_points(query_batch, dimension, 1);
+    const PointSet references = make_points(count, dimension, 2);
+    const kuukan::NormCache<InnerSpace> reference_norms(InnerSpace{}, std::span<const Element>(references.elements));
+    std::vector<double> out(query_batch * count);
+    kuukan::PairwiseOptions options;
+    options.thread_count = 1;
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        kuukan::pairwise_distances(InnerSpace{}, std::span<const Element>(queries.elements),
+                                   std::span<const Element>(references.elements), reference_norms,
+                                   std::span<double>(out), options);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, query_batch * count, query_batch * count * sizeof(double));
+}
+
+// k nearest neighbours of a query, k = 10
+
+constexpr std::size_t neighbour_count = 10;
+constexpr std::size_t query_count     = 64;
+
+void raw_knn(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const PointSet points = make_points(count, dimension, 1);
+    const PointSet queries = make_points(query_count, dimension, 2);
+    std::vector<std::pair<double, std::size_t>> candidates(count);
+    std::size_t query = 0;
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        const double* q = queries.flat.data() + query * dimension;
+        for (std::size_t index = 0; index < count; ++index) {
+            candidates[index] = {raw_distance(points.flat.data() + index * dimension, q, dimension), index};
+        }
+        std::partial_sort(candidates.begin(), candidates.begin() + neighbour_count, candidates.end());
+        benchmark::DoNotOptimize(candidates.data());
+        query = (query + 1) % query_count;
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, 1, count * dimension * sizeof(double));
+}
+
+void kuukan_knn(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const PointSet points = make_points(count, dimension, 1);
+    const PointSet queries = make_points(query_count, dimension, 2);
+    const kuukan::VPTree<Space> tree{std::span<const Element>(points.elements)};
+    std::size_t query = 0;
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto nearest = tree.knn(queries.elements[query], neighbour_count);
+        benchmark::DoNotOptimize(nearest.data());
+        query = (query + 1) % query_count;
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, 1, count * dimension * sizeof(double));
+}
+
+void kuukan_hnsw_knn(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const PointSet points = make_points(count, dimension, 1);
+    const PointSet queries = make_points(query_count, dimension, 2);
+    const kuukan::HNSWIndex<Space> index{std::span<const Element>(points.elements)};
+    std::size_t query = 0;
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto nearest = index.knn(queries.elements[query], neighbour_count);
+        benchmark::DoNotOptimize(nearest.data());
+        query = (query + 1) % query_count;
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, 1, count * dimension * sizeof(double));
+}
+
+} // namespace
+
+BENCHMARK(raw_pairwise)->Name("pairwise_distances/raw")->ArgsProduct({{64, 256, 1024}, {4, 32, 256}});
+BENCHMARK(kuukan_pairwise)->Name("pairwise_distances/kuukan")->ArgsProduct({{64, 256, 1024}, {4, 32, 256}});
+BENCHMARK(raw_pairwise_cached)->Name("pairwise_cached_norms/raw")->ArgsProduct({{1 << 10, 1 << 14}, {32, 128}});
+BENCHMARK(kuukan_pairwise_cached)->Name("pairwise_cached_norms/kuukan")->ArgsProduct({{1 << 10, 1 << 14}, {32, 128}});
+BENCHMARK(raw_knn)->Name("vp_tree_knn/raw")->ArgsProduct({{1 << 10, 1 << 14}, {4, 16}});
+BENCHMARK(kuukan_knn)->Name("vp_tree_knn/kuukan")->ArgsProduct({{1 << 10, 1 << 14}, {4, 16}});
+BENCHMARK(raw_knn)->Name("hnsw_knn/raw")->ArgsProduct({{1 << 14}, {64}});
+BENCHMARK(kuukan_hnsw_knn)->Name("hnsw_knn/kuukan")->ArgsProduct({{1 << 14}, {64}});
@@ -0,0 +1,383 @@
+/**
+ * @file vector_space_benchmarks.cpp
+ * @brief VectorSpace and NormedSpace operations against raw loops
+ *
+ * Each operation of a run-time sized DenseNormedSpace is measured across
+ * dimensions next to the equivalent loop over plain arrays. The raw
+ * value-returning loops allocate their result as the kuukan operations do,
+ * so the overhead ratio isolates the cost of the abstraction rather than
+ * that of the allocation. The fixed-size suites use R^3, R^4 and R^6,
+ * where any per-call overhead is most visible. weighted_sum runs on an InlineExecutor
+ * against a single accumulation loop over a row-major array.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <span>
+
+#include <kuukan/kuukan.hpp>
+
+#include "benchmark_support.hpp"
+
+namespace {
+
+using Space   = kuukan::DenseNormedSpace<double, std::dynamic_extent, kuukan::DenseL2Norm>;
+using Element = Space::element_type;
+
+Element make_element(std::size_t dimension, std::uint64_t seed) {
+    const std::vector<double> values = kuukan::bench::random_values(dimension, seed);
+    Element element(dimension, 0.0);
+    std::copy(values.begin(), values.end(), element.data());
+    return element;
+}
+
+void apply_dimensions(benchmark::internal::Benchmark* benchmark) {
+    benchmark->RangeMultiplier(8)->Range(16, 1 << 16);
+}
+
+// addition
+
+void raw_addition(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> a = kuukan::bench::random_values(n, 1);
+    const std::vector<double> b = kuukan::bench::random_values(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        std::unique_ptr<double[]> result = std::make_unique_for_overwrite<double[]>(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            result[i] = a[i] + b[i];
+        }
+        benchmark::DoNotOptimize(result.get());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 3 * n * sizeof(double));
+}
+
+void kuukan_addition(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const Element a = make_element(n, 1);
+    const Element b = make_element(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        Element result = Space::addition(a, b);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 3 * n * sizeof(double));
+}
+
+// axpy
+
+void raw_axpy(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> x = kuukan::bench::random_values(n, 1);
+    const std::vector<double> y = kuukan::bench::random_values(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        std::unique_ptr<double[]> result = std::make_unique_for_overwrite<double[]>(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            result[i] = 0.5 * x[i] + y[i];
+        }
+        benchmark::DoNotOptimize(result.get());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 3 * n * sizeof(double));
+}
+
+void kuukan_axpy(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const Element x = make_element(n, 1);
+    const Element y = make_element(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        Element result = Space::axpy(0.5, x, y);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 3 * n * sizeof(double));
+}
+
+// add_assign
+
+void raw_add_assign(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> a = kuukan::bench::random_values(n, 1);
+    const std::vector<double> b = kuukan::bench::random_values(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] += b[i];
+        }
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 3 * n * sizeof(double));
+}
+
+void kuukan_add_assign(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    Element a = make_element(n, 1);
+    const Element b = make_element(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        Space::add_assign(a, b);
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 3 * n * sizeof(double));
+}
+
+// linear_combination of four terms
+
+void raw_linear_combination(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> a = kuukan::bench::random_values(n, 1);
+    const std::vector<double> b = kuukan::bench::random_values(n, 2);
+    const std::vector<double> c = kuukan::bench::random_values(n, 3);
+    const std::vector<double> d = kuukan::bench::random_values(n, 4);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        std::unique_ptr<double[]> result = std::make_unique_for_overwrite<double[]>(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            result[i] = 2.0 * a[i] - 1.0 * b[i] + 0.5 * c[i] + 0.25 * d[i];
+        }
+        benchmark::DoNotOptimize(result.get());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 5 * n * sizeof(double));
+}
+
+void kuukan_linear_combination(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const Element a = make_element(n, 1);
+    const Element b = make_element(n, 2);
+    const Element c = make_element(n, 3);
+    const Element d = make_element(n, 4);
+    const double alpha = 2.0, beta = -1.0, gamma = 0.5, delta = 0.25;
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        Element result = Space::linear_combination({{alpha, a}, {beta, b}, {gamma, c}, {delta, d}});
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 5 * n * sizeof(double));
+}
+
+// norm
+
+void raw_norm(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> a = kuukan::bench::random_values(n, 1);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += a[i] * a[i];
+        }
+        benchmark::DoNotOptimize(std::sqrt(sum));
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, n * sizeof(double));
+}
+
+void kuukan_norm(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const Element a = make_element(n, 1);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Space::norm(a));
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, n * sizeof(double));
+}
+
+// distance
+
+void raw_distance(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> a = kuukan::bench::random_values(n, 1);
+    const std::vector<double> b = kuukan::bench::random_values(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double difference = a[i] - b[i];
+            sum += difference * difference;
+        }
+        benchmark::DoNotOptimize(std::sqrt(sum));
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 2 * n * sizeof(double));
+}
+
+void kuukan_distance(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const Element a = make_element(n, 1);
+    const Element b = make_element(n, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Space::distance(a, b));
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, n, 2 * n * sizeof(double));
+}
+
+// R^N for N = 3, 4, 6 (points, homogeneous points, poses): axpy and
+// distance, where per-call overhead dominates
+
+template <std::size_t N>
+using FixedSpace = kuukan::DenseNormedSpace<double, N, kuukan::DenseL2Norm>;
+
+template <std::size_t N>
+void raw_axpy_fixed(benchmark::State& state) {
+    const std::vector<double> values = kuukan::bench::random_values(2 * N, 1);
+    double x[N];
+    double y[N];
+    std::copy_n(values.begin(), N, x);
+    std::copy_n(values.begin() + N, N, y);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        double result[N];
+        for (std::size_t i = 0; i < N; ++i) {
+            result[i] = 0.5 * x[i] + y[i];
+        }
+        benchmark::DoNotOptimize(result);
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, 1, 3 * N * sizeof(double));
+}
+
+template <std::size_t N>
+void kuukan_axpy_fixed(benchmark::State& state) {
+    const std::vector<double> values = kuukan::bench::random_values(2 * N, 1);
+    typename FixedSpace<N>::element_type x{};
+    typename FixedSpace<N>::element_type y{};
+    std::copy_n(values.begin(), N, x.data());
+    std::copy_n(values.begin() + N, N, y.data());
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        typename FixedSpace<N>::element_type result = FixedSpace<N>::axpy(0.5, x, y);
+        benchmark::DoNotOptimize(result);
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, 1, 3 * N * sizeof(double));
+}
+
+template <std::size_t N>
+void raw_distance_fixed(benchmark::State& state) {
+    const std::vector<double> values = kuukan::bench::random_values(2 * N, 1);
+    double x[N];
+    double y[N];
+    std::copy_n(values.begin(), N, x);
+    std::copy_n(values.begin() + N, N, y);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        double sum = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            sum += (x[i] - y[i]) * (x[i] - y[i]);
+        }
+        benchmark::DoNotOptimize(std::sqrt(sum));
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, 1, 2 * N * sizeof(double));
+}
+
+template <std::size_t N>
+void kuukan_distance_fixed(benchmark::State& state) {
+    const std::vector<double> values = kuukan::bench::random_values(2 * N, 1);
+    typename FixedSpace<N>::element_type x{};
+    typename FixedSpace<N>::element_type y{};
+    std::copy_n(values.begin(), N, x.data());
+    std::copy_n(values.begin() + N, N, y.data());
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(FixedSpace<N>::distance(x, y));
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, 1, 2 * N * sizeof(double));
+}
+
+// weighted sum of count elements, on one thread
+
+void raw_weighted_sum(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const std::vector<double> weights = kuukan::bench::random_values(count, 1);
+    const std::vector<double> flat = kuukan::bench::random_values(count * dimension, 2);
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        std::unique_ptr<double[]> result = std::make_unique<double[]>(dimension);
+        for (std::size_t index = 0; index < count; ++index) {
+            const double* x = flat.data() + index * dimension;
+            for (std::size_t i = 0; i < dimension; ++i) {
+                result[i] += weights[index] * x[i];
+            }
+        }
+        benchmark::DoNotOptimize(result.get());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, count, count * dimension * sizeof(double));
+}
+
+void kuukan_weighted_sum(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t dimension = static_cast<std::size_t>(state.range(1));
+    const std::vector<double> weights = kuukan::bench::random_values(count, 1);
+    std::vector<Element> elements;
+    for (std::size_t index = 0; index < count; ++index) {
+        elements.push_back(make_element(dimension, index + 2));
+    }
+    kuukan::InlineExecutor executor;
+    kuukan::bench::AllocationCounter allocations;
+    for (auto _ : state) {
+        Element result = kuukan::weighted_sum(Space{}, std::span<const double>(weights),
+                                              std::span<const Element>(elements), {}, executor);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    kuukan::bench::set_throughput(state, count, count * dimension * sizeof(double));
+}
+
+} // namespace
+
+BENCHMARK(raw_addition)->Name("dense_addition/raw")->Apply(apply_dimensions);
+BENCHMARK(kuukan_addition)->Name("dense_addition/kuukan")->Apply(apply_dimensions);
+BENCHMARK(raw_axpy)->Name("dense_axpy/raw")->Apply(apply_dimensions);
+BENCHMARK(kuukan_axpy)->Name("dense_axpy/kuukan")->Apply(apply_dimensions);
+BENCHMARK(raw_add_assign)->Name("dense_add_assign/raw")->Apply(apply_dimensions);
+BENCHMARK(kuukan_add_assign)->Name("dense_add_assign/kuukan")->Apply(apply_dimensions);
+BENCHMARK(raw_linear_combination)->Name("dense_linear_combination/raw")->Apply(apply_dimensions);
+BENCHMARK(kuukan_linear_combination)->Name("dense_linear_combination/kuukan")->Apply(apply_dimensions);
+BENCHMARK(raw_norm)->Name("dense_norm/raw")->Apply(apply_dimensions);
+BENCHMARK(kuukan_norm)->Name("dense_norm/kuukan")->Apply(apply_dimensions);
+BENCHMARK(raw_distance)->Name("dense_distance/raw")->Apply(apply_dimensions);
+BENCHMARK(kuukan_distance)->Name("dense_distance/kuukan")->Apply(apply_dimensions);
+BENCHMARK(raw_axpy_fixed<3>)->Name("fixed3_axpy/raw")->Arg(3);
+BENCHMARK(kuukan_axpy_fixed<3>)->Name("fixed3_axpy/kuukan")->Arg(3);
+BENCHMARK(raw_distance_fixed<3>)->Name("fixed3_distance/raw")->Arg(3);
+BENCHMARK(kuukan_distance_fixed<3>)->Name("fixed3_distance/kuukan")->Arg(3);
+BENCHMARK(raw_axpy_fixed<4>)->Name("fixed4_axpy/raw")->Arg(4);
+BENCHMARK(kuukan_axpy_fixed<4>)->Name("fixed4_axpy/kuukan")->Arg(4);
+BENCHMARK(raw_distance_fixed<4>)->Name("fixed4_distance/raw")->Arg(4);
+BENCHMARK(kuukan_distance_fixed<4>)->Name("fixed4_distance/kuukan")->Arg(4);
+BENCHMARK(raw_axpy_fixed<6>)->Name("fixed6_axpy/raw")->Arg(6);
+BENCHMARK(kuukan_axpy_fixed<6>)->Name("fixed6_axpy/kuukan")->Arg(6);
+BENCHMARK(raw_distance_fixed<6>)->Name("fixed6_distance/raw")->Arg(6);
+BENCHMARK(kuukan_distance_fixed<6>)->Name("fixed6_distance/kuukan")->Arg(6);
+BENCHMARK(raw_weighted_sum)->Name("weighted_sum/raw")->ArgsProduct({{1 << 12, 1 << 16}, {8, 64}});
+BENCHMARK(kuukan_weighted_sum)->Name("weighted_sum/kuukan")->ArgsProduct({{1 << 12, 1 << 16}, {8, 64}});
@@ -0,0 +1,63 @@
+/**
+ * @file dense_vector_space.cpp
+ * @brief Example using the ready-made dense vector space backend
+ *
+ * This example shows how DenseVectorSpace and DenseNormedSpace replace the
+ * hand-written functors of a numeric array space. Both a statically sized
+ * space (R^3) and a run-time sized space are used; all operations run on
+ * the SIMD kernels selected by the compiler flags.
+ */
+
+#include <iostream>
+#include <span>
+
+#include <kuukan/kuukan.hpp>
+
+/// @brief Euclidean 3-space with compile-time size
+using Euclidean3 = kuukan::DenseNormedSpace<double, 3, kuukan::DenseL2Norm>;
+
+/// @brief Run-time sized space with the maximum norm
+using MaxNormSpace = kuukan::DenseNormedSpace<double, std::dynamic_extent, kuukan::DenseLinfNorm>;
+
+/**
+ * @brief Main function demonstrating dense space usage
+ *
+ * Performs fused updates and distance computations in a fixed-size and a
+ * dynamic-size space.
+ */
+int main() {
+    // Fixed-size elements are aggregates
+    Euclidean3::element_type a{1.0, 2.0, 3.0};
+    Euclidean3::element_type b{4.0, 6.0, 3.0};
+
+    // Fused a * x + y, computed in one pass
+    auto update = Euclidean3::axpy(0.5, a, b);
+    std::cout << "0.5 * a + b = (" << update[0] << ", " << update[1] << ", " << update[2] << ")\n";
+
+    // Induced distance through the fused L2 difference norm
+    std::cout << "||a - b||_2 = " << Euclidean3::distance(a, b) << "\n";
+    std::cout << "<a, b> = " << Euclidean3::dot(a, b) << "\n";
+
+    // Dynamic-size elements live in aligned heap storage
+    MaxNormSpace::element_type x(1000, 1.0);
+    MaxNormSpace::element_type y(1000, 0.25);
+    MaxNormSpace::scale_assign(4.0, y);
+
+    // Linear combination without intermediates: 2x - y
+    double two = 2.0, minus_one = -1.0;
+    auto combination = MaxNormSpace::linear_combination({{two, x}, {minus_one, y}});
+    std::cout << "||2x - y||_inf = " << MaxNormSpace::norm(combination) << "\n";
+
+    // Temporaries of a chain allocated in an arena and released together
+    using ArenaSpace = kuukan::ArenaDenseVectorSpace<double>;
+    kuukan::MonotonicArena arena;
+    for (int query = 0; query < 3; ++query) {
+        kuukan::ArenaScope scope(arena);
+        ArenaSpace::element_type u(1000, 1.0 + query);
+        auto chained = ArenaSpace::axpy(2.0, ArenaSpace::negation(u), u);
+        std::cout << "query " << query << ": (-2u + u)[0] = " << chained[0] << "\n";
+    }
+    std::cout << "arena capacity = " << arena.capacity() << " bytes\n";
+
+    return 0;
+}
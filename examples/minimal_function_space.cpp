@@ -9,30 +9,44 @@
  * 
  * This demonstrates the power of kuukan's abstraction: we can treat infinite-
  * dimensional function spaces exactly like finite-dimensional vector spaces.
+ * 
+ * Every operation here wraps its operands in a new closure, so evaluating a
+ * depth-d expression makes d indirect calls. The end of main() shows the
+ * same operations on kuukan::CompiledFunctionSpace, whose elements are
+ * flattened expression programs evaluated in batches.
  */
 
 #include <iostream>
 #include <functional>
 #include <string>
 #include <cmath>
+#include <numbers>
+#include <vector>
 
 #include <kuukan/kuukan.hpp>
 
 using ScalarType = double;
 
+/// @brief The symbol table shared by all function elements
+using FunctionSymbols = kuukan::SymbolTable<ScalarType>;
+
 /**
  * @brief Element of a function space
  * 
- * Represents a function from reals to reals, along with a symbolic identity
- * string for abstract equality checking. The evaluator is a callable that
- * computes the function value at a point.
+ * Represents a function from reals to reals, along with the ID of its
+ * symbolic identity in the shared symbol table, which makes equality an
+ * integer compare. The evaluator is a callable that computes the function
+ * value at a point.
  */
 struct RealFunctionElement {
     /// @brief Callable that evaluates the function at a point
     std::function<ScalarType(ScalarType)> evaluator;
     
-    /// @brief Symbolic representation of the function (for equality checking)
-    std::string symbolic_identity;
+    /// @brief Interned symbolic representation of the function (for equality checking)
+    kuukan::SymbolId symbol;
+
+    /// @brief Evaluate the function at a point (used by the function norms)
+    ScalarType operator()(ScalarType x) const { return evaluator(x); }
 };
 
 // —— Inject vector space operations (all pointwise definitions, keeping abstraction) ——
@@ -41,7 +55,7 @@ struct RealFunctionElement {
  * @brief Functor for adding two functions pointwise
  * 
  * Implements function addition: (f + g)(x) = f(x) + g(x)
- * The symbolic identity is constructed by concatenating the operands.
+ * The symbolic identity is the interned sum of the operands' identities.
  */
 struct FunctionAddition {
     RealFunctionElement operator()(const RealFunctionElement& function_left,
@@ -50,7 +64,7 @@ struct FunctionAddition {
             .evaluator = [lf = function_left.evaluator, rg = function_right.evaluator](ScalarType x) {
                 return lf(x) + rg(x);
             },
-            .symbolic_identity = "(" + function_left.symbolic_identity + " + " + function_right.symbolic_identity + ")"
+            .symbol = FunctionSymbols::global().sum(function_left.symbol, function_right.symbol)
         };
     }
 };
@@ -75,7 +89,7 @@ struct FunctionScalarAction {
             .evaluator = [s = scalar_value, f = function_value.evaluator](ScalarType x) {
                 return s * f(x);
             },
-            .symbolic_identity = "(" + std::to_string(scalar_value) + " * " + function_value.symbolic_identity + ")"
+            .symbol = FunctionSymbols::global().scaled(scalar_value, function_value.symbol)
         };
     }
 };
@@ -92,7 +106,7 @@ struct FunctionNegation {
             .evaluator = [f = function_value.evaluator](ScalarType x) {
                 return -f(x);
             },
-            .symbolic_identity = "(-" + function_value.symbolic_identity + ")"
+            .symbol = FunctionSymbols::global().negated(function_value.symbol)
         };
     }
 };
@@ -111,7 +125,7 @@ struct FunctionZeroSupplier {
     RealFunctionElement operator()() const {
         return RealFunctionElement{
             .evaluator = [](ScalarType){ return ScalarType{0}; },
-            .symbolic_identity = "0"
+            .symbol = FunctionSymbols::global().constant(ScalarType{0})
         };
     }
 };
@@ -119,14 +133,15 @@ struct FunctionZeroSupplier {
 /**
  * @brief Functor for function equality
  * 
- * Compares two functions by their symbolic identity. In a real implementation,
+ * Compares two functions by their interned symbolic identity, which is a
+ * single integer compare however deep the expressions are. In a real implementation,
  * you might want to check functional equality (e.g., by comparing values at
  * sample points or using symbolic simplification).
  */
 struct FunctionEquality {
     bool operator()(const RealFunctionElement& function_left,
                     const RealFunctionElement& function_right) const {
-        return function_left.symbolic_identity == function_right.symbolic_identity;
+        return function_left.symbol == function_right.symbol;
     }
 };
 
@@ -151,34 +166,9 @@ using FunctionVectorSpace = kuukan::VectorSpace<
 >;
 
 /**
- * @brief Placeholder norm functor
- * 
- * This is a placeholder implementation that demonstrates the interface.
- * A real implementation would compute the supremum norm (sup norm) of a
- * function, which is the maximum absolute value over the domain:
- * 
- *     ||f||_∞ = sup |f(x)|
- * 
- * Computing this typically requires numerical integration or symbolic
- * analysis. Here we just return 0.0 as a placeholder.
- * 
- * @note In a real application, you would implement this using numerical
- *       methods (e.g., sampling and optimization) or symbolic methods
- *       (e.g., symbolic differentiation to find extrema).
+ * @brief Domain of the function space: the interval [0, 2π]
  */
-struct SupNormPlaceholder {
-    /**
-     * @brief Compute the norm of a function (placeholder)
-     * 
-     * @param element The function element
-     * @return The norm value (0.0 in this placeholder)
-     */
-    double operator()(const RealFunctionElement& element) const {
-        // Real implementation can be done at a higher level using symbolic/numerical methods; 
-        // here only demonstrates type and interface.
-        return 0.0;
-    }
-};
+using FunctionDomain = kuukan::Interval<ScalarType, 0.0, 2.0 * std::numbers::pi>;
 
 /**
  * @brief Normed function space
@@ -188,25 +178,42 @@ struct SupNormPlaceholder {
  * 
  *     distance(f, g) = ||f - g||
  * 
- * where ||·|| is the norm (sup norm in this case).
+ * where ||·|| is the sup norm over FunctionDomain:
+ * 
+ *     ||f||_∞ = sup |f(x)|
+ * 
+ * kuukan::SupNorm samples the function on cached Clenshaw-Curtis nodes and
+ * refines adaptively around the maximum. Its fused difference norm samples
+ * f and g separately, so no closure for f - g is built.
+ */
+using FunctionSupNormedSpace = kuukan::FunctionNormedSpace<FunctionVectorSpace,
+                                                           kuukan::SupNorm<ScalarType, FunctionDomain>>;
+
+/**
+ * @brief L2 function space over the same domain
+ * 
+ *     ||f||_2 = (∫ |f(x)|² dx)^(1/2)
+ * 
+ * computed with adaptive Gauss-Legendre quadrature.
  */
-using FunctionSupNormedSpace = kuukan::NormedSpace<FunctionVectorSpace, SupNormPlaceholder>;
+using FunctionL2NormedSpace = kuukan::FunctionNormedSpace<FunctionVectorSpace,
+                                                          kuukan::LpNorm<ScalarType, 2, FunctionDomain>>;
 
 /**
  * @brief Main function demonstrating function space usage
  * 
  * Creates two functions (sin and cos), performs vector space operations on them,
- * and demonstrates the induced metric interface.
+ * and computes sup and L2 distances through the induced metrics.
  */
 int main() {
     // Create function elements representing sin(x) and cos(x)
     RealFunctionElement sin_function {
         .evaluator = [](ScalarType x){ return std::sin(x); },
-        .symbolic_identity = "sin"
+        .symbol = FunctionSymbols::global().atom("sin")
     };
     RealFunctionElement cos_function {
         .evaluator = [](ScalarType x){ return std::cos(x); },
-        .symbolic_identity = "cos"
+        .symbol = FunctionSymbols::global().atom("cos")
     };
 
     // Perform vector space operations
@@ -216,14 +223,35 @@ int main() {
     // Negate function: -cos
     auto neg_function = FunctionVectorSpace::negation(cos_function);
 
-    // Display symbolic identities
-    std::cout << "symbol(sum): " << sum_function.symbolic_identity << "\n";
-    std::cout << "symbol(neg): " << neg_function.symbolic_identity << "\n";
+    // Display symbolic identities (printed from the symbol table on demand)
+    std::cout << "symbol(sum): " << FunctionSymbols::global().to_string(sum_function.symbol) << "\n";
+    std::cout << "symbol(neg): " << FunctionSymbols::global().to_string(neg_function.symbol) << "\n";
+
+    // Compute distances using the induced metrics
+    // sup distance(sin, cos) = ||sin - cos||_∞ = √2
+    double sup_distance = FunctionSupNormedSpace::distance(sin_function, cos_function);
+    std::cout << "sup distance(sin, cos) = " << sup_distance << "\n";
 
-    // Compute distance using the induced metric
-    // distance(sin, cos) = ||sin - cos|| (placeholder: returns 0.0)
-    double abstract_distance = FunctionSupNormedSpace::distance(sin_function, cos_function);
-    std::cout << "abstract distance(sin, cos) = " << abstract_distance << "\n";
+    // L2 distance(sin, cos) = ||sin - cos||_2 = √(2π)
+    double l2_distance = FunctionL2NormedSpace::distance(sin_function, cos_function);
+    std::cout << "L2 distance(sin, cos) = " << l2_distance << "\n";
+
+    // The same operations on compiled function elements: one shared program
+    // per element, with sin(x) stored once in 2 * sin + (sin + cos)
+    using CompiledSpace = kuukan::CompiledFunctionSpace<ScalarType>;
+    using CompiledElement = CompiledSpace::element_type;
+    const CompiledElement x = CompiledElement::variable();
+    const CompiledElement compiled_sum = CompiledSpace::addition(CompiledElement::sin(x), CompiledElement::cos(x));
+    const CompiledElement compiled_axpy = CompiledSpace::axpy(2.0, CompiledElement::sin(x), compiled_sum);
+
+    std::vector<ScalarType> points{0.0, 0.5, 1.0, 1.5};
+    std::vector<ScalarType> values(points.size());
+    compiled_axpy.evaluate(points, values);   // all points per instruction
+    std::cout << "compiled: " << compiled_axpy.expression()
+              << " (" << compiled_axpy.size() << " instructions)\n";
+    for (std::size_t index = 0; index < points.size(); ++index) {
+        std::cout << "  f(" << points[index] << ") = " << values[index] << "\n";
+    }
 
     return 0;
 }
@@ -0,0 +1,589 @@
+/**
+ * @file clustering.hpp
+ * @brief Parallel k-means and k-medoids clustering with triangle-inequality bounds
+ *
+ * This file provides kmeans, which clusters the elements of a space that is
+ * both a vector space and a metric space (such as a NormedSpace) around
+ * centroids, and kmedoids, which needs only a MetricSpaceLike space and
+ * picks cluster centres among the elements themselves. Both are seeded with
+ * k-means++, keep Hamerly's upper and lower distance bounds per element to
+ * skip most distance evaluations, and run their assignment and update
+ * passes on an executor.
+ *
+ * @section clustering_bounds Hamerly Bounds
+ *
+ * For every element x assigned to centre a, an upper bound u ≥ d(x, c_a)
+ * and a lower bound l ≤ d(x, c_j) for all j ≠ a are kept across
+ * iterations. When centres move by p_j, u grows by p_a and l shrinks by the
+ * largest move among the other centres. With s_a half the distance from c_a
+ * to its nearest other centre, no centre can be closer than c_a while
+ * u ≤ max(s_a, l), so the element is skipped without touching any distance.
+ * Otherwise d(x, c_a) is recomputed (with kuukan::bounded_distance, which
+ * may stop at the bound) and only if the test still fails are all centres
+ * scanned, ranked by kuukan::comparable_distance.
+ *
+ * The results are deterministic: seeding uses ClusteringOptions::seed, every
+ * pass writes per-element or per-cluster slots, and centroids sum their
+ * members in index order, so the executor never changes the outcome.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/execution/executor.hpp"
+#include "kuukan/metric/metric_space.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/algorithm/reduce.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Parameters of kmeans and kmedoids
+ */
+struct ClusteringOptions {
+    /// @brief Maximum number of centre updates
+    std::size_t max_iterations = 100;
+
+    /// @brief kmeans stops once no centroid moves farther than this (in distance units)
+    double tolerance = 0;
+
+    /// @brief Seed of the k-means++ sampling; equal seeds give equal clusterings
+    std::uint64_t seed = 0x853c49e6748fea9bull;
+
+    /// @brief Elements per task in the parallel passes (smaller inputs run on the calling thread)
+    std::size_t grain_size = 256;
+};
+
+/**
+ * @brief Result of kmeans
+ *
+ * @tparam ElementType The element type of the space
+ * @tparam MeasureType The distance measure type
+ */
+template <typename ElementType, typename MeasureType>
+struct KMeansResult {
+    /// @brief The k centroids
+    std::vector<ElementType> centroids;
+
+    /// @brief Index of the centroid of every input element
+    std::vector<std::size_t> assignments;
+
+    /// @brief Sum of squared distances from the elements to their centroids
+    MeasureType inertia{};
+
+    /// @brief Number of centroid updates performed
+    std::size_t iterations = 0;
+
+    /// @brief Whether the assignments settled before max_iterations
+    bool converged = false;
+
+    /// @brief Distance evaluations spent, seeding included
+    std::size_t distance_evaluations = 0;
+};
+
+/**
+ * @brief Result of kmedoids
+ *
+ * @tparam MeasureType The distance measure type
+ */
+template <typename MeasureType>
+struct KMedoidsResult {
+    /// @brief Positions of the k medoids in the input span
+    std::vector<std::size_t> medoids;
+
+    /// @brief Index (into medoids) of the medoid of every input element
+    std::vector<std::size_t> assignments;
+
+    /// @brief Sum of distances from the elements to their medoids
+    MeasureType cost{};
+
+    /// @brief Number of medoid updates performed
+    std::size_t iterations = 0;
+
+    /// @brief Whether the medoids settled before max_iterations
+    bool converged = false;
+
+    /// @brief Distance evaluations spent, seeding included
+    std::size_t distance_evaluations = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief k-means++ seeding: positions of k elements, each drawn with probability ∝ D(x)²
+ *
+ * D(x) is the distance from x to the nearest centre drawn so far, tracked on
+ * the comparable scale. When every remaining weight is zero (duplicates),
+ * the first element not yet drawn is taken.
+ */
+template <MetricSpaceLike MS, ExecutorLike Executor>
+std::vector<std::size_t> kmeans_plus_plus(const MS& space,
+                                          std::span<const typename MS::element_type> elements,
+                                          std::size_t k, const ClusteringOptions& options,
+                                          Executor& executor, std::size_t& evaluations) {
+    using measure_type = typename MS::measure_type;
+    const std::size_t count = elements.size();
+    std::mt19937_64 engine(options.seed);
+    std::vector<std::size_t> seeds;
+    seeds.reserve(k);
+    seeds.push_back(std::uniform_int_distribution<std::size_t>(0, count - 1)(engine));
+
+    std::vector<measure_type> nearest(count, std::numeric_limits<measure_type>::infinity());
+    std::vector<char> drawn(count, 0);
+    drawn[seeds.back()] = 1;
+    while (seeds.size() < k) {
+        const auto& center = elements[seeds.back()];
+        parallel_for(executor, count, options.grain_size, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                nearest[index] = std::min(nearest[index],
+                                          kuukan::comparable_distance(space, elements[index], center));
+            }
+        });
+        evaluations += count;
+
+        double total = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            const double distance = double(kuukan::comparable_to_distance(space, nearest[index]));
+            total += distance * distance;
+        }
+        std::size_t chosen = count;
+        if (total > 0) {
+            const double target = std::uniform_real_distribution<double>(0, total)(engine);
+            double running = 0;
+            for (std::size_t index = 0; index < count; ++index) {
+                const double distance = double(kuukan::comparable_to_distance(space, nearest[index]));
+                running += distance * distance;
+                if (running > target && distance > 0) {
+                    chosen = index;
+                    break;
+                }
+            }
+        }
+        if (chosen == count || drawn[chosen]) {
+            chosen = std::size_t(std::find(drawn.begin(), drawn.end(), 0) - drawn.begin());
+        }
+        drawn[chosen] = 1;
+        seeds.push_back(chosen);
+    }
+    return seeds;
+}
+
+/**
+ * @brief Assignments and Hamerly bounds of every element, with the buffers they need
+ *
+ * Shared by kmeans and kmedoids; all buffers are sized once and reused by
+ * every iteration.
+ */
+template <MetricSpaceLike MS>
+class HamerlyState {
+public:
+    using element_type = typename MS::element_type;
+    using measure_type = typename MS::measure_type;
+
+    std::vector<std::size_t>  assignments;
+    std::vector<measure_type> upper;
+    std::vector<measure_type> lower;
+    std::vector<measure_type> half_separation;
+    std::vector<measure_type> moves;
+    std::size_t               evaluations = 0;
+
+    HamerlyState(std::size_t count, std::size_t k)
+        : assignments(count, 0), upper(count), lower(count), half_separation(k), moves(k) {}
+
+    /// @brief Assign every element with a full scan of the centres
+    template <ExecutorLike Executor>
+    void assign_all(const MS& space, std::span<const element_type> elements,
+                    std::span<const element_type> centers, std::size_t grain, Executor& executor) {
+        parallel_for(executor, elements.size(), grain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                scan(space, elements[index], centers, index);
+            }
+        });
+        evaluations += elements.size() * centers.size();
+    }
+
+    /**
+     * @brief Shift the bounds by the centre moves, then reassign the elements the bounds do not settle
+     * @return The number of elements whose centre changed
+     */
+    template <ExecutorLike Executor>
+    std::size_t reassign(const MS& space, std::span<const element_type> elements,
+                         std::span<const element_type> centers, std::size_t grain, Executor& executor) {
+        const std::size_t k = centers.size();
+        std::size_t farthest = 0;
+        measure_type largest(0), second(0);
+        for (std::size_t center = 0; center < k; ++center) {
+            if (moves[center] > largest) {
+                second = largest;
+                largest = moves[center];
+                farthest = center;
+            } else if (moves[center] > second) {
+                second = moves[center];
+            }
+        }
+        separate(space, centers, grain, executor);
+
+        std::atomic<std::size_t> changed{0};
+        std::atomic<std::size_t> spent{0};
+        parallel_for(executor, elements.size(), grain, [&](std::size_t begin, std::size_t end) {
+            std::size_t chunk_changed = 0;
+            std::size_t chunk_spent = 0;
+            for (std::size_t index = begin; index < end; ++index) {
+                const std::size_t assigned = assignments[index];
+                upper[index] += moves[assigned];
+                lower[index] -= assigned == farthest ? second : largest;
+                const measure_type bound = std::max(half_separation[assigned], lower[index]);
+                if (upper[index] <= bound) {
+                    continue;
+                }
+                const measure_type current = kuukan::bounded_distance(space, elements[index],
+                                                                      centers[assigned], bound);
+                ++chunk_spent;
+                if (current <= bound) {
+                    upper[index] = current;
+                    continue;
+                }
+                scan(space, elements[index], centers, index);
+                chunk_spent += k;
+                chunk_changed += assignments[index] != assigned;
+            }
+            changed.fetch_add(chunk_changed, std::memory_order_relaxed);
+            spent.fetch_add(chunk_spent, std::memory_order_relaxed);
+        });
+        evaluations += spent.load();
+        return changed.load();
+    }
+
+    /// @brief Exact distance of every element to its centre, accumulated as d or d² in index order
+    template <ExecutorLike Executor>
+    measure_type objective(const MS& space, std::span<const element_type> elements,
+                           std::span<const element_type> centers, bool squared,
+                           std::size_t grain, Executor& executor) {
+        parallel_for(executor, elements.size(), grain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                upper[index] = space.distance(elements[index], centers[assignments[index]]);
+            }
+        });
+        evaluations += elements.size();
+        measure_type total(0);
+        for (const measure_type distance : upper) {
+            total += squared ? distance * distance : distance;
+        }
+        return total;
+    }
+
+private:
+    /// @brief Nearest centre of one element with exact upper and lower bounds (ties: lowest index)
+    void scan(const MS& space, const element_type& element,
+              std::span<const element_type> centers, std::size_t index) {
+        measure_type best = std::numeric_limits<measure_type>::infinity();
+        measure_type runner_up = best;
+        std::size_t best_center = 0;
+        for (std::size_t center = 0; center < centers.size(); ++center) {
+            const measure_type comparable = kuukan::comparable_distance(space, element, centers[center]);
+            if (comparable < best) {
+                runner_up = best;
+                best = comparable;
+                best_center = center;
+            } else if (comparable < runner_up) {
+                runner_up = comparable;
+            }
+        }
+        assignments[index] = best_center;
+        upper[index] = kuukan::comparable_to_distance(space, best);
+        lower[index] = runner_up == std::numeric_limits<measure_type>::infinity()
+            ? runner_up
+            : kuukan::comparable_to_distance(space, runner_up);
+    }
+
+    /// @brief half_separation[j] = min over j' != j of d(c_j, c_j') / 2
+    template <ExecutorLike Executor>
+    void separate(const MS& space, std::span<const element_type> centers, std::size_t grain, Executor& executor) {
+        const std::size_t k = centers.size();
+        const std::size_t rows_per_task = std::max<std::size_t>(grain / std::max<std::size_t>(k, 1), 1);
+        parallel_for(executor, k, rows_per_task, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t center = begin; center < end; ++center) {
+                measure_type closest = std::numeric_limits<measure_type>::infinity();
+                for (std::size_t other = 0; other < k; ++other) {
+                    if (other != center) {
+                        closest = std::min(closest, space.distance(centers[center], centers[other]));
+                    }
+                }
+                half_separation[center] = closest / measure_type(2);
+            }
+        });
+        evaluations += k * (k - 1);
+    }
+};
+
+/// @brief Group element positions by cluster: members of cluster j are members[offsets[j], offsets[j + 1])
+inline void group_by_cluster(std::span<const std::size_t> assignments, std::size_t k,
+                             std::vector<std::size_t>& offsets, std::vector<std::size_t>& members) {
+    offsets.assign(k + 1, 0);
+    for (const std::size_t cluster : assignments) {
+        ++offsets[cluster + 1];
+    }
+    for (std::size_t cluster = 0; cluster < k; ++cluster) {
+        offsets[cluster + 1] += offsets[cluster];
+    }
+    members.resize(assignments.size());
+    // offsets[j] runs from the start to the end of cluster j, then everything shifts back by one
+    for (std::size_t index = 0; index < assignments.size(); ++index) {
+        members[offsets[assignments[index]]++] = index;
+    }
+    std::copy_backward(offsets.begin(), offsets.end() - 1, offsets.end());
+    offsets[0] = 0;
+}
+
+} // namespace detail
+
+/**
+ * @brief Cluster elements around k centroids (Lloyd iterations with Hamerly bounds)
+ *
+ * @tparam NS A space that is both VectorSpaceLike and MetricSpaceLike with a
+ *            floating-point measure (e.g. a NormedSpace)
+ * @param space The space whose operations and distance are used
+ * @param elements The elements to cluster
+ * @param k The number of clusters (clamped to elements.size())
+ * @param options Iteration limit, tolerance, seed and task size
+ * @param executor The executor running the passes (default: default_executor())
+ * @return The centroids, the assignment of every element and the inertia
+ *
+ * Centroids are seeded with k-means++ and then alternate between an update
+ * step, which sets every centroid to the mean of its members (summed with
+ * add_assign in index order, scaled by 1 / size), and an assignment step
+ * that skips every element whose bounds prove its centroid unchanged (see
+ * @ref clustering_bounds). Iteration stops when no assignment changes, when
+ * no centroid moves farther than options.tolerance, or after
+ * options.max_iterations updates. A centroid that loses all its members
+ * stays where it is.
+ *
+ * The bounds need the triangle inequality, so space.distance must be a
+ * true metric; the objective, as in Lloyd's algorithm, is the sum of
+ * squared distances.
+ *
+ * @note Each new centroid is computed on a task, with the storage of the
+ *       thread running it, and copied into the result on the calling
+ *       thread. Elements bound to an ArenaScope (ArenaDenseVectorSpace)
+ *       are thus only allocated from the arena by the thread owning it.
+ *
+ * @code{.cpp}
+ * auto clustering = kuukan::kmeans(MyNormedSpace{}, std::span(points), 16);
+ * for (std::size_t i = 0; i < points.size(); ++i) {
+ *     use(points[i], clustering.centroids[clustering.assignments[i]]);
+ * }
+ * @endcode
+ */
+template <typename NS, ExecutorLike Executor = WorkStealingPool>
+requires VectorSpaceLike<NS> && MetricSpaceLike<NS> && std::floating_point<typename NS::measure_type>
+KMeansResult<typename NS::element_type, typename NS::measure_type>
+kmeans(const NS& space, std::span<const typename NS::element_type> elements, std::size_t k,
+       ClusteringOptions options = {}, Executor& executor = default_executor()) {
+    using element_type = typename NS::element_type;
+    using scalar_type  = typename NS::scalar_type;
+    using measure_type = typename NS::measure_type;
+    KMeansResult<element_type, measure_type> result;
+    const std::size_t count = elements.size();
+    k = std::min(k, count);
+    if (k == 0) {
+        return result;
+    }
+
+    std::size_t seeding_evaluations = 0;
+    for (const std::size_t seed : detail::kmeans_plus_plus(space, elements, k, options, executor,
+                                                           seeding_evaluations)) {
+        result.centroids.push_back(elements[seed]);
+    }
+    detail::HamerlyState<NS> state(count, k);
+    state.evaluations = seeding_evaluations;
+    state.assign_all(space, elements, std::span<const element_type>(result.centroids),
+                     options.grain_size, executor);
+
+    // New centroids are constructed on the task that computes them and assigned on this
+    // thread, so centroids bound to the caller's arena are never allocated from by a worker
+    std::vector<std::optional<element_type>> next(k);
+    std::vector<std::size_t> offsets, members;
+    while (result.iterations < options.max_iterations) {
+        ++result.iterations;
+        detail::group_by_cluster(state.assignments, k, offsets, members);
+        parallel_for(executor, k, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t cluster = begin; cluster < end; ++cluster) {
+                const std::size_t size = offsets[cluster + 1] - offsets[cluster];
+                if (size == 0) {
+                    next[cluster].reset();
+                    state.moves[cluster] = measure_type(0);
+                    continue;
+                }
+                element_type sum = space.zero_supplier();
+                for (std::size_t member = offsets[cluster]; member < offsets[cluster + 1]; ++member) {
+                    detail::reduce_add_assign(space, sum, elements[members[member]]);
+                }
+                next[cluster].emplace(space.scalar_action(scalar_type(1) / static_cast<scalar_type>(size), sum));
+                state.moves[cluster] = space.distance(result.centroids[cluster], *next[cluster]);
+            }
+        });
+        state.evaluations += k;
+        for (std::size_t cluster = 0; cluster < k; ++cluster) {
+            if (next[cluster]) {
+                result.centroids[cluster] = std::move(*next[cluster]);
+            }
+        }
+
+        const measure_type largest_move = *std::max_element(state.moves.begin(), state.moves.end());
+        if (largest_move <= static_cast<measure_type>(options.tolerance)) {
+            result.converged = true;
+            break;
+        }
+        if (state.reassign(space, elements, std::span<const element_type>(result.centroids),
+                           options.grain_size, executor) == 0) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    result.inertia = state.objective(space, elements, std::span<const element_type>(result.centroids),
+                                     true, options.grain_size, executor);
+    result.assignments = std::move(state.assignments);
+    result.distance_evaluations = state.evaluations;
+    return result;
+}
+
+/**
+ * @brief Cluster elements around k medoids chosen among the elements
+ *
+ * @tparam MS The metric space (must satisfy MetricSpaceLike, floating-point measure)
+ * @param space The space whose distance is used
+ * @param elements The elements to cluster (element type must be copyable)
+ * @param k The number of clusters (clamped to elements.size())
+ * @param options Iteration limit, seed and task size (tolerance is unused)
+ * @param executor The executor running the passes (default: default_executor())
+ * @return The medoid positions, the assignment of every element and the cost
+ *
+ * Medoids are seeded with k-means++ and refined by alternating iterations
+ * (Park and Jun): every element joins its nearest medoid, with the same
+ * Hamerly bounds as kmeans, and every cluster then moves its medoid to the
+ * member with the smallest sum of distances to the other members. That
+ * search runs per cluster in parallel and abandons a candidate as soon as
+ * its partial sum exceeds the best one, passing the remaining budget to
+ * kuukan::bounded_distance. Iteration stops when no medoid changes or after
+ * options.max_iterations updates.
+ *
+ * @note The medoid update costs O(|C|²) distances for a cluster C in the
+ *       worst case; the alternating scheme may stop at a local optimum that
+ *       a full PAM swap search would escape.
+ *
+ * @code{.cpp}
+ * auto clustering = kuukan::kmedoids(EditDistanceSpace{}, std::span(words), 8);
+ * const auto& exemplar = words[clustering.medoids[clustering.assignments[0]]];
+ * @endcode
+ */
+template <MetricSpaceLike MS, ExecutorLike Executor = WorkStealingPool>
+requires std::floating_point<typename MS::measure_type> && std::copyable<typename MS::element_type>
+KMedoidsResult<typename MS::measure_type>
+kmedoids(const MS& space, std::span<const typename MS::element_type> elements, std::size_t k,
+         ClusteringOptions options = {}, Executor& executor = default_executor()) {
+    using element_type = typename MS::element_type;
+    using measure_type = typename MS::measure_type;
+    KMedoidsResult<measure_type> result;
+    const std::size_t count = elements.size();
+    k = std::min(k, count);
+    if (k == 0) {
+        return result;
+    }
+
+    std::size_t seeding_evaluations = 0;
+    result.medoids = detail::kmeans_plus_plus(space, elements, k, options, executor, seeding_evaluations);
+    std::vector<element_type> centers;
+    centers.reserve(k);
+    for (const std::size_t medoid : result.medoids) {
+        centers.push_back(elements[medoid]);
+    }
+    detail::HamerlyState<MS> state(count, k);
+    state.evaluations = seeding_evaluations;
+    state.assign_all(space, elements, std::span<const element_type>(centers), options.grain_size, executor);
+
+    std::vector<std::size_t> offsets, members, previous;
+    std::vector<std::size_t> spent(k);
+    while (result.iterations < options.max_iterations) {
+        ++result.iterations;
+        detail::group_by_cluster(state.assignments, k, offsets, members);
+        previous = result.medoids;
+        parallel_for(executor, k, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t cluster = begin; cluster < end; ++cluster) {
+                const std::span<const std::size_t> cluster_members(members.data() + offsets[cluster],
+                                                                   offsets[cluster + 1] - offsets[cluster]);
+                std::size_t evaluations = 0;
+                // Sum of distances from a candidate to the members, abandoned once above budget
+                auto cost = [&](std::size_t candidate, measure_type budget) {
+                    measure_type total(0);
+                    for (const std::size_t member : cluster_members) {
+                        if (member != candidate) {
+                            total += kuukan::bounded_distance(space, elements[candidate], elements[member],
+                                                              budget - total);
+                            ++evaluations;
+                            if (total > budget) {
+                                break;
+                            }
+                        }
+                    }
+                    return total;
+                };
+
+                const std::size_t current = result.medoids[cluster];
+                std::size_t best = current;
+                measure_type best_cost = std::numeric_limits<measure_type>::infinity();
+                if (std::binary_search(cluster_members.begin(), cluster_members.end(), current)) {
+                    best_cost = cost(current, best_cost);
+                }
+                for (const std::size_t candidate : cluster_members) {
+                    if (candidate != current) {
+                        const measure_type candidate_cost = cost(candidate, best_cost);
+                        if (candidate_cost < best_cost) {
+                            best = candidate;
+                            best_cost = candidate_cost;
+                        }
+                    }
+                }
+                state.moves[cluster] = best == current
+                    ? measure_type(0)
+                    : space.distance(elements[current], elements[best]);
+                evaluations += best != current;
+                result.medoids[cluster] = best;
+                spent[cluster] = evaluations;
+            }
+        });
+        bool moved = false;
+        for (std::size_t cluster = 0; cluster < k; ++cluster) {
+            state.evaluations += spent[cluster];
+            if (result.medoids[cluster] != previous[cluster]) {
+                centers[cluster] = elements[result.medoids[cluster]];
+                moved = true;
+            }
+        }
+
+        if (!moved) {
+            result.converged = true;
+            break;
+        }
+        state.reassign(space, elements, std::span<const element_type>(centers), options.grain_size, executor);
+    }
+
+    result.cost = state.objective(space, elements, std::span<const element_type>(centers),
+                                  false, options.grain_size, executor);
+    result.assignments = std::move(state.assignments);
+    result.distance_evaluations = state.evaluations;
+    return result;
+}
+
+} // namespace kuukan
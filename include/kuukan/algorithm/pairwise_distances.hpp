@@ -0,0 +1,280 @@
+/**
+ * @file pairwise_distances.hpp
+ * @brief Tiled, multithreaded distance matrix between two sets of elements
+ *
+ * This file provides pairwise_distances, which fills an N×M matrix with the
+ * distances between every element of one span and every element of another.
+ * The matrix is processed in square tiles so that both operand blocks stay in
+ * cache, and tiles are shared out among the threads of an executor. For inner
+ * product spaces, the squared norms of a reference set can come from a
+ * NormCache built once instead of being recomputed by every call.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/execution/executor.hpp"
+#include "kuukan/metric/metric_space.hpp"
+#include "kuukan/inner/inner_product_space.hpp"
+#include "kuukan/norm/norm_cache.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Tuning parameters for pairwise_distances
+ */
+struct PairwiseOptions {
+    /// @brief Rows and columns per tile (at most max_tile_size)
+    std::size_t tile_size = 64;
+
+    /// @brief Maximum number of tiles computed at once; 0 selects the executor's concurrency
+    std::size_t thread_count = 0;
+
+    /// @brief Matrices with fewer entries than this are computed on the calling thread
+    std::size_t parallel_threshold = 1 << 14;
+
+    /// @brief Write comparable_distance values instead of distances
+    ///        (convert with kuukan::comparable_to_distance; skips sqrt for dense L2)
+    bool comparable = false;
+
+    /// @brief Upper bound for tile_size (bounds the per-tile norm buffers)
+    static constexpr std::size_t max_tile_size = 256;
+};
+
+namespace detail {
+
+/**
+ * @brief Fill the tile [row_begin, row_end) × [column_begin, column_end) of out
+ *
+ * lhs_squared_norms and rhs_squared_norms, when not null, hold <x, x> for
+ * every element of lhs and rhs (e.g. from a NormCache); otherwise the tile
+ * computes the squared norms of its own rows and columns.
+ */
+template <MetricSpaceLike MS>
+void pairwise_tile(const MS& space,
+                   std::span<const typename MS::element_type> lhs,
+                   const typename MS::measure_type* lhs_squared_norms,
+                   std::span<const typename MS::element_type> rhs,
+                   const typename MS::measure_type* rhs_squared_norms,
+                   std::span<typename MS::measure_type> out,
+                   std::size_t row_begin, std::size_t row_end,
+                   std::size_t column_begin, std::size_t column_end,
+                   bool comparable) {
+    using measure_type = typename MS::measure_type;
+    const std::size_t columns = rhs.size();
+
+    if constexpr (InnerProductSpaceLike<MS>) {
+        measure_type row_buffer[PairwiseOptions::max_tile_size];
+        measure_type column_buffer[PairwiseOptions::max_tile_size];
+        const measure_type* row_norms = row_buffer;
+        const measure_type* column_norms = column_buffer;
+        if (lhs_squared_norms != nullptr) {
+            row_norms = lhs_squared_norms + row_begin;
+        } else {
+            for (std::size_t row = row_begin; row < row_end; ++row) {
+                row_buffer[row - row_begin] = space.inner_product(lhs[row], lhs[row]);
+            }
+        }
+        if (rhs_squared_norms != nullptr) {
+            column_norms = rhs_squared_norms + column_begin;
+        } else {
+            for (std::size_t column = column_begin; column < column_end; ++column) {
+                column_buffer[column - column_begin] = space.inner_product(rhs[column], rhs[column]);
+            }
+        }
+        // The expansion already is the comparable value when the surrogate is the squared distance
+        constexpr bool squared_comparable = requires { requires MS::comparable_is_squared_distance; };
+        for (std::size_t row = row_begin; row < row_end; ++row) {
+            const measure_type row_norm = row_norms[row - row_begin];
+            measure_type* out_row = out.data() + row * columns;
+            for (std::size_t column = column_begin; column < column_end; ++column) {
+                using std::sqrt;
+                const measure_type expansion = row_norm + column_norms[column - column_begin]
+                                             - measure_type(2) * space.inner_product(lhs[row], rhs[column]);
+                // Cancellation can push the expansion slightly below zero
+                const measure_type squared = expansion > measure_type(0) ? expansion : measure_type(0);
+                if (comparable && squared_comparable) {
+                    out_row[column] = squared;
+                } else {
+                    const measure_type distance = sqrt(squared);
+                    out_row[column] = comparable ? kuukan::distance_to_comparable(space, distance) : distance;
+                }
+            }
+        }
+    } else {
+        (void)lhs_squared_norms;
+        (void)rhs_squared_norms;
+        for (std::size_t row = row_begin; row < row_end; ++row) {
+            measure_type* out_row = out.data() + row * columns;
+            if (comparable) {
+                for (std::size_t column = column_begin; column < column_end; ++column) {
+                    out_row[column] = kuukan::comparable_distance(space, lhs[row], rhs[column]);
+                }
+            } else {
+                for (std::size_t column = column_begin; column < column_end; ++column) {
+                    out_row[column] = space.distance(lhs[row], rhs[column]);
+                }
+            }
+        }
+    }
+}
+
+/// @brief Shared driver of the pairwise_distances overloads (null norms: computed per tile)
+template <MetricSpaceLike MS, ExecutorLike Executor>
+void pairwise_blocks(const MS& space,
+                     std::span<const typename MS::element_type> lhs,
+                     const typename MS::measure_type* lhs_squared_norms,
+                     std::span<const typename MS::element_type> rhs,
+                     const typename MS::measure_type* rhs_squared_norms,
+                     std::span<typename MS::measure_type> out,
+                     const PairwiseOptions& options, Executor& executor) {
+    const std::size_t rows = lhs.size();
+    const std::size_t columns = rhs.size();
+    assert(out.size() >= rows * columns);
+    if (rows == 0 || columns == 0) {
+        return;
+    }
+
+    const std::size_t tile = std::clamp<std::size_t>(options.tile_size, 1, PairwiseOptions::max_tile_size);
+    const std::size_t tile_rows = (rows + tile - 1) / tile;
+    const std::size_t tile_columns = (columns + tile - 1) / tile;
+    const std::size_t tile_count = tile_rows * tile_columns;
+
+    auto run_tile = [&](std::size_t tile_index) {
+        const std::size_t row_begin = tile_index / tile_columns * tile;
+        const std::size_t column_begin = tile_index % tile_columns * tile;
+        pairwise_tile(space, lhs, lhs_squared_norms, rhs, rhs_squared_norms, out,
+                      row_begin, std::min(row_begin + tile, rows),
+                      column_begin, std::min(column_begin + tile, columns),
+                      options.comparable);
+    };
+
+    std::size_t task_count = options.thread_count != 0
+        ? options.thread_count
+        : std::max<std::size_t>(executor.concurrency(), 1);
+    task_count = std::min(task_count, tile_count);
+    if (task_count <= 1 || rows * columns < options.parallel_threshold) {
+        for (std::size_t tile_index = 0; tile_index < tile_count; ++tile_index) {
+            run_tile(tile_index);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next_tile{0};
+    executor.bulk(task_count, [&](std::size_t) {
+        for (std::size_t tile_index = next_tile.fetch_add(1, std::memory_order_relaxed);
+             tile_index < tile_count;
+             tile_index = next_tile.fetch_add(1, std::memory_order_relaxed)) {
+            run_tile(tile_index);
+        }
+    });
+}
+
+} // namespace detail
+
+/**
+ * @brief Compute the distance matrix between two spans of elements
+ *
+ * Writes distance(lhs[i], rhs[j]) to out[i * rhs.size() + j] (row-major).
+ *
+ * @tparam MS The metric space (must satisfy MetricSpaceLike)
+ * @param space The space whose distance is used
+ * @param lhs The row elements
+ * @param rhs The column elements
+ * @param out Caller-provided buffer of at least lhs.size() * rhs.size() measures
+ * @param options Tiling and threading parameters
+ * @param executor The executor running the tiles (default: default_executor())
+ *
+ * The matrix is split into tiles of options.tile_size × options.tile_size
+ * entries, which the tasks of one bulk call claim one at a time. Apart from
+ * what the executor needs to schedule the tasks, no memory is allocated.
+ *
+ * If MS satisfies InnerProductSpaceLike, each tile computes the squared
+ * norms of its rows and columns once and derives every entry as
+ * sqrt(<x, x> + <y, y> - 2 <x, y>). Otherwise MS::distance is called per pair.
+ * The overloads taking NormCache arguments read the squared norms instead.
+ *
+ * With options.comparable set, out receives kuukan::comparable_distance
+ * values instead, which rank like the distances but may skip the final
+ * root (e.g. squared distances for dense L2 spaces). When the space's
+ * surrogate is the squared distance (InnerProductSpace::
+ * comparable_is_squared_distance), the expansion is written as is.
+ *
+ * @note Entries computed through the inner-product expansion may differ from
+ *       MS::distance by rounding; distances between nearly equal elements
+ *       lose relative accuracy.
+ *
+ * @code{.cpp}
+ * std::vector<double> matrix(points.size() * centers.size());
+ * kuukan::pairwise_distances(MySpace{}, std::span(points), std::span(centers), std::span(matrix));
+ * @endcode
+ */
+template <MetricSpaceLike MS, ExecutorLike Executor = WorkStealingPool>
+void pairwise_distances(const MS& space,
+                        std::span<const typename MS::element_type> lhs,
+                        std::span<const typename MS::element_type> rhs,
+                        std::span<typename MS::measure_type> out,
+                        PairwiseOptions options = {},
+                        Executor& executor = default_executor()) {
+    detail::pairwise_blocks(space, lhs, nullptr, rhs, nullptr, out, options, executor);
+}
+
+/**
+ * @brief Compute the distance matrix against a reference set with cached norms
+ *
+ * @param space The space whose inner product is used
+ * @param lhs The row elements (e.g. a batch of queries)
+ * @param rhs The column elements (e.g. the reference set)
+ * @param rhs_norms The norms of rhs; must be current and of size rhs.size()
+ * @param out Caller-provided buffer of at least lhs.size() * rhs.size() measures
+ * @param options Tiling and threading parameters
+ * @param executor The executor running the tiles (default: default_executor())
+ *
+ * Same result as pairwise_distances without the cache, but column tiles read
+ * <y, y> from rhs_norms instead of recomputing it, so a reference set that
+ * is queried repeatedly pays for its norms once.
+ */
+template <InnerProductSpaceLike MS, ExecutorLike Executor = WorkStealingPool>
+void pairwise_distances(const MS& space,
+                        std::span<const typename MS::element_type> lhs,
+                        std::span<const typename MS::element_type> rhs,
+                        const NormCache<MS>& rhs_norms,
+                        std::span<typename MS::measure_type> out,
+                        PairwiseOptions options = {},
+                        Executor& executor = default_executor()) {
+    assert(rhs_norms.size() == rhs.size() && rhs_norms.is_current());
+    detail::pairwise_blocks(space, lhs, nullptr, rhs, rhs_norms.squared_norms().data(),
+                            out, options, executor);
+}
+
+/**
+ * @brief Compute the distance matrix between two sets with cached norms
+ *
+ * As above, with the squared norms of both lhs and rhs read from their
+ * caches (e.g. the distances within one reference set); no tile computes
+ * an inner product of an element with itself.
+ */
+template <InnerProductSpaceLike MS, ExecutorLike Executor = WorkStealingPool>
+void pairwise_distances(const MS& space,
+                        std::span<const typename MS::element_type> lhs,
+                        const NormCache<MS>& lhs_norms,
+                        std::span<const typename MS::element_type> rhs,
+                        const NormCache<MS>& rhs_norms,
+                        std::span<typename MS::measure_type> out,
+                        PairwiseOptions options = {},
+                        Executor& executor = default_executor()) {
+    assert(lhs_norms.size() == lhs.size() && lhs_norms.is_current());
+    assert(rhs_norms.size() == rhs.size() && rhs_norms.is_current());
+    detail::pairwise_blocks(space, lhs, lhs_norms.squared_norms().data(),
+                            rhs, rhs_norms.squared_norms().data(), out, options, executor);
+}
+
+} // namespace kuukan
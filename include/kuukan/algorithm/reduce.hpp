@@ -0,0 +1,260 @@
+/**
+ * @file reduce.hpp
+ * @brief Parallel, deterministic sums and weighted sums over spans of elements
+ *
+ * This file provides reduce, which computes x_1 + ... + x_n, and
+ * weighted_sum, which computes a_1 x_1 + ... + a_n x_n, for any
+ * VectorSpaceLike space. The input is cut into blocks of a fixed size, each
+ * block is accumulated into its own partial sum on an executor, and the
+ * partial sums are combined in a fixed binary tree. Block boundaries and the
+ * tree depend only on the input size and ReduceOptions::block_size, never on
+ * the executor, so the result is bitwise reproducible across thread counts.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/execution/executor.hpp"
+#include "kuukan/vector/vector_space.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Tuning parameters for reduce and weighted_sum
+ */
+struct ReduceOptions {
+    /// @brief Elements accumulated into each partial sum; fixes the summation order
+    std::size_t block_size = 1024;
+
+    /// @brief Use Kahan-compensated accumulation inside each block
+    ///        (only for floating-point scalars; ignored otherwise)
+    bool compensated = false;
+};
+
+namespace detail {
+
+/// @brief target += source, in place when the space provides add_assign
+template <VectorSpaceLike VS>
+void reduce_add_assign(const VS& space, typename VS::element_type& target,
+                       const typename VS::element_type& source) {
+    if constexpr (requires { space.add_assign(target, source); }) {
+        space.add_assign(target, source);
+    } else {
+        target = space.addition(target, source);
+    }
+}
+
+/// @brief scalar_value * element_x + element_y, fused when the space provides axpy
+template <VectorSpaceLike VS>
+typename VS::element_type reduce_axpy(const VS& space, const typename VS::scalar_type& scalar_value,
+                                      const typename VS::element_type& element_x,
+                                      const typename VS::element_type& element_y) {
+    if constexpr (requires { space.axpy(scalar_value, element_x, element_y); }) {
+        return space.axpy(scalar_value, element_x, element_y);
+    } else {
+        return space.addition(space.scalar_action(scalar_value, element_x), element_y);
+    }
+}
+
+/// @brief Whether reduce_block can run Kahan-compensated for VS
+template <typename VS>
+inline constexpr bool compensable = std::floating_point<typename VS::scalar_type>;
+
+/**
+ * @brief Accumulate elements[begin, end) (scaled by weights, if any) into one partial sum
+ *
+ * Uncompensated sums start from zero_supplier and add one element at a time
+ * with add_assign. Weighted sums hand groups of terms to the space's
+ * linear_combination, with the running sum as the first term, so dense
+ * spaces make one fused pass per group instead of one per element.
+ *
+ * Compensated sums carry a correction element c alongside the sum s and,
+ * for each term t, compute y = t + c, s' = s + y and c = (s - s') + y: the
+ * componentwise form of Kahan summation, written with space operations only.
+ */
+template <VectorSpaceLike VS>
+typename VS::element_type reduce_block(const VS& space,
+                                       std::span<const typename VS::scalar_type> weights,
+                                       std::span<const typename VS::element_type> elements,
+                                       std::size_t begin, std::size_t end, bool compensated) {
+    using element_type = typename VS::element_type;
+    using scalar_type  = typename VS::scalar_type;
+    const bool weighted = !weights.empty();
+
+    element_type sum = space.zero_supplier();
+    if constexpr (compensable<VS>) {
+        if (compensated) {
+            element_type correction = space.zero_supplier();
+            for (std::size_t index = begin; index < end; ++index) {
+                const element_type term = weighted
+                    ? reduce_axpy(space, weights[index], elements[index], correction)
+                    : space.addition(elements[index], correction);
+                element_type next = space.addition(sum, term);
+                correction = space.difference(sum, next);
+                reduce_add_assign(space, correction, term);
+                sum = std::move(next);
+            }
+            reduce_add_assign(space, sum, correction);
+            return sum;
+        }
+    }
+
+    if (!weighted) {
+        for (std::size_t index = begin; index < end; ++index) {
+            reduce_add_assign(space, sum, elements[index]);
+        }
+        return sum;
+    }
+
+    if constexpr (requires { typename VS::term_type; } &&
+                  std::same_as<typename VS::term_type, LinearTerm<scalar_type, element_type>>) {
+        // Terms per linear_combination call, including the running sum
+        constexpr std::size_t group_size = 16;
+        const scalar_type one(1);
+        std::vector<typename VS::term_type> terms;
+        terms.reserve(group_size);
+        for (std::size_t index = begin; index < end;) {
+            const std::size_t group_end = std::min(index + group_size - 1, end);
+            terms.clear();
+            terms.push_back({one, sum});
+            for (; index < group_end; ++index) {
+                terms.push_back({weights[index], elements[index]});
+            }
+            sum = space.linear_combination(std::span<const typename VS::term_type>(terms));
+        }
+    } else {
+        for (std::size_t index = begin; index < end; ++index) {
+            sum = reduce_axpy(space, weights[index], elements[index], sum);
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Shared driver of reduce and weighted_sum (empty weights: unweighted)
+ *
+ * Partial sums are combined pairwise, partials[i] += partials[i + stride]
+ * for stride = 1, 2, 4, ..., so the tree is fixed by the block count.
+ *
+ * Each partial is move-constructed on the thread that sums its block, so
+ * it keeps the storage that thread allocated. Assigning it into an element
+ * created on the calling thread would copy it into that element's storage,
+ * e.g. the caller's MonotonicArena, from another thread.
+ */
+template <VectorSpaceLike VS, ExecutorLike Executor>
+typename VS::element_type reduce_blocks(const VS& space,
+                                        std::span<const typename VS::scalar_type> weights,
+                                        std::span<const typename VS::element_type> elements,
+                                        const ReduceOptions& options, Executor& executor) {
+    using element_type = typename VS::element_type;
+    const std::size_t count = elements.size();
+    const std::size_t block_size = std::max<std::size_t>(options.block_size, 1);
+    const std::size_t block_count = (count + block_size - 1) / block_size;
+    if (block_count <= 1) {
+        return reduce_block(space, weights, elements, 0, count, options.compensated);
+    }
+
+    std::vector<std::optional<element_type>> partials(block_count);
+    parallel_for(executor, block_count, 1, [&](std::size_t block_begin, std::size_t block_end) {
+        for (std::size_t block = block_begin; block < block_end; ++block) {
+            partials[block].emplace(reduce_block(space, weights, elements, block * block_size,
+                                                 std::min(block * block_size + block_size, count),
+                                                 options.compensated));
+        }
+    });
+
+    for (std::size_t stride = 1; stride < block_count; stride *= 2) {
+        for (std::size_t block = 0; block + stride < block_count; block += 2 * stride) {
+            reduce_add_assign(space, *partials[block], *partials[block + stride]);
+        }
+    }
+    return std::move(*partials[0]);
+}
+
+} // namespace detail
+
+/**
+ * @brief Sum a span of elements in parallel
+ *
+ * @tparam VS The vector space (must satisfy VectorSpaceLike)
+ * @param space The space whose operations are used
+ * @param elements The elements to sum
+ * @param options Block size and compensation
+ * @param executor The executor running the blocks (default: default_executor())
+ * @return elements[0] + ... + elements[n - 1], or zero_supplier() for an empty span
+ *
+ * The elements are cut into blocks of options.block_size. Each block is a
+ * task that accumulates its elements, in order, into a partial sum started
+ * from zero_supplier (with add_assign when the space provides it, so dense
+ * spaces do not allocate per element). The partial sums are then combined
+ * pairwise in a fixed tree. The order of every addition depends only on
+ * elements.size() and options.block_size, so the result is the same for any
+ * executor, including InlineExecutor.
+ *
+ * With options.compensated set and a floating-point scalar type, each block
+ * is summed with Kahan compensation; together with the pairwise combination
+ * of blocks the error stays close to one rounding, independent of n. The
+ * compensated loop costs about four space operations per element.
+ *
+ * @note Partial sums are allocated per block, on the thread that runs the
+ *       block, and combined on the calling thread. Elements whose
+ *       allocator is bound to the calling thread's ArenaScope (e.g.
+ *       ArenaDenseVectorSpace) therefore take their partials from each
+ *       worker's own current arena, or the heap outside any scope; the
+ *       result may hold such heap storage even inside a scope.
+ *
+ * @code{.cpp}
+ * auto total = kuukan::reduce(space, std::span(gradients));
+ * @endcode
+ */
+template <VectorSpaceLike VS, ExecutorLike Executor = WorkStealingPool>
+typename VS::element_type reduce(const VS& space,
+                                 std::span<const typename VS::element_type> elements,
+                                 ReduceOptions options = {},
+                                 Executor& executor = default_executor()) {
+    return detail::reduce_blocks(space, std::span<const typename VS::scalar_type>{},
+                                 elements, options, executor);
+}
+
+/**
+ * @brief Compute the weighted sum a_1 x_1 + ... + a_n x_n of a span of elements in parallel
+ *
+ * @tparam VS The vector space (must satisfy VectorSpaceLike)
+ * @param space The space whose operations are used
+ * @param weights The coefficients a_i (same length as elements)
+ * @param elements The elements x_i
+ * @param options Block size and compensation
+ * @param executor The executor running the blocks (default: default_executor())
+ * @return The weighted sum, or zero_supplier() for empty spans
+ *
+ * Blocks, partial sums and the combination tree are those of reduce, so
+ * the result is deterministic in the same way. Within a block, terms are
+ * passed to the space's linear_combination in groups of 15 (plus the running
+ * sum), so spaces with a fused kernel, such as the dense spaces, read each
+ * group in one pass; spaces without linear_combination use axpy.
+ *
+ * @code{.cpp}
+ * auto centroid = kuukan::weighted_sum(space, std::span(memberships), std::span(points));
+ * @endcode
+ */
+template <VectorSpaceLike VS, ExecutorLike Executor = WorkStealingPool>
+typename VS::element_type weighted_sum(const VS& space,
+                                       std::span<const typename VS::scalar_type> weights,
+                                       std::span<const typename VS::element_type> elements,
+                                       ReduceOptions options = {},
+                                       Executor& executor = default_executor()) {
+    assert(weights.size() == elements.size());
+    if (elements.empty()) {
+        return space.zero_supplier();
+    }
+    return detail::reduce_blocks(space, weights, elements, options, executor);
+}
+
+} // namespace kuukan
@@ -0,0 +1,529 @@
+/**
+ * @file element_batch.hpp
+ * @brief Structure-of-arrays container for many elements of a dense space
+ *
+ * This file provides ElementBatch, which stores a batch of elements of a
+ * space with array-like elements in structure-of-arrays (SoA) layout, and
+ * batched versions of the space operations. Applying an operation to the
+ * whole batch lets SIMD registers run across elements instead of across the
+ * components of a single element.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/dense/simd.hpp"
+#include "kuukan/dense/aligned_allocator.hpp"
+#include "kuukan/execution/executor.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Concept for element types that are arrays of components
+ *
+ * @tparam E The type to check
+ *
+ * A type satisfies DenseElementLike if it exposes a `value_type`, a `size()`
+ * and indexed access to its components. DenseVector, `std::array` and
+ * `std::vector` all qualify. An element of size zero is read as the zero
+ * element (see DenseVector<T, std::dynamic_extent>).
+ */
+template <typename E>
+concept DenseElementLike =
+    requires(E& element, const E& const_element, std::size_t index) {
+        typename E::value_type;
+        { const_element.size() } -> std::convertible_to<std::size_t>;
+        { element[index] } -> std::same_as<typename E::value_type&>;
+        { const_element[index] } -> std::convertible_to<const typename E::value_type&>;
+    };
+
+/**
+ * @brief Create a dense element with the given number of components
+ *
+ * Elements constructible from a size (e.g. run-time sized DenseVector or
+ * `std::vector`) are constructed with it; statically sized aggregates are
+ * value-initialized and already have the right size.
+ *
+ * @tparam E The element type
+ * @param dimension The number of components
+ * @return A zero-valued element with dimension components
+ */
+template <DenseElementLike E>
+E make_dense_element(std::size_t dimension) {
+    if constexpr (!std::is_aggregate_v<E> && std::constructible_from<E, std::size_t>) {
+        return E(dimension);
+    } else {
+        E element{};
+        assert(static_cast<std::size_t>(element.size()) == dimension);
+        return element;
+    }
+}
+
+/**
+ * @brief Batch of elements of a dense space in structure-of-arrays layout
+ *
+ * @tparam VS The vector space of the elements (its element type must satisfy DenseElementLike)
+ *
+ * An ElementBatch stores `size()` elements with `dimension()` components
+ * each as `dimension()` rows of `stride()` lanes: lane j of row c holds
+ * component c of element j. The stride is rounded up to the SIMD register
+ * width and unused lanes are kept at zero.
+ *
+ * @section batch_dispatch Kernel Dispatch
+ *
+ * The batched operations use wide-lane kernels when the space supplies them
+ * and fall back to the scalar functors of VS (gathering each element,
+ * applying the functor and scattering the result) otherwise:
+ * - `addition` / `scalar_action` use `VS::batch_kernels` when present
+ *   (DenseVectorSpace provides it).
+ * - `norm` / `distance` use the static `batch_norm` / `batch_difference_norm`
+ *   of the norm functor when present (DenseL1Norm, DenseL2Norm and
+ *   DenseLinfNorm provide them). Distances are always the induced
+ *   norm(left - right) in that case, as for NormedSpace itself.
+ *
+ * Batches of at least parallel_threshold components are split into
+ * lane-aligned ranges of elements (or of rows, for the kernels of
+ * `addition` and `scalar_action`) that run as tasks of the executor passed
+ * as the last argument, default_executor() unless given.
+ *
+ * @section batch_usage Usage
+ *
+ * @code{.cpp}
+ * using E8 = kuukan::DenseNormedSpace<float, 8, kuukan::DenseL2Norm>;
+ *
+ * kuukan::ElementBatch<E8> points(std::span<const E8::element_type>(elements));
+ * std::vector<float> distances(points.size());
+ * kuukan::ElementBatch<E8>::distance(points, query, distances);
+ * @endcode
+ */
+template <StaticVectorSpaceLike VS>
+requires DenseElementLike<typename VS::element_type>
+class ElementBatch {
+public:
+    /// @brief Type alias for the space of the elements
+    using space_type   = VS;
+
+    /// @brief Type alias for elements of the space
+    using element_type = typename VS::element_type;
+
+    /// @brief Type alias for scalars of the space
+    using scalar_type  = typename VS::scalar_type;
+
+    /// @brief Type alias for the component type
+    using value_type   = typename element_type::value_type;
+
+    /// @brief Type alias for the underlying storage
+    using storage_type = std::vector<value_type, AlignedAllocator<value_type>>;
+
+    /// @brief Number of lanes processed per SIMD register
+    static constexpr std::size_t lane_width = simd::native<value_type>::width;
+
+    /// @brief Whether the space supplies wide-lane kernels for addition and scalar_action
+    static constexpr bool has_batch_kernels = requires { typename VS::batch_kernels; };
+
+    /// @brief Batches with fewer components than this run on the calling thread
+    static constexpr std::size_t parallel_threshold = std::size_t(1) << 16;
+
+    /// @brief Construct an empty batch of dimension zero
+    ElementBatch() = default;
+
+    /**
+     * @brief Construct count zero elements of the given dimension
+     *
+     * @param dimension The number of components of every element
+     * @param count The initial number of elements
+     */
+    explicit ElementBatch(std::size_t dimension, std::size_t count = 0)
+        : dimension_(dimension) {
+        resize(count);
+    }
+
+    /**
+     * @brief Construct a batch holding copies of the given elements
+     *
+     * The dimension is the size of the largest element; empty elements are
+     * stored as zero.
+     *
+     * @param elements The elements to store
+     */
+    explicit ElementBatch(std::span<const element_type> elements) {
+        for (const element_type& element : elements) {
+            dimension_ = std::max(dimension_, static_cast<std::size_t>(element.size()));
+        }
+        reserve(elements.size());
+        for (const element_type& element : elements) {
+            push_back(element);
+        }
+    }
+
+    /// @brief Number of elements
+    std::size_t size() const noexcept { return count_; }
+
+    /// @brief Whether the batch holds no elements
+    bool empty() const noexcept { return count_ == 0; }
+
+    /// @brief Number of components of every element
+    std::size_t dimension() const noexcept { return dimension_; }
+
+    /// @brief Distance (in values) between consecutive rows; the lane capacity
+    std::size_t stride() const noexcept { return stride_; }
+
+    /// @brief The SoA buffer (dimension() rows of stride() lanes)
+    value_type*       data() noexcept       { return components_.data(); }
+    const value_type* data() const noexcept { return components_.data(); }
+
+    /// @brief The lanes of row component_index (component component_index of every element)
+    std::span<value_type> row(std::size_t component_index) noexcept {
+        return {components_.data() + component_index * stride_, count_};
+    }
+    std::span<const value_type> row(std::size_t component_index) const noexcept {
+        return {components_.data() + component_index * stride_, count_};
+    }
+
+    /**
+     * @brief Ensure room for capacity elements without relayout
+     *
+     * @param capacity The number of elements to make room for
+     */
+    void reserve(std::size_t capacity) {
+        const std::size_t new_stride = round_up(capacity);
+        if (new_stride <= stride_) {
+            return;
+        }
+        storage_type relaid(dimension_ * new_stride, value_type{});
+        for (std::size_t component = 0; component < dimension_; ++component) {
+            std::copy_n(components_.data() + component * stride_, count_,
+                        relaid.data() + component * new_stride);
+        }
+        components_ = std::move(relaid);
+        stride_ = new_stride;
+    }
+
+    /**
+     * @brief Change the number of elements; new elements are zero
+     *
+     * @param count The new number of elements
+     */
+    void resize(std::size_t count) {
+        reserve(count);
+        for (std::size_t component = 0; component < dimension_; ++component) {
+            value_type* lanes = components_.data() + component * stride_;
+            if (count < count_) {
+                std::fill(lanes + count, lanes + count_, value_type{});
+            }
+        }
+        count_ = count;
+    }
+
+    /**
+     * @brief Append a copy of an element
+     *
+     * @param element The element to append (same dimension, or empty for zero)
+     */
+    void push_back(const element_type& element) {
+        if (count_ == stride_) {
+            reserve(std::max<std::size_t>(2 * stride_, lane_width));
+        }
+        ++count_;
+        set(count_ - 1, element);
+    }
+
+    /**
+     * @brief Gather element index into an element of the space
+     *
+     * @param index The element index
+     * @return A copy of the element
+     */
+    element_type get(std::size_t index) const {
+        element_type element = make_dense_element<element_type>(dimension_);
+        for (std::size_t component = 0; component < dimension_; ++component) {
+            element[component] = components_[component * stride_ + index];
+        }
+        return element;
+    }
+
+    /**
+     * @brief Scatter an element into slot index
+     *
+     * @param index The element index
+     * @param element The element to store (same dimension, or empty for zero)
+     */
+    void set(std::size_t index, const element_type& element) {
+        const std::size_t size = static_cast<std::size_t>(element.size());
+        assert(size == dimension_ || size == 0);
+        for (std::size_t component = 0; component < dimension_; ++component) {
+            components_[component * stride_ + index] = size == 0 ? value_type{} : element[component];
+        }
+    }
+
+    /**
+     * @brief Batched addition: out[j] = left[j] + right[j]
+     *
+     * @param left The left operands
+     * @param right The right operands (same size and dimension)
+     * @param out The results; reshaped to left's layout and may alias an operand
+     *        (aliasing right with a different stride computes into a new batch)
+     * @param executor The executor for large batches
+     */
+    template <ExecutorLike Executor = WorkStealingPool>
+    static void addition(const ElementBatch& left, const ElementBatch& right, ElementBatch& out,
+                         Executor& executor = default_executor()) {
+        assert(left.size() == right.size() && left.dimension() == right.dimension());
+        if constexpr (has_batch_kernels) {
+            if (left.stride_ == right.stride_) {
+                out.reshape_like(left);
+                const std::size_t stride = left.stride_;
+                left.for_row_ranges(executor, [&](std::size_t begin, std::size_t end) {
+                    VS::batch_kernels::addition(left.data() + begin * stride, right.data() + begin * stride,
+                                                out.data() + begin * stride, end - begin, stride);
+                });
+                return;
+            }
+        }
+        if (&out == &right && out.stride_ != left.stride_) {
+            // Reshaping right to left's layout would clear it before it is read
+            ElementBatch result;
+            addition(left, right, result, executor);
+            out = std::move(result);
+            return;
+        }
+        out.reshape_like(left);
+        left.for_element_ranges(executor, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                out.set(index, VS::addition(left.get(index), right.get(index)));
+            }
+        });
+    }
+
+    /**
+     * @brief Batched scalar multiplication: out[j] = scalar_value * batch[j]
+     *
+     * @param scalar_value The scalar multiplier
+     * @param batch The operands
+     * @param out The results; reshaped as needed and may alias batch
+     * @param executor The executor for large batches
+     */
+    template <ExecutorLike Executor = WorkStealingPool>
+    static void scalar_action(const scalar_type& scalar_value, const ElementBatch& batch,
+                              ElementBatch& out, Executor& executor = default_executor()) {
+        out.reshape_like(batch);
+        if constexpr (has_batch_kernels) {
+            const std::size_t stride = batch.stride_;
+            batch.for_row_ranges(executor, [&](std::size_t begin, std::size_t end) {
+                VS::batch_kernels::scalar_action(scalar_value, batch.data() + begin * stride,
+                                                 out.data() + begin * stride, end - begin, stride);
+            });
+        } else {
+            batch.for_element_ranges(executor, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t index = begin; index < end; ++index) {
+                    out.set(index, VS::scalar_action(scalar_value, batch.get(index)));
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Batched norm: out[j] = norm(batch[j])
+     *
+     * Available when VS is a normed space.
+     *
+     * @param batch The elements
+     * @param out Receives batch.size() norms
+     * @param executor The executor for large batches
+     */
+    template <typename Space = VS, ExecutorLike Executor = WorkStealingPool>
+    requires requires(const element_type& element) { typename Space::measure_type; Space::norm(element); }
+    static void norm(const ElementBatch& batch, std::span<typename Space::measure_type> out,
+                     Executor& executor = default_executor()) {
+        using Measure = typename Space::measure_type;
+        assert(out.size() >= batch.size());
+        using norm_functor = std::remove_cvref_t<decltype(VS::norm)>;
+        batch.for_element_ranges(executor, [&](std::size_t begin, std::size_t end) {
+            if constexpr (std::same_as<Measure, value_type> &&
+                          requires(const value_type* soa, value_type* result, std::size_t n) {
+                              norm_functor::batch_norm(soa, n, n, n, result);
+                          }) {
+                norm_functor::batch_norm(batch.data() + begin, batch.dimension_, batch.stride_,
+                                         end - begin, out.data() + begin);
+            } else {
+                for (std::size_t index = begin; index < end; ++index) {
+                    out[index] = VS::norm(batch.get(index));
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Batched elementwise distance: out[j] = distance(left[j], right[j])
+     *
+     * Available when VS is a metric (e.g. normed) space.
+     *
+     * @param left The left operands
+     * @param right The right operands (same size and dimension)
+     * @param out Receives left.size() distances
+     * @param executor The executor for large batches
+     */
+    template <typename Space = VS, ExecutorLike Executor = WorkStealingPool>
+    requires requires(const element_type& element) { typename Space::measure_type; Space::distance(element, element); }
+    static void distance(const ElementBatch& left, const ElementBatch& right,
+                         std::span<typename Space::measure_type> out,
+                         Executor& executor = default_executor()) {
+        using Measure = typename Space::measure_type;
+        assert(left.size() == right.size() && left.dimension() == right.dimension());
+        assert(out.size() >= left.size());
+        if constexpr (lane_norm_available<Measure, simd::lane_operand<value_type, false>>()) {
+            if (left.stride_ == right.stride_) {
+                using norm_functor = std::remove_cvref_t<decltype(VS::norm)>;
+                left.for_element_ranges(executor, [&](std::size_t begin, std::size_t end) {
+                    norm_functor::batch_difference_norm(
+                        left.data() + begin, left.dimension_, left.stride_,
+                        simd::lane_operand<value_type, false>{right.data() + begin, right.stride_},
+                        end - begin, out.data() + begin);
+                });
+                return;
+            }
+        }
+        left.for_element_ranges(executor, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                out[index] = VS::distance(left.get(index), right.get(index));
+            }
+        });
+    }
+
+    /**
+     * @brief Batched one-to-many distance: out[j] = distance(batch[j], query)
+     *
+     * Available when VS is a metric (e.g. normed) space.
+     *
+     * @param batch The elements
+     * @param query The element every distance is measured to
+     * @param out Receives batch.size() distances
+     * @param executor The executor for large batches
+     */
+    template <typename Space = VS, ExecutorLike Executor = WorkStealingPool>
+    requires requires(const element_type& element) { typename Space::measure_type; Space::distance(element, element); }
+    static void distance(const ElementBatch& batch, const element_type& query,
+                         std::span<typename Space::measure_type> out,
+                         Executor& executor = default_executor()) {
+        using Measure = typename Space::measure_type;
+        assert(out.size() >= batch.size());
+        if constexpr (lane_norm_available<Measure, simd::lane_operand<value_type, true>>()) {
+            using norm_functor = std::remove_cvref_t<decltype(VS::norm)>;
+            const std::size_t query_size = static_cast<std::size_t>(query.size());
+            assert(query_size == batch.dimension_ || query_size == 0);
+            std::vector<value_type> zero_query;
+            const value_type* query_values = nullptr;
+            if (query_size == 0) {
+                zero_query.assign(batch.dimension_, value_type{});
+                query_values = zero_query.data();
+            } else {
+                query_values = &query[0];
+            }
+            batch.for_element_ranges(executor, [&](std::size_t begin, std::size_t end) {
+                norm_functor::batch_difference_norm(
+                    batch.data() + begin, batch.dimension_, batch.stride_,
+                    simd::lane_operand<value_type, true>{query_values, 0},
+                    end - begin, out.data() + begin);
+            });
+        } else {
+            batch.for_element_ranges(executor, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t index = begin; index < end; ++index) {
+                    out[index] = VS::distance(batch.get(index), query);
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Batched one-to-many distance to a query of another representation
+     *
+     * Accepts any query that can scatter itself into dense storage via
+     * `query.scatter(values, dimension)`, e.g. a SparseVector measured against
+     * a batch of dense elements. The query is scattered once and then
+     * broadcast across lanes like an element query.
+     *
+     * @param batch The elements
+     * @param query The query (at most dimension() components)
+     * @param out Receives batch.size() distances
+     * @param executor The executor for large batches
+     */
+    template <typename Query, typename Space = VS, ExecutorLike Executor = WorkStealingPool>
+    requires (!std::same_as<Query, element_type>) &&
+             requires(const Query& query, value_type* values, std::size_t dimension) {
+                 query.scatter(values, dimension);
+             } &&
+             requires(const element_type& element) { typename Space::measure_type; Space::distance(element, element); }
+    static void distance(const ElementBatch& batch, const Query& query,
+                         std::span<typename Space::measure_type> out,
+                         Executor& executor = default_executor()) {
+        element_type dense = make_dense_element<element_type>(batch.dimension_);
+        if (batch.dimension_ != 0) {
+            query.scatter(&dense[0], batch.dimension_);
+        }
+        distance(batch, dense, out, executor);
+    }
+
+private:
+    static std::size_t round_up(std::size_t count) noexcept {
+        return (count + lane_width - 1) / lane_width * lane_width;
+    }
+
+    /// @brief Run body(begin, end) over ranges of elements (lane-aligned), split up for large batches
+    template <typename Executor, typename Body>
+    void for_element_ranges(Executor& executor, Body&& body) const {
+        const std::size_t rows = std::max<std::size_t>(dimension_, 1);
+        const std::size_t grain = count_ * rows < parallel_threshold
+            ? count_
+            : round_up(std::max<std::size_t>(parallel_threshold / rows, 1));
+        parallel_for(executor, count_, grain, body);
+    }
+
+    /// @brief Run body(begin, end) over ranges of component rows, split up for large batches
+    template <typename Executor, typename Body>
+    void for_row_ranges(Executor& executor, Body&& body) const {
+        const std::size_t grain = dimension_ * stride_ < parallel_threshold
+            ? dimension_
+            : std::max<std::size_t>(parallel_threshold / std::max<std::size_t>(stride_, 1), 1);
+        parallel_for(executor, dimension_, grain, body);
+    }
+
+    template <typename Measure, typename Operand>
+    static constexpr bool lane_norm_available() {
+        if constexpr (requires { VS::norm; }) {
+            using norm_functor = std::remove_cvref_t<decltype(VS::norm)>;
+            return std::same_as<Measure, value_type> &&
+                   requires(const value_type* soa, value_type* result, std::size_t n, Operand right) {
+                       norm_functor::batch_difference_norm(soa, n, n, right, n, result);
+                   };
+        } else {
+            return false;
+        }
+    }
+
+    void reshape_like(const ElementBatch& other) {
+        if (this == &other) {
+            return;
+        }
+        if (dimension_ != other.dimension_ || stride_ != other.stride_) {
+            dimension_ = other.dimension_;
+            stride_ = other.stride_;
+            components_.assign(dimension_ * stride_, value_type{});
+        }
+        count_ = other.count_;
+    }
+
+    std::size_t  dimension_ = 0;
+    std::size_t  count_     = 0;
+    std::size_t  stride_    = 0;
+    storage_type components_;
+};
+
+} // namespace kuukan
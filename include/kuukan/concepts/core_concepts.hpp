@@ -119,4 +119,155 @@ concept CallableLike =
     std::regular_invocable<F, Args...> &&
     std::convertible_to<std::invoke_result_t<F, Args...>, R>;
 
+/**
+ * @brief Concept for callable types that update their first argument in place
+ * 
+ * @tparam F The callable type (function, functor, lambda, etc.)
+ * @tparam Args The argument types; the mutated operand is passed by reference
+ * 
+ * A type satisfies InPlaceCallableLike<F, Args...> if F can be called with
+ * arguments Args... . Any return value is ignored. Unlike CallableLike, the
+ * callable is not required to be regular invocable, since its purpose is to
+ * modify one of its operands (e.g. `x += y` for heap-backed elements).
+ * 
+ * @example
+ * @code{.cpp}
+ * struct AddAssign {
+ *     void operator()(int& a, const int& b) const { a += b; }
+ * };
+ * static_assert(InPlaceCallableLike<AddAssign, int&, const int&>);
+ * @endcode
+ */
+template <typename F, typename... Args>
+concept InPlaceCallableLike = std::invocable<F, Args...>;
+
+/**
+ * @brief Placeholder for an optional operation slot that was not injected
+ * 
+ * Several structures (e.g. VectorSpace) accept optional functors in addition
+ * to the required ones, for instance a fused `a * x + y`. Leaving such a slot
+ * at its default of NotInjected tells the structure to derive the operation
+ * from the required functors instead.
+ * 
+ * @example
+ * @code{.cpp}
+ * static_assert(!Injected<NotInjected>);
+ * @endcode
+ */
+struct NotInjected {};
+
+/**
+ * @brief Concept for an optional operation slot that holds a real functor
+ * 
+ * @tparam F The functor type placed in the optional slot
+ * 
+ * Satisfied for every type except NotInjected. Structures use this with
+ * `if constexpr` to prefer an injected operation over the derived fallback.
+ */
+template <typename F>
+concept Injected = !std::same_as<F, NotInjected>;
+
+/**
+ * @brief Concept for optional callable slots
+ * 
+ * @tparam F The functor type placed in the optional slot
+ * @tparam R The expected return type
+ * @tparam Args The argument types
+ * 
+ * Satisfied either when F is NotInjected (the slot is empty) or when F is a
+ * default constructible CallableLike<F, R, Args...>. This keeps the signature
+ * checking of the required slots for the optional ones as well.
+ */
+template <typename F, typename R, typename... Args>
+concept OptionallyCallableLike =
+    !Injected<F> ||
+    (std::default_initializable<F> && CallableLike<F, R, Args...>);
+
+/**
+ * @brief Concept for optional in-place callable slots
+ * 
+ * @tparam F The functor type placed in the optional slot
+ * @tparam Args The argument types, including the mutated operand
+ * 
+ * Satisfied either when F is NotInjected or when F is a default
+ * constructible InPlaceCallableLike<F, Args...>.
+ */
+template <typename F, typename... Args>
+concept OptionallyInPlaceCallableLike =
+    !Injected<F> ||
+    (std::default_initializable<F> && InPlaceCallableLike<F, Args...>);
+
+/**
+ * @brief Concept for monotone surrogates of a distance
+ * 
+ * @tparam F The surrogate functor type
+ * @tparam M The measure type of the distance
+ * @tparam Args The argument types of the distance
+ * 
+ * A type satisfies ComparableSurrogateLike<F, M, Args...> if it is a
+ * CallableLike<F, M, Args...> returning a value that orders pairs exactly
+ * like the true distance (e.g. the squared Euclidean distance), and provides
+ * the conversions between both scales:
+ * - `to_distance(M)`: surrogate value -> true distance
+ * - `to_comparable(M)`: true distance -> surrogate value
+ * 
+ * Both conversions must be monotone and inverse to each other.
+ * 
+ * @example
+ * @code{.cpp}
+ * struct SquaredDistance {
+ *     double operator()(double a, double b) const { return (a - b) * (a - b); }
+ *     double to_distance(double c) const { return std::sqrt(c); }
+ *     double to_comparable(double d) const { return d * d; }
+ * };
+ * static_assert(ComparableSurrogateLike<SquaredDistance, double, double, double>);
+ * @endcode
+ */
+template <typename F, typename M, typename... Args>
+concept ComparableSurrogateLike =
+    CallableLike<F, M, Args...> &&
+    requires(const F surrogate, const M measure) {
+        { surrogate.to_distance(measure) }   -> std::convertible_to<M>;
+        { surrogate.to_comparable(measure) } -> std::convertible_to<M>;
+    };
+
+/**
+ * @brief Concept for optional surrogate slots
+ * 
+ * Satisfied either when F is NotInjected or when F is a default
+ * constructible ComparableSurrogateLike<F, M, Args...>.
+ */
+template <typename F, typename M, typename... Args>
+concept OptionallyComparableSurrogateLike =
+    !Injected<F> ||
+    (std::default_initializable<F> && ComparableSurrogateLike<F, M, Args...>);
+
+/**
+ * @brief Concept for optional callable slots of instance-based structures
+ * 
+ * Like OptionallyCallableLike, but for functors stored as members: F need
+ * not be default constructible and is called through a const reference.
+ */
+template <typename F, typename R, typename... Args>
+concept OptionallyInstanceCallableLike =
+    !Injected<F> || CallableLike<const F&, R, Args...>;
+
+/**
+ * @brief Concept for optional in-place callable slots of instance-based structures
+ * 
+ * Like OptionallyInPlaceCallableLike, for functors stored as members.
+ */
+template <typename F, typename... Args>
+concept OptionallyInstanceInPlaceCallableLike =
+    !Injected<F> || InPlaceCallableLike<const F&, Args...>;
+
+/**
+ * @brief Concept for optional surrogate slots of instance-based structures
+ * 
+ * Like OptionallyComparableSurrogateLike, for functors stored as members.
+ */
+template <typename F, typename M, typename... Args>
+concept OptionallyInstanceComparableSurrogateLike =
+    !Injected<F> || ComparableSurrogateLike<const F&, M, Args...>;
+
 } // namespace kuukan
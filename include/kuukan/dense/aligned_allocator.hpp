@@ -0,0 +1,93 @@
+/**
+ * @file aligned_allocator.hpp
+ * @brief Standard allocator returning over-aligned storage
+ *
+ * Dense elements of dynamic size keep their components in heap storage
+ * aligned to simd::alignment, so that SIMD kernels never straddle cache
+ * lines at the start of an array.
+ */
+
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "kuukan/dense/simd.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Allocator that aligns every allocation to Alignment bytes
+ *
+ * @tparam T The value type
+ * @tparam Alignment The requested alignment in bytes (a power of two)
+ *
+ * A stateless allocator built on the aligned forms of operator new/delete.
+ * All instances compare equal.
+ *
+ * Construction without arguments default-initializes (like `new T[n]`), so
+ * sizing a container of trivial values does not write to the memory. This
+ * lets kernels that overwrite every component skip a zero-fill pass.
+ *
+ * @code{.cpp}
+ * std::vector<double, kuukan::AlignedAllocator<double>> buffer(1024);     // uninitialized
+ * std::vector<double, kuukan::AlignedAllocator<double>> zeros(1024, 0.0); // zero-filled
+ * @endcode
+ */
+template <typename T, std::size_t Alignment = simd::alignment>
+struct AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+    using value_type = T;
+
+    /// @brief Rebind support required by the allocator requirements
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    constexpr AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    /**
+     * @brief Allocate storage for count objects
+     *
+     * @param count The number of objects
+     * @return Pointer to uninitialized storage aligned to Alignment
+     */
+    [[nodiscard]] T* allocate(std::size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    /**
+     * @brief Release storage obtained from allocate
+     *
+     * @param pointer The storage to release
+     * @param count The number of objects it was allocated for
+     */
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        ::operator delete(pointer, count * sizeof(T), std::align_val_t{Alignment});
+    }
+
+    /// @brief Default-initialize an object (no zero-fill for trivial types)
+    template <typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    /// @brief Construct an object from the given arguments
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args) {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    constexpr bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+};
+
+} // namespace kuukan
@@ -0,0 +1,97 @@
+/**
+ * @file blas.hpp
+ * @brief Optional CBLAS bindings for batched dense kernels
+ *
+ * When the library is configured with `KUUKAN_WITH_BLAS` (which defines
+ * `KUUKAN_HAS_CBLAS` and links a CBLAS implementation), the batched inner
+ * product kernels of the dense backend hand large problems to the level-3
+ * BLAS routines declared here. Without it, `blas::available<T>` is false and
+ * callers use the SIMD kernels of `dense/simd.hpp` instead.
+ */
+
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+#if defined(KUUKAN_HAS_CBLAS)
+#include <cblas.h>
+#endif
+
+namespace kuukan::blas {
+
+/// @brief Whether a BLAS routine is bound for scalar type T
+template <typename T>
+inline constexpr bool available =
+#if defined(KUUKAN_HAS_CBLAS)
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+#else
+    false;
+#endif
+
+/**
+ * @brief Problem size (count * count * dimension) from which BLAS is preferred
+ *
+ * Below it the call overhead and the packing of the operands outweigh the
+ * faster kernel.
+ */
+inline constexpr std::size_t gram_threshold = std::size_t{1} << 15;
+
+#if defined(KUUKAN_HAS_CBLAS)
+
+/**
+ * @brief Upper triangle of out = packed * packed^T (row-major syrk)
+ *
+ * @param packed The count × dimension row-major matrix of elements
+ * @param count The number of elements (rows)
+ * @param dimension The number of components (columns)
+ * @param out The count × count row-major result; only the upper triangle is written
+ */
+inline void syrk_upper(const double* packed, std::size_t count, std::size_t dimension, double* out) {
+    cblas_dsyrk(CblasRowMajor, CblasUpper, CblasNoTrans,
+                static_cast<int>(count), static_cast<int>(dimension),
+                1.0, packed, static_cast<int>(dimension),
+                0.0, out, static_cast<int>(count));
+}
+
+/// @copydoc syrk_upper(const double*, std::size_t, std::size_t, double*)
+inline void syrk_upper(const float* packed, std::size_t count, std::size_t dimension, float* out) {
+    cblas_ssyrk(CblasRowMajor, CblasUpper, CblasNoTrans,
+                static_cast<int>(count), static_cast<int>(dimension),
+                1.0f, packed, static_cast<int>(dimension),
+                0.0f, out, static_cast<int>(count));
+}
+
+/**
+ * @brief out = left * right^T (row-major gemm)
+ *
+ * @param left The left_count × dimension row-major matrix
+ * @param left_count The number of rows of left
+ * @param right The right_count × dimension row-major matrix
+ * @param right_count The number of rows of right
+ * @param dimension The number of components
+ * @param out The left_count × right_count row-major result
+ */
+inline void gemm_transposed(const double* left, std::size_t left_count,
+                            const double* right, std::size_t right_count,
+                            std::size_t dimension, double* out) {
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans,
+                static_cast<int>(left_count), static_cast<int>(right_count), static_cast<int>(dimension),
+                1.0, left, static_cast<int>(dimension),
+                right, static_cast<int>(dimension),
+                0.0, out, static_cast<int>(right_count));
+}
+
+/// @copydoc gemm_transposed(const double*, std::size_t, const double*, std::size_t, std::size_t, double*)
+inline void gemm_transposed(const float* left, std::size_t left_count,
+                            const float* right, std::size_t right_count,
+                            std::size_t dimension, float* out) {
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans,
+                static_cast<int>(left_count), static_cast<int>(right_count), static_cast<int>(dimension),
+                1.0f, left, static_cast<int>(dimension),
+                right, static_cast<int>(dimension),
+                0.0f, out, static_cast<int>(right_count));
+}
+
+#endif // KUUKAN_HAS_CBLAS
+
+} // namespace kuukan::blas
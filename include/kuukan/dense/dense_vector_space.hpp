@@ -0,0 +1,945 @@
+/**
+ * @file dense_vector_space.hpp
+ * @brief Ready-made vector space backend for plain numeric arrays
+ *
+ * This file provides DenseVector, an element type holding a contiguous
+ * array of numbers, and DenseVectorSpace, a VectorSpace over it whose
+ * operations run on the explicit SIMD kernels of `dense/simd.hpp`. It also
+ * provides the L1, L2 and L-infinity norms with fused difference norms, so
+ * that a complete normed space is one alias away, and the Euclidean inner
+ * product space. The norms take a precision policy (`dense/precision.hpp`)
+ * in place of the scalar type, so that elements stored as float16, bfloat16
+ * or float are measured in float or double.
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/norm/normed_space.hpp"
+#include "kuukan/inner/inner_product_space.hpp"
+#include "kuukan/dense/simd.hpp"
+#include "kuukan/dense/precision.hpp"
+#include "kuukan/dense/aligned_allocator.hpp"
+#include "kuukan/dense/blas.hpp"
+#include "kuukan/memory/arena.hpp"
+
+namespace kuukan {
+
+/// @brief Tag type selecting the constructors that leave components uninitialized
+struct uninitialized_t {
+    explicit constexpr uninitialized_t() = default;
+};
+
+/// @brief Tag value selecting the constructors that leave components uninitialized
+inline constexpr uninitialized_t uninitialized{};
+
+/**
+ * @brief Alignment used for a statically sized dense array
+ *
+ * The smallest power of two covering the whole array, capped at
+ * simd::alignment, so that small arrays are not padded to a cache line.
+ */
+template <typename T, std::size_t Extent>
+inline constexpr std::size_t dense_alignment =
+    std::max(alignof(T), std::min(simd::alignment, std::bit_ceil(sizeof(T) * Extent)));
+
+/**
+ * @brief Array length of a statically sized dense array
+ *
+ * Extent rounded up to fill a multiple of dense_alignment, so that the
+ * lanes a whole-register store writes past Extent are elements of the
+ * array rather than padding after it.
+ */
+template <typename T, std::size_t Extent>
+inline constexpr std::size_t dense_padded_extent =
+    (sizeof(T) * Extent + dense_alignment<T, Extent> - 1) / dense_alignment<T, Extent>
+    * dense_alignment<T, Extent> / sizeof(T);
+
+/**
+ * @brief Contiguous array of Extent numbers (compile-time size)
+ *
+ * @tparam T The scalar type of the components
+ * @tparam Extent The number of components, or std::dynamic_extent
+ * @tparam Allocator The storage allocator of the run-time sized form
+ *
+ * The statically sized form is an aligned aggregate, so it can be brace
+ * initialized, used in constant expressions and is trivially copyable. Its
+ * array is lengthened to dense_padded_extent, so DenseVector<double, 3>
+ * holds four doubles and fills one 256-bit register; the spare components
+ * are zero when brace initialized, and the dense kernels may write, but
+ * never read, them:
+ *
+ * @code{.cpp}
+ * kuukan::DenseVector<double, 3> v{1.0, 2.0, 3.0};
+ * @endcode
+ *
+ * @see DenseVector<T, std::dynamic_extent> for the run-time sized form
+ */
+template <typename T, std::size_t Extent = std::dynamic_extent, typename Allocator = AlignedAllocator<T>>
+struct DenseVector {
+    static_assert(Extent > 0, "a statically sized DenseVector needs at least one component");
+    static_assert(std::is_same_v<Allocator, AlignedAllocator<T>>,
+                  "only the run-time sized DenseVector takes an allocator");
+
+    /// @brief Type alias for the component type
+    using value_type = T;
+
+    /// @brief The compile-time number of components
+    static constexpr std::size_t extent = Extent;
+
+    /// @brief The components, followed by the spare ones up to dense_padded_extent
+    alignas(dense_alignment<T, Extent>) T components[dense_padded_extent<T, Extent>];
+
+    /// @brief Number of components
+    static constexpr std::size_t size() noexcept { return Extent; }
+
+    /// @brief Whether the vector has no components (never, for a static extent)
+    static constexpr bool empty() noexcept { return false; }
+
+    constexpr T*       data() noexcept       { return components; }
+    constexpr const T* data() const noexcept { return components; }
+
+    constexpr T&       operator[](std::size_t index) noexcept       { return components[index]; }
+    constexpr const T& operator[](std::size_t index) const noexcept { return components[index]; }
+
+    constexpr T*       begin() noexcept       { return components; }
+    constexpr const T* begin() const noexcept { return components; }
+    constexpr T*       end() noexcept         { return components + Extent; }
+    constexpr const T* end() const noexcept   { return components + Extent; }
+};
+
+/**
+ * @brief Contiguous array of numbers (run-time size)
+ *
+ * @tparam T The scalar type of the components
+ * @tparam Allocator The storage allocator (AlignedAllocator by default;
+ *         ArenaAllocator draws temporaries from the current ArenaScope)
+ *
+ * Components live in heap storage aligned to simd::alignment. A
+ * default-constructed (empty) vector stands for the zero element of every
+ * size: this is what DenseVectorSpace::zero_supplier returns, since the
+ * nullary zero supplier cannot know the dimension. All dense operations
+ * treat an empty operand as zero.
+ *
+ * @code{.cpp}
+ * kuukan::DenseVector<double> v{1.0, 2.0, 3.0};
+ * kuukan::DenseVector<double> w(1024);   // 1024 zeros
+ * @endcode
+ */
+template <typename T, typename Allocator>
+class DenseVector<T, std::dynamic_extent, Allocator> {
+public:
+    /// @brief Type alias for the component type
+    using value_type     = T;
+
+    /// @brief Type alias for the storage allocator
+    using allocator_type = Allocator;
+
+    /// @brief Type alias for the underlying storage
+    using storage_type   = std::vector<T, Allocator>;
+
+    /// @brief Marks the size as a run-time property
+    static constexpr std::size_t extent = std::dynamic_extent;
+
+    /// @brief Construct the empty vector (the zero element of any size)
+    DenseVector() = default;
+
+    /// @brief Construct size zero-valued components
+    explicit DenseVector(std::size_t size) : components_(size, T{}) {}
+
+    /// @brief Construct size components equal to value
+    DenseVector(std::size_t size, const T& value) : components_(size, value) {}
+
+    /// @brief Construct size components without initializing them
+    DenseVector(uninitialized_t, std::size_t size) : components_(size) {}
+
+    /// @brief Construct from a list of components
+    DenseVector(std::initializer_list<T> values) : components_(values) {}
+
+    /// @brief Construct by copying the given components
+    explicit DenseVector(std::span<const T> values)
+        : components_(values.begin(), values.end()) {}
+
+    /// @brief Number of components
+    std::size_t size() const noexcept { return components_.size(); }
+
+    /// @brief Whether the vector is the empty (zero) vector
+    bool empty() const noexcept { return components_.empty(); }
+
+    /// @brief The allocator of the storage
+    allocator_type get_allocator() const noexcept { return components_.get_allocator(); }
+
+    T*       data() noexcept       { return components_.data(); }
+    const T* data() const noexcept { return components_.data(); }
+
+    T&       operator[](std::size_t index) noexcept       { return components_[index]; }
+    const T& operator[](std::size_t index) const noexcept { return components_[index]; }
+
+    T*       begin() noexcept       { return components_.data(); }
+    const T* begin() const noexcept { return components_.data(); }
+    T*       end() noexcept         { return components_.data() + components_.size(); }
+    const T* end() const noexcept   { return components_.data() + components_.size(); }
+
+private:
+    storage_type components_;
+};
+
+/**
+ * @brief Concept for contiguous read-only views of dense components
+ *
+ * @tparam E The type to check
+ * @tparam T The component type
+ *
+ * DenseVector of either extent and `std::span<const T>` qualify. The fused
+ * difference norms accept any such type, so elements that live outside a
+ * DenseVector (e.g. rows of a MappedElementStore) are measured in place.
+ */
+template <typename E, typename T>
+concept DenseComponentsOf = requires(const E& element) {
+    { element.data() } -> std::convertible_to<const T*>;
+    { element.size() } -> std::convertible_to<std::size_t>;
+    { element.empty() } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief Operation functors of DenseVectorSpace
+ *
+ * @tparam T The scalar type of the components
+ * @tparam Extent The number of components, or std::dynamic_extent
+ * @tparam Allocator The storage allocator of run-time sized elements
+ *
+ * Every functor forwards to a kernel of `dense/simd.hpp`. With a static
+ * Extent the kernels are instantiated for that exact size and fully
+ * unrolled for small sizes; an extent shorter than one native register is
+ * a single simd::fixed register, stored whole into the element's spare
+ * components (see capacity). The functors are constexpr, so static elements can be
+ * combined and measured in constant expressions. With a dynamic extent,
+ * empty operands are treated as the zero element and the sizes of
+ * non-empty operands must match.
+ */
+template <typename T, std::size_t Extent = std::dynamic_extent, typename Allocator = AlignedAllocator<T>>
+struct DenseOperations {
+    /// @brief Type alias for the element type
+    using element_type = DenseVector<T, Extent, Allocator>;
+
+    /// @brief Type alias for the terms of a linear combination
+    using term_type    = LinearTerm<T, element_type>;
+
+    /// @brief Whether the size is only known at run time
+    static constexpr bool is_dynamic = Extent == std::dynamic_extent;
+
+    /// @brief Components writable at data() of a static element, spare ones included (see simd::fixed)
+    static constexpr std::size_t capacity = [] {
+        if constexpr (is_dynamic) {
+            return std::dynamic_extent;
+        } else {
+            return dense_padded_extent<T, Extent>;
+        }
+    }();
+
+    /// @brief Element of the given size whose components are to be overwritten
+    static constexpr element_type make_uninitialized(std::size_t size) {
+        if constexpr (is_dynamic) {
+            return element_type(uninitialized, size);
+        } else {
+            return element_type{};
+        }
+    }
+
+    /// @brief Whether a (dynamic) element is the empty zero element
+    static constexpr bool is_empty(const element_type& element) noexcept {
+        if constexpr (is_dynamic) {
+            return element.empty();
+        } else {
+            return false;
+        }
+    }
+
+    /// @brief Componentwise addition
+    struct Addition {
+        constexpr element_type operator()(const element_type& left, const element_type& right) const {
+            if (is_empty(left))  { return right; }
+            if (is_empty(right)) { return left; }
+            assert(left.size() == right.size());
+            element_type result = make_uninitialized(left.size());
+            simd::add<T, Extent, capacity>(left.data(), right.data(), result.data(), left.size());
+            return result;
+        }
+    };
+
+    /// @brief Componentwise subtraction
+    struct Subtraction {
+        constexpr element_type operator()(const element_type& left, const element_type& right) const {
+            if (is_empty(right)) { return left; }
+            element_type result = make_uninitialized(right.size());
+            if (is_empty(left)) {
+                simd::negate<T, Extent, capacity>(right.data(), result.data(), right.size());
+                return result;
+            }
+            assert(left.size() == right.size());
+            simd::subtract<T, Extent, capacity>(left.data(), right.data(), result.data(), left.size());
+            return result;
+        }
+    };
+
+    /// @brief Componentwise multiplication by a scalar
+    struct ScalarAction {
+        constexpr element_type operator()(const T& scalar_value, const element_type& element) const {
+            element_type result = make_uninitialized(element.size());
+            simd::scale<T, Extent, capacity>(scalar_value, element.data(), result.data(), element.size());
+            return result;
+        }
+    };
+
+    /// @brief Componentwise negation
+    struct Negation {
+        constexpr element_type operator()(const element_type& element) const {
+            element_type result = make_uninitialized(element.size());
+            simd::negate<T, Extent, capacity>(element.data(), result.data(), element.size());
+            return result;
+        }
+    };
+
+    /// @brief The zero vector (the empty vector for a dynamic extent)
+    struct ZeroSupplier {
+        constexpr element_type operator()() const {
+            return element_type{};
+        }
+    };
+
+    /// @brief Exact componentwise equality (an empty vector equals any all-zero vector)
+    struct Equality {
+        constexpr bool operator()(const element_type& left, const element_type& right) const {
+            if constexpr (is_dynamic) {
+                if (left.size() != right.size()) {
+                    const element_type& nonempty = is_empty(left) ? right : left;
+                    return (is_empty(left) || is_empty(right)) &&
+                           std::all_of(nonempty.begin(), nonempty.end(),
+                                       [](const T& value) { return value == T{}; });
+                }
+            }
+            return std::equal(left.begin(), left.end(), right.begin());
+        }
+    };
+
+    /// @brief Fused scalar_value * x + y
+    struct Axpy {
+        constexpr element_type operator()(const T& scalar_value, const element_type& x,
+                                const element_type& y) const {
+            if (is_empty(x)) { return y; }
+            element_type result = make_uninitialized(x.size());
+            if (is_empty(y)) {
+                simd::scale<T, Extent, capacity>(scalar_value, x.data(), result.data(), x.size());
+                return result;
+            }
+            assert(x.size() == y.size());
+            simd::axpy<T, Extent, capacity>(scalar_value, x.data(), y.data(), result.data(), x.size());
+            return result;
+        }
+    };
+
+    /// @brief Fused linear combination computed in one pass over the result
+    struct LinearCombination {
+        constexpr element_type operator()(std::span<const term_type> terms) const {
+            constexpr std::size_t inline_capacity = 16;
+            std::array<T, inline_capacity> inline_coefficients;
+            std::array<const T*, inline_capacity> inline_elements;
+            std::vector<T> heap_coefficients;
+            std::vector<const T*> heap_elements;
+            T* coefficients = inline_coefficients.data();
+            const T** elements = inline_elements.data();
+            if (terms.size() > inline_capacity) {
+                heap_coefficients.resize(terms.size());
+                heap_elements.resize(terms.size());
+                coefficients = heap_coefficients.data();
+                elements = heap_elements.data();
+            }
+
+            std::size_t size = 0;
+            std::size_t count = 0;
+            for (const term_type& term : terms) {
+                if (is_empty(term.element)) {
+                    continue;
+                }
+                assert(count == 0 || term.element.size() == size);
+                size = term.element.size();
+                coefficients[count] = term.coefficient;
+                elements[count] = term.element.data();
+                ++count;
+            }
+            if (count == 0) {
+                return ZeroSupplier{}();
+            }
+            element_type result = make_uninitialized(size);
+            simd::linear_combination<T, Extent, capacity>(coefficients, elements, count, result.data(), size);
+            return result;
+        }
+    };
+
+    /// @brief In-place target += right
+    struct AddAssign {
+        constexpr void operator()(element_type& target, const element_type& right) const {
+            if (is_empty(right)) { return; }
+            if (is_empty(target)) { target = right; return; }
+            assert(target.size() == right.size());
+            simd::add<T, Extent, capacity>(target.data(), right.data(), target.data(), target.size());
+        }
+    };
+
+    /// @brief In-place target *= scalar_value
+    struct ScaleAssign {
+        constexpr void operator()(const T& scalar_value, element_type& target) const {
+            simd::scale<T, Extent, capacity>(scalar_value, target.data(), target.data(), target.size());
+        }
+    };
+
+    /// @brief In-place target = -target
+    struct NegateInPlace {
+        constexpr void operator()(element_type& target) const {
+            simd::negate<T, Extent, capacity>(target.data(), target.data(), target.size());
+        }
+    };
+
+    /**
+     * @brief Wide-lane kernels over structure-of-arrays batches
+     *
+     * Used by ElementBatch: since every operation is componentwise, a whole
+     * SoA buffer of dimension rows and stride lanes is processed as one flat
+     * array, vectorized across elements.
+     */
+    struct BatchKernels {
+        static void addition(const T* left, const T* right, T* out,
+                             std::size_t dimension, std::size_t stride) {
+            simd::add<T>(left, right, out, dimension * stride);
+        }
+
+        static void scalar_action(const T& scalar_value, const T* values, T* out,
+                                  std::size_t dimension, std::size_t stride) {
+            simd::scale<T>(scalar_value, values, out, dimension * stride);
+        }
+    };
+
+    /**
+     * @brief Euclidean inner product
+     *
+     * The static `gram` and `cross` kernels compute many inner products at
+     * once for InnerProductSpace. With `KUUKAN_HAS_CBLAS` they pack large
+     * problems into row-major matrices and call BLAS syrk/gemm; otherwise
+     * they evaluate cache-sized tiles of SIMD dot products.
+     */
+    struct Dot {
+        constexpr T operator()(const element_type& left, const element_type& right) const {
+            if (is_empty(left) || is_empty(right)) { return T{}; }
+            assert(left.size() == right.size());
+            return simd::dot<T, Extent>(left.data(), right.data(), left.size());
+        }
+
+        /// @brief out[i * count + j] = <elements[i], elements[j]> for a symmetric count × count result
+        static void gram(const element_type* elements, std::size_t count, T* out) {
+            if constexpr (blas::available<T>) {
+                const std::size_t dimension = max_size(elements, count);
+                if (count * count * dimension >= blas::gram_threshold) {
+#if defined(KUUKAN_HAS_CBLAS)
+                    const auto packed = pack(elements, count, dimension);
+                    blas::syrk_upper(packed.data(), count, dimension, out);
+                    for (std::size_t row = 0; row < count; ++row) {
+                        for (std::size_t column = 0; column < row; ++column) {
+                            out[row * count + column] = out[column * count + row];
+                        }
+                    }
+                    return;
+#endif
+                }
+            }
+            for (std::size_t row_block = 0; row_block < count; row_block += tile) {
+                const std::size_t row_end = std::min(row_block + tile, count);
+                for (std::size_t column_block = row_block; column_block < count; column_block += tile) {
+                    const std::size_t column_end = std::min(column_block + tile, count);
+                    for (std::size_t row = row_block; row < row_end; ++row) {
+                        for (std::size_t column = std::max(row, column_block); column < column_end; ++column) {
+                            const T value = Dot{}(elements[row], elements[column]);
+                            out[row * count + column] = value;
+                            out[column * count + row] = value;
+                        }
+                    }
+                }
+            }
+        }
+
+        /// @brief out[i * right_count + j] = <left[i], right[j]> for a left_count × right_count result
+        static void cross(const element_type* left, std::size_t left_count,
+                          const element_type* right, std::size_t right_count, T* out) {
+            if constexpr (blas::available<T>) {
+                const std::size_t dimension = std::max(max_size(left, left_count), max_size(right, right_count));
+                if (left_count * right_count * dimension >= blas::gram_threshold) {
+#if defined(KUUKAN_HAS_CBLAS)
+                    const auto packed_left = pack(left, left_count, dimension);
+                    const auto packed_right = pack(right, right_count, dimension);
+                    blas::gemm_transposed(packed_left.data(), left_count,
+                                          packed_right.data(), right_count, dimension, out);
+                    return;
+#endif
+                }
+            }
+            for (std::size_t row_block = 0; row_block < left_count; row_block += tile) {
+                const std::size_t row_end = std::min(row_block + tile, left_count);
+                for (std::size_t column_block = 0; column_block < right_count; column_block += tile) {
+                    const std::size_t column_end = std::min(column_block + tile, right_count);
+                    for (std::size_t row = row_block; row < row_end; ++row) {
+                        for (std::size_t column = column_block; column < column_end; ++column) {
+                            out[row * right_count + column] = Dot{}(left[row], right[column]);
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        /// @brief Elements per tile edge of the SIMD fallback
+        static constexpr std::size_t tile = 32;
+
+        static std::size_t max_size(const element_type* elements, std::size_t count) {
+            std::size_t size = 0;
+            for (std::size_t index = 0; index < count; ++index) {
+                size = std::max(size, static_cast<std::size_t>(elements[index].size()));
+            }
+            return size;
+        }
+
+        /// @brief Row-major count × dimension copy of the elements (empty elements become zero rows)
+        static std::vector<T, AlignedAllocator<T>> pack(const element_type* elements, std::size_t count,
+                                                        std::size_t dimension) {
+            std::vector<T, AlignedAllocator<T>> packed(count * dimension, T{});
+            for (std::size_t index = 0; index < count; ++index) {
+                if (!is_empty(elements[index])) {
+                    std::copy_n(elements[index].data(), dimension, packed.data() + index * dimension);
+                }
+            }
+            return packed;
+        }
+    };
+};
+
+/**
+ * @brief Vector space of dense numeric arrays with SIMD operations
+ *
+ * @tparam T The scalar type of the components
+ * @tparam Extent The number of components, or std::dynamic_extent (default)
+ * @tparam Allocator The storage allocator of run-time sized elements
+ *
+ * A VectorSpace over DenseVector<T, Extent> with every optional slot
+ * injected: fused axpy and linear combination, in-place operations and
+ * direct subtraction, all running on the kernels of `dense/simd.hpp`.
+ * Additionally exposes the Euclidean inner product as `dot`.
+ *
+ * @code{.cpp}
+ * using R3 = kuukan::DenseVectorSpace<double, 3>;
+ * R3::element_type a{1.0, 2.0, 3.0}, b{4.0, 5.0, 6.0};
+ * auto c = R3::axpy(2.0, a, b);   // 2a + b in one pass
+ * double d = R3::dot(a, b);       // 32
+ * @endcode
+ *
+ * @see DenseNormedSpace for the normed variants
+ */
+template <typename T, std::size_t Extent = std::dynamic_extent, typename Allocator = AlignedAllocator<T>>
+struct DenseVectorSpace : VectorSpace<
+    DenseVector<T, Extent, Allocator>,
+    T,
+    typename DenseOperations<T, Extent, Allocator>::Addition,
+    typename DenseOperations<T, Extent, Allocator>::ScalarAction,
+    typename DenseOperations<T, Extent, Allocator>::Negation,
+    typename DenseOperations<T, Extent, Allocator>::ZeroSupplier,
+    typename DenseOperations<T, Extent, Allocator>::Equality,
+    typename DenseOperations<T, Extent, Allocator>::Axpy,
+    typename DenseOperations<T, Extent, Allocator>::LinearCombination,
+    typename DenseOperations<T, Extent, Allocator>::AddAssign,
+    typename DenseOperations<T, Extent, Allocator>::ScaleAssign,
+    typename DenseOperations<T, Extent, Allocator>::NegateInPlace,
+    typename DenseOperations<T, Extent, Allocator>::Subtraction
+> {
+    /// @brief The compile-time number of components, or std::dynamic_extent
+    static constexpr std::size_t extent = Extent;
+
+    /// @brief Wide-lane kernels picked up by ElementBatch
+    using batch_kernels = typename DenseOperations<T, Extent, Allocator>::BatchKernels;
+
+    /// @brief Static instance of the Euclidean inner product functor
+    static inline constexpr typename DenseOperations<T, Extent, Allocator>::Dot dot{};
+};
+
+/**
+ * @brief Fused L1 distance: sum_i |left_i - right_i|
+ *
+ * Like every fused difference norm below, it measures any pair of
+ * DenseComponentsOf views of the storage type, not only DenseVector.
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseL1DifferenceNorm {
+    template <DenseComponentsOf<dense_storage_t<T>> E>
+    constexpr dense_measure_t<T> operator()(const E& left, const E& right) const {
+        if constexpr (Extent == std::dynamic_extent) {
+            if (left.empty())  { return simd::widened_sum_abs<precision_of_t<T>>(right.data(), right.size()); }
+            if (right.empty()) { return simd::widened_sum_abs<precision_of_t<T>>(left.data(), left.size()); }
+            assert(left.size() == right.size());
+        }
+        return simd::widened_sum_abs_difference<precision_of_t<T>, Extent>(left.data(), right.data(), left.size());
+    }
+};
+
+/**
+ * @brief Fused L2 distance: sqrt(sum_i (left_i - right_i)^2)
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseL2DifferenceNorm {
+    template <DenseComponentsOf<dense_storage_t<T>> E>
+    constexpr dense_measure_t<T> operator()(const E& left, const E& right) const {
+        if constexpr (Extent == std::dynamic_extent) {
+            if (left.empty())  { return simd::scalar_sqrt(simd::widened_sum_squares<precision_of_t<T>>(right.data(), right.size())); }
+            if (right.empty()) { return simd::scalar_sqrt(simd::widened_sum_squares<precision_of_t<T>>(left.data(), left.size())); }
+            assert(left.size() == right.size());
+        }
+        return simd::scalar_sqrt(simd::widened_sum_squared_difference<precision_of_t<T>, Extent>(left.data(), right.data(), left.size()));
+    }
+};
+
+/**
+ * @brief Fused L-infinity distance: max_i |left_i - right_i|
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseLinfDifferenceNorm {
+    template <DenseComponentsOf<dense_storage_t<T>> E>
+    constexpr dense_measure_t<T> operator()(const E& left, const E& right) const {
+        if constexpr (Extent == std::dynamic_extent) {
+            if (left.empty())  { return simd::widened_max_abs<precision_of_t<T>>(right.data(), right.size()); }
+            if (right.empty()) { return simd::widened_max_abs<precision_of_t<T>>(left.data(), left.size()); }
+            assert(left.size() == right.size());
+        }
+        return simd::widened_max_abs_difference<precision_of_t<T>, Extent>(left.data(), right.data(), left.size());
+    }
+};
+
+/**
+ * @brief Early-exit L1 distance for the BoundedDifferenceNorm slot of NormedSpace
+ *
+ * Returns the exact distance if it is at most bound, otherwise a partial sum
+ * greater than bound (checked every simd::bound_check_blocks registers).
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseL1BoundedDifferenceNorm {
+    template <DenseComponentsOf<dense_storage_t<T>> E>
+    constexpr dense_measure_t<T> operator()(const E& left, const E& right,
+                 const dense_measure_t<T>& bound) const {
+        if constexpr (Extent == std::dynamic_extent) {
+            if (left.empty() || right.empty()) { return DenseL1DifferenceNorm<T, Extent>{}(left, right); }
+            assert(left.size() == right.size());
+        }
+        return simd::widened_sum_abs_difference_bounded<precision_of_t<T>, Extent>(left.data(), right.data(), left.size(), bound);
+    }
+};
+
+/**
+ * @brief Early-exit L2 distance for the BoundedDifferenceNorm slot of NormedSpace
+ *
+ * The running sum of squares is compared with bound^2, so no square root is
+ * taken before the exit.
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseL2BoundedDifferenceNorm {
+    template <DenseComponentsOf<dense_storage_t<T>> E>
+    constexpr dense_measure_t<T> operator()(const E& left, const E& right,
+                 const dense_measure_t<T>& bound) const {
+        if constexpr (Extent == std::dynamic_extent) {
+            if (left.empty() || right.empty()) { return DenseL2DifferenceNorm<T, Extent>{}(left, right); }
+            assert(left.size() == right.size());
+        }
+        // Every distance exceeds a negative bound, so any partial sum may be returned then
+        const dense_measure_t<T> squared_bound = bound < 0 ? dense_measure_t<T>(0) : bound * bound;
+        const dense_measure_t<T> partial = simd::widened_sum_squared_difference_bounded<precision_of_t<T>, Extent>(
+            left.data(), right.data(), left.size(), squared_bound);
+        const dense_measure_t<T> result = simd::scalar_sqrt(partial);
+        // Rounding of bound^2 and sqrt can leave an early exit at or below bound; finish the sum then
+        if (squared_bound < partial && !(bound < result)) {
+            return DenseL2DifferenceNorm<T, Extent>{}(left, right);
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Early-exit L-infinity distance for the BoundedDifferenceNorm slot of NormedSpace
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseLinfBoundedDifferenceNorm {
+    template <DenseComponentsOf<dense_storage_t<T>> E>
+    constexpr dense_measure_t<T> operator()(const E& left, const E& right,
+                 const dense_measure_t<T>& bound) const {
+        if constexpr (Extent == std::dynamic_extent) {
+            if (left.empty() || right.empty()) { return DenseLinfDifferenceNorm<T, Extent>{}(left, right); }
+            assert(left.size() == right.size());
+        }
+        return simd::widened_max_abs_difference_bounded<precision_of_t<T>, Extent>(left.data(), right.data(), left.size(), bound);
+    }
+};
+
+/**
+ * @brief Squared L2 distance, the comparable surrogate of DenseL2Norm distances
+ *
+ * Orders pairs like the Euclidean distance without the square root; fits the
+ * ComparableDifferenceNorm slot of NormedSpace.
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseL2SquaredDifferenceNorm {
+    /// @brief The surrogate is the squared distance (see InnerProductSpace::comparable_is_squared_distance)
+    static constexpr bool is_squared_distance = true;
+
+    template <DenseComponentsOf<dense_storage_t<T>> E>
+    constexpr dense_measure_t<T> operator()(const E& left, const E& right) const {
+        if constexpr (Extent == std::dynamic_extent) {
+            if (left.empty())  { return simd::widened_sum_squares<precision_of_t<T>>(right.data(), right.size()); }
+            if (right.empty()) { return simd::widened_sum_squares<precision_of_t<T>>(left.data(), left.size()); }
+            assert(left.size() == right.size());
+        }
+        return simd::widened_sum_squared_difference<precision_of_t<T>, Extent>(left.data(), right.data(), left.size());
+    }
+
+    /// @brief Squared distance -> distance
+    constexpr dense_measure_t<T> to_distance(const dense_measure_t<T>& comparable) const { return simd::scalar_sqrt(comparable); }
+
+    /// @brief Distance -> squared distance
+    constexpr dense_measure_t<T> to_comparable(const dense_measure_t<T>& distance) const { return distance * distance; }
+};
+
+/**
+ * @brief L1 norm: sum_i |v_i|
+ *
+ * `difference_norm`, `bounded_difference_norm` and `comparable_difference_norm`
+ * name the matching functors for NormedSpace; the static batch kernels let
+ * ElementBatch vectorize across elements, and combination_norm lets
+ * Lazy::norm measure a linear combination without materializing it.
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseL1Norm {
+    using difference_norm = DenseL1DifferenceNorm<T, Extent>;
+    using bounded_difference_norm = DenseL1BoundedDifferenceNorm<T, Extent>;
+    using comparable_difference_norm = NotInjected;
+
+    template <typename Allocator>
+    constexpr dense_measure_t<T> operator()(const DenseVector<dense_storage_t<T>, Extent, Allocator>& element) const {
+        return simd::widened_sum_abs<precision_of_t<T>, Extent>(element.data(), element.size());
+    }
+
+    /// @brief L1 norms of count SoA elements, vectorized across elements (used by ElementBatch)
+    static void batch_norm(const T* soa, std::size_t dimension, std::size_t stride,
+                           std::size_t count, T* out) requires std::floating_point<T> {
+        simd::lanes_sum_abs<T>(soa, dimension, stride, count, out);
+    }
+
+    /// @brief L1 distances of count SoA elements to a SoA batch or broadcast element (used by ElementBatch)
+    template <typename Operand>
+    static void batch_difference_norm(const T* soa, std::size_t dimension, std::size_t stride,
+                                      Operand right, std::size_t count, T* out) requires std::floating_point<T> {
+        simd::lanes_sum_abs_difference<T>(soa, dimension, stride, right, count, out);
+    }
+
+    /// @brief L1 norm of sum_k coefficients[k] * elements[k], fused into one pass without storing it (used by Lazy::norm)
+    static constexpr T combination_norm(const T* coefficients, const T* const* elements,
+                                        std::size_t term_count, std::size_t count) requires std::floating_point<T> {
+        return simd::combination_sum_abs<T, Extent>(coefficients, elements, term_count, count);
+    }
+};
+
+/**
+ * @brief L2 (Euclidean) norm: sqrt(sum_i v_i^2)
+ *
+ * `difference_norm`, `bounded_difference_norm` and `comparable_difference_norm`
+ * name the matching functors for NormedSpace; the static batch kernels let
+ * ElementBatch vectorize across elements, and combination_norm lets
+ * Lazy::norm measure a linear combination without materializing it.
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseL2Norm {
+    using difference_norm = DenseL2DifferenceNorm<T, Extent>;
+    using bounded_difference_norm = DenseL2BoundedDifferenceNorm<T, Extent>;
+    using comparable_difference_norm = DenseL2SquaredDifferenceNorm<T, Extent>;
+
+    template <typename Allocator>
+    constexpr dense_measure_t<T> operator()(const DenseVector<dense_storage_t<T>, Extent, Allocator>& element) const {
+        return simd::scalar_sqrt(simd::widened_sum_squares<precision_of_t<T>, Extent>(element.data(), element.size()));
+    }
+
+    /// @brief L2 norms of count SoA elements, vectorized across elements (used by ElementBatch)
+    static void batch_norm(const T* soa, std::size_t dimension, std::size_t stride,
+                           std::size_t count, T* out) requires std::floating_point<T> {
+        simd::lanes_sum_squares<T>(soa, dimension, stride, count, out, true);
+    }
+
+    /// @brief L2 distances of count SoA elements to a SoA batch or broadcast element (used by ElementBatch)
+    template <typename Operand>
+    static void batch_difference_norm(const T* soa, std::size_t dimension, std::size_t stride,
+                                      Operand right, std::size_t count, T* out) requires std::floating_point<T> {
+        simd::lanes_sum_squared_difference<T>(soa, dimension, stride, right, count, out, true);
+    }
+
+    /// @brief L2 norm of sum_k coefficients[k] * elements[k], fused into one pass without storing it (used by Lazy::norm)
+    static constexpr T combination_norm(const T* coefficients, const T* const* elements,
+                                        std::size_t term_count, std::size_t count) requires std::floating_point<T> {
+        return simd::scalar_sqrt(simd::combination_sum_squares<T, Extent>(coefficients, elements, term_count, count));
+    }
+};
+
+/**
+ * @brief L-infinity (maximum) norm: max_i |v_i|
+ *
+ * `difference_norm`, `bounded_difference_norm` and `comparable_difference_norm`
+ * name the matching functors for NormedSpace; the static batch kernels let
+ * ElementBatch vectorize across elements, and combination_norm lets
+ * Lazy::norm measure a linear combination without materializing it.
+ */
+template <DensePrecisionLike T, std::size_t Extent = std::dynamic_extent>
+struct DenseLinfNorm {
+    using difference_norm = DenseLinfDifferenceNorm<T, Extent>;
+    using bounded_difference_norm = DenseLinfBoundedDifferenceNorm<T, Extent>;
+    using comparable_difference_norm = NotInjected;
+
+    template <typename Allocator>
+    constexpr dense_measure_t<T> operator()(const DenseVector<dense_storage_t<T>, Extent, Allocator>& element) const {
+        return simd::widened_max_abs<precision_of_t<T>, Extent>(element.data(), element.size());
+    }
+
+    /// @brief L-infinity norms of count SoA elements, vectorized across elements (used by ElementBatch)
+    static void batch_norm(const T* soa, std::size_t dimension, std::size_t stride,
+                           std::size_t count, T* out) requires std::floating_point<T> {
+        simd::lanes_max_abs<T>(soa, dimension, stride, count, out);
+    }
+
+    /// @brief L-infinity distances of count SoA elements to a SoA batch or broadcast element (used by ElementBatch)
+    template <typename Operand>
+    static void batch_difference_norm(const T* soa, std::size_t dimension, std::size_t stride,
+                                      Operand right, std::size_t count, T* out) requires std::floating_point<T> {
+        simd::lanes_max_abs_difference<T>(soa, dimension, stride, right, count, out);
+    }
+
+    /// @brief L-infinity norm of sum_k coefficients[k] * elements[k], fused into one pass without storing it (used by Lazy::norm)
+    static constexpr T combination_norm(const T* coefficients, const T* const* elements,
+                                        std::size_t term_count, std::size_t count) requires std::floating_point<T> {
+        return simd::combination_max_abs<T, Extent>(coefficients, elements, term_count, count);
+    }
+};
+
+/**
+ * @brief Normed space over DenseVectorSpace with a fused induced distance
+ *
+ * @tparam T The scalar type of the components (float or double), or a
+ *         Precision policy whose storage_type is the component type
+ * @tparam Extent The number of components, or std::dynamic_extent
+ * @tparam Norm One of DenseL1Norm, DenseL2Norm or DenseLinfNorm
+ * @tparam Allocator The storage allocator of run-time sized elements
+ *
+ * With a policy, norms and distances read storage_type components, widen
+ * them in registers and return accumulate_type, which is the measure_type
+ * of the space. The vector space operations stay in storage_type; for the
+ * 16-bit types they run one component at a time through float.
+ *
+ * @code{.cpp}
+ * using E3 = kuukan::DenseNormedSpace<double, 3, kuukan::DenseL2Norm>;
+ * double d = E3::distance(a, b);   // one streaming pass, no temporary
+ * bool near = E3::distance_within(a, b, 0.5);  // stops once the sum exceeds 0.5^2
+ *
+ * static_assert(E3::distance({0.0, 3.0, 4.0}, {0.0, 0.0, 0.0}) == 5.0);   // static extents are constexpr
+ *
+ * // float16 components, float arithmetic, double sums
+ * using H = kuukan::DenseNormedSpace<kuukan::Precision<kuukan::float16, float, double>,
+ *                                    std::dynamic_extent, kuukan::DenseL2Norm>;
+ * double e = H::distance(kuukan::precision_cast<kuukan::float16>(x), kuukan::precision_cast<kuukan::float16>(y));
+ * @endcode
+ */
+template <typename T, std::size_t Extent, template <typename, std::size_t> class Norm,
+          typename Allocator = AlignedAllocator<dense_storage_t<T>>>
+using DenseNormedSpace = NormedSpace<DenseVectorSpace<dense_storage_t<T>, Extent, Allocator>,
+                                     Norm<T, Extent>,
+                                     typename Norm<T, Extent>::difference_norm,
+                                     typename Norm<T, Extent>::bounded_difference_norm,
+                                     typename Norm<T, Extent>::comparable_difference_norm>;
+
+/**
+ * @brief Euclidean inner product space over DenseVectorSpace
+ *
+ * @tparam T The scalar type of the components
+ * @tparam Extent The number of components, or std::dynamic_extent
+ * @tparam Allocator The storage allocator of run-time sized elements
+ *
+ * Uses the SIMD dot product, its batched gram/cross kernels (BLAS-backed
+ * when available) and the fused, bounded and squared L2 distances.
+ *
+ * @code{.cpp}
+ * using R3 = kuukan::DenseInnerProductSpace<double, 3>;
+ * kuukan::DenseVector<double, 3> p = R3::project(x, std::span(basis));
+ * @endcode
+ */
+template <std::floating_point T, std::size_t Extent = std::dynamic_extent,
+          typename Allocator = AlignedAllocator<T>>
+using DenseInnerProductSpace = InnerProductSpace<DenseVectorSpace<T, Extent, Allocator>,
+                                                 typename DenseOperations<T, Extent, Allocator>::Dot,
+                                                 DenseL2DifferenceNorm<T, Extent>,
+                                                 DenseL2BoundedDifferenceNorm<T, Extent>,
+                                                 DenseL2SquaredDifferenceNorm<T, Extent>>;
+
+/**
+ * @brief Run-time sized dense vector whose storage comes from the current ArenaScope
+ *
+ * Outside every scope it allocates from the heap like DenseVector<T>.
+ *
+ * @see memory/arena.hpp
+ */
+template <typename T>
+using ArenaDenseVector = DenseVector<T, std::dynamic_extent, ArenaAllocator<T>>;
+
+/**
+ * @brief Run-time sized DenseVectorSpace whose results are allocated in the current ArenaScope
+ *
+ * @code{.cpp}
+ * using Space = kuukan::ArenaDenseVectorSpace<double>;
+ * kuukan::MonotonicArena arena;
+ * {
+ *     kuukan::ArenaScope scope(arena);
+ *     auto r = Space::addition(Space::scalar_action(2.0, a), b);   // no malloc once the arena is warm
+ *     use(r);
+ * }   // released in one step
+ * @endcode
+ */
+template <typename T>
+using ArenaDenseVectorSpace = DenseVectorSpace<T, std::dynamic_extent, ArenaAllocator<T>>;
+
+/**
+ * @brief Copy of a dense element with its components converted to To
+ *
+ * @tparam To The new component type: float16, bfloat16, float or double
+ * @param element The element to convert
+ * @return A DenseVector<To, Extent> of the same size
+ *
+ * Narrowing rounds to nearest even with the vector conversion instructions
+ * of simd::convert; widening is exact.
+ *
+ * @code{.cpp}
+ * kuukan::DenseVector<kuukan::bfloat16> stored = kuukan::precision_cast<kuukan::bfloat16>(embedding);
+ * @endcode
+ */
+template <DenseStorageType To, DenseStorageType From, std::size_t Extent, typename Allocator>
+constexpr DenseVector<To, Extent> precision_cast(const DenseVector<From, Extent, Allocator>& element) {
+    auto result = DenseOperations<To, Extent>::make_uninitialized(element.size());
+    simd::convert(element.data(), result.data(), element.size());
+    return result;
+}
+
+} // namespace kuukan
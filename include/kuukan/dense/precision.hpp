@@ -0,0 +1,781 @@
+/**
+ * @file precision.hpp
+ * @brief Storage, compute and accumulation precision for the dense backend
+ *
+ * This file provides the 16-bit storage types float16 (IEEE binary16) and
+ * bfloat16, the Precision policy that names a storage, a compute and an
+ * accumulation type separately, and the mixed-precision SIMD kernels that
+ * the dense norm functors use when the three differ.
+ *
+ * Embeddings stored as float16 or bfloat16 move half (or, against double, a
+ * quarter) of the bytes through memory per distance. The kernels widen each
+ * register block on load with the hardware conversion instructions (F16C /
+ * AVX-512F `vcvtph2ps` for float16, a 16-bit shift for bfloat16,
+ * `vcvtps2pd` for float to double), evaluate differences and products in
+ * the compute type and sum in the accumulation type.
+ *
+ * @code{.cpp}
+ * using Half = kuukan::Precision<kuukan::float16>;                  // store float16, compute and sum in float
+ * using Wide = kuukan::Precision<float, float, double>;             // store float, sum in double
+ * using Embeddings = kuukan::DenseNormedSpace<Half, std::dynamic_extent, kuukan::DenseL2Norm>;
+ *
+ * auto stored = kuukan::precision_cast<kuukan::float16>(embedding);  // DenseVector<float> -> DenseVector<float16>
+ * float d = Embeddings::distance(stored, other);                      // measure_type is float
+ * @endcode
+ */
+
+#pragma once
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <compare>
+#include <type_traits>
+#include "kuukan/dense/simd.hpp"
+
+namespace kuukan {
+
+namespace detail {
+
+/// @brief float -> binary16 bits, rounding to nearest even (overflow to infinity, NaN kept quiet)
+constexpr std::uint16_t float_to_half_bits(float value) {
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    const std::uint32_t sign = (bits >> 16) & 0x8000u;
+    const std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {
+        const std::uint32_t payload = magnitude > 0x7F800000u ? 0x0200u | ((magnitude >> 13) & 0x03FFu) : 0u;
+        return static_cast<std::uint16_t>(sign | 0x7C00u | payload);
+    }
+    if (magnitude >= 0x477FF000u) {   // at least halfway above 65504: infinity
+        return static_cast<std::uint16_t>(sign | 0x7C00u);
+    }
+    const std::uint32_t exponent = magnitude >> 23;
+    if (exponent < 113) {             // below 2^-14: a subnormal half in units of 2^-24
+        if (exponent < 102) {
+            return static_cast<std::uint16_t>(sign);
+        }
+        const std::uint32_t mantissa = (magnitude & 0x007FFFFFu) | 0x00800000u;
+        const std::uint32_t shift = 126 - exponent;
+        std::uint32_t result = mantissa >> shift;
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const std::uint32_t half = 1u << (shift - 1);
+        result += remainder > half || (remainder == half && (result & 1u));
+        return static_cast<std::uint16_t>(sign | result);
+    }
+    std::uint32_t result = ((exponent - 112) << 10) | ((magnitude >> 13) & 0x03FFu);
+    const std::uint32_t remainder = magnitude & 0x1FFFu;
+    result += remainder > 0x1000u || (remainder == 0x1000u && (result & 1u));
+    return static_cast<std::uint16_t>(sign | result);
+}
+
+/// @brief binary16 bits -> float (exact)
+constexpr float half_bits_to_float(std::uint16_t half) {
+    const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+    const std::uint32_t exponent = (half >> 10) & 0x1Fu;
+    std::uint32_t mantissa = half & 0x03FFu;
+    if (exponent == 0x1Fu) {
+        return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            return std::bit_cast<float>(sign);
+        }
+        std::uint32_t biased = 113;
+        while (!(mantissa & 0x0400u)) {
+            mantissa <<= 1;
+            --biased;
+        }
+        return std::bit_cast<float>(sign | (biased << 23) | ((mantissa & 0x03FFu) << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+/// @brief float -> bfloat16 bits, rounding to nearest even (NaN kept quiet)
+constexpr std::uint16_t float_to_bfloat16_bits(float value) {
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        return static_cast<std::uint16_t>((bits >> 16) | 0x0040u);
+    }
+    return static_cast<std::uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+}
+
+/**
+ * @brief double -> float rounded to odd
+ *
+ * Rounding to odd first and to nearest even second rounds correctly to any
+ * format with at least two fewer significand bits than float, so doubles
+ * reach the 16-bit types without double rounding.
+ */
+constexpr float float_round_to_odd(double value) {
+    const float rounded = static_cast<float>(value);
+    if (static_cast<double>(rounded) == value || value != value) {
+        return rounded;
+    }
+    std::uint32_t bits = std::bit_cast<std::uint32_t>(rounded);
+    const double magnitude = value < 0 ? -value : value;
+    const double rounded_magnitude = rounded < 0 ? -static_cast<double>(rounded) : static_cast<double>(rounded);
+    bits -= rounded_magnitude > magnitude;   // truncate toward zero (infinity becomes the largest float)
+    return std::bit_cast<float>(bits | 1u);
+}
+
+} // namespace detail
+
+/**
+ * @brief IEEE 754 binary16 storage type
+ *
+ * Converts exactly to float and rounds to nearest even from float and
+ * double. Arithmetic is evaluated in float and rounded back, which makes
+ * the type usable as the scalar of a DenseVectorSpace; the dense kernels
+ * widen whole registers instead (see Precision).
+ */
+struct float16 {
+    /// @brief The binary16 encoding
+    std::uint16_t bits = 0;
+
+    constexpr float16() = default;
+    explicit constexpr float16(float value) : bits(detail::float_to_half_bits(value)) {}
+    explicit constexpr float16(double value) : float16(detail::float_round_to_odd(value)) {}
+    template <std::integral I>
+    explicit constexpr float16(I value) : float16(static_cast<double>(value)) {}
+
+    /// @brief The value with the given encoding
+    static constexpr float16 from_bits(std::uint16_t encoding) {
+        float16 result;
+        result.bits = encoding;
+        return result;
+    }
+
+    /// @brief Widen to float (exact)
+    constexpr operator float() const { return detail::half_bits_to_float(bits); }
+
+    friend constexpr float16 operator+(float16 left, float16 right) { return float16(float(left) + float(right)); }
+    friend constexpr float16 operator-(float16 left, float16 right) { return float16(float(left) - float(right)); }
+    friend constexpr float16 operator*(float16 left, float16 right) { return float16(float(left) * float(right)); }
+    friend constexpr float16 operator/(float16 left, float16 right) { return float16(float(left) / float(right)); }
+    friend constexpr float16 operator-(float16 value) { return from_bits(static_cast<std::uint16_t>(value.bits ^ 0x8000u)); }
+    constexpr float16& operator+=(float16 other) { return *this = *this + other; }
+    constexpr float16& operator-=(float16 other) { return *this = *this - other; }
+    constexpr float16& operator*=(float16 other) { return *this = *this * other; }
+    constexpr float16& operator/=(float16 other) { return *this = *this / other; }
+    friend constexpr bool operator==(float16 left, float16 right) { return float(left) == float(right); }
+    friend constexpr std::partial_ordering operator<=>(float16 left, float16 right) { return float(left) <=> float(right); }
+};
+
+/**
+ * @brief bfloat16 storage type: the upper half of a float
+ *
+ * Keeps float's exponent range with an 8-bit significand. Conversions and
+ * arithmetic behave as for float16.
+ */
+struct bfloat16 {
+    /// @brief The upper 16 bits of the float encoding
+    std::uint16_t bits = 0;
+
+    constexpr bfloat16() = default;
+    explicit constexpr bfloat16(float value) : bits(detail::float_to_bfloat16_bits(value)) {}
+    explicit constexpr bfloat16(double value) : bfloat16(detail::float_round_to_odd(value)) {}
+    template <std::integral I>
+    explicit constexpr bfloat16(I value) : bfloat16(static_cast<double>(value)) {}
+
+    /// @brief The value with the given encoding
+    static constexpr bfloat16 from_bits(std::uint16_t encoding) {
+        bfloat16 result;
+        result.bits = encoding;
+        return result;
+    }
+
+    /// @brief Widen to float (exact)
+    constexpr operator float() const { return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16); }
+
+    friend constexpr bfloat16 operator+(bfloat16 left, bfloat16 right) { return bfloat16(float(left) + float(right)); }
+    friend constexpr bfloat16 operator-(bfloat16 left, bfloat16 right) { return bfloat16(float(left) - float(right)); }
+    friend constexpr bfloat16 operator*(bfloat16 left, bfloat16 right) { return bfloat16(float(left) * float(right)); }
+    friend constexpr bfloat16 operator/(bfloat16 left, bfloat16 right) { return bfloat16(float(left) / float(right)); }
+    friend constexpr bfloat16 operator-(bfloat16 value) { return from_bits(static_cast<std::uint16_t>(value.bits ^ 0x8000u)); }
+    constexpr bfloat16& operator+=(bfloat16 other) { return *this = *this + other; }
+    constexpr bfloat16& operator-=(bfloat16 other) { return *this = *this - other; }
+    constexpr bfloat16& operator*=(bfloat16 other) { return *this = *this * other; }
+    constexpr bfloat16& operator/=(bfloat16 other) { return *this = *this / other; }
+    friend constexpr bool operator==(bfloat16 left, bfloat16 right) { return float(left) == float(right); }
+    friend constexpr std::partial_ordering operator<=>(bfloat16 left, bfloat16 right) { return float(left) <=> float(right); }
+};
+
+/**
+ * @brief Concept for the component types that dense elements can be stored in
+ */
+template <typename T>
+concept DenseStorageType = std::same_as<T, float16> || std::same_as<T, bfloat16> ||
+                           std::same_as<T, float> || std::same_as<T, double>;
+
+/// @brief The narrowest hardware arithmetic type holding every T exactly (float for the 16-bit types)
+template <DenseStorageType T>
+using promoted_compute_t = std::conditional_t<(sizeof(T) < sizeof(float)), float, T>;
+
+/**
+ * @brief Precision policy: storage, compute and accumulation types chosen separately
+ *
+ * @tparam Storage The component type of stored elements: float16, bfloat16, float or double
+ * @tparam Compute The type differences, products and absolute values are
+ *         evaluated in: float or double, at least as wide as Storage
+ *         (default: float for the 16-bit types, otherwise Storage)
+ * @tparam Accumulate The type sums and maxima are accumulated in, and the
+ *         measure type of the norms: float or double, at least as wide as
+ *         Compute (default: Compute)
+ *
+ * Widening Storage to Compute is exact, so the policy only decides where
+ * rounding happens: once per elementwise operation in Compute, once per
+ * addition in Accumulate. With Compute equal to Accumulate, products are
+ * fused into the sum.
+ *
+ * Passing a plain float or double where the dense norms expect a policy
+ * means Precision<T>, which runs the single-precision-type kernels of
+ * simd.hpp unchanged.
+ */
+template <DenseStorageType Storage, typename Compute = promoted_compute_t<Storage>, typename Accumulate = Compute>
+requires (std::same_as<Compute, float> || std::same_as<Compute, double>) &&
+         (std::same_as<Accumulate, float> || std::same_as<Accumulate, double>) &&
+         (sizeof(Storage) <= sizeof(Compute)) && (sizeof(Compute) <= sizeof(Accumulate))
+struct Precision {
+    /// @brief Component type of stored elements
+    using storage_type    = Storage;
+
+    /// @brief Type of elementwise arithmetic
+    using compute_type    = Compute;
+
+    /// @brief Type of sums, maxima and results
+    using accumulate_type = Accumulate;
+
+    /// @brief Whether all three types coincide (the kernels of simd.hpp are used as they are)
+    static constexpr bool is_uniform = std::same_as<Storage, Compute> && std::same_as<Compute, Accumulate>;
+};
+
+namespace detail {
+
+template <typename T>
+struct is_precision : std::false_type {};
+
+template <typename Storage, typename Compute, typename Accumulate>
+struct is_precision<Precision<Storage, Compute, Accumulate>> : std::true_type {};
+
+template <typename T>
+struct precision_of { using type = Precision<T>; };
+
+template <typename Storage, typename Compute, typename Accumulate>
+struct precision_of<Precision<Storage, Compute, Accumulate>> { using type = Precision<Storage, Compute, Accumulate>; };
+
+} // namespace detail
+
+/**
+ * @brief Concept for what the dense norms accept as their first parameter:
+ *        a Precision policy, or float / double standing for Precision<T>
+ */
+template <typename T>
+concept DensePrecisionLike = std::same_as<T, float> || std::same_as<T, double> || detail::is_precision<T>::value;
+
+/// @brief The Precision policy named by T (Precision<T> for float and double)
+template <DensePrecisionLike T>
+using precision_of_t = typename detail::precision_of<T>::type;
+
+/// @brief The component type of elements under the precision T
+template <DensePrecisionLike T>
+using dense_storage_t = typename precision_of_t<T>::storage_type;
+
+/// @brief The measure type (accumulate_type) of norms under the precision T
+template <DensePrecisionLike T>
+using dense_measure_t = typename precision_of_t<T>::accumulate_type;
+
+} // namespace kuukan
+
+namespace kuukan::simd {
+
+/**
+ * @brief Mixed-precision register abstraction (scalar fallback)
+ *
+ * @tparam P A Precision policy
+ *
+ * Plugs into reduce_blocks with the interface of native<Accumulate> for the
+ * accumulators, plus:
+ *
+ * - `load(const storage_type*)`: width storage values widened to a compute register
+ * - `sub`, `mul`, `abs`: compute-register arithmetic
+ * - `accumulate(acc, c)`, `accumulate_product(acc, a, b)`, `accumulate_max(acc, c)`:
+ *   widen a compute register (or a product, fused when Compute is Accumulate) into acc
+ *
+ * The primary template handles one element at a time; the x86 specialization
+ * below uses whole registers.
+ */
+template <typename P>
+struct precision_register {
+    using storage_type     = typename P::storage_type;
+    using compute_type     = typename P::compute_type;
+    using accumulate_type  = typename P::accumulate_type;
+    using register_type    = accumulate_type;
+    using compute_register = compute_type;
+    static constexpr std::size_t width = 1;
+
+    static KUUKAN_ALWAYS_INLINE compute_register load(const storage_type* source) { return static_cast<compute_type>(*source); }
+    static KUUKAN_ALWAYS_INLINE compute_register sub(compute_register a, compute_register b) { return a - b; }
+    static KUUKAN_ALWAYS_INLINE compute_register mul(compute_register a, compute_register b) { return a * b; }
+    static KUUKAN_ALWAYS_INLINE compute_register abs(compute_register a) { return scalar_abs(a); }
+
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return accumulate_type{}; }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return a + b; }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return scalar_max(a, b); }
+    static KUUKAN_ALWAYS_INLINE accumulate_type reduce_add(register_type a) { return a; }
+    static KUUKAN_ALWAYS_INLINE accumulate_type reduce_max(register_type a) { return a; }
+
+    static KUUKAN_ALWAYS_INLINE register_type accumulate(register_type acc, compute_register value) {
+        return acc + static_cast<accumulate_type>(value);
+    }
+    static KUUKAN_ALWAYS_INLINE register_type accumulate_product(register_type acc, compute_register a, compute_register b) {
+        return acc + static_cast<accumulate_type>(a * b);
+    }
+    static KUUKAN_ALWAYS_INLINE register_type accumulate_max(register_type acc, compute_register value) {
+        return scalar_max(acc, static_cast<accumulate_type>(value));
+    }
+};
+
+#if !defined(KUUKAN_DISABLE_SIMD) && (defined(__AVX512F__) || defined(__AVX2__))
+
+/// @brief The x86 register of Width lanes of T (register_128/256/512)
+template <typename T, std::size_t Width>
+struct register_of_width;
+
+template <> struct register_of_width<float, 4>  : register_128<float>  {};
+template <> struct register_of_width<double, 4> : register_256<double> {};
+template <> struct register_of_width<float, 8>  : register_256<float>  {};
+#  if defined(__AVX512F__)
+template <> struct register_of_width<double, 8> : register_512<double> {};
+template <> struct register_of_width<float, 16> : register_512<float>  {};
+#  endif
+
+/**
+ * @brief Load Width storage values and widen them to a Compute register
+ *
+ * float16 uses `vcvtph2ps` (AVX-512F, or F16C for 256/128-bit registers),
+ * bfloat16 zero-extends to 32 bits and shifts into the upper half, float to
+ * double uses `vcvtps2pd`. Combinations without an instruction in this
+ * build (float16 without F16C) convert lane by lane through a buffer.
+ */
+template <typename Storage, typename Compute, std::size_t Width>
+KUUKAN_ALWAYS_INLINE auto widen_load(const Storage* source) {
+    using target = register_of_width<Compute, Width>;
+    if constexpr (std::same_as<Storage, Compute>) {
+        return target::load(source);
+    } else if constexpr (std::same_as<Compute, double>) {
+        if constexpr (Width == 8) {
+#  if defined(__AVX512F__)
+            if constexpr (std::same_as<Storage, float>) {
+                return _mm512_cvtps_pd(_mm256_loadu_ps(source));
+            } else {
+                return _mm512_cvtps_pd(widen_load<Storage, float, 8>(source));
+            }
+#  endif
+        } else {
+            static_assert(Width == 4);
+            if constexpr (std::same_as<Storage, float>) {
+                return _mm256_cvtps_pd(_mm_loadu_ps(source));
+            } else {
+                return _mm256_cvtps_pd(widen_load<Storage, float, 4>(source));
+            }
+        }
+    } else if constexpr (std::same_as<Storage, bfloat16>) {
+        if constexpr (Width == 16) {
+#  if defined(__AVX512F__)
+            return _mm512_castsi512_ps(_mm512_slli_epi32(
+                _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source))), 16));
+#  endif
+        } else if constexpr (Width == 8) {
+            return _mm256_castsi256_ps(_mm256_slli_epi32(
+                _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source))), 16));
+        } else {
+            static_assert(Width == 4);
+            return _mm_castsi128_ps(_mm_slli_epi32(
+                _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source))), 16));
+        }
+    } else {
+        static_assert(std::same_as<Storage, float16>);
+        if constexpr (Width == 16) {
+#  if defined(__AVX512F__)
+            return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)));
+#  endif
+#  if defined(__F16C__)
+        } else if constexpr (Width == 8) {
+            return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+        } else if constexpr (Width == 4) {
+            return _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+#  endif
+        } else {
+            alignas(32) float buffer[Width];
+            for (std::size_t lane = 0; lane < Width; ++lane) {
+                buffer[lane] = float(source[lane]);
+            }
+            return target::load(buffer);
+        }
+    }
+}
+
+/// @brief Mixed-precision register abstraction on x86: native<Accumulate> lanes, widened on load
+template <typename Storage, typename Compute, typename Accumulate>
+struct precision_register<Precision<Storage, Compute, Accumulate>> {
+    using storage_type     = Storage;
+    using compute_type     = Compute;
+    using accumulate_type  = Accumulate;
+    using accumulate_traits = native<Accumulate>;
+    static constexpr std::size_t width = accumulate_traits::width;
+    using compute_traits   = register_of_width<Compute, width>;
+    using register_type    = typename accumulate_traits::register_type;
+    using compute_register = typename compute_traits::register_type;
+
+    static KUUKAN_ALWAYS_INLINE compute_register load(const Storage* source) {
+        return widen_load<Storage, Compute, width>(source);
+    }
+    static KUUKAN_ALWAYS_INLINE compute_register sub(compute_register a, compute_register b) { return compute_traits::sub(a, b); }
+    static KUUKAN_ALWAYS_INLINE compute_register mul(compute_register a, compute_register b) { return compute_traits::mul(a, b); }
+    static KUUKAN_ALWAYS_INLINE compute_register abs(compute_register a) { return compute_traits::abs(a); }
+
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return accumulate_traits::zero(); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return accumulate_traits::add(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return accumulate_traits::max(a, b); }
+    static KUUKAN_ALWAYS_INLINE Accumulate reduce_add(register_type a) { return accumulate_traits::reduce_add(a); }
+    static KUUKAN_ALWAYS_INLINE Accumulate reduce_max(register_type a) { return accumulate_traits::reduce_max(a); }
+
+    /// @brief A compute register as accumulate lanes (vcvtps2pd when float sums into double)
+    static KUUKAN_ALWAYS_INLINE register_type widen(compute_register value) {
+        if constexpr (std::same_as<Compute, Accumulate>) {
+            return value;
+        } else if constexpr (width == 8) {
+#  if defined(__AVX512F__)
+            return _mm512_cvtps_pd(value);
+#  endif
+        } else {
+            return _mm256_cvtps_pd(value);
+        }
+    }
+
+    static KUUKAN_ALWAYS_INLINE register_type accumulate(register_type acc, compute_register value) {
+        return accumulate_traits::add(acc, widen(value));
+    }
+    static KUUKAN_ALWAYS_INLINE register_type accumulate_product(register_type acc, compute_register a, compute_register b) {
+        if constexpr (std::same_as<Compute, Accumulate>) {
+            return accumulate_traits::fma(a, b, acc);
+        } else {
+            return accumulate_traits::add(acc, widen(compute_traits::mul(a, b)));
+        }
+    }
+    static KUUKAN_ALWAYS_INLINE register_type accumulate_max(register_type acc, compute_register value) {
+        return accumulate_traits::max(acc, widen(value));
+    }
+};
+
+#endif
+
+// —— Mixed-precision reduction kernels ——
+//
+// Each takes a Precision policy P, reads P::storage_type arrays and returns
+// P::accumulate_type. Uniform policies forward to the kernels of simd.hpp.
+
+/// @brief sum_i left[i] * right[i]
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_dot(const typename P::storage_type* left, const typename P::storage_type* right, std::size_t count) {
+    using C = typename P::compute_type;
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return dot<A, Extent>(left, right, count);
+    } else {
+        return reduce_blocks<A, Extent, precision_register<P>>(count,
+            [&](auto traits, auto acc, std::size_t i) { return traits.accumulate_product(acc, traits.load(left + i), traits.load(right + i)); },
+            [&](A acc, std::size_t i) { return acc + static_cast<A>(static_cast<C>(left[i]) * static_cast<C>(right[i])); },
+            [](auto traits, auto a, auto b) { return traits.add(a, b); },
+            [](auto traits, auto a) { return traits.reduce_add(a); });
+    }
+}
+
+/// @brief sum_i values[i]^2
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_sum_squares(const typename P::storage_type* values, std::size_t count) {
+    return widened_dot<P, Extent>(values, values, count);
+}
+
+/// @brief sum_i |values[i]|
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_sum_abs(const typename P::storage_type* values, std::size_t count) {
+    using C = typename P::compute_type;
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return sum_abs<A, Extent>(values, count);
+    } else {
+        return reduce_blocks<A, Extent, precision_register<P>>(count,
+            [&](auto traits, auto acc, std::size_t i) { return traits.accumulate(acc, traits.abs(traits.load(values + i))); },
+            [&](A acc, std::size_t i) { return acc + static_cast<A>(scalar_abs(static_cast<C>(values[i]))); },
+            [](auto traits, auto a, auto b) { return traits.add(a, b); },
+            [](auto traits, auto a) { return traits.reduce_add(a); });
+    }
+}
+
+/// @brief max_i |values[i]| (zero for an empty array)
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_max_abs(const typename P::storage_type* values, std::size_t count) {
+    using C = typename P::compute_type;
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return max_abs<A, Extent>(values, count);
+    } else {
+        return reduce_blocks<A, Extent, precision_register<P>>(count,
+            [&](auto traits, auto acc, std::size_t i) { return traits.accumulate_max(acc, traits.abs(traits.load(values + i))); },
+            [&](A acc, std::size_t i) { return scalar_max(acc, static_cast<A>(scalar_abs(static_cast<C>(values[i])))); },
+            [](auto traits, auto a, auto b) { return traits.max(a, b); },
+            [](auto traits, auto a) { return traits.reduce_max(a); });
+    }
+}
+
+/// @brief Steps shared by the plain and early-exit difference kernels
+namespace widened_steps {
+
+template <typename P>
+struct abs_difference {
+    const typename P::storage_type* left;
+    const typename P::storage_type* right;
+
+    template <typename Traits, typename Register>
+    KUUKAN_ALWAYS_INLINE Register operator()(Traits traits, Register acc, std::size_t i) const {
+        return traits.accumulate(acc, traits.abs(traits.sub(traits.load(left + i), traits.load(right + i))));
+    }
+    KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+    operator()(typename P::accumulate_type acc, std::size_t i) const {
+        using C = typename P::compute_type;
+        return acc + static_cast<typename P::accumulate_type>(
+            scalar_abs(static_cast<C>(static_cast<C>(left[i]) - static_cast<C>(right[i]))));
+    }
+};
+
+template <typename P>
+struct squared_difference {
+    const typename P::storage_type* left;
+    const typename P::storage_type* right;
+
+    template <typename Traits, typename Register>
+    KUUKAN_ALWAYS_INLINE Register operator()(Traits traits, Register acc, std::size_t i) const {
+        const auto delta = traits.sub(traits.load(left + i), traits.load(right + i));
+        return traits.accumulate_product(acc, delta, delta);
+    }
+    KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+    operator()(typename P::accumulate_type acc, std::size_t i) const {
+        using C = typename P::compute_type;
+        const C delta = static_cast<C>(left[i]) - static_cast<C>(right[i]);
+        return acc + static_cast<typename P::accumulate_type>(delta * delta);
+    }
+};
+
+template <typename P>
+struct max_abs_difference {
+    const typename P::storage_type* left;
+    const typename P::storage_type* right;
+
+    template <typename Traits, typename Register>
+    KUUKAN_ALWAYS_INLINE Register operator()(Traits traits, Register acc, std::size_t i) const {
+        return traits.accumulate_max(acc, traits.abs(traits.sub(traits.load(left + i), traits.load(right + i))));
+    }
+    KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+    operator()(typename P::accumulate_type acc, std::size_t i) const {
+        using C = typename P::compute_type;
+        return scalar_max(acc, static_cast<typename P::accumulate_type>(
+            scalar_abs(static_cast<C>(static_cast<C>(left[i]) - static_cast<C>(right[i])))));
+    }
+};
+
+inline constexpr auto add = [](auto traits, auto a, auto b) { return traits.add(a, b); };
+inline constexpr auto max = [](auto traits, auto a, auto b) { return traits.max(a, b); };
+inline constexpr auto reduce_add = [](auto traits, auto a) { return traits.reduce_add(a); };
+inline constexpr auto reduce_max = [](auto traits, auto a) { return traits.reduce_max(a); };
+
+} // namespace widened_steps
+
+/// @brief sum_i |left[i] - right[i]|
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_sum_abs_difference(const typename P::storage_type* left, const typename P::storage_type* right,
+                           std::size_t count) {
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return sum_abs_difference<A, Extent>(left, right, count);
+    } else {
+        const widened_steps::abs_difference<P> step{left, right};
+        return reduce_blocks<A, Extent, precision_register<P>>(count, step, step,
+            widened_steps::add, widened_steps::reduce_add);
+    }
+}
+
+/// @brief sum_i (left[i] - right[i])^2
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_sum_squared_difference(const typename P::storage_type* left, const typename P::storage_type* right,
+                               std::size_t count) {
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return sum_squared_difference<A, Extent>(left, right, count);
+    } else {
+        const widened_steps::squared_difference<P> step{left, right};
+        return reduce_blocks<A, Extent, precision_register<P>>(count, step, step,
+            widened_steps::add, widened_steps::reduce_add);
+    }
+}
+
+/// @brief max_i |left[i] - right[i]| (zero for empty arrays)
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_max_abs_difference(const typename P::storage_type* left, const typename P::storage_type* right,
+                           std::size_t count) {
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return max_abs_difference<A, Extent>(left, right, count);
+    } else {
+        const widened_steps::max_abs_difference<P> step{left, right};
+        return reduce_blocks<A, Extent, precision_register<P>>(count, step, step,
+            widened_steps::max, widened_steps::reduce_max);
+    }
+}
+
+/// @brief sum_i |left[i] - right[i]|, stopping early once it exceeds bound
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_sum_abs_difference_bounded(const typename P::storage_type* left, const typename P::storage_type* right,
+                                   std::size_t count, typename P::accumulate_type bound) {
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return sum_abs_difference_bounded<A, Extent>(left, right, count, bound);
+    } else {
+        const widened_steps::abs_difference<P> step{left, right};
+        return reduce_blocks_bounded<A, Extent, precision_register<P>>(count, bound, step, step,
+            widened_steps::add, widened_steps::reduce_add);
+    }
+}
+
+/// @brief sum_i (left[i] - right[i])^2, stopping early once it exceeds bound
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_sum_squared_difference_bounded(const typename P::storage_type* left, const typename P::storage_type* right,
+                                       std::size_t count, typename P::accumulate_type bound) {
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return sum_squared_difference_bounded<A, Extent>(left, right, count, bound);
+    } else {
+        const widened_steps::squared_difference<P> step{left, right};
+        return reduce_blocks_bounded<A, Extent, precision_register<P>>(count, bound, step, step,
+            widened_steps::add, widened_steps::reduce_add);
+    }
+}
+
+/// @brief max_i |left[i] - right[i]|, stopping early once it exceeds bound
+template <typename P, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr typename P::accumulate_type
+widened_max_abs_difference_bounded(const typename P::storage_type* left, const typename P::storage_type* right,
+                                   std::size_t count, typename P::accumulate_type bound) {
+    using A = typename P::accumulate_type;
+    if constexpr (P::is_uniform) {
+        return max_abs_difference_bounded<A, Extent>(left, right, count, bound);
+    } else {
+        const widened_steps::max_abs_difference<P> step{left, right};
+        return reduce_blocks_bounded<A, Extent, precision_register<P>>(count, bound, step, step,
+            widened_steps::max, widened_steps::reduce_max);
+    }
+}
+
+// —— Conversion ——
+
+/**
+ * @brief target[i] = To(source[i]), rounding to nearest even when narrowing
+ *
+ * @tparam From, To Any two of float16, bfloat16, float and double
+ *
+ * Widening runs through widen_load. Narrowing float to float16 uses
+ * `vcvtps2ph` (AVX-512F or F16C), float to bfloat16 rounds the integer
+ * encodings in registers, double to float uses `vcvtpd2ps`. Double to a
+ * 16-bit type converts element by element (rounding to odd through float,
+ * so without double rounding). Every path gives the bits of the scalar
+ * conversion; `vcvtneps2bf16` (AVX512-BF16) is not used because it flushes
+ * subnormal inputs to zero.
+ */
+template <DenseStorageType From, DenseStorageType To>
+constexpr void convert(const From* source, To* target, std::size_t count) {
+    std::size_t index = 0;
+    if (!std::is_constant_evaluated()) {
+        if constexpr (std::same_as<From, To>) {
+            for (; index < count; ++index) {
+                target[index] = source[index];
+            }
+            return;
+#if !defined(KUUKAN_DISABLE_SIMD) && (defined(__AVX512F__) || defined(__AVX2__))
+        } else if constexpr (sizeof(From) < sizeof(To)) {
+            using to_traits = native<To>;
+            constexpr std::size_t width = to_traits::width;
+            for (; index + width <= count; index += width) {
+                to_traits::store(target + index, widen_load<From, To, width>(source + index));
+            }
+        } else if constexpr (std::same_as<From, double> && std::same_as<To, float>) {
+#  if defined(__AVX512F__)
+            for (; index + 8 <= count; index += 8) {
+                _mm256_storeu_ps(target + index, _mm512_cvtpd_ps(_mm512_loadu_pd(source + index)));
+            }
+#  else
+            for (; index + 4 <= count; index += 4) {
+                _mm_storeu_ps(target + index, _mm256_cvtpd_ps(_mm256_loadu_pd(source + index)));
+            }
+#  endif
+        } else if constexpr (std::same_as<From, float> && std::same_as<To, float16>) {
+#  if defined(__AVX512F__)
+            for (; index + 16 <= count; index += 16) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + index),
+                    _mm512_cvtps_ph(_mm512_loadu_ps(source + index), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+            }
+#  elif defined(__F16C__)
+            for (; index + 8 <= count; index += 8) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(target + index),
+                    _mm256_cvtps_ph(_mm256_loadu_ps(source + index), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+            }
+#  endif
+        } else if constexpr (std::same_as<From, float> && std::same_as<To, bfloat16>) {
+#  if defined(__AVX512F__)
+            const __m512i magnitude_mask = _mm512_set1_epi32(0x7FFFFFFF);
+            const __m512i infinity = _mm512_set1_epi32(0x7F800000);
+            for (; index + 16 <= count; index += 16) {
+                const __m512i bits = _mm512_castps_si512(_mm512_loadu_ps(source + index));
+                const __m512i odd = _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+                __m512i rounded = _mm512_srli_epi32(
+                    _mm512_add_epi32(bits, _mm512_add_epi32(_mm512_set1_epi32(0x7FFF), odd)), 16);
+                const __mmask16 nan = _mm512_cmpgt_epi32_mask(_mm512_and_si512(bits, magnitude_mask), infinity);
+                rounded = _mm512_mask_mov_epi32(rounded, nan,
+                    _mm512_or_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(0x0040)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + index), _mm512_cvtepi32_epi16(rounded));
+            }
+#  else
+            const __m256i magnitude_mask = _mm256_set1_epi32(0x7FFFFFFF);
+            const __m256i infinity = _mm256_set1_epi32(0x7F800000);
+            auto round = [&](__m256i bits) {
+                const __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+                const __m256i rounded = _mm256_srli_epi32(
+                    _mm256_add_epi32(bits, _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), odd)), 16);
+                const __m256i nan = _mm256_cmpgt_epi32(_mm256_and_si256(bits, magnitude_mask), infinity);
+                return _mm256_blendv_epi8(rounded,
+                    _mm256_or_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(0x0040)), nan);
+            };
+            for (; index + 16 <= count; index += 16) {
+                const __m256i low = round(_mm256_castps_si256(_mm256_loadu_ps(source + index)));
+                const __m256i high = round(_mm256_castps_si256(_mm256_loadu_ps(source + index + 8)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + index),
+                                    _mm256_permute4x64_epi64(_mm256_packus_epi32(low, high), 0xD8));
+            }
+#  endif
+#endif
+        }
+    }
+    for (; index < count; ++index) {
+        target[index] = static_cast<To>(source[index]);
+    }
+}
+
+} // namespace kuukan::simd
@@ -0,0 +1,1159 @@
+/**
+ * @file simd.hpp
+ * @brief Explicit SIMD kernels for contiguous numeric arrays
+ *
+ * This file provides the low-level kernels used by the dense vector space
+ * backend: elementwise maps (add, subtract, scale, axpy, linear combination)
+ * and reductions (dot product, sums and maxima of absolute values). Each
+ * kernel is written once against a small register abstraction,
+ * `simd::native<T>`, which is specialized for the instruction set the
+ * translation unit is compiled for:
+ *
+ * - AVX-512F (`__AVX512F__`): 8 doubles / 16 floats per register
+ * - AVX2 (`__AVX2__`, FMA used when `__FMA__` is defined): 4 doubles / 8 floats
+ * - NEON on AArch64 (`__ARM_NEON` and `__aarch64__`): 2 doubles / 4 floats
+ *
+ * Other scalar types, and all types when `KUUKAN_DISABLE_SIMD` is defined,
+ * fall back to plain scalar loops of width 1. The instruction set is chosen
+ * by the compiler flags of the including translation unit (e.g.
+ * `-march=native`); the library itself does not force any.
+ *
+ * @section simd_fixed Fixed extents
+ *
+ * Kernels instantiated with a static Extent are fully unrolled. On x86, an
+ * extent shorter than the native width (a 3- or 4-vector of doubles, say)
+ * is mapped onto the single narrowest register that covers it, `fixed`, so
+ * that a 3D distance is one load, subtract, multiply and horizontal add per
+ * operand instead of a scalar loop. Every kernel is also `constexpr`: in a
+ * constant expression it runs the scalar path, so norms and distances of
+ * known inputs can be evaluated at compile time.
+ */
+
+#pragma once
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if !defined(KUUKAN_DISABLE_SIMD)
+#  if defined(__AVX512F__) || defined(__AVX2__)
+#    include <immintrin.h>
+#  elif defined(__ARM_NEON) && defined(__aarch64__)
+#    include <arm_neon.h>
+#  endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  define KUUKAN_ALWAYS_INLINE __forceinline
+#else
+/// @brief Force inlining of small kernel helpers
+#  define KUUKAN_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace kuukan::simd {
+
+/// @brief Alignment (in bytes) used for dense heap storage; one cache line, wide enough for AVX-512
+inline constexpr std::size_t alignment = 64;
+
+/// @brief Number of whole-register blocks up to which static extents are fully unrolled
+inline constexpr std::size_t unroll_limit = 16;
+
+/// @brief Number of whole-register blocks between bound checks in early-exit reductions (a multiple of 4)
+inline constexpr std::size_t bound_check_blocks = 16;
+
+/**
+ * @brief Register abstraction for SIMD kernels (scalar fallback)
+ *
+ * @tparam T The scalar type of the array elements
+ *
+ * The primary template processes one element at a time and works for any
+ * arithmetic type. Specializations for float and double map the same
+ * interface onto the widest available vector registers.
+ */
+template <typename T>
+struct native {
+    using register_type = T;
+    static constexpr std::size_t width = 1;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const T* source) { return *source; }
+    static KUUKAN_ALWAYS_INLINE void store(T* target, register_type value) { *target = value; }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(T value) { return value; }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return T{}; }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return a + b; }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return a - b; }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return a * b; }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) { return a * b + c; }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return a < T{} ? -a : a; }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return a < b ? b : a; }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { using std::sqrt; return sqrt(a); }
+    static KUUKAN_ALWAYS_INLINE T reduce_add(register_type a) { return a; }
+    static KUUKAN_ALWAYS_INLINE T reduce_max(register_type a) { return a; }
+};
+
+#if !defined(KUUKAN_DISABLE_SIMD) && (defined(__AVX512F__) || defined(__AVX2__))
+
+/// @brief All-ones lane of a mask vector if lane < count, otherwise zero
+template <typename Integer>
+constexpr Integer lane_mask(std::size_t lane, std::size_t count) { return lane < count ? Integer(-1) : Integer(0); }
+
+/**
+ * @brief 128-bit x86 register (SSE), used for fixed extents
+ *
+ * Like every x86 register below it adds load_first<Count> and
+ * store_first<Count>, which touch only the first Count lanes (loads zero the
+ * others). They use AVX-512VL mask registers when available and the AVX
+ * maskload/maskstore instructions otherwise.
+ */
+template <typename T>
+struct register_128;
+
+template <>
+struct register_128<double> {
+    using register_type = __m128d;
+    static constexpr std::size_t width = 2;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const double* source) { return _mm_loadu_pd(source); }
+    static KUUKAN_ALWAYS_INLINE void store(double* target, register_type value) { _mm_storeu_pd(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(double value) { return _mm_set1_pd(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return _mm_setzero_pd(); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return _mm_add_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return _mm_sub_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return _mm_mul_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) {
+#  if defined(__FMA__)
+        return _mm_fmadd_pd(a, b, c);
+#  else
+        return _mm_add_pd(_mm_mul_pd(a, b), c);
+#  endif
+    }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return _mm_max_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return _mm_sqrt_pd(a); }
+    static KUUKAN_ALWAYS_INLINE double reduce_add(register_type a) { return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a))); }
+    static KUUKAN_ALWAYS_INLINE double reduce_max(register_type a) { return _mm_cvtsd_f64(_mm_max_sd(a, _mm_unpackhi_pd(a, a))); }
+
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE register_type load_first(const double* source) {
+#  if defined(__AVX512VL__)
+        return _mm_maskz_loadu_pd(__mmask8((1u << Count) - 1), source);
+#  else
+        return _mm_maskload_pd(source, _mm_set_epi64x(lane_mask<long long>(1, Count), lane_mask<long long>(0, Count)));
+#  endif
+    }
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE void store_first(double* target, register_type value) {
+#  if defined(__AVX512VL__)
+        _mm_mask_storeu_pd(target, __mmask8((1u << Count) - 1), value);
+#  else
+        _mm_maskstore_pd(target, _mm_set_epi64x(lane_mask<long long>(1, Count), lane_mask<long long>(0, Count)), value);
+#  endif
+    }
+};
+
+template <>
+struct register_128<float> {
+    using register_type = __m128;
+    static constexpr std::size_t width = 4;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const float* source) { return _mm_loadu_ps(source); }
+    static KUUKAN_ALWAYS_INLINE void store(float* target, register_type value) { _mm_storeu_ps(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(float value) { return _mm_set1_ps(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return _mm_setzero_ps(); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return _mm_add_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return _mm_sub_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return _mm_mul_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) {
+#  if defined(__FMA__)
+        return _mm_fmadd_ps(a, b, c);
+#  else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#  endif
+    }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return _mm_max_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return _mm_sqrt_ps(a); }
+    static KUUKAN_ALWAYS_INLINE float reduce_add(register_type a) {
+        const __m128 pair = _mm_add_ps(a, _mm_movehl_ps(a, a));
+        return _mm_cvtss_f32(_mm_add_ss(pair, _mm_movehdup_ps(pair)));
+    }
+    static KUUKAN_ALWAYS_INLINE float reduce_max(register_type a) {
+        const __m128 pair = _mm_max_ps(a, _mm_movehl_ps(a, a));
+        return _mm_cvtss_f32(_mm_max_ss(pair, _mm_movehdup_ps(pair)));
+    }
+
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE register_type load_first(const float* source) {
+#  if defined(__AVX512VL__)
+        return _mm_maskz_loadu_ps(__mmask8((1u << Count) - 1), source);
+#  else
+        return _mm_maskload_ps(source, _mm_setr_epi32(lane_mask<int>(0, Count), lane_mask<int>(1, Count),
+                                                      lane_mask<int>(2, Count), lane_mask<int>(3, Count)));
+#  endif
+    }
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE void store_first(float* target, register_type value) {
+#  if defined(__AVX512VL__)
+        _mm_mask_storeu_ps(target, __mmask8((1u << Count) - 1), value);
+#  else
+        _mm_maskstore_ps(target, _mm_setr_epi32(lane_mask<int>(0, Count), lane_mask<int>(1, Count),
+                                                lane_mask<int>(2, Count), lane_mask<int>(3, Count)), value);
+#  endif
+    }
+};
+
+/// @brief 256-bit x86 register (AVX)
+template <typename T>
+struct register_256;
+
+template <>
+struct register_256<double> {
+    using register_type = __m256d;
+    static constexpr std::size_t width = 4;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const double* source) { return _mm256_loadu_pd(source); }
+    static KUUKAN_ALWAYS_INLINE void store(double* target, register_type value) { _mm256_storeu_pd(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(double value) { return _mm256_set1_pd(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return _mm256_setzero_pd(); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return _mm256_add_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return _mm256_sub_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return _mm256_mul_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) {
+#  if defined(__FMA__)
+        return _mm256_fmadd_pd(a, b, c);
+#  else
+        return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#  endif
+    }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return _mm256_max_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return _mm256_sqrt_pd(a); }
+    static KUUKAN_ALWAYS_INLINE double reduce_add(register_type a) {
+        const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+    static KUUKAN_ALWAYS_INLINE double reduce_max(register_type a) {
+        const __m128d pair = _mm_max_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_max_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE register_type load_first(const double* source) {
+#  if defined(__AVX512VL__)
+        return _mm256_maskz_loadu_pd(__mmask8((1u << Count) - 1), source);
+#  else
+        return _mm256_maskload_pd(source, _mm256_setr_epi64x(lane_mask<long long>(0, Count), lane_mask<long long>(1, Count),
+                                                             lane_mask<long long>(2, Count), lane_mask<long long>(3, Count)));
+#  endif
+    }
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE void store_first(double* target, register_type value) {
+#  if defined(__AVX512VL__)
+        _mm256_mask_storeu_pd(target, __mmask8((1u << Count) - 1), value);
+#  else
+        _mm256_maskstore_pd(target, _mm256_setr_epi64x(lane_mask<long long>(0, Count), lane_mask<long long>(1, Count),
+                                                       lane_mask<long long>(2, Count), lane_mask<long long>(3, Count)), value);
+#  endif
+    }
+};
+
+template <>
+struct register_256<float> {
+    using register_type = __m256;
+    static constexpr std::size_t width = 8;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const float* source) { return _mm256_loadu_ps(source); }
+    static KUUKAN_ALWAYS_INLINE void store(float* target, register_type value) { _mm256_storeu_ps(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(float value) { return _mm256_set1_ps(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return _mm256_setzero_ps(); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return _mm256_add_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return _mm256_sub_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return _mm256_mul_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) {
+#  if defined(__FMA__)
+        return _mm256_fmadd_ps(a, b, c);
+#  else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#  endif
+    }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return _mm256_max_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return _mm256_sqrt_ps(a); }
+    static KUUKAN_ALWAYS_INLINE float reduce_add(register_type a) {
+        return register_128<float>::reduce_add(_mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+    static KUUKAN_ALWAYS_INLINE float reduce_max(register_type a) {
+        return register_128<float>::reduce_max(_mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE register_type load_first(const float* source) {
+#  if defined(__AVX512VL__)
+        return _mm256_maskz_loadu_ps(__mmask8((1u << Count) - 1), source);
+#  else
+        return _mm256_maskload_ps(source, _mm256_setr_epi32(
+            lane_mask<int>(0, Count), lane_mask<int>(1, Count), lane_mask<int>(2, Count), lane_mask<int>(3, Count),
+            lane_mask<int>(4, Count), lane_mask<int>(5, Count), lane_mask<int>(6, Count), lane_mask<int>(7, Count)));
+#  endif
+    }
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE void store_first(float* target, register_type value) {
+#  if defined(__AVX512VL__)
+        _mm256_mask_storeu_ps(target, __mmask8((1u << Count) - 1), value);
+#  else
+        _mm256_maskstore_ps(target, _mm256_setr_epi32(
+            lane_mask<int>(0, Count), lane_mask<int>(1, Count), lane_mask<int>(2, Count), lane_mask<int>(3, Count),
+            lane_mask<int>(4, Count), lane_mask<int>(5, Count), lane_mask<int>(6, Count), lane_mask<int>(7, Count)), value);
+#  endif
+    }
+};
+
+#  if defined(__AVX512F__)
+
+/// @brief 512-bit x86 register (AVX-512F)
+template <typename T>
+struct register_512;
+
+template <>
+struct register_512<double> {
+    using register_type = __m512d;
+    static constexpr std::size_t width = 8;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const double* source) { return _mm512_loadu_pd(source); }
+    static KUUKAN_ALWAYS_INLINE void store(double* target, register_type value) { _mm512_storeu_pd(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(double value) { return _mm512_set1_pd(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return _mm512_setzero_pd(); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return _mm512_add_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return _mm512_sub_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return _mm512_mul_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) { return _mm512_fmadd_pd(a, b, c); }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return _mm512_abs_pd(a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return _mm512_max_pd(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return _mm512_sqrt_pd(a); }
+    static KUUKAN_ALWAYS_INLINE double reduce_add(register_type a) { return _mm512_reduce_add_pd(a); }
+    static KUUKAN_ALWAYS_INLINE double reduce_max(register_type a) { return _mm512_reduce_max_pd(a); }
+
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE register_type load_first(const double* source) {
+        return _mm512_maskz_loadu_pd(__mmask8((1u << Count) - 1), source);
+    }
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE void store_first(double* target, register_type value) {
+        _mm512_mask_storeu_pd(target, __mmask8((1u << Count) - 1), value);
+    }
+};
+
+template <>
+struct register_512<float> {
+    using register_type = __m512;
+    static constexpr std::size_t width = 16;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const float* source) { return _mm512_loadu_ps(source); }
+    static KUUKAN_ALWAYS_INLINE void store(float* target, register_type value) { _mm512_storeu_ps(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(float value) { return _mm512_set1_ps(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return _mm512_setzero_ps(); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return _mm512_add_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return _mm512_sub_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return _mm512_mul_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) { return _mm512_fmadd_ps(a, b, c); }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return _mm512_abs_ps(a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return _mm512_max_ps(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return _mm512_sqrt_ps(a); }
+    static KUUKAN_ALWAYS_INLINE float reduce_add(register_type a) { return _mm512_reduce_add_ps(a); }
+    static KUUKAN_ALWAYS_INLINE float reduce_max(register_type a) { return _mm512_reduce_max_ps(a); }
+
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE register_type load_first(const float* source) {
+        return _mm512_maskz_loadu_ps(__mmask16((1u << Count) - 1), source);
+    }
+    template <std::size_t Count>
+    static KUUKAN_ALWAYS_INLINE void store_first(float* target, register_type value) {
+        _mm512_mask_storeu_ps(target, __mmask16((1u << Count) - 1), value);
+    }
+};
+
+template <> struct native<double> : register_512<double> {};
+template <> struct native<float>  : register_512<float>  {};
+
+#  else
+
+template <> struct native<double> : register_256<double> {};
+template <> struct native<float>  : register_256<float>  {};
+
+#  endif
+
+#elif !defined(KUUKAN_DISABLE_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+
+template <>
+struct native<double> {
+    using register_type = float64x2_t;
+    static constexpr std::size_t width = 2;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const double* source) { return vld1q_f64(source); }
+    static KUUKAN_ALWAYS_INLINE void store(double* target, register_type value) { vst1q_f64(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(double value) { return vdupq_n_f64(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return vdupq_n_f64(0.0); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return vaddq_f64(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return vsubq_f64(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return vmulq_f64(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) { return vfmaq_f64(c, a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return vabsq_f64(a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return vmaxq_f64(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return vsqrtq_f64(a); }
+    static KUUKAN_ALWAYS_INLINE double reduce_add(register_type a) { return vaddvq_f64(a); }
+    static KUUKAN_ALWAYS_INLINE double reduce_max(register_type a) { return vmaxvq_f64(a); }
+};
+
+template <>
+struct native<float> {
+    using register_type = float32x4_t;
+    static constexpr std::size_t width = 4;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const float* source) { return vld1q_f32(source); }
+    static KUUKAN_ALWAYS_INLINE void store(float* target, register_type value) { vst1q_f32(target, value); }
+    static KUUKAN_ALWAYS_INLINE register_type broadcast(float value) { return vdupq_n_f32(value); }
+    static KUUKAN_ALWAYS_INLINE register_type zero() { return vdupq_n_f32(0.0f); }
+    static KUUKAN_ALWAYS_INLINE register_type add(register_type a, register_type b) { return vaddq_f32(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sub(register_type a, register_type b) { return vsubq_f32(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type mul(register_type a, register_type b) { return vmulq_f32(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type fma(register_type a, register_type b, register_type c) { return vfmaq_f32(c, a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type abs(register_type a) { return vabsq_f32(a); }
+    static KUUKAN_ALWAYS_INLINE register_type max(register_type a, register_type b) { return vmaxq_f32(a, b); }
+    static KUUKAN_ALWAYS_INLINE register_type sqrt(register_type a) { return vsqrtq_f32(a); }
+    static KUUKAN_ALWAYS_INLINE float reduce_add(register_type a) { return vaddvq_f32(a); }
+    static KUUKAN_ALWAYS_INLINE float reduce_max(register_type a) { return vmaxvq_f32(a); }
+};
+
+#endif
+
+/**
+ * @brief The narrowest register covering a static extent shorter than native<T>::width
+ *
+ * `type` is void when there is none: for an extent of one, for extents of
+ * at least native<T>::width, and in builds without x86 SIMD.
+ */
+template <typename T, std::size_t Extent>
+struct fitting_register {
+    using type = void;
+};
+
+#if !defined(KUUKAN_DISABLE_SIMD) && (defined(__AVX512F__) || defined(__AVX2__))
+template <typename T, std::size_t Extent>
+    requires (std::is_same_v<T, float> || std::is_same_v<T, double>) &&
+             (1 < Extent && Extent < native<T>::width)
+struct fitting_register<T, Extent> {
+#  if defined(__AVX512F__)
+    using type = std::conditional_t<Extent * sizeof(T) <= 16, register_128<T>,
+                 std::conditional_t<Extent * sizeof(T) <= 32, register_256<T>, register_512<T>>>;
+#  else
+    using type = std::conditional_t<Extent * sizeof(T) <= 16, register_128<T>, register_256<T>>;
+#  endif
+};
+#endif
+
+/// @brief Whether a static extent is processed as one fixed register
+template <typename T, std::size_t Extent>
+inline constexpr bool has_fixed_register = !std::is_void_v<typename fitting_register<T, Extent>::type>;
+
+/**
+ * @brief One register holding a whole static extent shorter than native<T>::width
+ *
+ * @tparam T The scalar type
+ * @tparam Extent The static element count (has_fixed_register must hold)
+ * @tparam Capacity The number of elements writable at a store target
+ *
+ * The interface of native<T>, over fitting_register<T, Extent>::type: load
+ * reads the Extent elements and zeroes the remaining lanes, store writes
+ * them, or the whole register when Capacity covers it (no mask needed).
+ * The zeroed lanes stay zero through every reduction kernel, so a fixed
+ * register reduces exactly like Extent scalars.
+ */
+template <typename T, std::size_t Extent, std::size_t Capacity = Extent>
+struct fixed : fitting_register<T, Extent>::type {
+    using base = typename fitting_register<T, Extent>::type;
+    using typename base::register_type;
+    using base::width;
+
+    static KUUKAN_ALWAYS_INLINE register_type load(const T* source) {
+        if constexpr (Extent == width) {
+            return base::load(source);
+        } else {
+            return base::template load_first<Extent>(source);
+        }
+    }
+    static KUUKAN_ALWAYS_INLINE void store(T* target, register_type value) {
+        if constexpr (Extent == width || width <= Capacity) {
+            base::store(target, value);
+        } else {
+            base::template store_first<Extent>(target, value);
+        }
+    }
+};
+
+/// @brief |value| for the scalar tail of a kernel
+template <typename T>
+KUUKAN_ALWAYS_INLINE constexpr T scalar_abs(T value) { return value < T{} ? -value : value; }
+
+/// @brief max(left, right) for the scalar tail of a kernel
+template <typename T>
+KUUKAN_ALWAYS_INLINE constexpr T scalar_max(T left, T right) { return left < right ? right : left; }
+
+/**
+ * @brief Square root that can be evaluated at compile time
+ *
+ * At run time this is std::sqrt. In a constant expression, where std::sqrt
+ * need not be constexpr, Newton's method runs from above until the estimate
+ * stops decreasing, and the estimate or a neighbour is picked by the exact
+ * residual of its square (Dekker's product), which matches the correctly
+ * rounded std::sqrt for all normal results.
+ */
+template <std::floating_point T>
+constexpr T scalar_sqrt(T value) {
+    if (std::is_constant_evaluated()) {
+        constexpr T infinity = std::numeric_limits<T>::infinity();
+        if (!(value > T(0)) || value == infinity) {
+            return value == T(0) || value == infinity ? value : std::numeric_limits<T>::quiet_NaN();
+        }
+        T estimate = value < T(1) ? T(1) : value;
+        for (T next = (estimate + value / estimate) / T(2); next < estimate;
+             next = (estimate + value / estimate) / T(2)) {
+            estimate = next;
+        }
+        // |candidate^2 - value|, with candidate^2 split into its rounded value and exact error
+        const auto residual = [value](T candidate) {
+            constexpr T split = T((1ull << ((std::numeric_limits<T>::digits + 1) / 2)) + 1);
+            const T product = candidate * candidate;
+            const T scaled = split * candidate;
+            const T high = scaled - (scaled - candidate);
+            const T low = candidate - high;
+            const T error = ((high * high - product) + T(2) * high * low) + low * low;
+            const T result = (product - value) + error;
+            return result < T(0) ? -result : result;
+        };
+        using bits_type = std::conditional_t<sizeof(T) == sizeof(unsigned long long), unsigned long long, unsigned>;
+        const bits_type bits = std::bit_cast<bits_type>(estimate);
+        T best = estimate;
+        for (const T neighbour : {std::bit_cast<T>(bits_type(bits - 1)), std::bit_cast<T>(bits_type(bits + 1))}) {
+            if (residual(neighbour) < residual(best)) {
+                best = neighbour;
+            }
+        }
+        return best;
+    }
+    return std::sqrt(value);
+}
+
+/**
+ * @brief Call body(integral_constant<I>) for I = 0 .. Count - 1, fully unrolled
+ *
+ * @tparam Count The number of calls
+ * @param body The callable to invoke
+ */
+template <std::size_t Count, typename Body>
+KUUKAN_ALWAYS_INLINE constexpr void unrolled(Body&& body) {
+    [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+        (body(std::integral_constant<std::size_t, Index>{}), ...);
+    }(std::make_index_sequence<Count>{});
+}
+
+/**
+ * @brief Elementwise loop skeleton shared by all map kernels
+ *
+ * Calls vector_body(traits, i) for every register block starting at i and
+ * scalar_body(i) for the remaining tail elements, where traits is the
+ * register abstraction of the block: native<T>, or fixed<T, Extent,
+ * Capacity> when the whole static extent fits one narrower register. When
+ * Extent is a compile-time size of at most unroll_limit blocks, both loops
+ * are fully unrolled. In a constant expression only scalar_body runs.
+ *
+ * @tparam T The scalar type
+ * @tparam Extent The static element count, or std::dynamic_extent
+ * @tparam Capacity The number of elements writable at the output (see fixed)
+ * @param count The element count (equal to Extent when static)
+ * @param vector_body Callable (traits, i) processing traits::width elements at offset i
+ * @param scalar_body Callable processing the single element at offset i
+ */
+template <typename T, std::size_t Extent, std::size_t Capacity = Extent, typename VectorBody, typename ScalarBody>
+KUUKAN_ALWAYS_INLINE constexpr void for_each_block(std::size_t count, VectorBody&& vector_body,
+                                                   ScalarBody&& scalar_body) {
+    using traits = native<T>;
+    constexpr std::size_t width = traits::width;
+    if (std::is_constant_evaluated()) {
+        for (std::size_t index = 0; index < count; ++index) {
+            scalar_body(index);
+        }
+    } else if constexpr (has_fixed_register<T, Extent>) {
+        vector_body(fixed<T, Extent, Capacity>{}, std::size_t{0});
+    } else if constexpr (Extent != std::dynamic_extent && Extent / width <= unroll_limit) {
+        unrolled<Extent / width>([&](auto block) { vector_body(traits{}, block * width); });
+        unrolled<Extent % width>([&](auto lane) { scalar_body(Extent / width * width + lane); });
+    } else {
+        const std::size_t block_end = count - count % width;
+        std::size_t index = 0;
+        for (; index < block_end; index += width) {
+            vector_body(traits{}, index);
+        }
+        for (; index < count; ++index) {
+            scalar_body(index);
+        }
+    }
+}
+
+/**
+ * @brief Reduction skeleton shared by all reduction kernels
+ *
+ * Accumulates whole register blocks with step(traits, accumulator, i),
+ * using four independent accumulators on long arrays to hide instruction
+ * latency, then merges them, reduces horizontally and folds the tail with
+ * scalar_step. A static extent that fits one fixed register is a single
+ * step; in a constant expression only scalar_step runs, from T{}.
+ *
+ * @tparam T The scalar type
+ * @tparam Extent The static element count, or std::dynamic_extent
+ * @tparam Traits The register abstraction (native<T>; load may read another
+ *         storage type, as the mixed-precision registers of precision.hpp do)
+ * @param count The element count (equal to Extent when static)
+ * @param step Callable (traits, register_type, i) -> register_type for one block
+ * @param scalar_step Callable (T, i) -> T for one tail element
+ * @param merge Callable (traits, register_type, register_type) -> register_type
+ * @param horizontal Callable (traits, register_type) -> T
+ * @return The reduced value
+ */
+template <typename T, std::size_t Extent, typename Traits = native<T>, typename Step, typename ScalarStep,
+          typename Merge, typename Horizontal>
+KUUKAN_ALWAYS_INLINE constexpr T reduce_blocks(std::size_t count, Step&& step, ScalarStep&& scalar_step,
+                                               Merge&& merge, Horizontal&& horizontal) {
+    using traits = Traits;
+    constexpr std::size_t width = traits::width;
+    if (std::is_constant_evaluated()) {
+        T result{};
+        for (std::size_t index = 0; index < count; ++index) {
+            result = scalar_step(result, index);
+        }
+        return result;
+    } else if constexpr (std::same_as<Traits, native<T>> && has_fixed_register<T, Extent>) {
+        using register_traits = fixed<T, Extent>;
+        return horizontal(register_traits{}, step(register_traits{}, register_traits::zero(), std::size_t{0}));
+    } else if constexpr (Extent != std::dynamic_extent && Extent / width <= unroll_limit) {
+        auto accumulator = traits::zero();
+        unrolled<Extent / width>([&](auto block) { accumulator = step(traits{}, accumulator, block * width); });
+        T result = horizontal(traits{}, accumulator);
+        unrolled<Extent % width>([&](auto lane) { result = scalar_step(result, Extent / width * width + lane); });
+        return result;
+    } else {
+        auto accumulator0 = traits::zero();
+        auto accumulator1 = traits::zero();
+        auto accumulator2 = traits::zero();
+        auto accumulator3 = traits::zero();
+        const std::size_t unrolled_end = count - count % (4 * width);
+        const std::size_t block_end = count - count % width;
+        std::size_t index = 0;
+        for (; index < unrolled_end; index += 4 * width) {
+            accumulator0 = step(traits{}, accumulator0, index);
+            accumulator1 = step(traits{}, accumulator1, index + width);
+            accumulator2 = step(traits{}, accumulator2, index + 2 * width);
+            accumulator3 = step(traits{}, accumulator3, index + 3 * width);
+        }
+        for (; index < block_end; index += width) {
+            accumulator0 = step(traits{}, accumulator0, index);
+        }
+        T result = horizontal(traits{}, merge(traits{}, merge(traits{}, accumulator0, accumulator1),
+                                              merge(traits{}, accumulator2, accumulator3)));
+        for (; index < count; ++index) {
+            result = scalar_step(result, index);
+        }
+        return result;
+    }
+}
+
+/**
+ * @brief Early-exit variant of reduce_blocks for monotone reductions
+ *
+ * Like reduce_blocks, but every bound_check_blocks blocks the partial result
+ * is reduced and compared with bound; once it exceeds bound it is returned
+ * immediately. Since the step callables only ever increase the partial
+ * result, the early value lies between bound and the full result. Static
+ * extents that reduce_blocks unrolls completely are too short to profit and
+ * are reduced in full, as are constant expressions.
+ *
+ * @param count The element count (equal to Extent when static)
+ * @param bound The early-exit threshold (in the units of the reduced value)
+ * @return The full result, or a partial result greater than bound
+ */
+template <typename T, std::size_t Extent, typename Traits = native<T>, typename Step, typename ScalarStep,
+          typename Merge, typename Horizontal>
+KUUKAN_ALWAYS_INLINE constexpr T reduce_blocks_bounded(std::size_t count, T bound, Step&& step,
+                                                       ScalarStep&& scalar_step, Merge&& merge,
+                                                       Horizontal&& horizontal) {
+    using traits = Traits;
+    constexpr std::size_t width = traits::width;
+    if (std::is_constant_evaluated()) {
+        return reduce_blocks<T, Extent, Traits>(count, step, scalar_step, merge, horizontal);
+    } else if constexpr (Extent != std::dynamic_extent && Extent / width <= unroll_limit) {
+        return reduce_blocks<T, Extent, Traits>(count, step, scalar_step, merge, horizontal);
+    } else {
+        static_assert(bound_check_blocks % 4 == 0);
+        auto accumulator0 = traits::zero();
+        auto accumulator1 = traits::zero();
+        auto accumulator2 = traits::zero();
+        auto accumulator3 = traits::zero();
+        constexpr std::size_t chunk = bound_check_blocks * width;
+        const std::size_t chunk_end = count - count % chunk;
+        const std::size_t unrolled_end = count - count % (4 * width);
+        const std::size_t block_end = count - count % width;
+        std::size_t index = 0;
+        while (index < chunk_end) {
+            for (const std::size_t stop = index + chunk; index < stop; index += 4 * width) {
+                accumulator0 = step(traits{}, accumulator0, index);
+                accumulator1 = step(traits{}, accumulator1, index + width);
+                accumulator2 = step(traits{}, accumulator2, index + 2 * width);
+                accumulator3 = step(traits{}, accumulator3, index + 3 * width);
+            }
+            const T partial = horizontal(traits{}, merge(traits{}, merge(traits{}, accumulator0, accumulator1),
+                                                         merge(traits{}, accumulator2, accumulator3)));
+            if (bound < partial) {
+                return partial;
+            }
+        }
+        for (; index < unrolled_end; index += 4 * width) {
+            accumulator0 = step(traits{}, accumulator0, index);
+            accumulator1 = step(traits{}, accumulator1, index + width);
+            accumulator2 = step(traits{}, accumulator2, index + 2 * width);
+            accumulator3 = step(traits{}, accumulator3, index + 3 * width);
+        }
+        for (; index < block_end; index += width) {
+            accumulator0 = step(traits{}, accumulator0, index);
+        }
+        T result = horizontal(traits{}, merge(traits{}, merge(traits{}, accumulator0, accumulator1),
+                                              merge(traits{}, accumulator2, accumulator3)));
+        for (; index < count; ++index) {
+            result = scalar_step(result, index);
+        }
+        return result;
+    }
+}
+
+// —— Map kernels: out may alias any input ——
+//
+// Capacity is the number of elements writable at out (at least Extent).
+// When it covers the whole fixed register of a small static extent, the
+// register is stored without a mask; DenseVector pads small extents so.
+
+/// @brief out[i] = left[i] + right[i]
+template <typename T, std::size_t Extent = std::dynamic_extent, std::size_t Capacity = Extent>
+KUUKAN_ALWAYS_INLINE constexpr void add(const T* left, const T* right, T* out, std::size_t count) {
+    for_each_block<T, Extent, Capacity>(count,
+        [&](auto traits, std::size_t i) { traits.store(out + i, traits.add(traits.load(left + i), traits.load(right + i))); },
+        [&](std::size_t i) { out[i] = left[i] + right[i]; });
+}
+
+/// @brief out[i] = left[i] - right[i]
+template <typename T, std::size_t Extent = std::dynamic_extent, std::size_t Capacity = Extent>
+KUUKAN_ALWAYS_INLINE constexpr void subtract(const T* left, const T* right, T* out, std::size_t count) {
+    for_each_block<T, Extent, Capacity>(count,
+        [&](auto traits, std::size_t i) { traits.store(out + i, traits.sub(traits.load(left + i), traits.load(right + i))); },
+        [&](std::size_t i) { out[i] = left[i] - right[i]; });
+}
+
+/// @brief out[i] = scalar * values[i]
+template <typename T, std::size_t Extent = std::dynamic_extent, std::size_t Capacity = Extent>
+KUUKAN_ALWAYS_INLINE constexpr void scale(T scalar, const T* values, T* out, std::size_t count) {
+    for_each_block<T, Extent, Capacity>(count,
+        [&](auto traits, std::size_t i) { traits.store(out + i, traits.mul(traits.broadcast(scalar), traits.load(values + i))); },
+        [&](std::size_t i) { out[i] = scalar * values[i]; });
+}
+
+/// @brief out[i] = -values[i]
+template <typename T, std::size_t Extent = std::dynamic_extent, std::size_t Capacity = Extent>
+KUUKAN_ALWAYS_INLINE constexpr void negate(const T* values, T* out, std::size_t count) {
+    scale<T, Extent, Capacity>(T(-1), values, out, count);
+}
+
+/// @brief out[i] = scalar * x[i] + y[i]
+template <typename T, std::size_t Extent = std::dynamic_extent, std::size_t Capacity = Extent>
+KUUKAN_ALWAYS_INLINE constexpr void axpy(T scalar, const T* x, const T* y, T* out, std::size_t count) {
+    for_each_block<T, Extent, Capacity>(count,
+        [&](auto traits, std::size_t i) {
+            traits.store(out + i, traits.fma(traits.broadcast(scalar), traits.load(x + i), traits.load(y + i)));
+        },
+        [&](std::size_t i) { out[i] = scalar * x[i] + y[i]; });
+}
+
+/**
+ * @brief out[i] = sum_k coefficients[k] * elements[k][i], in one pass over out
+ *
+ * @param coefficients The term_count coefficients
+ * @param elements The term_count input arrays
+ * @param term_count The number of terms (at least one)
+ * @param out The output array (may alias one of the inputs)
+ * @param count The element count
+ */
+template <typename T, std::size_t Extent = std::dynamic_extent, std::size_t Capacity = Extent>
+KUUKAN_ALWAYS_INLINE constexpr void linear_combination(const T* coefficients, const T* const* elements,
+                                                       std::size_t term_count, T* out, std::size_t count) {
+    for_each_block<T, Extent, Capacity>(count,
+        [&](auto traits, std::size_t i) {
+            auto accumulator = traits.mul(traits.broadcast(coefficients[0]), traits.load(elements[0] + i));
+            for (std::size_t term = 1; term < term_count; ++term) {
+                accumulator = traits.fma(traits.broadcast(coefficients[term]),
+                                         traits.load(elements[term] + i), accumulator);
+            }
+            traits.store(out + i, accumulator);
+        },
+        [&](std::size_t i) {
+            T accumulator = coefficients[0] * elements[0][i];
+            for (std::size_t term = 1; term < term_count; ++term) {
+                accumulator += coefficients[term] * elements[term][i];
+            }
+            out[i] = accumulator;
+        });
+}
+
+// —— Reduction kernels ——
+
+/// @brief sum_i left[i] * right[i]
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T dot(const T* left, const T* right, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) { return traits.fma(traits.load(left + i), traits.load(right + i), acc); },
+        [&](T acc, std::size_t i) { return acc + left[i] * right[i]; },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief sum_i |values[i]|
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T sum_abs(const T* values, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) { return traits.add(acc, traits.abs(traits.load(values + i))); },
+        [&](T acc, std::size_t i) { return acc + scalar_abs(values[i]); },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief sum_i values[i]^2
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T sum_squares(const T* values, std::size_t count) {
+    return dot<T, Extent>(values, values, count);
+}
+
+/// @brief max_i |values[i]| (zero for an empty array)
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T max_abs(const T* values, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) { return traits.max(acc, traits.abs(traits.load(values + i))); },
+        [&](T acc, std::size_t i) { return scalar_max(acc, scalar_abs(values[i])); },
+        [](auto traits, auto a, auto b) { return traits.max(a, b); },
+        [](auto traits, auto a) { return traits.reduce_max(a); });
+}
+
+/**
+ * @brief Register-wide value of sum_k coefficients[k] * elements[k][i .. i + width)
+ *
+ * Shared by the combination reductions, which consume it without storing it.
+ */
+template <typename Traits, typename T>
+KUUKAN_ALWAYS_INLINE constexpr auto combination_block(Traits traits, const T* coefficients, const T* const* elements,
+                                                      std::size_t term_count, std::size_t i) {
+    auto value = traits.mul(traits.broadcast(coefficients[0]), traits.load(elements[0] + i));
+    for (std::size_t term = 1; term < term_count; ++term) {
+        value = traits.fma(traits.broadcast(coefficients[term]), traits.load(elements[term] + i), value);
+    }
+    return value;
+}
+
+/// @brief sum_k coefficients[k] * elements[k][i] for one component
+template <typename T>
+KUUKAN_ALWAYS_INLINE constexpr T combination_component(const T* coefficients, const T* const* elements,
+                                                       std::size_t term_count, std::size_t i) {
+    T value = coefficients[0] * elements[0][i];
+    for (std::size_t term = 1; term < term_count; ++term) {
+        value += coefficients[term] * elements[term][i];
+    }
+    return value;
+}
+
+/// @brief sum_i |v[i]| for v = sum_k coefficients[k] * elements[k], in one pass without storing v
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T combination_sum_abs(const T* coefficients, const T* const* elements,
+                                                     std::size_t term_count, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) {
+            return traits.add(acc, traits.abs(combination_block(traits, coefficients, elements, term_count, i)));
+        },
+        [&](T acc, std::size_t i) { return acc + scalar_abs(combination_component(coefficients, elements, term_count, i)); },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief sum_i v[i]^2 for v = sum_k coefficients[k] * elements[k], in one pass without storing v
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T combination_sum_squares(const T* coefficients, const T* const* elements,
+                                                         std::size_t term_count, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) {
+            const auto value = combination_block(traits, coefficients, elements, term_count, i);
+            return traits.fma(value, value, acc);
+        },
+        [&](T acc, std::size_t i) {
+            const T value = combination_component(coefficients, elements, term_count, i);
+            return acc + value * value;
+        },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief max_i |v[i]| for v = sum_k coefficients[k] * elements[k], in one pass without storing v
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T combination_max_abs(const T* coefficients, const T* const* elements,
+                                                     std::size_t term_count, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) {
+            return traits.max(acc, traits.abs(combination_block(traits, coefficients, elements, term_count, i)));
+        },
+        [&](T acc, std::size_t i) {
+            return scalar_max(acc, scalar_abs(combination_component(coefficients, elements, term_count, i)));
+        },
+        [](auto traits, auto a, auto b) { return traits.max(a, b); },
+        [](auto traits, auto a) { return traits.reduce_max(a); });
+}
+
+/// @brief sum_i |left[i] - right[i]|
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T sum_abs_difference(const T* left, const T* right, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) {
+            return traits.add(acc, traits.abs(traits.sub(traits.load(left + i), traits.load(right + i))));
+        },
+        [&](T acc, std::size_t i) { return acc + scalar_abs(left[i] - right[i]); },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief sum_i (left[i] - right[i])^2
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T sum_squared_difference(const T* left, const T* right, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) {
+            const auto delta = traits.sub(traits.load(left + i), traits.load(right + i));
+            return traits.fma(delta, delta, acc);
+        },
+        [&](T acc, std::size_t i) { const T delta = left[i] - right[i]; return acc + delta * delta; },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief max_i |left[i] - right[i]| (zero for empty arrays)
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T max_abs_difference(const T* left, const T* right, std::size_t count) {
+    return reduce_blocks<T, Extent>(count,
+        [&](auto traits, auto acc, std::size_t i) {
+            return traits.max(acc, traits.abs(traits.sub(traits.load(left + i), traits.load(right + i))));
+        },
+        [&](T acc, std::size_t i) { return scalar_max(acc, scalar_abs(left[i] - right[i])); },
+        [](auto traits, auto a, auto b) { return traits.max(a, b); },
+        [](auto traits, auto a) { return traits.reduce_max(a); });
+}
+
+// —— Early-exit reduction kernels: full result, or a partial result > bound ——
+
+/// @brief sum_i |left[i] - right[i]|, stopping early once it exceeds bound
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T sum_abs_difference_bounded(const T* left, const T* right, std::size_t count, T bound) {
+    return reduce_blocks_bounded<T, Extent>(count, bound,
+        [&](auto traits, auto acc, std::size_t i) {
+            return traits.add(acc, traits.abs(traits.sub(traits.load(left + i), traits.load(right + i))));
+        },
+        [&](T acc, std::size_t i) { return acc + scalar_abs(left[i] - right[i]); },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief sum_i (left[i] - right[i])^2, stopping early once it exceeds bound
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T sum_squared_difference_bounded(const T* left, const T* right, std::size_t count, T bound) {
+    return reduce_blocks_bounded<T, Extent>(count, bound,
+        [&](auto traits, auto acc, std::size_t i) {
+            const auto delta = traits.sub(traits.load(left + i), traits.load(right + i));
+            return traits.fma(delta, delta, acc);
+        },
+        [&](T acc, std::size_t i) { const T delta = left[i] - right[i]; return acc + delta * delta; },
+        [](auto traits, auto a, auto b) { return traits.add(a, b); },
+        [](auto traits, auto a) { return traits.reduce_add(a); });
+}
+
+/// @brief max_i |left[i] - right[i]|, stopping early once it exceeds bound
+template <typename T, std::size_t Extent = std::dynamic_extent>
+KUUKAN_ALWAYS_INLINE constexpr T max_abs_difference_bounded(const T* left, const T* right, std::size_t count, T bound) {
+    return reduce_blocks_bounded<T, Extent>(count, bound,
+        [&](auto traits, auto acc, std::size_t i) {
+            return traits.max(acc, traits.abs(traits.sub(traits.load(left + i), traits.load(right + i))));
+        },
+        [&](T acc, std::size_t i) { return scalar_max(acc, scalar_abs(left[i] - right[i])); },
+        [](auto traits, auto a, auto b) { return traits.max(a, b); },
+        [](auto traits, auto a) { return traits.reduce_max(a); });
+}
+
+// —— Lane kernels over structure-of-arrays (SoA) storage ——
+//
+// A SoA buffer holds `dimension` rows of `stride` lanes; lane j of row c is
+// component c of element j. Registers run across elements, so one pass
+// evaluates native<T>::width elements at once.
+
+/**
+ * @brief Lane-wise reduction skeleton shared by all SoA reduction kernels
+ *
+ * For every element j < count, folds step over the dimension rows and
+ * writes finish(accumulator) to out[j]. Whole register blocks of elements
+ * are processed together; the remaining elements use the scalar callables.
+ *
+ * @param dimension The number of rows (components per element)
+ * @param count The number of elements (lanes) to produce
+ * @param out The count results
+ * @param step Callable (register_type, row, lane) -> register_type
+ * @param finish Callable (register_type) -> register_type
+ * @param scalar_step Callable (T, row, lane) -> T
+ * @param scalar_finish Callable (T) -> T
+ */
+template <typename T, typename Step, typename Finish, typename ScalarStep, typename ScalarFinish>
+KUUKAN_ALWAYS_INLINE void reduce_lanes(std::size_t dimension, std::size_t count, T* out,
+                                       Step&& step, Finish&& finish,
+                                       ScalarStep&& scalar_step, ScalarFinish&& scalar_finish) {
+    using traits = native<T>;
+    constexpr std::size_t width = traits::width;
+    const std::size_t block_end = count - count % width;
+    std::size_t lane = 0;
+    for (; lane < block_end; lane += width) {
+        auto accumulator = traits::zero();
+        for (std::size_t row = 0; row < dimension; ++row) {
+            accumulator = step(accumulator, row, lane);
+        }
+        traits::store(out + lane, finish(accumulator));
+    }
+    for (; lane < count; ++lane) {
+        T accumulator{};
+        for (std::size_t row = 0; row < dimension; ++row) {
+            accumulator = scalar_step(accumulator, row, lane);
+        }
+        out[lane] = scalar_finish(accumulator);
+    }
+}
+
+/// @brief Lane-wise sum of |value| over rows (L1 of each element)
+template <typename T>
+KUUKAN_ALWAYS_INLINE void lanes_sum_abs(const T* soa, std::size_t dimension, std::size_t stride,
+                                        std::size_t count, T* out) {
+    using traits = native<T>;
+    reduce_lanes<T>(dimension, count, out,
+        [&](auto acc, std::size_t row, std::size_t lane) { return traits::add(acc, traits::abs(traits::load(soa + row * stride + lane))); },
+        [](auto acc) { return acc; },
+        [&](T acc, std::size_t row, std::size_t lane) { return acc + scalar_abs(soa[row * stride + lane]); },
+        [](T acc) { return acc; });
+}
+
+/// @brief Lane-wise sum of value^2 over rows (squared L2 of each element)
+template <typename T>
+KUUKAN_ALWAYS_INLINE void lanes_sum_squares(const T* soa, std::size_t dimension, std::size_t stride,
+                                            std::size_t count, T* out, bool take_sqrt) {
+    using traits = native<T>;
+    reduce_lanes<T>(dimension, count, out,
+        [&](auto acc, std::size_t row, std::size_t lane) {
+            const auto value = traits::load(soa + row * stride + lane);
+            return traits::fma(value, value, acc);
+        },
+        [&](auto acc) { return take_sqrt ? traits::sqrt(acc) : acc; },
+        [&](T acc, std::size_t row, std::size_t lane) { const T value = soa[row * stride + lane]; return acc + value * value; },
+        [&](T acc) { using std::sqrt; return take_sqrt ? sqrt(acc) : acc; });
+}
+
+/// @brief Lane-wise max of |value| over rows (L-infinity of each element)
+template <typename T>
+KUUKAN_ALWAYS_INLINE void lanes_max_abs(const T* soa, std::size_t dimension, std::size_t stride,
+                                        std::size_t count, T* out) {
+    using traits = native<T>;
+    reduce_lanes<T>(dimension, count, out,
+        [&](auto acc, std::size_t row, std::size_t lane) { return traits::max(acc, traits::abs(traits::load(soa + row * stride + lane))); },
+        [](auto acc) { return acc; },
+        [&](T acc, std::size_t row, std::size_t lane) { return scalar_max(acc, scalar_abs(soa[row * stride + lane])); },
+        [](T acc) { return acc; });
+}
+
+/**
+ * @brief Row accessor for the right operand of a lane-wise difference
+ *
+ * Either another SoA buffer (elementwise pairs) or, with Broadcast set, a
+ * single element whose components are broadcast to every lane (one-to-many
+ * queries; stride is then unused).
+ */
+template <typename T, bool Broadcast>
+struct lane_operand {
+    const T*    values;
+    std::size_t stride;
+
+    KUUKAN_ALWAYS_INLINE auto load(std::size_t row, std::size_t lane) const {
+        if constexpr (Broadcast) {
+            return native<T>::broadcast(values[row]);
+        } else {
+            return native<T>::load(values + row * stride + lane);
+        }
+    }
+    KUUKAN_ALWAYS_INLINE T get(std::size_t row, std::size_t lane) const {
+        if constexpr (Broadcast) {
+            return values[row];
+        } else {
+            return values[row * stride + lane];
+        }
+    }
+};
+
+/// @brief Lane-wise sum of |left - right| over rows (L1 distance of each element)
+template <typename T, typename Operand>
+KUUKAN_ALWAYS_INLINE void lanes_sum_abs_difference(const T* soa, std::size_t dimension, std::size_t stride,
+                                                   Operand right, std::size_t count, T* out) {
+    using traits = native<T>;
+    reduce_lanes<T>(dimension, count, out,
+        [&](auto acc, std::size_t row, std::size_t lane) {
+            return traits::add(acc, traits::abs(traits::sub(traits::load(soa + row * stride + lane), right.load(row, lane))));
+        },
+        [](auto acc) { return acc; },
+        [&](T acc, std::size_t row, std::size_t lane) { return acc + scalar_abs(soa[row * stride + lane] - right.get(row, lane)); },
+        [](T acc) { return acc; });
+}
+
+/// @brief Lane-wise sum of (left - right)^2 over rows (squared L2 distance of each element)
+template <typename T, typename Operand>
+KUUKAN_ALWAYS_INLINE void lanes_sum_squared_difference(const T* soa, std::size_t dimension, std::size_t stride,
+                                                       Operand right, std::size_t count, T* out,
+                                                       bool take_sqrt) {
+    using traits = native<T>;
+    reduce_lanes<T>(dimension, count, out,
+        [&](auto acc, std::size_t row, std::size_t lane) {
+            const auto delta = traits::sub(traits::load(soa + row * stride + lane), right.load(row, lane));
+            return traits::fma(delta, delta, acc);
+        },
+        [&](auto acc) { return take_sqrt ? traits::sqrt(acc) : acc; },
+        [&](T acc, std::size_t row, std::size_t lane) {
+            const T delta = soa[row * stride + lane] - right.get(row, lane);
+            return acc + delta * delta;
+        },
+        [&](T acc) { using std::sqrt; return take_sqrt ? sqrt(acc) : acc; });
+}
+
+/// @brief Lane-wise max of |left - right| over rows (L-infinity distance of each element)
+template <typename T, typename Operand>
+KUUKAN_ALWAYS_INLINE void lanes_max_abs_difference(const T* soa, std::size_t dimension, std::size_t stride,
+                                                   Operand right, std::size_t count, T* out) {
+    using traits = native<T>;
+    reduce_lanes<T>(dimension, count, out,
+        [&](auto acc, std::size_t row, std::size_t lane) {
+            return traits::max(acc, traits::abs(traits::sub(traits::load(soa + row * stride + lane), right.load(row, lane))));
+        },
+        [](auto acc) { return acc; },
+        [&](T acc, std::size_t row, std::size_t lane) { return scalar_max(acc, scalar_abs(soa[row * stride + lane] - right.get(row, lane))); },
+        [](T acc) { return acc; });
+}
+
+} // namespace kuukan::simd
@@ -0,0 +1,387 @@
+/**
+ * @file executor.hpp
+ * @brief Executors shared by the parallel algorithms
+ *
+ * Every kuukan entry point that processes many elements at once
+ * (pairwise_distances, HNSWIndex construction and batch queries, the
+ * batched ElementBatch operations) takes an optional executor argument and
+ * hands its work to it as one bulk call. By default they all use
+ * default_executor(), a single process-wide WorkStealingPool, so the
+ * algorithms share one set of threads instead of each starting its own;
+ * callers can pass their own pool, InlineExecutor for serial execution, or
+ * any type satisfying ExecutorLike.
+ *
+ * @code{.cpp}
+ * kuukan::WorkStealingPool pool(kuukan::WorkStealingPoolOptions{.thread_count = 8, .pin_threads = true});
+ * kuukan::pairwise_distances(MySpace{}, lhs, rhs, out, {}, pool);
+ * kuukan::HNSWIndex<MySpace> index{points, MySpace{}, {}, pool};
+ * @endcode
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <cstdlib>
+#include <fstream>
+#include <sched.h>
+#include <pthread.h>
+#include <string>
+#endif
+
+namespace kuukan {
+
+/**
+ * @brief Concept for executors of bulk work
+ *
+ * @tparam E The type to check
+ *
+ * An executor reports how many tasks it can run at once and runs
+ * `task(index)` for every index below count, returning when all calls have
+ * finished. The calls may run concurrently and in any order; tasks must not
+ * throw. bulk may be called from inside a task.
+ *
+ * @code{.cpp}
+ * struct SerialExecutor {
+ *     std::size_t concurrency() const noexcept { return 1; }
+ *     template <typename Task>
+ *     void bulk(std::size_t count, Task&& task) { for (std::size_t i = 0; i < count; ++i) task(i); }
+ * };
+ * @endcode
+ */
+template <typename E>
+concept ExecutorLike = requires(E& executor, std::size_t count, void (&task)(std::size_t)) {
+    { executor.concurrency() } -> std::convertible_to<std::size_t>;
+    executor.bulk(count, task);
+};
+
+/// @brief Executor that runs every task on the calling thread, in index order
+struct InlineExecutor {
+    /// @brief One task at a time
+    constexpr std::size_t concurrency() const noexcept { return 1; }
+
+    /// @brief Call task(index) for index = 0 .. count - 1
+    template <typename Task>
+    constexpr void bulk(std::size_t count, Task&& task) const {
+        for (std::size_t index = 0; index < count; ++index) {
+            task(index);
+        }
+    }
+};
+
+/// @brief Construction parameters of a WorkStealingPool
+struct WorkStealingPoolOptions {
+    /// @brief Threads running tasks, including the thread that calls bulk; 0 selects std::thread::hardware_concurrency()
+    std::size_t thread_count = 0;
+
+    /// @brief Pin each worker to one CPU, filling one NUMA node after another (Linux only, ignored elsewhere)
+    bool pin_threads = false;
+};
+
+namespace detail {
+
+/// @brief CPUs the process may run on, ordered node by node when the NUMA topology is known
+inline std::vector<int> pinning_order() {
+    std::vector<int> order;
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return order;
+    }
+    std::vector<bool> taken(CPU_SETSIZE, false);
+    auto add = [&](int cpu) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed) && !taken[cpu]) {
+            taken[cpu] = true;
+            order.push_back(cpu);
+        }
+    };
+    // cpulist holds ranges such as "0-15,32-47"
+    for (int node = 0;; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            break;
+        }
+        std::string list;
+        std::getline(file, list);
+        const char* cursor = list.c_str();
+        while (*cursor != '\0') {
+            char* end = nullptr;
+            const long first = std::strtol(cursor, &end, 10);
+            if (end == cursor) {
+                break;
+            }
+            long last = first;
+            if (*end == '-') {
+                cursor = end + 1;
+                last = std::strtol(cursor, &end, 10);
+            }
+            for (long cpu = first; cpu <= last; ++cpu) {
+                add(static_cast<int>(cpu));
+            }
+            cursor = *end == ',' ? end + 1 : end;
+        }
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        add(cpu);
+    }
+#endif
+    return order;
+}
+
+/// @brief Pin the calling thread to one CPU
+inline void pin_current_thread([[maybe_unused]] int cpu) noexcept {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Thread pool with one task deque per worker and work stealing
+ *
+ * bulk splits its index range into a few chunks per thread and deals
+ * them out to the worker deques (all to its own deque when called from a
+ * worker). Each worker takes tasks from the back of its own deque (the
+ * most recent, whose data is still in cache) and, when that is empty,
+ * steals from the front of the others, so uneven tasks balance out. The
+ * calling thread runs tasks as well until its bulk call is complete, which
+ * also makes nested bulk calls from inside tasks safe.
+ *
+ * Idle workers sleep on a condition variable. The destructor waits for
+ * the workers to finish (no bulk call may be in progress).
+ */
+class WorkStealingPool {
+public:
+    /// @brief Start a pool with the given number of threads (0: std::thread::hardware_concurrency())
+    explicit WorkStealingPool(std::size_t thread_count = 0)
+        : WorkStealingPool(WorkStealingPoolOptions{thread_count, false}) {}
+
+    /// @brief Start a pool with the given options
+    explicit WorkStealingPool(WorkStealingPoolOptions options) {
+        const std::size_t threads = options.thread_count != 0
+            ? options.thread_count
+            : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        const std::vector<int> cpus = options.pin_threads ? detail::pinning_order() : std::vector<int>{};
+        queue_count_ = threads - 1;
+        queues_ = std::make_unique<Queue[]>(queue_count_);
+        workers_.reserve(queue_count_);
+        for (std::size_t worker = 0; worker + 1 < threads; ++worker) {
+            const int cpu = cpus.empty() ? -1 : cpus[worker % cpus.size()];
+            workers_.emplace_back([this, worker, cpu] { run_worker(worker, cpu); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& thread : workers_) {
+            thread.join();
+        }
+    }
+
+    /// @brief Number of threads running tasks (the workers and the calling thread)
+    std::size_t concurrency() const noexcept { return queue_count_ + 1; }
+
+    /**
+     * @brief Call task(index) for every index below count and wait for completion
+     *
+     * @param count The number of calls
+     * @param task The callable; invoked concurrently from several threads
+     */
+    template <typename Task>
+    void bulk(std::size_t count, Task&& task) {
+        if (count == 0) {
+            return;
+        }
+        if (queue_count_ == 0 || count == 1) {
+            for (std::size_t index = 0; index < count; ++index) {
+                task(index);
+            }
+            return;
+        }
+
+        using TaskType = std::remove_reference_t<Task>;
+        Group group;
+        group.context = const_cast<void*>(static_cast<const void*>(std::addressof(task)));
+        group.invoke = [](void* context, std::size_t index) { (*static_cast<TaskType*>(context))(index); };
+
+        const std::size_t chunks = std::min(count, 4 * concurrency());
+        const std::size_t chunk_size = (count + chunks - 1) / chunks;
+        const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+        group.pending.store(chunk_count, std::memory_order_relaxed);
+        queued_.fetch_add(chunk_count, std::memory_order_release);
+
+        const std::size_t own = current_worker();
+        std::size_t target = next_queue_.fetch_add(1, std::memory_order_relaxed);
+        for (std::size_t begin = 0; begin < count; begin += chunk_size) {
+            const std::size_t queue = own != no_worker ? own : target++ % queue_count_;
+            std::lock_guard lock(queues_[queue].mutex);
+            queues_[queue].tasks.push_back(Chunk{&group, begin, std::min(begin + chunk_size, count)});
+        }
+        {
+            std::lock_guard lock(sleep_mutex_);
+        }
+        wake_.notify_all();
+
+        // Help until every chunk of this call has run
+        while (group.pending.load(std::memory_order_acquire) != 0) {
+            if (!run_one(own == no_worker ? 0 : own)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t no_worker = static_cast<std::size_t>(-1);
+
+    struct Group {
+        void (*invoke)(void*, std::size_t) = nullptr;
+        void*                    context = nullptr;
+        std::atomic<std::size_t> pending{0};
+    };
+
+    struct Chunk {
+        Group*      group;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct Queue {
+        std::mutex        mutex;
+        std::deque<Chunk> tasks;
+    };
+
+    /// @brief Index of the calling thread among the workers of this pool, or no_worker
+    std::size_t current_worker() const noexcept {
+        return current_pool() == this ? current_index() : no_worker;
+    }
+
+    static const WorkStealingPool*& current_pool() noexcept {
+        static thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+
+    static std::size_t& current_index() noexcept {
+        static thread_local std::size_t index = no_worker;
+        return index;
+    }
+
+    /// @brief Run one chunk: from the back of queue home, else stolen from the front of another
+    bool run_one(std::size_t home) {
+        Chunk chunk{};
+        bool found = false;
+        {
+            std::lock_guard lock(queues_[home].mutex);
+            if (!queues_[home].tasks.empty()) {
+                chunk = queues_[home].tasks.back();
+                queues_[home].tasks.pop_back();
+                found = true;
+            }
+        }
+        for (std::size_t offset = 1; !found && offset < queue_count_; ++offset) {
+            Queue& victim = queues_[(home + offset) % queue_count_];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                chunk = victim.tasks.front();
+                victim.tasks.pop_front();
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        for (std::size_t index = chunk.begin; index < chunk.end; ++index) {
+            chunk.group->invoke(chunk.group->context, index);
+        }
+        chunk.group->pending.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    void run_worker(std::size_t worker, int cpu) {
+        if (cpu >= 0) {
+            detail::pin_current_thread(cpu);
+        }
+        current_pool() = this;
+        current_index() = worker;
+        for (;;) {
+            if (run_one(worker)) {
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [&] { return stopping_ || queued_.load(std::memory_order_acquire) != 0; });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    std::size_t                queue_count_ = 0;
+    std::unique_ptr<Queue[]>   queues_;
+    std::vector<std::thread>   workers_;
+    std::atomic<std::size_t>   queued_{0};
+    std::atomic<std::size_t>   next_queue_{0};
+    std::mutex                 sleep_mutex_;
+    std::condition_variable    wake_;
+    bool                       stopping_ = false;
+};
+
+/// @brief The process-wide pool used by every algorithm that is not given an executor
+inline WorkStealingPool& default_executor() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+/**
+ * @brief Split [0, count) into chunks and run body(begin, end) for each on an executor
+ *
+ * @param executor The executor
+ * @param count The size of the range
+ * @param grain The minimum chunk size; chunk boundaries are multiples of it
+ * @param body Called with disjoint half-open ranges covering [0, count)
+ *
+ * Runs body(0, count) on the calling thread when the range holds a single
+ * chunk.
+ */
+template <ExecutorLike Executor, typename Body>
+void parallel_for(Executor& executor, std::size_t count, std::size_t grain, Body&& body) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t grains = (count + grain - 1) / grain;
+    const std::size_t chunks = std::min(grains, 4 * std::max<std::size_t>(executor.concurrency(), 1));
+    if (chunks <= 1) {
+        body(std::size_t(0), count);
+        return;
+    }
+    const std::size_t chunk_size = (grains + chunks - 1) / chunks * grain;
+    executor.bulk((count + chunk_size - 1) / chunk_size, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * chunk_size;
+        body(begin, std::min(begin + chunk_size, count));
+    });
+}
+
+} // namespace kuukan
@@ -0,0 +1,437 @@
+/**
+ * @file chebyshev_space.hpp
+ * @brief Function space of truncated Chebyshev expansions
+ *
+ * This file provides ChebyshevFunction, a function on an interval stored as
+ * the N coefficients of its Chebyshev expansion
+ *
+ *     f(x) = sum_{k < N} c_k T_k(t),   t = (x - midpoint) / half_width,
+ *
+ * and ChebyshevSpace, a VectorSpace over it. Since the expansion is linear
+ * in its coefficients, every vector space operation is a SIMD operation on
+ * a fixed-size coefficient array (the dense backend's kernels), and
+ * evaluation is a Clenshaw recurrence. Elements are trivially copyable and
+ * live entirely in their N coefficients.
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/norm/normed_space.hpp"
+#include "kuukan/dense/simd.hpp"
+#include "kuukan/dense/dense_vector_space.hpp"
+#include "kuukan/function/domain.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Truncated Chebyshev expansion of a function on an interval
+ *
+ * @tparam T The scalar type
+ * @tparam N The number of coefficients (degree N - 1)
+ * @tparam Domain The interval (must satisfy IntervalDomainLike)
+ *
+ * ChebyshevFunction is an aggregate over a DenseVector<T, N> of
+ * coefficients; value-initialization gives the zero function.
+ *
+ * @code{.cpp}
+ * using F = kuukan::ChebyshevFunction<double, 32, kuukan::Interval<double, 0.0, 2.0>>;
+ * F f = F::interpolate([](double x) { return std::exp(-x) * std::sin(4 * x); });
+ * double y = f(0.75);
+ * @endcode
+ */
+template <std::floating_point T, std::size_t N, IntervalDomainLike Domain = ReferenceInterval<T>>
+requires (N > 0) && std::same_as<typename Domain::scalar_type, T>
+struct ChebyshevFunction {
+    /// @brief Type alias for the scalar type
+    using scalar_type      = T;
+
+    /// @brief Type alias for the domain policy
+    using domain_type      = Domain;
+
+    /// @brief Type alias for the coefficient storage
+    using coefficient_type = DenseVector<T, N>;
+
+    /// @brief The number of coefficients
+    static constexpr std::size_t order = N;
+
+    /// @brief The Chebyshev coefficients c_0 .. c_{N-1}
+    coefficient_type coefficients;
+
+    /// @brief The constant function c
+    static constexpr ChebyshevFunction constant(T value) noexcept {
+        ChebyshevFunction result{};
+        result.coefficients[0] = value;
+        return result;
+    }
+
+    /// @brief The identity function x on the domain
+    static constexpr ChebyshevFunction identity() noexcept requires (N >= 2) {
+        ChebyshevFunction result{};
+        result.coefficients[0] = Domain::midpoint;
+        result.coefficients[1] = Domain::half_width;
+        return result;
+    }
+
+    /**
+     * @brief The N interpolation nodes (Chebyshev points of the first kind) in the domain
+     *
+     * Computed once per instantiation.
+     */
+    static const std::array<T, N>& points() {
+        static const std::array<T, N> nodes = [] {
+            std::array<T, N> result{};
+            for (std::size_t j = 0; j < N; ++j) {
+                result[j] = Domain::from_reference(std::cos(std::numbers::pi_v<T> * (T(j) + T(0.5)) / T(N)));
+            }
+            return result;
+        }();
+        return nodes;
+    }
+
+    /**
+     * @brief Interpolate a function at the Chebyshev points
+     *
+     * @param function Callable T -> T; a function object with a batched
+     *        `evaluate(std::span<const T>, std::span<T>)` member (such as
+     *        CompiledFunction) is evaluated at all points in one call
+     * @return The expansion agreeing with function at points()
+     *
+     * The coefficients are a discrete cosine transform of the samples,
+     * computed as N dot products against a cached N × N table.
+     */
+    template <typename Function>
+    static ChebyshevFunction interpolate(const Function& function) {
+        const std::array<T, N>& nodes = points();
+        std::array<T, N> samples;
+        if constexpr (requires { function.evaluate(std::span<const T>(nodes), std::span<T>(samples)); }) {
+            function.evaluate(std::span<const T>(nodes), std::span<T>(samples));
+        } else {
+            for (std::size_t j = 0; j < N; ++j) {
+                samples[j] = static_cast<T>(function(nodes[j]));
+            }
+        }
+        const std::array<T, N * N>& table = transform_table();
+        ChebyshevFunction result{};
+        for (std::size_t k = 0; k < N; ++k) {
+            result.coefficients[k] = simd::dot<T, N>(table.data() + k * N, samples.data(), N);
+        }
+        return result;
+    }
+
+    /// @brief Evaluate at one point of the domain (Clenshaw recurrence)
+    T operator()(T point) const noexcept {
+        const T t = (point - Domain::midpoint) * inverse_half_width;
+        const T two_t = t + t;
+        T next = T{};
+        T after_next = T{};
+        for (std::size_t k = N - 1; k >= 1; --k) {
+            const T current = coefficients[k] + two_t * next - after_next;
+            after_next = next;
+            next = current;
+        }
+        return coefficients[0] + t * next - after_next;
+    }
+
+    /**
+     * @brief Evaluate at every point of an array
+     *
+     * @param points The arguments (in the domain)
+     * @param values Output buffer of at least points.size() values (may alias points)
+     *
+     * The recurrence runs on SIMD registers holding several points at once.
+     */
+    void evaluate(std::span<const T> points, std::span<T> values) const noexcept {
+        assert(values.size() >= points.size());
+        using traits = simd::native<T>;
+        const T* in = points.data();
+        T* out = values.data();
+        simd::for_each_block<T, std::dynamic_extent>(points.size(),
+            [&](traits, std::size_t i) {
+                const auto t = traits::mul(traits::sub(traits::load(in + i), traits::broadcast(Domain::midpoint)),
+                                           traits::broadcast(inverse_half_width));
+                const auto two_t = traits::add(t, t);
+                auto next = traits::zero();
+                auto after_next = traits::zero();
+                for (std::size_t k = N - 1; k >= 1; --k) {
+                    const auto current = traits::fma(two_t, next,
+                                                     traits::sub(traits::broadcast(coefficients[k]), after_next));
+                    after_next = next;
+                    next = current;
+                }
+                traits::store(out + i, traits::fma(t, next,
+                                                   traits::sub(traits::broadcast(coefficients[0]), after_next)));
+            },
+            [&](std::size_t i) { out[i] = (*this)(in[i]); });
+    }
+
+private:
+    static constexpr T inverse_half_width = T(1) / Domain::half_width;
+
+    /// @brief Row k holds (2 / N) cos(k theta_j), halved for k = 0
+    static const std::array<T, N * N>& transform_table() {
+        static const std::array<T, N * N> table = [] {
+            std::array<T, N * N> result{};
+            for (std::size_t k = 0; k < N; ++k) {
+                const T weight = (k == 0 ? T(1) : T(2)) / T(N);
+                for (std::size_t j = 0; j < N; ++j) {
+                    result[k * N + j] = weight * std::cos(std::numbers::pi_v<T> * T(k) * (T(j) + T(0.5)) / T(N));
+                }
+            }
+            return result;
+        }();
+        return table;
+    }
+};
+
+/**
+ * @brief Vector space operations on ChebyshevFunction
+ *
+ * @tparam T The scalar type
+ * @tparam N The number of coefficients
+ * @tparam Domain The interval
+ *
+ * All operations act on the coefficient arrays through the dense SIMD
+ * kernels. Equality compares the coefficients up to a relative tolerance,
+ * since coefficients computed along different paths (e.g. interpolating
+ * f + g versus adding the interpolants) agree only up to rounding.
+ */
+template <std::floating_point T, std::size_t N, IntervalDomainLike Domain = ReferenceInterval<T>>
+struct ChebyshevOperations {
+    /// @brief Type alias for the element type
+    using element_type = ChebyshevFunction<T, N, Domain>;
+
+    /// @brief Relative tolerance of Equality
+    static constexpr T equality_tolerance = T(64) * std::numeric_limits<T>::epsilon();
+
+    /// @brief Coefficientwise sum
+    struct Addition {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            element_type result;
+            simd::add<T, N>(left.coefficients.data(), right.coefficients.data(), result.coefficients.data(), N);
+            return result;
+        }
+    };
+
+    /// @brief Coefficientwise difference
+    struct Subtraction {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            element_type result;
+            simd::subtract<T, N>(left.coefficients.data(), right.coefficients.data(), result.coefficients.data(), N);
+            return result;
+        }
+    };
+
+    /// @brief Coefficientwise scaling
+    struct ScalarAction {
+        element_type operator()(const T& scalar_value, const element_type& element) const {
+            element_type result;
+            simd::scale<T, N>(scalar_value, element.coefficients.data(), result.coefficients.data(), N);
+            return result;
+        }
+    };
+
+    /// @brief Coefficientwise negation
+    struct Negation {
+        element_type operator()(const element_type& element) const {
+            element_type result;
+            simd::negate<T, N>(element.coefficients.data(), result.coefficients.data(), N);
+            return result;
+        }
+    };
+
+    /// @brief The zero function
+    struct ZeroSupplier {
+        constexpr element_type operator()() const { return element_type{}; }
+    };
+
+    /**
+     * @brief Equality up to equality_tolerance
+     *
+     * Holds when sum_k |a_k - b_k| <= equality_tolerance * max(sum_k |a_k|, sum_k |b_k|).
+     * Since |T_k| <= 1 on the interval, the left-hand side bounds the largest
+     * pointwise difference of the two functions.
+     */
+    struct Equality {
+        bool operator()(const element_type& left, const element_type& right) const {
+            const T* a = left.coefficients.data();
+            const T* b = right.coefficients.data();
+            const T difference = simd::sum_abs_difference<T, N>(a, b, N);
+            const T scale = std::max(simd::sum_abs<T, N>(a, N), simd::sum_abs<T, N>(b, N));
+            return difference <= equality_tolerance * scale;
+        }
+    };
+
+    /// @brief Fused scalar_value * x + y on the coefficients
+    struct Axpy {
+        element_type operator()(const T& scalar_value, const element_type& x, const element_type& y) const {
+            element_type result;
+            simd::axpy<T, N>(scalar_value, x.coefficients.data(), y.coefficients.data(), result.coefficients.data(), N);
+            return result;
+        }
+    };
+
+    /// @brief Fused linear combination in one pass over the coefficients
+    struct LinearCombination {
+        element_type operator()(std::span<const LinearTerm<T, element_type>> terms) const {
+            if (terms.empty()) {
+                return element_type{};
+            }
+            constexpr std::size_t inline_capacity = 16;
+            std::array<T, inline_capacity> inline_coefficients;
+            std::array<const T*, inline_capacity> inline_elements;
+            std::vector<T> heap_coefficients;
+            std::vector<const T*> heap_elements;
+            T* coefficients = inline_coefficients.data();
+            const T** elements = inline_elements.data();
+            if (terms.size() > inline_capacity) {
+                heap_coefficients.resize(terms.size());
+                heap_elements.resize(terms.size());
+                coefficients = heap_coefficients.data();
+                elements = heap_elements.data();
+            }
+            for (std::size_t index = 0; index < terms.size(); ++index) {
+                coefficients[index] = terms[index].coefficient;
+                elements[index] = terms[index].element.coefficients.data();
+            }
+            element_type result;
+            simd::linear_combination<T, N>(coefficients, elements, terms.size(), result.coefficients.data(), N);
+            return result;
+        }
+    };
+
+    /// @brief In-place target += right
+    struct AddAssign {
+        void operator()(element_type& target, const element_type& right) const {
+            simd::add<T, N>(target.coefficients.data(), right.coefficients.data(), target.coefficients.data(), N);
+        }
+    };
+
+    /// @brief In-place target *= scalar_value
+    struct ScaleAssign {
+        void operator()(const T& scalar_value, element_type& target) const {
+            simd::scale<T, N>(scalar_value, target.coefficients.data(), target.coefficients.data(), N);
+        }
+    };
+
+    /// @brief In-place target = -target
+    struct NegateInPlace {
+        void operator()(element_type& target) const {
+            simd::negate<T, N>(target.coefficients.data(), target.coefficients.data(), N);
+        }
+    };
+};
+
+/**
+ * @brief Vector space of truncated Chebyshev expansions
+ *
+ * @tparam T The scalar type
+ * @tparam N The number of coefficients
+ * @tparam Domain The interval
+ *
+ * All optional slots of VectorSpace are filled with coefficient kernels.
+ *
+ * @code{.cpp}
+ * using CS = kuukan::ChebyshevSpace<double, 16>;
+ * using F  = CS::element_type;
+ * F f = F::interpolate([](double x) { return std::sin(x); });
+ * F g = F::interpolate([](double x) { return std::cos(x); });
+ * F h = CS::axpy(2.0, f, g);   // 2 sin + cos, 16 fused multiply-adds
+ * @endcode
+ */
+template <std::floating_point T, std::size_t N, IntervalDomainLike Domain = ReferenceInterval<T>>
+struct ChebyshevSpace : VectorSpace<
+    ChebyshevFunction<T, N, Domain>, T,
+    typename ChebyshevOperations<T, N, Domain>::Addition,
+    typename ChebyshevOperations<T, N, Domain>::ScalarAction,
+    typename ChebyshevOperations<T, N, Domain>::Negation,
+    typename ChebyshevOperations<T, N, Domain>::ZeroSupplier,
+    typename ChebyshevOperations<T, N, Domain>::Equality,
+    typename ChebyshevOperations<T, N, Domain>::Axpy,
+    typename ChebyshevOperations<T, N, Domain>::LinearCombination,
+    typename ChebyshevOperations<T, N, Domain>::AddAssign,
+    typename ChebyshevOperations<T, N, Domain>::ScaleAssign,
+    typename ChebyshevOperations<T, N, Domain>::NegateInPlace,
+    typename ChebyshevOperations<T, N, Domain>::Subtraction> {
+    /// @brief The number of coefficients
+    static constexpr std::size_t order = N;
+};
+
+/**
+ * @brief Fused Chebyshev-weighted L2 distance computed on the coefficients
+ *
+ * @see ChebyshevWeightedL2Norm
+ */
+template <std::floating_point T, std::size_t N, IntervalDomainLike Domain = ReferenceInterval<T>>
+struct ChebyshevWeightedL2DifferenceNorm {
+    T operator()(const ChebyshevFunction<T, N, Domain>& left, const ChebyshevFunction<T, N, Domain>& right) const {
+        const T* a = left.coefficients.data();
+        const T* b = right.coefficients.data();
+        const T first = a[0] - b[0];
+        return std::sqrt(weight * (simd::sum_squared_difference<T, N>(a, b, N) + first * first));
+    }
+
+    /// @brief half_width * pi / 2, the Gram factor of T_k for k >= 1
+    static constexpr T weight = Domain::half_width * std::numbers::pi_v<T> / T(2);
+};
+
+/**
+ * @brief L2 norm with the Chebyshev weight 1 / sqrt(1 - t^2)
+ *
+ * @tparam T The scalar type
+ * @tparam N The number of coefficients
+ * @tparam Domain The interval
+ *
+ *     ||f||^2 = integral over the domain of f(x)^2 / sqrt(1 - t(x)^2) dx
+ *             = half_width * pi / 2 * (2 c_0^2 + sum_{k >= 1} c_k^2)
+ *
+ * The Chebyshev polynomials are orthogonal for this weight, so the norm is
+ * exact and costs one pass over the coefficients. The unweighted sup and
+ * L^p norms need quadrature or sampling of the function.
+ */
+template <std::floating_point T, std::size_t N, IntervalDomainLike Domain = ReferenceInterval<T>>
+struct ChebyshevWeightedL2Norm {
+    using difference_norm = ChebyshevWeightedL2DifferenceNorm<T, N, Domain>;
+    using bounded_difference_norm = NotInjected;
+    using comparable_difference_norm = NotInjected;
+
+    T operator()(const ChebyshevFunction<T, N, Domain>& element) const {
+        const T* c = element.coefficients.data();
+        return std::sqrt(difference_norm::weight * (simd::sum_squares<T, N>(c, N) + c[0] * c[0]));
+    }
+};
+
+/**
+ * @brief Normed space over ChebyshevSpace
+ *
+ * @tparam T The scalar type
+ * @tparam N The number of coefficients
+ * @tparam Domain The interval
+ * @tparam Norm A norm template over (T, N, Domain) naming its difference_norm,
+ *         bounded_difference_norm and comparable_difference_norm
+ *
+ * @code{.cpp}
+ * using CN = kuukan::ChebyshevNormedSpace<double, 16>;
+ * double d = CN::distance(f, g);   // weighted L2, one pass over 16 coefficients
+ * @endcode
+ */
+template <std::floating_point T, std::size_t N, IntervalDomainLike Domain = ReferenceInterval<T>,
+          template <typename, std::size_t, typename> class Norm = ChebyshevWeightedL2Norm>
+using ChebyshevNormedSpace = NormedSpace<ChebyshevSpace<T, N, Domain>,
+                                         Norm<T, N, Domain>,
+                                         typename Norm<T, N, Domain>::difference_norm,
+                                         typename Norm<T, N, Domain>::bounded_difference_norm,
+                                         typename Norm<T, N, Domain>::comparable_difference_norm>;
+
+} // namespace kuukan
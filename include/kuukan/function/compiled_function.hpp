@@ -0,0 +1,826 @@
+/**
+ * @file compiled_function.hpp
+ * @brief Function-space elements stored as flattened expression programs
+ *
+ * This file provides CompiledFunction, a real function of one real variable
+ * represented as a small program: a topologically ordered array of
+ * instructions (a DAG) in which structurally identical subexpressions are
+ * stored once. Vector space operations merge the operands' programs instead
+ * of wrapping them in closures, and a batched interpreter evaluates a whole
+ * array of points per instruction, so the cost of an evaluation does not
+ * grow with the nesting depth of the expression.
+ *
+ * CompiledFunctionSpace assembles the operations into a VectorSpace.
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/dense/simd.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Instruction set of CompiledFunction programs
+ *
+ * Operands are referred to by instruction index; every operand precedes the
+ * instruction that uses it.
+ */
+enum class FunctionOpcode : std::uint8_t {
+    constant,   ///< c
+    variable,   ///< x
+    callable,   ///< leaf(x) for a user-supplied callable (operand: leaf index)
+    add,        ///< f + g
+    subtract,   ///< f - g
+    multiply,   ///< f * g (pointwise)
+    scale,      ///< c * f
+    axpy,       ///< c * f + g
+    negate,     ///< -f
+    sin,        ///< sin(f)
+    cos,        ///< cos(f)
+    exp,        ///< exp(f)
+    log,        ///< log(f)
+    sqrt,       ///< sqrt(f)
+    abs         ///< |f|
+};
+
+/// @brief Number of instruction operands taken by an opcode
+constexpr std::size_t function_opcode_arity(FunctionOpcode opcode) noexcept {
+    switch (opcode) {
+    case FunctionOpcode::constant:
+    case FunctionOpcode::variable:
+    case FunctionOpcode::callable:
+        return 0;
+    case FunctionOpcode::add:
+    case FunctionOpcode::subtract:
+    case FunctionOpcode::multiply:
+    case FunctionOpcode::axpy:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief One instruction of a CompiledFunction program
+ *
+ * @tparam T The scalar type
+ */
+template <typename T>
+struct FunctionInstruction {
+    /// @brief The operation
+    FunctionOpcode opcode = FunctionOpcode::constant;
+
+    /// @brief First operand (instruction index; leaf index for callable)
+    std::uint32_t left = 0;
+
+    /// @brief Second operand (instruction index)
+    std::uint32_t right = 0;
+
+    /// @brief Immediate value of constant, scale and axpy
+    T constant{};
+
+    friend bool operator==(const FunctionInstruction&, const FunctionInstruction&) = default;
+};
+
+/**
+ * @brief User-supplied leaf function of a CompiledFunction
+ *
+ * @tparam T The scalar type
+ */
+template <typename T>
+struct FunctionLeaf {
+    /// @brief The callable evaluated at x
+    std::function<T(T)> evaluate;
+
+    /// @brief Name used when printing expressions
+    std::string name;
+};
+
+/**
+ * @brief Immutable program shared by CompiledFunction elements
+ *
+ * @tparam T The scalar type
+ *
+ * The last instruction is the result. Each instruction other than the
+ * result and x has a scratch register; registers are reused once their
+ * value is dead, so register_count is usually much smaller than the number
+ * of instructions.
+ */
+template <typename T>
+struct FunctionProgram {
+    /// @brief Register index of instructions that do not need one
+    static constexpr std::uint32_t no_register = std::numeric_limits<std::uint32_t>::max();
+
+    /// @brief The instructions in evaluation order
+    std::vector<FunctionInstruction<T>> instructions;
+
+    /// @brief Scratch register of every instruction (or no_register)
+    std::vector<std::uint32_t> registers;
+
+    /// @brief Number of distinct scratch registers
+    std::uint32_t register_count = 0;
+
+    /// @brief Callables referenced by callable instructions
+    std::vector<std::shared_ptr<const FunctionLeaf<T>>> leaves;
+};
+
+namespace detail {
+
+/// @brief Value of a non-leaf instruction at one point, given its operand values
+template <typename T>
+T apply_function_opcode(const FunctionInstruction<T>& instruction, T left, T right) {
+    using std::sin; using std::cos; using std::exp; using std::log; using std::sqrt; using std::abs;
+    switch (instruction.opcode) {
+    case FunctionOpcode::add:      return left + right;
+    case FunctionOpcode::subtract: return left - right;
+    case FunctionOpcode::multiply: return left * right;
+    case FunctionOpcode::scale:    return instruction.constant * left;
+    case FunctionOpcode::axpy:     return instruction.constant * left + right;
+    case FunctionOpcode::negate:   return -left;
+    case FunctionOpcode::sin:      return sin(left);
+    case FunctionOpcode::cos:      return cos(left);
+    case FunctionOpcode::exp:      return exp(left);
+    case FunctionOpcode::log:      return log(left);
+    case FunctionOpcode::sqrt:     return sqrt(left);
+    case FunctionOpcode::abs:      return abs(left);
+    default:                       return instruction.constant;
+    }
+}
+
+/**
+ * @brief Incremental construction of a FunctionProgram
+ *
+ * Instructions are simplified (constant folding, identities such as
+ * 1 * f = f and f + 0 = f) and looked up in a hash table before they are
+ * appended, so every distinct subexpression is stored once. finish() drops
+ * instructions the result does not depend on and assigns registers.
+ */
+template <typename T>
+class FunctionProgramBuilder {
+public:
+    using instruction_type = FunctionInstruction<T>;
+    using program_type     = FunctionProgram<T>;
+
+    /// @brief Append the instructions of an existing program; returns the index of its result
+    std::uint32_t import(const program_type& program) {
+        std::vector<std::uint32_t> remap(program.instructions.size());
+        for (std::size_t index = 0; index < program.instructions.size(); ++index) {
+            instruction_type instruction = program.instructions[index];
+            if (instruction.opcode == FunctionOpcode::callable) {
+                instruction.left = leaf_index(program.leaves[instruction.left]);
+            } else {
+                const std::size_t arity = function_opcode_arity(instruction.opcode);
+                if (arity >= 1) { instruction.left = remap[instruction.left]; }
+                if (arity == 2) { instruction.right = remap[instruction.right]; }
+            }
+            remap[index] = emit(instruction);
+        }
+        return remap.back();
+    }
+
+    /// @brief Append a callable instruction for a leaf; returns its index
+    std::uint32_t leaf(std::shared_ptr<const FunctionLeaf<T>> function_leaf) {
+        return emit(instruction_type{FunctionOpcode::callable, leaf_index(function_leaf), 0, T{}});
+    }
+
+    /// @brief Append a simplified, deduplicated instruction; returns the index holding its value
+    std::uint32_t emit(instruction_type instruction) {
+        const std::size_t arity = function_opcode_arity(instruction.opcode);
+        if (arity != 0) {
+            const instruction_type& left = instructions_[instruction.left];
+            const instruction_type& right = instructions_[arity == 2 ? instruction.right : instruction.left];
+            if (left.opcode == FunctionOpcode::constant && right.opcode == FunctionOpcode::constant) {
+                return constant(apply_function_opcode(instruction, left.constant, right.constant));
+            }
+            if (const auto simplified = simplify(instruction); simplified != no_index) {
+                return simplified;
+            }
+        }
+        if (instruction.opcode == FunctionOpcode::constant || instruction.opcode == FunctionOpcode::variable
+            || instruction.opcode == FunctionOpcode::callable) {
+            instruction.right = 0;
+            if (instruction.opcode != FunctionOpcode::callable) { instruction.left = 0; }
+        }
+        const auto [position, inserted] = lookup_.try_emplace(instruction, static_cast<std::uint32_t>(instructions_.size()));
+        if (inserted) {
+            instructions_.push_back(instruction);
+        }
+        return position->second;
+    }
+
+    /// @brief Append (or find) the constant c
+    std::uint32_t constant(T value) {
+        return emit(instruction_type{FunctionOpcode::constant, 0, 0, value});
+    }
+
+    /// @brief Build the program computing the value of instruction result
+    std::shared_ptr<const program_type> finish(std::uint32_t result) {
+        // Keep only instructions reachable from the result, in their original order
+        std::vector<bool> reachable(result + 1, false);
+        reachable[result] = true;
+        for (std::size_t index = result + 1; index-- > 0;) {
+            if (!reachable[index]) { continue; }
+            const instruction_type& instruction = instructions_[index];
+            const std::size_t arity = function_opcode_arity(instruction.opcode);
+            if (arity >= 1) { reachable[instruction.left] = true; }
+            if (arity == 2) { reachable[instruction.right] = true; }
+        }
+
+        auto program = std::make_shared<program_type>();
+        std::vector<std::uint32_t> remap(result + 1);
+        std::vector<std::uint32_t> leaf_remap(leaves_.size(), program_type::no_register);
+        for (std::size_t index = 0; index <= result; ++index) {
+            if (!reachable[index]) { continue; }
+            instruction_type instruction = instructions_[index];
+            if (instruction.opcode == FunctionOpcode::callable) {
+                if (leaf_remap[instruction.left] == program_type::no_register) {
+                    leaf_remap[instruction.left] = static_cast<std::uint32_t>(program->leaves.size());
+                    program->leaves.push_back(leaves_[instruction.left]);
+                }
+                instruction.left = leaf_remap[instruction.left];
+            } else {
+                const std::size_t arity = function_opcode_arity(instruction.opcode);
+                if (arity >= 1) { instruction.left = remap[instruction.left]; }
+                if (arity == 2) { instruction.right = remap[instruction.right]; }
+            }
+            remap[index] = static_cast<std::uint32_t>(program->instructions.size());
+            program->instructions.push_back(instruction);
+        }
+        assign_registers(*program);
+        return program;
+    }
+
+private:
+    static constexpr std::uint32_t no_index = std::numeric_limits<std::uint32_t>::max();
+
+    struct InstructionHash {
+        std::size_t operator()(const instruction_type& instruction) const noexcept {
+            std::size_t hash = static_cast<std::size_t>(instruction.opcode);
+            auto mix = [&](std::size_t value) { hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+            mix(instruction.left);
+            mix(instruction.right);
+            mix(std::hash<T>{}(instruction.constant));
+            return hash;
+        }
+    };
+
+    std::uint32_t leaf_index(const std::shared_ptr<const FunctionLeaf<T>>& function_leaf) {
+        const auto found = std::find(leaves_.begin(), leaves_.end(), function_leaf);
+        if (found != leaves_.end()) {
+            return static_cast<std::uint32_t>(found - leaves_.begin());
+        }
+        leaves_.push_back(function_leaf);
+        return static_cast<std::uint32_t>(leaves_.size() - 1);
+    }
+
+    bool is_constant(std::uint32_t index, T value) const {
+        return instructions_[index].opcode == FunctionOpcode::constant && instructions_[index].constant == value;
+    }
+
+    /// @brief Algebraic identities; returns no_index when none applies
+    std::uint32_t simplify(instruction_type& instruction) {
+        const std::uint32_t left = instruction.left;
+        const std::uint32_t right = instruction.right;
+        const instruction_type& operand = instructions_[left];
+        switch (instruction.opcode) {
+        case FunctionOpcode::add:
+            if (is_constant(left, T{}))  { return right; }
+            if (is_constant(right, T{})) { return left; }
+            if (right < left) { std::swap(instruction.left, instruction.right); }
+            break;
+        case FunctionOpcode::multiply:
+            if (is_constant(left, T{}) || is_constant(right, T{})) { return constant(T{}); }
+            if (is_constant(left, T(1)))  { return right; }
+            if (is_constant(right, T(1))) { return left; }
+            if (right < left) { std::swap(instruction.left, instruction.right); }
+            break;
+        case FunctionOpcode::subtract:
+            if (left == right)           { return constant(T{}); }
+            if (is_constant(right, T{})) { return left; }
+            if (is_constant(left, T{}))  { return emit(instruction_type{FunctionOpcode::negate, right, 0, T{}}); }
+            break;
+        case FunctionOpcode::scale:
+            if (instruction.constant == T{})   { return constant(T{}); }
+            if (instruction.constant == T(1))  { return left; }
+            if (instruction.constant == T(-1)) { return emit(instruction_type{FunctionOpcode::negate, left, 0, T{}}); }
+            if (operand.opcode == FunctionOpcode::scale) {
+                return emit(instruction_type{FunctionOpcode::scale, operand.left, 0, instruction.constant * operand.constant});
+            }
+            if (operand.opcode == FunctionOpcode::negate) {
+                return emit(instruction_type{FunctionOpcode::scale, operand.left, 0, -instruction.constant});
+            }
+            break;
+        case FunctionOpcode::axpy:
+            if (instruction.constant == T{})   { return right; }
+            if (is_constant(right, T{})) { return emit(instruction_type{FunctionOpcode::scale, left, 0, instruction.constant}); }
+            if (instruction.constant == T(1))  { return emit(instruction_type{FunctionOpcode::add, left, right, T{}}); }
+            if (instruction.constant == T(-1)) { return emit(instruction_type{FunctionOpcode::subtract, right, left, T{}}); }
+            break;
+        case FunctionOpcode::negate:
+            if (operand.opcode == FunctionOpcode::negate) { return operand.left; }
+            if (operand.opcode == FunctionOpcode::scale) {
+                return emit(instruction_type{FunctionOpcode::scale, operand.left, 0, -operand.constant});
+            }
+            break;
+        default:
+            break;
+        }
+        if (function_opcode_arity(instruction.opcode) == 1) {
+            instruction.right = 0;
+        }
+        if (instruction.opcode != FunctionOpcode::scale && instruction.opcode != FunctionOpcode::axpy) {
+            instruction.constant = T{};
+        }
+        return no_index;
+    }
+
+    /// @brief Linear-scan register allocation over the last use of every value
+    static void assign_registers(program_type& program) {
+        const std::size_t count = program.instructions.size();
+        std::vector<std::size_t> last_use(count, 0);
+        for (std::size_t index = 0; index < count; ++index) {
+            const instruction_type& instruction = program.instructions[index];
+            const std::size_t arity = function_opcode_arity(instruction.opcode);
+            if (arity >= 1) { last_use[instruction.left] = index; }
+            if (arity == 2) { last_use[instruction.right] = index; }
+        }
+
+        program.registers.assign(count, program_type::no_register);
+        std::vector<std::uint32_t> free_registers;
+        for (std::size_t index = 0; index < count; ++index) {
+            const instruction_type& instruction = program.instructions[index];
+            // Kernels allow the output to alias an input, so operands dying
+            // here hand their register straight to the result.
+            const std::size_t arity = function_opcode_arity(instruction.opcode);
+            auto release = [&](std::uint32_t operand) {
+                if (last_use[operand] == index && program.registers[operand] != program_type::no_register) {
+                    free_registers.push_back(program.registers[operand]);
+                }
+            };
+            if (arity >= 1) { release(instruction.left); }
+            if (arity == 2 && instruction.right != instruction.left) { release(instruction.right); }
+
+            if (instruction.opcode == FunctionOpcode::variable || index + 1 == count) {
+                continue;
+            }
+            if (free_registers.empty()) {
+                program.registers[index] = program.register_count++;
+            } else {
+                program.registers[index] = free_registers.back();
+                free_registers.pop_back();
+            }
+        }
+    }
+
+    std::vector<instruction_type> instructions_;
+    std::unordered_map<instruction_type, std::uint32_t, InstructionHash> lookup_;
+    std::vector<std::shared_ptr<const FunctionLeaf<T>>> leaves_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Real function of one real variable, stored as a shared expression program
+ *
+ * @tparam T The scalar type of arguments and values
+ *
+ * A CompiledFunction holds a shared pointer to an immutable FunctionProgram,
+ * so copies are cheap and never duplicate the program. Operations on
+ * functions build a new program from their operands' programs in one pass;
+ * structurally identical subexpressions (e.g. the `sin` in `sin + 2 * sin`)
+ * are merged and constant subexpressions are folded.
+ *
+ * @section compiled_function_evaluation Evaluation
+ *
+ * evaluate(points, values) runs the program over blocks of block_size
+ * points: each instruction processes a whole block with the SIMD kernels of
+ * `dense/simd.hpp` before the next one runs. There is no per-node indirect
+ * call, and user-supplied leaf callables cost one call per point.
+ *
+ * @code{.cpp}
+ * using F = kuukan::CompiledFunction<double>;
+ * const F x = F::variable();
+ * const F f = F::apply(kuukan::FunctionOpcode::axpy, F::product(x, x), F::sin(x), 0.5);   // 0.5 x^2 + sin(x)
+ *
+ * std::vector<double> points(1024), values(1024);
+ * f.evaluate(points, values);
+ * double y = f(0.25);
+ * @endcode
+ *
+ * @note Arithmetic operators are not defined on the element; use
+ *       CompiledFunctionSpace (or CompiledFunctionOperations) as with any
+ *       other kuukan element type.
+ */
+template <std::floating_point T>
+class CompiledFunction {
+public:
+    /// @brief Type alias for the scalar type
+    using scalar_type  = T;
+
+    /// @brief Type alias for the shared program
+    using program_type = FunctionProgram<T>;
+
+    /// @brief Number of points processed per instruction by evaluate
+    static constexpr std::size_t block_size = 256;
+
+    /// @brief Construct the zero function (shares one program; no allocation)
+    CompiledFunction() : program_(zero_program()) {}
+
+    /// @brief The identity function x
+    static CompiledFunction variable() {
+        static const std::shared_ptr<const program_type> program = [] {
+            detail::FunctionProgramBuilder<T> builder;
+            return builder.finish(builder.emit(FunctionInstruction<T>{FunctionOpcode::variable, 0, 0, T{}}));
+        }();
+        return CompiledFunction(program);
+    }
+
+    /// @brief The constant function c
+    static CompiledFunction constant(T value) {
+        detail::FunctionProgramBuilder<T> builder;
+        return CompiledFunction(builder.finish(builder.constant(value)));
+    }
+
+    /**
+     * @brief A leaf wrapping an arbitrary callable
+     *
+     * @param function Callable T -> T evaluated at x
+     * @param name Name used by expression()
+     *
+     * Leaves are identified by object: two leaves created from the same
+     * callable are different subexpressions, while copies of one leaf are
+     * shared.
+     */
+    template <typename Function>
+    requires std::is_invocable_r_v<T, const Function&, T>
+    static CompiledFunction callable(Function function, std::string name) {
+        detail::FunctionProgramBuilder<T> builder;
+        auto function_leaf = std::make_shared<const FunctionLeaf<T>>(
+            FunctionLeaf<T>{std::function<T(T)>(std::move(function)), std::move(name)});
+        return CompiledFunction(builder.finish(builder.leaf(std::move(function_leaf))));
+    }
+
+    /**
+     * @brief Apply a unary opcode (scale, negate, sin, cos, exp, log, sqrt, abs)
+     *
+     * @param opcode The operation
+     * @param operand The function it applies to
+     * @param constant The immediate value (the factor of scale)
+     */
+    static CompiledFunction apply(FunctionOpcode opcode, const CompiledFunction& operand, T constant = T{}) {
+        assert(function_opcode_arity(opcode) == 1);
+        detail::FunctionProgramBuilder<T> builder;
+        const std::uint32_t argument = builder.import(*operand.program_);
+        return CompiledFunction(builder.finish(builder.emit(FunctionInstruction<T>{opcode, argument, 0, constant})));
+    }
+
+    /**
+     * @brief Apply a binary opcode (add, subtract, multiply, axpy)
+     *
+     * @param opcode The operation
+     * @param left The first operand
+     * @param right The second operand
+     * @param constant The immediate value (the factor of axpy)
+     */
+    static CompiledFunction apply(FunctionOpcode opcode, const CompiledFunction& left,
+                                  const CompiledFunction& right, T constant = T{}) {
+        assert(function_opcode_arity(opcode) == 2);
+        detail::FunctionProgramBuilder<T> builder;
+        const std::uint32_t first = builder.import(*left.program_);
+        const std::uint32_t second = builder.import(*right.program_);
+        return CompiledFunction(builder.finish(builder.emit(FunctionInstruction<T>{opcode, first, second, constant})));
+    }
+
+    /// @brief Pointwise product f * g
+    static CompiledFunction product(const CompiledFunction& left, const CompiledFunction& right) {
+        return apply(FunctionOpcode::multiply, left, right);
+    }
+
+    /// @brief sin(f)
+    static CompiledFunction sin(const CompiledFunction& f)  { return apply(FunctionOpcode::sin, f); }
+    /// @brief cos(f)
+    static CompiledFunction cos(const CompiledFunction& f)  { return apply(FunctionOpcode::cos, f); }
+    /// @brief exp(f)
+    static CompiledFunction exp(const CompiledFunction& f)  { return apply(FunctionOpcode::exp, f); }
+    /// @brief log(f)
+    static CompiledFunction log(const CompiledFunction& f)  { return apply(FunctionOpcode::log, f); }
+    /// @brief sqrt(f)
+    static CompiledFunction sqrt(const CompiledFunction& f) { return apply(FunctionOpcode::sqrt, f); }
+    /// @brief |f|
+    static CompiledFunction abs(const CompiledFunction& f)  { return apply(FunctionOpcode::abs, f); }
+
+    /// @brief Build a function from an already constructed program
+    explicit CompiledFunction(std::shared_ptr<const program_type> program) : program_(std::move(program)) {
+        assert(program_ && !program_->instructions.empty());
+    }
+
+    /// @brief The shared program
+    const program_type& program() const noexcept { return *program_; }
+
+    /// @brief Number of instructions (distinct subexpressions)
+    std::size_t size() const noexcept { return program_->instructions.size(); }
+
+    /// @brief Evaluate at one point
+    T operator()(T point) const {
+        T value{};
+        if (program_->register_count <= small_register_count) {
+            std::array<T, small_register_count> registers;
+            run(&point, &value, 1, registers.data(), 1);
+        } else {
+            std::vector<T> registers(program_->register_count);
+            run(&point, &value, 1, registers.data(), 1);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Evaluate at every point of an array
+     *
+     * @param points The arguments
+     * @param values Output buffer of at least points.size() values (may alias points)
+     */
+    void evaluate(std::span<const T> points, std::span<T> values) const {
+        assert(values.size() >= points.size());
+        const std::size_t count = points.size();
+        const std::size_t stride = std::min(block_size, count);
+        std::vector<T> registers(static_cast<std::size_t>(program_->register_count) * stride);
+        for (std::size_t begin = 0; begin < count; begin += block_size) {
+            run(points.data() + begin, values.data() + begin, std::min(block_size, count - begin),
+                registers.data(), stride);
+        }
+    }
+
+    /**
+     * @brief Whether two functions have the same program
+     *
+     * Programs are built deterministically from the operations applied, so
+     * expressions constructed the same way compare equal. Mathematically
+     * equal functions with different expressions (e.g. f + g and g + f
+     * built from different operands) may compare unequal.
+     */
+    bool structurally_equal(const CompiledFunction& other) const {
+        return program_ == other.program_
+            || (program_->instructions == other.program_->instructions
+                && program_->leaves == other.program_->leaves);
+    }
+
+    /// @brief Printable form of the expression (built on demand)
+    std::string expression() const {
+        return print(program_->instructions.size() - 1);
+    }
+
+private:
+    static constexpr std::size_t small_register_count = 32;
+
+    static const std::shared_ptr<const program_type>& zero_program() {
+        static const std::shared_ptr<const program_type> program = [] {
+            detail::FunctionProgramBuilder<T> builder;
+            return builder.finish(builder.constant(T{}));
+        }();
+        return program;
+    }
+
+    /// @brief Interpret the program over count points; registers holds register_count rows of stride values
+    void run(const T* points, T* values, std::size_t count, T* registers, std::size_t stride) const {
+        using traits = simd::native<T>;
+        const auto& instructions = program_->instructions;
+        const auto& slots = program_->registers;
+        auto operand = [&](std::uint32_t index) -> const T* {
+            return instructions[index].opcode == FunctionOpcode::variable
+                ? points
+                : registers + static_cast<std::size_t>(slots[index]) * stride;
+        };
+        auto unary = [&](T* out, const T* in, auto&& vector_step, auto&& scalar_step) {
+            simd::for_each_block<T, std::dynamic_extent>(count,
+                [&](traits, std::size_t i) { traits::store(out + i, vector_step(traits::load(in + i))); },
+                [&](std::size_t i) { out[i] = scalar_step(in[i]); });
+        };
+
+        for (std::size_t index = 0; index < instructions.size(); ++index) {
+            const FunctionInstruction<T>& instruction = instructions[index];
+            T* out = index + 1 == instructions.size() ? values
+                   : slots[index] == program_type::no_register ? nullptr
+                   : registers + static_cast<std::size_t>(slots[index]) * stride;
+            switch (instruction.opcode) {
+            case FunctionOpcode::constant:
+                std::fill_n(out, count, instruction.constant);
+                break;
+            case FunctionOpcode::variable:
+                if (out == values) {
+                    std::copy_n(points, count, out);
+                }
+                break;
+            case FunctionOpcode::callable: {
+                const auto& evaluate_leaf = program_->leaves[instruction.left]->evaluate;
+                for (std::size_t i = 0; i < count; ++i) {
+                    out[i] = evaluate_leaf(points[i]);
+                }
+                break;
+            }
+            case FunctionOpcode::add:
+                simd::add(operand(instruction.left), operand(instruction.right), out, count);
+                break;
+            case FunctionOpcode::subtract:
+                simd::subtract(operand(instruction.left), operand(instruction.right), out, count);
+                break;
+            case FunctionOpcode::multiply: {
+                const T* left = operand(instruction.left);
+                const T* right = operand(instruction.right);
+                simd::for_each_block<T, std::dynamic_extent>(count,
+                    [&](traits, std::size_t i) { traits::store(out + i, traits::mul(traits::load(left + i), traits::load(right + i))); },
+                    [&](std::size_t i) { out[i] = left[i] * right[i]; });
+                break;
+            }
+            case FunctionOpcode::scale:
+                simd::scale(instruction.constant, operand(instruction.left), out, count);
+                break;
+            case FunctionOpcode::axpy:
+                simd::axpy(instruction.constant, operand(instruction.left), operand(instruction.right), out, count);
+                break;
+            case FunctionOpcode::negate:
+                simd::negate(operand(instruction.left), out, count);
+                break;
+            case FunctionOpcode::sqrt:
+                unary(out, operand(instruction.left),
+                      [](auto value) { return traits::sqrt(value); },
+                      [](T value) { return std::sqrt(value); });
+                break;
+            case FunctionOpcode::abs:
+                unary(out, operand(instruction.left),
+                      [](auto value) { return traits::abs(value); },
+                      [](T value) { return simd::scalar_abs(value); });
+                break;
+            default: {
+                // Transcendental functions: elementwise library calls
+                const T* in = operand(instruction.left);
+                for (std::size_t i = 0; i < count; ++i) {
+                    out[i] = detail::apply_function_opcode(instruction, in[i], T{});
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    std::string print(std::size_t index) const {
+        const FunctionInstruction<T>& instruction = program_->instructions[index];
+        auto number = [](T value) {
+            std::ostringstream stream;
+            stream << value;
+            return stream.str();
+        };
+        auto call = [&](const char* name) { return std::string(name) + "(" + print(instruction.left) + ")"; };
+        switch (instruction.opcode) {
+        case FunctionOpcode::constant: return number(instruction.constant);
+        case FunctionOpcode::variable: return "x";
+        case FunctionOpcode::callable: return program_->leaves[instruction.left]->name;
+        case FunctionOpcode::add:      return "(" + print(instruction.left) + " + " + print(instruction.right) + ")";
+        case FunctionOpcode::subtract: return "(" + print(instruction.left) + " - " + print(instruction.right) + ")";
+        case FunctionOpcode::multiply: return "(" + print(instruction.left) + " * " + print(instruction.right) + ")";
+        case FunctionOpcode::scale:    return "(" + number(instruction.constant) + " * " + print(instruction.left) + ")";
+        case FunctionOpcode::axpy:
+            return "(" + number(instruction.constant) + " * " + print(instruction.left) + " + " + print(instruction.right) + ")";
+        case FunctionOpcode::negate:   return "(-" + print(instruction.left) + ")";
+        case FunctionOpcode::sin:      return call("sin");
+        case FunctionOpcode::cos:      return call("cos");
+        case FunctionOpcode::exp:      return call("exp");
+        case FunctionOpcode::log:      return call("log");
+        case FunctionOpcode::sqrt:     return call("sqrt");
+        case FunctionOpcode::abs:      return call("abs");
+        }
+        return {};
+    }
+
+    std::shared_ptr<const program_type> program_;
+};
+
+/**
+ * @brief Vector space operations on CompiledFunction
+ *
+ * @tparam T The scalar type
+ *
+ * Every operation builds one new program from its operands' programs; the
+ * fused Axpy and LinearCombination merge all operands at once instead of
+ * building a program per intermediate sum.
+ */
+template <std::floating_point T>
+struct CompiledFunctionOperations {
+    /// @brief Type alias for the element type
+    using element_type = CompiledFunction<T>;
+
+    /// @brief Pointwise sum
+    struct Addition {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            return element_type::apply(FunctionOpcode::add, left, right);
+        }
+    };
+
+    /// @brief Pointwise difference
+    struct Subtraction {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            return element_type::apply(FunctionOpcode::subtract, left, right);
+        }
+    };
+
+    /// @brief Scalar multiple (multiplying by zero gives the zero function)
+    struct ScalarAction {
+        element_type operator()(const T& scalar_value, const element_type& element) const {
+            return element_type::apply(FunctionOpcode::scale, element, scalar_value);
+        }
+    };
+
+    /// @brief Pointwise negation
+    struct Negation {
+        element_type operator()(const element_type& element) const {
+            return element_type::apply(FunctionOpcode::negate, element);
+        }
+    };
+
+    /// @brief The zero function; shares one program
+    struct ZeroSupplier {
+        element_type operator()() const { return element_type{}; }
+    };
+
+    /// @brief Structural equality of the programs (see CompiledFunction::structurally_equal)
+    struct Equality {
+        bool operator()(const element_type& left, const element_type& right) const {
+            return left.structurally_equal(right);
+        }
+    };
+
+    /// @brief Fused a * f + g as one axpy instruction
+    struct Axpy {
+        element_type operator()(const T& scalar_value, const element_type& x, const element_type& y) const {
+            return element_type::apply(FunctionOpcode::axpy, x, y, scalar_value);
+        }
+    };
+
+    /// @brief a_1 * f_1 + ... + a_n * f_n as a chain of axpy instructions in one program
+    struct LinearCombination {
+        element_type operator()(std::span<const LinearTerm<T, element_type>> terms) const {
+            if (terms.empty()) {
+                return element_type{};
+            }
+            detail::FunctionProgramBuilder<T> builder;
+            std::uint32_t result = builder.emit(FunctionInstruction<T>{
+                FunctionOpcode::scale, builder.import(terms[0].element.program()), 0, terms[0].coefficient});
+            for (std::size_t index = 1; index < terms.size(); ++index) {
+                const std::uint32_t term = builder.import(terms[index].element.program());
+                result = builder.emit(FunctionInstruction<T>{FunctionOpcode::axpy, term, result, terms[index].coefficient});
+            }
+            return element_type(builder.finish(result));
+        }
+    };
+};
+
+/**
+ * @brief Vector space of compiled real functions
+ *
+ * @tparam T The scalar type
+ *
+ * A drop-in replacement for closure-based function spaces: the same
+ * VectorSpace interface, with elements whose evaluation cost depends on the
+ * number of distinct subexpressions rather than on how they were nested.
+ *
+ * @code{.cpp}
+ * using FS = kuukan::CompiledFunctionSpace<double>;
+ * using F  = FS::element_type;
+ * const F x = F::variable();
+ * F f = FS::linear_combination({{2.0, F::sin(x)}, {-1.0, F::cos(x)}});
+ * F g = FS::addition(f, F::sin(x));   // sin(x) is stored once
+ * @endcode
+ */
+template <std::floating_point T>
+struct CompiledFunctionSpace : VectorSpace<
+    CompiledFunction<T>, T,
+    typename CompiledFunctionOperations<T>::Addition,
+    typename CompiledFunctionOperations<T>::ScalarAction,
+    typename CompiledFunctionOperations<T>::Negation,
+    typename CompiledFunctionOperations<T>::ZeroSupplier,
+    typename CompiledFunctionOperations<T>::Equality,
+    typename CompiledFunctionOperations<T>::Axpy,
+    typename CompiledFunctionOperations<T>::LinearCombination,
+    NotInjected,
+    NotInjected,
+    NotInjected,
+    typename CompiledFunctionOperations<T>::Subtraction> {};
+
+} // namespace kuukan
@@ -0,0 +1,79 @@
+/**
+ * @file domain.hpp
+ * @brief Compile-time interval domains for function spaces
+ *
+ * Function-space backends that discretize their elements (Chebyshev
+ * expansions, quadrature rules) are parameterized by a domain policy type
+ * describing the interval [lower, upper] and the affine map onto the
+ * reference interval [-1, 1] on which their node sets are defined.
+ */
+
+#pragma once
+#include <concepts>
+
+namespace kuukan {
+
+/**
+ * @brief The closed interval [Lower, Upper] as a domain policy
+ *
+ * @tparam T The scalar type
+ * @tparam Lower The left endpoint
+ * @tparam Upper The right endpoint (greater than Lower)
+ *
+ * @code{.cpp}
+ * using UnitInterval = kuukan::Interval<double, 0.0, 1.0>;
+ * double t = UnitInterval::to_reference(0.25);   // -0.5
+ * @endcode
+ */
+template <std::floating_point T, T Lower, T Upper>
+struct Interval {
+    static_assert(Lower < Upper, "an interval domain needs Lower < Upper");
+
+    /// @brief Type alias for the scalar type
+    using scalar_type = T;
+
+    /// @brief The left endpoint
+    static constexpr T lower = Lower;
+
+    /// @brief The right endpoint
+    static constexpr T upper = Upper;
+
+    /// @brief (lower + upper) / 2
+    static constexpr T midpoint = (Lower + Upper) / T(2);
+
+    /// @brief (upper - lower) / 2, the Jacobian of the map from [-1, 1]
+    static constexpr T half_width = (Upper - Lower) / T(2);
+
+    /// @brief Map a point of the interval to [-1, 1]
+    static constexpr T to_reference(T point) noexcept { return (point - midpoint) / half_width; }
+
+    /// @brief Map a point of [-1, 1] to the interval
+    static constexpr T from_reference(T reference) noexcept { return midpoint + half_width * reference; }
+};
+
+/// @brief The reference interval [-1, 1]
+template <std::floating_point T>
+using ReferenceInterval = Interval<T, T(-1), T(1)>;
+
+/**
+ * @brief Concept for interval domain policies
+ *
+ * @tparam D The type to check
+ *
+ * A type satisfies IntervalDomainLike if it names its scalar type, its
+ * endpoints, midpoint and half width, and maps points to and from [-1, 1].
+ *
+ * @note Interval automatically satisfies this concept.
+ */
+template <typename D>
+concept IntervalDomainLike = requires(typename D::scalar_type point) {
+    requires std::floating_point<typename D::scalar_type>;
+    { D::lower }      -> std::convertible_to<typename D::scalar_type>;
+    { D::upper }      -> std::convertible_to<typename D::scalar_type>;
+    { D::midpoint }   -> std::convertible_to<typename D::scalar_type>;
+    { D::half_width } -> std::convertible_to<typename D::scalar_type>;
+    { D::to_reference(point) }   -> std::same_as<typename D::scalar_type>;
+    { D::from_reference(point) } -> std::same_as<typename D::scalar_type>;
+};
+
+} // namespace kuukan
@@ -0,0 +1,439 @@
+/**
+ * @file function_norms.hpp
+ * @brief Sup and L^p norms of function-space elements by sampling and quadrature
+ *
+ * This file provides SupNorm and LpNorm, norm functors for any function
+ * element that can be evaluated at points (see PointEvaluableLike), with the
+ * fused difference norms NormedSpace uses for distances. Both start from the
+ * cached node set of a rule on the whole domain and refine adaptively:
+ * every refinement round splits the panels that still need work and samples
+ * all their nodes in one batched evaluation.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/norm/normed_space.hpp"
+#include "kuukan/dense/simd.hpp"
+#include "kuukan/function/domain.hpp"
+#include "kuukan/function/quadrature.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Adaptive refinement policy of the function norms
+ *
+ * @tparam T The scalar type
+ * @tparam Tolerance The relative accuracy requested from the refinement
+ * @tparam MaxPanels The largest number of panels the domain is split into
+ *
+ * Refinement stops when the estimate is stable to Tolerance (relative to its
+ * magnitude) or when MaxPanels panels are in use. MaxPanels = 1 evaluates
+ * the rule once on the whole domain.
+ */
+template <std::floating_point T, T Tolerance = T(1e-10), std::size_t MaxPanels = 1024>
+requires (Tolerance >= T(0)) && (MaxPanels >= 1)
+struct AdaptiveRefinement {
+    /// @brief The relative tolerance
+    static constexpr T tolerance = Tolerance;
+
+    /// @brief The panel budget
+    static constexpr std::size_t max_panels = MaxPanels;
+};
+
+/// @brief A single evaluation of the rule on the whole domain
+template <std::floating_point T>
+using NoRefinement = AdaptiveRefinement<T, T(0), 1>;
+
+namespace detail {
+
+/// @brief Subinterval of the domain with the estimate computed on it
+template <typename T>
+struct FunctionPanel {
+    T lower;
+    T upper;
+    T estimate;
+};
+
+/**
+ * @brief Fill points with the rule's nodes mapped onto each half of every panel
+ *
+ * Half 2 i + h of panels[i] (h = 0 left, 1 right) occupies
+ * points[(2 i + h) * size, (2 i + h + 1) * size).
+ */
+template <typename T, std::size_t Size>
+void map_panel_halves(const QuadratureRule<T, Size>& reference,
+                      const std::vector<FunctionPanel<T>>& panels, std::vector<T>& points) {
+    points.resize(panels.size() * 2 * Size);
+    T* out = points.data();
+    for (const FunctionPanel<T>& panel : panels) {
+        const T middle = (panel.lower + panel.upper) / T(2);
+        const T quarter = (panel.upper - panel.lower) / T(4);
+        for (const T center : {panel.lower + quarter, middle + quarter}) {
+            for (std::size_t node = 0; node < Size; ++node) {
+                *out++ = center + quarter * reference.nodes[node];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Adaptive integral of an integrand sampled in batches
+ *
+ * @param sample Callable (std::span<const T> points, std::span<T> values)
+ *        filling the integrand at every point
+ *
+ * A panel is accepted when the rule on the panel and on its two halves
+ * differ by at most tolerance * |integral| * (panel width / domain width),
+ * so the accepted errors add up to at most tolerance * |integral|.
+ */
+template <typename Rule, typename Refinement, IntervalDomainLike Domain, typename Sample>
+typename Domain::scalar_type adaptive_integral(Sample&& sample) {
+    using T = typename Domain::scalar_type;
+    constexpr std::size_t size = Rule::size;
+    const QuadratureRule<T, size>& whole = mapped_rule<Rule, Domain>();
+    const QuadratureRule<T, size>& reference = Rule::template reference<T>();
+
+    std::vector<T> points(whole.nodes.begin(), whole.nodes.end());
+    std::vector<T> values(size);
+    sample(std::span<const T>(points), std::span<T>(values));
+    const T total = simd::dot<T, size>(whole.weights.data(), values.data(), size);
+    if constexpr (Refinement::max_panels == 1) {
+        return total;
+    }
+
+    const T domain_width = T(Domain::upper) - T(Domain::lower);
+    std::vector<FunctionPanel<T>> pending{FunctionPanel<T>{T(Domain::lower), T(Domain::upper), total}};
+    std::vector<FunctionPanel<T>> halves;
+    std::vector<FunctionPanel<T>> refine;
+    std::size_t panel_count = 1;
+    T accepted = T{};
+    while (!pending.empty()) {
+        if (panel_count + pending.size() > Refinement::max_panels) {
+            for (const FunctionPanel<T>& panel : pending) {
+                accepted += panel.estimate;
+            }
+            break;
+        }
+        map_panel_halves(reference, pending, points);
+        values.resize(points.size());
+        sample(std::span<const T>(points), std::span<T>(values));
+        panel_count += pending.size();
+
+        halves.clear();
+        T estimate = accepted;
+        for (std::size_t index = 0; index < pending.size(); ++index) {
+            const FunctionPanel<T>& panel = pending[index];
+            const T middle = (panel.lower + panel.upper) / T(2);
+            const T jacobian = (panel.upper - panel.lower) / T(4);
+            const T left = jacobian * simd::dot<T, size>(reference.weights.data(),
+                                                         values.data() + 2 * index * size, size);
+            const T right = jacobian * simd::dot<T, size>(reference.weights.data(),
+                                                          values.data() + (2 * index + 1) * size, size);
+            halves.push_back(FunctionPanel<T>{panel.lower, middle, left});
+            halves.push_back(FunctionPanel<T>{middle, panel.upper, right});
+            estimate += left + right;
+        }
+
+        const T scale = std::max(std::abs(estimate), std::numeric_limits<T>::min());
+        refine.clear();
+        for (std::size_t index = 0; index < pending.size(); ++index) {
+            const FunctionPanel<T>& panel = pending[index];
+            const T refined = halves[2 * index].estimate + halves[2 * index + 1].estimate;
+            const T budget = Refinement::tolerance * scale * (panel.upper - panel.lower) / domain_width;
+            if (std::abs(refined - panel.estimate) <= budget) {
+                accepted += refined;
+            } else {
+                refine.push_back(halves[2 * index]);
+                refine.push_back(halves[2 * index + 1]);
+            }
+        }
+        pending.swap(refine);
+    }
+    return accepted;
+}
+
+/**
+ * @brief Adaptive maximum of |values| over the domain, sampled in batches
+ *
+ * @param sample Callable (std::span<const T> points, std::span<T> values)
+ * @param bound Stop as soon as a sample exceeds bound and return it
+ *
+ * After the first pass over the whole domain, every round splits the
+ * panels whose sampled maximum is within tolerance of the largest sample of
+ * the previous round (the panels that contain the peak), and stops once two
+ * successive rounds agree to tolerance. The result is the largest sample
+ * seen.
+ *
+ * @note Sampling gives a lower bound of the supremum; features narrower
+ *       than the node spacing of every panel may be missed.
+ */
+template <typename Rule, typename Refinement, IntervalDomainLike Domain, typename Sample>
+typename Domain::scalar_type adaptive_max(Sample&& sample, typename Domain::scalar_type bound) {
+    using T = typename Domain::scalar_type;
+    constexpr std::size_t size = Rule::size;
+    const QuadratureRule<T, size>& whole = mapped_rule<Rule, Domain>();
+    const QuadratureRule<T, size>& reference = Rule::template reference<T>();
+
+    std::vector<T> points(whole.nodes.begin(), whole.nodes.end());
+    std::vector<T> values(size);
+    sample(std::span<const T>(points), std::span<T>(values));
+    T maximum = simd::max_abs<T, size>(values.data(), size);
+    if (Refinement::max_panels == 1 || maximum > bound) {
+        return maximum;
+    }
+
+    std::vector<FunctionPanel<T>> pending{FunctionPanel<T>{T(Domain::lower), T(Domain::upper), maximum}};
+    std::vector<FunctionPanel<T>> next;
+    std::size_t panel_count = 1;
+    T previous = maximum;
+    while (!pending.empty() && panel_count + pending.size() <= Refinement::max_panels) {
+        map_panel_halves(reference, pending, points);
+        values.resize(points.size());
+        sample(std::span<const T>(points), std::span<T>(values));
+        panel_count += pending.size();
+
+        next.clear();
+        T round_maximum = T{};
+        for (std::size_t index = 0; index < pending.size(); ++index) {
+            const FunctionPanel<T>& panel = pending[index];
+            const T middle = (panel.lower + panel.upper) / T(2);
+            const T left = simd::max_abs<T, size>(values.data() + 2 * index * size, size);
+            const T right = simd::max_abs<T, size>(values.data() + (2 * index + 1) * size, size);
+            next.push_back(FunctionPanel<T>{panel.lower, middle, left});
+            next.push_back(FunctionPanel<T>{middle, panel.upper, right});
+            round_maximum = std::max({round_maximum, left, right});
+        }
+        // The halves' nodes are not nested in the panel's, so the peak is
+        // resolved once two successive rounds agree, not once the overall
+        // maximum stops growing.
+        maximum = std::max(maximum, round_maximum);
+        if (maximum > bound || std::abs(round_maximum - previous) <= Refinement::tolerance * maximum) {
+            break;
+        }
+        previous = round_maximum;
+        pending.clear();
+        for (const FunctionPanel<T>& panel : next) {
+            if (panel.estimate >= round_maximum - Refinement::tolerance * round_maximum) {
+                pending.push_back(panel);
+            }
+        }
+    }
+    return maximum;
+}
+
+/// @brief Sampler of left - right for the fused difference norms
+template <typename T, typename Left, typename Right>
+auto difference_sampler(const Left& left, const Right& right) {
+    return [&left, &right, scratch = std::vector<T>{}](std::span<const T> points, std::span<T> values) mutable {
+        scratch.resize(points.size());
+        evaluate_function<T>(left, points, values);
+        evaluate_function<T>(right, points, std::span<T>(scratch));
+        simd::subtract(values.data(), scratch.data(), values.data(), points.size());
+    };
+}
+
+/// @brief Sampler of the function itself
+template <typename T, typename Function>
+auto function_sampler(const Function& function) {
+    return [&function](std::span<const T> points, std::span<T> values) {
+        evaluate_function<T>(function, points, values);
+    };
+}
+
+/// @brief |value|^P
+template <std::size_t P, typename T>
+T absolute_power(T value) {
+    const T magnitude = std::abs(value);
+    if constexpr (P == 1) {
+        return magnitude;
+    } else if constexpr (P == 2) {
+        return magnitude * magnitude;
+    } else {
+        return std::pow(magnitude, T(P));
+    }
+}
+
+/// @brief c^(1/P)
+template <std::size_t P, typename T>
+T root(T value) {
+    if constexpr (P == 1) {
+        return value;
+    } else if constexpr (P == 2) {
+        return std::sqrt(value);
+    } else {
+        return std::pow(value, T(1) / T(P));
+    }
+}
+
+/// @brief Replace every sample by |sample|^P after sampling
+template <std::size_t P, typename T, typename Sample>
+auto power_sampler(Sample sample) {
+    return [sample = std::move(sample)](std::span<const T> points, std::span<T> values) mutable {
+        sample(points, values);
+        for (std::size_t index = 0; index < points.size(); ++index) {
+            values[index] = absolute_power<P>(values[index]);
+        }
+    };
+}
+
+} // namespace detail
+
+/**
+ * @brief Fused sup distance: sup_x |f(x) - g(x)|, without forming f - g
+ *
+ * @see SupNorm
+ */
+template <std::floating_point T, IntervalDomainLike Domain = ReferenceInterval<T>,
+          typename Rule = ClenshawCurtis<33>, typename Refinement = AdaptiveRefinement<T>>
+struct SupDifferenceNorm {
+    template <PointEvaluableLike<T> Function>
+    T operator()(const Function& left, const Function& right) const {
+        return detail::adaptive_max<Rule, Refinement, Domain>(detail::difference_sampler<T>(left, right),
+                                                              std::numeric_limits<T>::infinity());
+    }
+};
+
+/**
+ * @brief Early-exit sup distance: stops sampling once a difference exceeds the bound
+ *
+ * @see SupNorm
+ */
+template <std::floating_point T, IntervalDomainLike Domain = ReferenceInterval<T>,
+          typename Rule = ClenshawCurtis<33>, typename Refinement = AdaptiveRefinement<T>>
+struct SupBoundedDifferenceNorm {
+    template <PointEvaluableLike<T> Function>
+    T operator()(const Function& left, const Function& right, const T& bound) const {
+        return detail::adaptive_max<Rule, Refinement, Domain>(detail::difference_sampler<T>(left, right), bound);
+    }
+};
+
+/**
+ * @brief Sup (uniform) norm ||f||_inf = sup_x |f(x)| over an interval
+ *
+ * @tparam T The scalar type
+ * @tparam Domain The interval
+ * @tparam Rule The sampling node set per panel (Clenshaw-Curtis by default,
+ *         whose nodes include the panel endpoints)
+ * @tparam Refinement The adaptive refinement policy
+ *
+ * Samples the function at the cached nodes of the whole domain, then
+ * refines around the largest samples until the maximum is stable to the
+ * refinement tolerance (see AdaptiveRefinement). Works with any element
+ * satisfying PointEvaluableLike; elements with a batched evaluate member
+ * are evaluated once per refinement round.
+ *
+ * @code{.cpp}
+ * using D = kuukan::Interval<double, 0.0, 6.283185307179586>;
+ * using FS = kuukan::CompiledFunctionSpace<double>;
+ * using Sup = kuukan::FunctionNormedSpace<FS, kuukan::SupNorm<double, D>>;
+ * double d = Sup::distance(f, g);
+ * @endcode
+ */
+template <std::floating_point T, IntervalDomainLike Domain = ReferenceInterval<T>,
+          typename Rule = ClenshawCurtis<33>, typename Refinement = AdaptiveRefinement<T>>
+requires QuadratureRuleLike<Rule, T> && std::same_as<typename Domain::scalar_type, T>
+struct SupNorm {
+    using difference_norm = SupDifferenceNorm<T, Domain, Rule, Refinement>;
+    using bounded_difference_norm = SupBoundedDifferenceNorm<T, Domain, Rule, Refinement>;
+    using comparable_difference_norm = NotInjected;
+
+    template <PointEvaluableLike<T> Function>
+    T operator()(const Function& function) const {
+        return detail::adaptive_max<Rule, Refinement, Domain>(detail::function_sampler<T>(function),
+                                                              std::numeric_limits<T>::infinity());
+    }
+};
+
+/**
+ * @brief Comparable surrogate of the L^p distance: the integral of |f - g|^p
+ *
+ * Skips the final root; to_distance and to_comparable convert.
+ *
+ * @see LpNorm
+ */
+template <std::floating_point T, std::size_t P, IntervalDomainLike Domain = ReferenceInterval<T>,
+          typename Rule = GaussLegendre<16>, typename Refinement = AdaptiveRefinement<T>>
+struct LpComparableDifferenceNorm {
+    template <PointEvaluableLike<T> Function>
+    T operator()(const Function& left, const Function& right) const {
+        return detail::adaptive_integral<Rule, Refinement, Domain>(
+            detail::power_sampler<P, T>(detail::difference_sampler<T>(left, right)));
+    }
+
+    static T to_distance(const T& comparable) { return detail::root<P>(comparable); }
+    static T to_comparable(const T& distance) { return detail::absolute_power<P>(distance); }
+};
+
+/**
+ * @brief Fused L^p distance: (integral of |f - g|^p)^(1/p), without forming f - g
+ *
+ * @see LpNorm
+ */
+template <std::floating_point T, std::size_t P, IntervalDomainLike Domain = ReferenceInterval<T>,
+          typename Rule = GaussLegendre<16>, typename Refinement = AdaptiveRefinement<T>>
+struct LpDifferenceNorm {
+    template <PointEvaluableLike<T> Function>
+    T operator()(const Function& left, const Function& right) const {
+        return detail::root<P>(LpComparableDifferenceNorm<T, P, Domain, Rule, Refinement>{}(left, right));
+    }
+};
+
+/**
+ * @brief L^p norm ||f||_p = (integral over the domain of |f(x)|^p dx)^(1/p)
+ *
+ * @tparam T The scalar type
+ * @tparam P The exponent (at least one)
+ * @tparam Domain The interval
+ * @tparam Rule The quadrature rule per panel (Gauss-Legendre by default)
+ * @tparam Refinement The adaptive refinement policy
+ *
+ * Integrates with the cached rule on the whole domain, then bisects the
+ * panels whose estimate changes on refinement by more than their share of
+ * the tolerance. Non-smooth integrands (|f|^p at the roots of f) therefore
+ * only cost extra nodes near the kinks.
+ *
+ * @code{.cpp}
+ * using D = kuukan::Interval<double, 0.0, 1.0>;
+ * using L2 = kuukan::LpNorm<double, 2, D>;
+ * double n = L2{}(f);
+ * @endcode
+ */
+template <std::floating_point T, std::size_t P, IntervalDomainLike Domain = ReferenceInterval<T>,
+          typename Rule = GaussLegendre<16>, typename Refinement = AdaptiveRefinement<T>>
+requires (P >= 1) && QuadratureRuleLike<Rule, T> && std::same_as<typename Domain::scalar_type, T>
+struct LpNorm {
+    using difference_norm = LpDifferenceNorm<T, P, Domain, Rule, Refinement>;
+    using bounded_difference_norm = NotInjected;
+    using comparable_difference_norm = LpComparableDifferenceNorm<T, P, Domain, Rule, Refinement>;
+
+    template <PointEvaluableLike<T> Function>
+    T operator()(const Function& function) const {
+        return detail::root<P>(detail::adaptive_integral<Rule, Refinement, Domain>(
+            detail::power_sampler<P, T>(detail::function_sampler<T>(function))));
+    }
+};
+
+/**
+ * @brief Normed space over a function vector space with one of the function norms
+ *
+ * @tparam VS The function vector space (elements must satisfy PointEvaluableLike)
+ * @tparam Norm A norm naming difference_norm, bounded_difference_norm and
+ *         comparable_difference_norm (SupNorm, LpNorm)
+ */
+template <StaticVectorSpaceLike VS, typename Norm>
+using FunctionNormedSpace = NormedSpace<VS, Norm,
+                                        typename Norm::difference_norm,
+                                        typename Norm::bounded_difference_norm,
+                                        typename Norm::comparable_difference_norm>;
+
+} // namespace kuukan
@@ -0,0 +1,235 @@
+/**
+ * @file quadrature.hpp
+ * @brief Cached quadrature node sets and batched function evaluation
+ *
+ * This file provides the Gauss-Legendre and Clenshaw-Curtis rules used by
+ * the function-space norms of `function/function_norms.hpp`. Node sets are
+ * computed once per scalar type and order on [-1, 1], and once more per
+ * interval domain, and are handed to the integrand as one array so that
+ * function elements with a batched `evaluate` member process all nodes in
+ * a single call.
+ */
+
+#pragma once
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include "kuukan/dense/simd.hpp"
+#include "kuukan/function/domain.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Nodes and weights of a quadrature rule
+ *
+ * @tparam T The scalar type
+ * @tparam Size The number of nodes
+ *
+ * Nodes are in ascending order.
+ */
+template <std::floating_point T, std::size_t Size>
+struct QuadratureRule {
+    /// @brief The number of nodes
+    static constexpr std::size_t size = Size;
+
+    /// @brief The nodes
+    std::array<T, Size> nodes;
+
+    /// @brief The weights
+    std::array<T, Size> weights;
+};
+
+/**
+ * @brief Gauss-Legendre rule with Order nodes
+ *
+ * @tparam Order The number of nodes (at least one)
+ *
+ * Exact for polynomials of degree 2 Order - 1. The nodes are interior, so
+ * integrands may be singular at the endpoints.
+ */
+template <std::size_t Order>
+requires (Order >= 1)
+struct GaussLegendre {
+    /// @brief The number of nodes
+    static constexpr std::size_t size = Order;
+
+    /// @brief The rule on [-1, 1], computed on first use (Newton iteration on P_Order)
+    template <std::floating_point T>
+    static const QuadratureRule<T, Order>& reference() {
+        static const QuadratureRule<T, Order> rule = [] {
+            QuadratureRule<T, Order> result{};
+            using wide = long double;
+            for (std::size_t i = 0; i < (Order + 1) / 2; ++i) {
+                wide x = std::cos(std::numbers::pi_v<wide> * (wide(i) + wide(0.75)) / (wide(Order) + wide(0.5)));
+                wide derivative = 1;
+                for (int iteration = 0; iteration < 100; ++iteration) {
+                    wide previous = 1;
+                    wide current = x;
+                    for (std::size_t k = 2; k <= Order; ++k) {
+                        const wide next = ((2 * wide(k) - 1) * x * current - (wide(k) - 1) * previous) / wide(k);
+                        previous = current;
+                        current = next;
+                    }
+                    derivative = wide(Order) * (x * current - previous) / (x * x - 1);
+                    const wide step = current / derivative;
+                    x -= step;
+                    if (std::abs(step) <= std::numeric_limits<wide>::epsilon()) {
+                        break;
+                    }
+                }
+                const wide weight = 2 / ((1 - x * x) * derivative * derivative);
+                result.nodes[i] = static_cast<T>(-x);
+                result.nodes[Order - 1 - i] = static_cast<T>(x);
+                result.weights[i] = static_cast<T>(weight);
+                result.weights[Order - 1 - i] = static_cast<T>(weight);
+            }
+            return result;
+        }();
+        return rule;
+    }
+};
+
+/**
+ * @brief Clenshaw-Curtis rule with Order nodes
+ *
+ * @tparam Order The number of nodes (at least two)
+ *
+ * The nodes are the Chebyshev extreme points cos(k pi / (Order - 1)),
+ * including both endpoints, which also makes them a good sampling set for
+ * maxima. Exact for polynomials of degree Order - 1.
+ */
+template <std::size_t Order>
+requires (Order >= 2)
+struct ClenshawCurtis {
+    /// @brief The number of nodes
+    static constexpr std::size_t size = Order;
+
+    /// @brief The rule on [-1, 1], computed on first use
+    template <std::floating_point T>
+    static const QuadratureRule<T, Order>& reference() {
+        static const QuadratureRule<T, Order> rule = [] {
+            QuadratureRule<T, Order> result{};
+            using wide = long double;
+            constexpr std::size_t n = Order - 1;
+            for (std::size_t k = 0; k <= n; ++k) {
+                const wide theta = std::numbers::pi_v<wide> * wide(k) / wide(n);
+                wide sum = 1;
+                for (std::size_t j = 1; 2 * j <= n; ++j) {
+                    const wide factor = 2 * j == n ? 1 : 2;
+                    sum -= factor * std::cos(2 * wide(j) * theta) / (4 * wide(j) * wide(j) - 1);
+                }
+                const wide endpoint = k == 0 || k == n ? 1 : 2;
+                result.nodes[k] = static_cast<T>(-std::cos(theta));
+                result.weights[k] = static_cast<T>(endpoint * sum / wide(n));
+            }
+            return result;
+        }();
+        return rule;
+    }
+};
+
+/**
+ * @brief Concept for quadrature rule policies
+ *
+ * @tparam R The type to check
+ * @tparam T The scalar type
+ *
+ * A rule names its node count and returns its cached rule on [-1, 1].
+ */
+template <typename R, typename T>
+concept QuadratureRuleLike = requires {
+    { R::size } -> std::convertible_to<std::size_t>;
+    { R::template reference<T>() } -> std::same_as<const QuadratureRule<T, R::size>&>;
+};
+
+/**
+ * @brief A rule mapped onto an interval domain, computed once per rule and domain
+ *
+ * @tparam Rule The rule policy (e.g. GaussLegendre<16>)
+ * @tparam Domain The interval
+ */
+template <typename Rule, IntervalDomainLike Domain>
+requires QuadratureRuleLike<Rule, typename Domain::scalar_type>
+const QuadratureRule<typename Domain::scalar_type, Rule::size>& mapped_rule() {
+    using T = typename Domain::scalar_type;
+    static const QuadratureRule<T, Rule::size> rule = [] {
+        const QuadratureRule<T, Rule::size>& reference = Rule::template reference<T>();
+        QuadratureRule<T, Rule::size> result{};
+        for (std::size_t index = 0; index < Rule::size; ++index) {
+            result.nodes[index] = Domain::from_reference(reference.nodes[index]);
+            result.weights[index] = Domain::half_width * reference.weights[index];
+        }
+        return result;
+    }();
+    return rule;
+}
+
+/**
+ * @brief Concept for function elements that can be evaluated at points of type T
+ *
+ * Either callable as function(x), or providing a batched
+ * `evaluate(std::span<const T> points, std::span<T> values)` member (as
+ * CompiledFunction and ChebyshevFunction do).
+ */
+template <typename F, typename T>
+concept PointEvaluableLike =
+    requires(const F& function, std::span<const T> points, std::span<T> values) {
+        function.evaluate(points, values);
+    } ||
+    requires(const F& function, T point) {
+        { function(point) } -> std::convertible_to<T>;
+    };
+
+/**
+ * @brief Evaluate a function element at every point of an array
+ *
+ * Uses the element's batched evaluate member when it has one, and calls it
+ * point by point otherwise.
+ *
+ * @param function The function element
+ * @param points The arguments
+ * @param values Output buffer of at least points.size() values
+ */
+template <std::floating_point T, PointEvaluableLike<T> Function>
+void evaluate_function(const Function& function, std::span<const T> points, std::span<T> values) {
+    assert(values.size() >= points.size());
+    if constexpr (requires { function.evaluate(points, values); }) {
+        function.evaluate(points, values);
+    } else {
+        for (std::size_t index = 0; index < points.size(); ++index) {
+            values[index] = static_cast<T>(function(points[index]));
+        }
+    }
+}
+
+/**
+ * @brief Integrate a function element over a domain with a fixed rule
+ *
+ * @tparam Rule The rule policy
+ * @tparam Domain The interval
+ * @param function The integrand; evaluated at all nodes in one call
+ * @return sum_i w_i f(x_i)
+ *
+ * @code{.cpp}
+ * using D = kuukan::Interval<double, 0.0, 1.0>;
+ * double area = kuukan::integrate<kuukan::GaussLegendre<16>, D>([](double x) { return x * x; });
+ * @endcode
+ */
+template <typename Rule, IntervalDomainLike Domain, typename Function>
+requires QuadratureRuleLike<Rule, typename Domain::scalar_type>
+      && PointEvaluableLike<Function, typename Domain::scalar_type>
+typename Domain::scalar_type integrate(const Function& function) {
+    using T = typename Domain::scalar_type;
+    const QuadratureRule<T, Rule::size>& rule = mapped_rule<Rule, Domain>();
+    std::array<T, Rule::size> values;
+    evaluate_function<T>(function, std::span<const T>(rule.nodes), std::span<T>(values));
+    return simd::dot<T, Rule::size>(rule.weights.data(), values.data(), Rule::size);
+}
+
+} // namespace kuukan
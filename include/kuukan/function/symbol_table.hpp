@@ -0,0 +1,247 @@
+/**
+ * @file symbol_table.hpp
+ * @brief Hash-consed symbolic identities with stable integer IDs
+ *
+ * This file provides SymbolTable, which interns symbolic expressions
+ * (atoms, constants, sums, scalar multiples, negations and named function
+ * applications) as nodes referring to their operands by ID. Every
+ * structurally distinct expression is stored exactly once, so two
+ * expressions are equal exactly when their IDs are, each operation costs
+ * one hash lookup regardless of the depth of its operands, and the
+ * printable form is only assembled when asked for.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace kuukan {
+
+/// @brief Stable identifier of an interned expression
+using SymbolId = std::uint32_t;
+
+/// @brief Node kinds of a SymbolTable
+enum class SymbolKind : std::uint8_t {
+    atom,      ///< named leaf, e.g. "sin" (first: name index)
+    constant,  ///< scalar constant (value)
+    sum,       ///< first + second
+    scaled,    ///< value * first
+    negated,   ///< -first
+    call       ///< name(second) (first: name index)
+};
+
+/**
+ * @brief One interned expression node
+ *
+ * @tparam T The scalar type of constants and scale factors
+ */
+template <typename T>
+struct SymbolNode {
+    /// @brief The node kind
+    SymbolKind kind = SymbolKind::constant;
+
+    /// @brief First operand ID, or name index for atom and call
+    SymbolId first = 0;
+
+    /// @brief Second operand ID (sum, call)
+    SymbolId second = 0;
+
+    /// @brief Constant value or scale factor
+    T value{};
+
+    friend bool operator==(const SymbolNode&, const SymbolNode&) = default;
+};
+
+/**
+ * @brief Hash-consing table of symbolic expressions
+ *
+ * @tparam T The scalar type of constants and scale factors
+ *
+ * Nodes are never removed, so IDs stay valid for the lifetime of the table.
+ * Sums are stored with their operands in ID order (so f + g and g + f
+ * share an ID) and double negations collapse; no other algebra is applied.
+ *
+ * All member functions are thread-safe: interning takes an exclusive lock,
+ * lookups and printing a shared one. Comparing IDs needs no table access.
+ *
+ * @code{.cpp}
+ * auto& symbols = kuukan::SymbolTable<double>::global();
+ * kuukan::SymbolId f = symbols.sum(symbols.atom("sin"), symbols.atom("cos"));
+ * kuukan::SymbolId g = symbols.sum(symbols.atom("cos"), symbols.atom("sin"));
+ * bool same = f == g;                      // true
+ * std::string text = symbols.to_string(f); // "(sin + cos)"
+ * @endcode
+ */
+template <typename T>
+class SymbolTable {
+public:
+    /// @brief Type alias for the scalar type
+    using scalar_type = T;
+
+    /// @brief Type alias for the node type
+    using node_type   = SymbolNode<T>;
+
+    /// @brief The process-wide table, for element types whose operations are stateless functors
+    static SymbolTable& global() {
+        static SymbolTable table;
+        return table;
+    }
+
+    /// @brief Intern the named leaf name
+    SymbolId atom(std::string_view name) {
+        std::unique_lock lock(mutex_);
+        return intern(node_type{SymbolKind::atom, name_index(name), 0, T{}});
+    }
+
+    /// @brief Intern the constant value
+    SymbolId constant(const T& value) {
+        std::unique_lock lock(mutex_);
+        return intern(node_type{SymbolKind::constant, 0, 0, value});
+    }
+
+    /// @brief Intern left + right (commutative: operands are ordered by ID)
+    SymbolId sum(SymbolId left, SymbolId right) {
+        if (right < left) {
+            std::swap(left, right);
+        }
+        std::unique_lock lock(mutex_);
+        return intern(node_type{SymbolKind::sum, left, right, T{}});
+    }
+
+    /// @brief Intern factor * operand
+    SymbolId scaled(const T& factor, SymbolId operand) {
+        std::unique_lock lock(mutex_);
+        return intern(node_type{SymbolKind::scaled, operand, 0, factor});
+    }
+
+    /// @brief Intern -operand (-(-f) is f)
+    SymbolId negated(SymbolId operand) {
+        std::unique_lock lock(mutex_);
+        const node_type& inner = nodes_[operand];
+        if (inner.kind == SymbolKind::negated) {
+            return inner.first;
+        }
+        return intern(node_type{SymbolKind::negated, operand, 0, T{}});
+    }
+
+    /// @brief Intern function(argument), e.g. call("exp", f)
+    SymbolId call(std::string_view function, SymbolId argument) {
+        std::unique_lock lock(mutex_);
+        return intern(node_type{SymbolKind::call, name_index(function), argument, T{}});
+    }
+
+    /// @brief The node with the given ID
+    node_type node(SymbolId id) const {
+        std::shared_lock lock(mutex_);
+        return nodes_[id];
+    }
+
+    /// @brief Number of interned expressions
+    std::size_t size() const {
+        std::shared_lock lock(mutex_);
+        return nodes_.size();
+    }
+
+    /**
+     * @brief Printable form of an expression, built on demand
+     *
+     * Shared subexpressions are printed at every occurrence.
+     */
+    std::string to_string(SymbolId id) const {
+        std::shared_lock lock(mutex_);
+        std::string text;
+        print(id, text);
+        return text;
+    }
+
+private:
+    struct NodeHash {
+        std::size_t operator()(const node_type& node) const noexcept {
+            std::size_t hash = static_cast<std::size_t>(node.kind);
+            auto mix = [&](std::size_t value) { hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+            mix(node.first);
+            mix(node.second);
+            mix(std::hash<T>{}(node.value));
+            return hash;
+        }
+    };
+
+    SymbolId intern(const node_type& node) {
+        const auto [position, inserted] = index_.try_emplace(node, static_cast<SymbolId>(nodes_.size()));
+        if (inserted) {
+            nodes_.push_back(node);
+        }
+        return position->second;
+    }
+
+    SymbolId name_index(std::string_view name) {
+        const auto found = name_index_.find(std::string(name));
+        if (found != name_index_.end()) {
+            return found->second;
+        }
+        const auto index = static_cast<SymbolId>(names_.size());
+        names_.emplace_back(name);
+        name_index_.emplace(names_.back(), index);
+        return index;
+    }
+
+    void print(SymbolId id, std::string& text) const {
+        const node_type& node = nodes_[id];
+        switch (node.kind) {
+        case SymbolKind::atom:
+            text += names_[node.first];
+            break;
+        case SymbolKind::constant:
+            append_number(node.value, text);
+            break;
+        case SymbolKind::sum:
+            text += '(';
+            print(node.first, text);
+            text += " + ";
+            print(node.second, text);
+            text += ')';
+            break;
+        case SymbolKind::scaled:
+            text += '(';
+            append_number(node.value, text);
+            text += " * ";
+            print(node.first, text);
+            text += ')';
+            break;
+        case SymbolKind::negated:
+            text += "(-";
+            print(node.first, text);
+            text += ')';
+            break;
+        case SymbolKind::call:
+            text += names_[node.first];
+            text += '(';
+            print(node.second, text);
+            text += ')';
+            break;
+        }
+    }
+
+    static void append_number(const T& value, std::string& text) {
+        std::ostringstream stream;
+        stream << value;
+        text += stream.str();
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::vector<node_type> nodes_;
+    std::unordered_map<node_type, SymbolId, NodeHash> index_;
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, SymbolId> name_index_;
+};
+
+} // namespace kuukan
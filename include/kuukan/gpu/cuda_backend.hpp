@@ -0,0 +1,736 @@
+/**
+ * @file cuda_backend.hpp
+ * @brief Optional CUDA offload of batched dense distances, Gram matrices and sums
+ *
+ * When the library is configured with `KUUKAN_WITH_CUDA` (which defines
+ * `KUUKAN_HAS_CUDA` and links the CUDA runtime and cuBLAS), this file
+ * provides CudaExecutor, DeviceElementBatch and CudaExecutor overloads of
+ * pairwise_distances, cross_gram, reduce and weighted_sum for dense inner
+ * product spaces. Passing a CudaExecutor where the CPU entry points take an
+ * executor selects the device; everything else about the call is unchanged.
+ * Without it, `cuda::available` is false and the file declares nothing else.
+ *
+ * The kernels are cuBLAS level-2 and level-3 routines, so the header needs
+ * no CUDA compiler: host code including it is built by the usual C++
+ * compiler against the toolkit headers.
+ */
+
+#pragma once
+
+namespace kuukan::cuda {
+
+/// @brief Whether the CUDA backend is compiled in
+inline constexpr bool available =
+#if defined(KUUKAN_HAS_CUDA)
+    true;
+#else
+    false;
+#endif
+
+} // namespace kuukan::cuda
+
+#if defined(KUUKAN_HAS_CUDA)
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+#include <cuda_runtime_api.h>
+#include <cublas_v2.h>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/inner/inner_product_space.hpp"
+#include "kuukan/batch/element_batch.hpp"
+#include "kuukan/algorithm/pairwise_distances.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Tuning parameters of CudaExecutor
+ */
+struct CudaOptions {
+    /// @brief Rows of lhs per output tile
+    std::size_t tile_rows = 4096;
+
+    /// @brief Columns (rhs elements) per output tile
+    std::size_t tile_columns = 16384;
+
+    /// @brief Elements packed and sent per host-to-device transfer
+    std::size_t transfer_chunk = 16384;
+};
+
+/**
+ * @brief Executor placing batched dense work on a CUDA device
+ *
+ * Owns a cuBLAS handle and pipeline_depth streams on one device. Entry
+ * points that receive a CudaExecutor alternate their steps over the
+ * streams, so that the transfer of one tile overlaps the computation of the
+ * next and the host-side packing and unpacking run meanwhile.
+ *
+ * CudaExecutor deliberately does not satisfy ExecutorLike: it runs device
+ * kernels, not host tasks, and selects the overloads of this file.
+ *
+ * CUDA and cuBLAS failures do not throw. The first one is recorded (and
+ * asserted in debug builds); entry points return early once ok() is false,
+ * leaving their outputs unspecified.
+ *
+ * @note One CudaExecutor must not be used by several threads at once; use
+ *       one per thread (they may share a device).
+ */
+class CudaExecutor {
+public:
+    /// @brief Number of streams the pipelined entry points alternate over
+    static constexpr std::size_t pipeline_depth = 2;
+
+    /**
+     * @brief Create the streams and the cuBLAS handle on a device
+     *
+     * @param device The CUDA device ordinal
+     * @param options Tile and transfer sizes
+     */
+    explicit CudaExecutor(int device = 0, CudaOptions options = {})
+        : device_(device), options_(options) {
+        if (!check(cudaSetDevice(device_))) {
+            return;
+        }
+        for (cudaStream_t& stream : streams_) {
+            if (!check(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking))) {
+                return;
+            }
+        }
+        check(cublasCreate(&handle_));
+    }
+
+    CudaExecutor(const CudaExecutor&) = delete;
+    CudaExecutor& operator=(const CudaExecutor&) = delete;
+
+    ~CudaExecutor() {
+        cudaSetDevice(device_);
+        if (handle_ != nullptr) {
+            cublasDestroy(handle_);
+        }
+        for (cudaStream_t stream : streams_) {
+            if (stream != nullptr) {
+                cudaStreamDestroy(stream);
+            }
+        }
+    }
+
+    /// @brief The device ordinal
+    int device() const noexcept { return device_; }
+
+    /// @brief Tile and transfer sizes
+    const CudaOptions& options() const noexcept { return options_; }
+
+    /// @brief Whether no CUDA or cuBLAS call has failed
+    bool ok() const noexcept { return error_ == cudaSuccess && blas_error_ == CUBLAS_STATUS_SUCCESS; }
+
+    /// @brief The first CUDA runtime error, or cudaSuccess
+    cudaError_t error() const noexcept { return error_; }
+
+    /// @brief The first cuBLAS error, or CUBLAS_STATUS_SUCCESS
+    cublasStatus_t blas_error() const noexcept { return blas_error_; }
+
+    /// @brief Stream index of the pipeline
+    cudaStream_t stream(std::size_t index) const noexcept { return streams_[index % pipeline_depth]; }
+
+    /// @brief The cuBLAS handle
+    cublasHandle_t blas_handle() const noexcept { return handle_; }
+
+    /// @brief Make the device current on the calling thread; false once an error was recorded
+    bool activate() { return ok() && check(cudaSetDevice(device_)); }
+
+    /// @brief Wait for all work on the pipeline streams
+    void synchronize() {
+        for (cudaStream_t stream : streams_) {
+            check(cudaStreamSynchronize(stream));
+        }
+    }
+
+    /// @brief Record status if it is the first failure; returns whether it succeeded
+    bool check(cudaError_t status) {
+        assert(status == cudaSuccess);
+        if (status != cudaSuccess && error_ == cudaSuccess) {
+            error_ = status;
+        }
+        return status == cudaSuccess;
+    }
+
+    /// @copydoc check(cudaError_t)
+    bool check(cublasStatus_t status) {
+        assert(status == CUBLAS_STATUS_SUCCESS);
+        if (status != CUBLAS_STATUS_SUCCESS && blas_error_ == CUBLAS_STATUS_SUCCESS) {
+            blas_error_ = status;
+        }
+        return status == CUBLAS_STATUS_SUCCESS;
+    }
+
+private:
+    int device_;
+    CudaOptions options_;
+    cudaStream_t streams_[pipeline_depth] = {};
+    cublasHandle_t handle_ = nullptr;
+    cudaError_t error_ = cudaSuccess;
+    cublasStatus_t blas_error_ = CUBLAS_STATUS_SUCCESS;
+};
+
+/**
+ * @brief Concept for spaces the CUDA backend computes in
+ *
+ * Dense inner product spaces (e.g. DenseInnerProductSpace) with float or
+ * double components measured in the component type.
+ */
+template <typename VS>
+concept CudaDenseSpaceLike =
+    StaticVectorSpaceLike<VS> && InnerProductSpaceLike<VS> &&
+    DenseElementLike<typename VS::element_type> &&
+    (std::same_as<typename VS::element_type::value_type, float> ||
+     std::same_as<typename VS::element_type::value_type, double>) &&
+    std::same_as<typename VS::measure_type, typename VS::element_type::value_type>;
+
+namespace detail {
+
+/// @brief Device (Pinned = false) or page-locked host (Pinned = true) array of T
+template <typename T, bool Pinned>
+class CudaBuffer {
+public:
+    CudaBuffer() = default;
+    CudaBuffer(const CudaBuffer&) = delete;
+    CudaBuffer& operator=(const CudaBuffer&) = delete;
+    CudaBuffer(CudaBuffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    CudaBuffer& operator=(CudaBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+    ~CudaBuffer() { release(); }
+
+    /// @brief Hold at least size values (contents unspecified); false on failure
+    bool reserve(std::size_t size, CudaExecutor& executor) {
+        if (size <= size_) {
+            return true;
+        }
+        release();
+        void* memory = nullptr;
+        const cudaError_t status = Pinned ? cudaMallocHost(&memory, size * sizeof(T))
+                                          : cudaMalloc(&memory, size * sizeof(T));
+        if (!executor.check(status)) {
+            return false;
+        }
+        data_ = static_cast<T*>(memory);
+        size_ = size;
+        return true;
+    }
+
+    T*       data() noexcept       { return data_; }
+    const T* data() const noexcept { return data_; }
+
+private:
+    void release() noexcept {
+        if (data_ != nullptr) {
+            if constexpr (Pinned) {
+                cudaFreeHost(data_);
+            } else {
+                cudaFree(data_);
+            }
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+inline cublasStatus_t cuda_gemm(cublasHandle_t handle, cublasOperation_t left_op, cublasOperation_t right_op,
+                                int m, int n, int k, const float* alpha, const float* left, int left_ld,
+                                const float* right, int right_ld, const float* beta, float* out, int out_ld) {
+    return cublasSgemm(handle, left_op, right_op, m, n, k, alpha, left, left_ld, right, right_ld, beta, out, out_ld);
+}
+
+inline cublasStatus_t cuda_gemm(cublasHandle_t handle, cublasOperation_t left_op, cublasOperation_t right_op,
+                                int m, int n, int k, const double* alpha, const double* left, int left_ld,
+                                const double* right, int right_ld, const double* beta, double* out, int out_ld) {
+    return cublasDgemm(handle, left_op, right_op, m, n, k, alpha, left, left_ld, right, right_ld, beta, out, out_ld);
+}
+
+inline cublasStatus_t cuda_ger(cublasHandle_t handle, int m, int n, const float* alpha,
+                               const float* x, const float* y, float* out, int out_ld) {
+    return cublasSger(handle, m, n, alpha, x, 1, y, 1, out, out_ld);
+}
+
+inline cublasStatus_t cuda_ger(cublasHandle_t handle, int m, int n, const double* alpha,
+                               const double* x, const double* y, double* out, int out_ld) {
+    return cublasDger(handle, m, n, alpha, x, 1, y, 1, out, out_ld);
+}
+
+inline cublasStatus_t cuda_gemv(cublasHandle_t handle, cublasOperation_t op, int m, int n,
+                                const float* alpha, const float* matrix, int ld, const float* x,
+                                const float* beta, float* y) {
+    return cublasSgemv(handle, op, m, n, alpha, matrix, ld, x, 1, beta, y, 1);
+}
+
+inline cublasStatus_t cuda_gemv(cublasHandle_t handle, cublasOperation_t op, int m, int n,
+                                const double* alpha, const double* matrix, int ld, const double* x,
+                                const double* beta, double* y) {
+    return cublasDgemv(handle, op, m, n, alpha, matrix, ld, x, 1, beta, y, 1);
+}
+
+} // namespace detail
+
+/**
+ * @brief Device-resident batch of dense elements in ElementBatch layout
+ *
+ * @tparam VS The space of the elements (must satisfy CudaDenseSpaceLike)
+ *
+ * Components are stored structure-of-arrays like ElementBatch: dimension()
+ * rows of stride() lanes, which cuBLAS reads as a column-major
+ * size() × dimension() matrix with leading dimension stride(). The squared
+ * norms <x_i, x_i> are computed on the host while packing and kept on the
+ * device alongside, for the distance expansion.
+ *
+ * Uploading from a span of elements packs transfer_chunk elements at a time
+ * into page-locked buffers and sends each chunk while the next is packed,
+ * alternating over the executor's streams.
+ *
+ * @code{.cpp}
+ * using Space = kuukan::DenseInnerProductSpace<float>;
+ * kuukan::CudaExecutor gpu;
+ * kuukan::DeviceElementBatch<Space> references(std::span(points), gpu);   // resident across queries
+ * kuukan::pairwise_distances(Space{}, queries_on_device, references, std::span(matrix), {}, gpu);
+ * @endcode
+ */
+template <CudaDenseSpaceLike VS>
+class DeviceElementBatch {
+public:
+    /// @brief Type alias for the space of the elements
+    using space_type   = VS;
+
+    /// @brief Type alias for elements of the space
+    using element_type = typename VS::element_type;
+
+    /// @brief Type alias for the component type
+    using value_type   = typename element_type::value_type;
+
+    /// @brief Lane counts are rounded up to this (a 128-byte transaction of floats)
+    static constexpr std::size_t lane_alignment = 32;
+
+    /// @brief Construct an empty batch
+    DeviceElementBatch() = default;
+
+    /// @brief Upload a span of elements (see assign)
+    DeviceElementBatch(std::span<const element_type> elements, CudaExecutor& executor) {
+        assign(elements, executor);
+    }
+
+    /// @brief Upload a host ElementBatch (see assign)
+    DeviceElementBatch(const ElementBatch<VS>& batch, CudaExecutor& executor) {
+        assign(batch, executor);
+    }
+
+    /**
+     * @brief Replace the contents with a span of elements, pipelined through pinned buffers
+     *
+     * The dimension is the size of the largest element; empty elements are
+     * stored as zero. Returns when the upload has finished.
+     */
+    void assign(std::span<const element_type> elements, CudaExecutor& executor) {
+        std::size_t dimension = 0;
+        for (const element_type& element : elements) {
+            dimension = std::max(dimension, static_cast<std::size_t>(element.size()));
+        }
+        if (!allocate(dimension, elements.size(), round_up(elements.size()), executor)) {
+            return;
+        }
+        const std::size_t chunk = std::max<std::size_t>(executor.options().transfer_chunk, 1);
+        detail::CudaBuffer<value_type, true> staging[CudaExecutor::pipeline_depth];
+        detail::CudaBuffer<value_type, true> staging_norms[CudaExecutor::pipeline_depth];
+        for (std::size_t stage = 0; stage < CudaExecutor::pipeline_depth; ++stage) {
+            if (!staging[stage].reserve(chunk * std::max<std::size_t>(dimension, 1), executor) ||
+                !staging_norms[stage].reserve(chunk, executor)) {
+                return;
+            }
+        }
+        std::size_t step = 0;
+        for (std::size_t first = 0; first < count_; first += chunk, ++step) {
+            const std::size_t stage = step % CudaExecutor::pipeline_depth;
+            const cudaStream_t stream = executor.stream(stage);
+            const std::size_t count = std::min(chunk, count_ - first);
+            // The stage's previous transfer must finish before its buffer is refilled
+            if (!executor.check(cudaStreamSynchronize(stream))) {
+                return;
+            }
+            value_type* soa = staging[stage].data();
+            value_type* norms = staging_norms[stage].data();
+            for (std::size_t offset = 0; offset < count; ++offset) {
+                const element_type& element = elements[first + offset];
+                value_type squared{};
+                for (std::size_t component = 0; component < dimension; ++component) {
+                    const value_type value = component < element.size() ? element[component] : value_type{};
+                    soa[component * count + offset] = value;
+                    squared += value * value;
+                }
+                norms[offset] = squared;
+            }
+            if (dimension != 0) {
+                executor.check(cudaMemcpy2DAsync(data_.data() + first, stride_ * sizeof(value_type),
+                                                 soa, count * sizeof(value_type), count * sizeof(value_type),
+                                                 dimension, cudaMemcpyHostToDevice, stream));
+            }
+            executor.check(cudaMemcpyAsync(squared_norms_.data() + first, norms, count * sizeof(value_type),
+                                           cudaMemcpyHostToDevice, stream));
+        }
+        executor.synchronize();
+    }
+
+    /// @brief Replace the contents with a host ElementBatch (one transfer of its SoA buffer)
+    void assign(const ElementBatch<VS>& batch, CudaExecutor& executor) {
+        if (!allocate(batch.dimension(), batch.size(), batch.stride(), executor)) {
+            return;
+        }
+        std::vector<value_type> norms(count_, value_type{});
+        for (std::size_t component = 0; component < dimension_; ++component) {
+            const auto lanes = batch.row(component);
+            for (std::size_t index = 0; index < count_; ++index) {
+                norms[index] += lanes[index] * lanes[index];
+            }
+        }
+        const cudaStream_t stream = executor.stream(0);
+        executor.check(cudaMemcpyAsync(data_.data(), batch.data(), dimension_ * stride_ * sizeof(value_type),
+                                       cudaMemcpyHostToDevice, stream));
+        executor.check(cudaMemcpyAsync(squared_norms_.data(), norms.data(), count_ * sizeof(value_type),
+                                       cudaMemcpyHostToDevice, stream));
+        executor.check(cudaStreamSynchronize(stream));
+    }
+
+    /// @brief Copy the batch back into a host ElementBatch
+    ElementBatch<VS> download(CudaExecutor& executor) const {
+        ElementBatch<VS> batch(dimension_, count_);
+        if (executor.activate() && dimension_ != 0 && count_ != 0) {
+            const cudaStream_t stream = executor.stream(0);
+            executor.check(cudaMemcpy2DAsync(batch.data(), batch.stride() * sizeof(value_type),
+                                             data_.data(), stride_ * sizeof(value_type),
+                                             count_ * sizeof(value_type), dimension_,
+                                             cudaMemcpyDeviceToHost, stream));
+            executor.check(cudaStreamSynchronize(stream));
+        }
+        return batch;
+    }
+
+    /// @brief Number of elements
+    std::size_t size() const noexcept { return count_; }
+
+    /// @brief Whether the batch holds no elements
+    bool empty() const noexcept { return count_ == 0; }
+
+    /// @brief Number of components of every element
+    std::size_t dimension() const noexcept { return dimension_; }
+
+    /// @brief Distance (in values) between consecutive rows; the leading dimension for cuBLAS
+    std::size_t stride() const noexcept { return stride_; }
+
+    /// @brief The device SoA buffer (dimension() rows of stride() lanes)
+    const value_type* data() const noexcept { return data_.data(); }
+
+    /// @brief The device array of squared norms <x_i, x_i>
+    const value_type* squared_norms() const noexcept { return squared_norms_.data(); }
+
+private:
+    static std::size_t round_up(std::size_t count) noexcept {
+        return (count + lane_alignment - 1) / lane_alignment * lane_alignment;
+    }
+
+    bool allocate(std::size_t dimension, std::size_t count, std::size_t stride, CudaExecutor& executor) {
+        dimension_ = 0;
+        count_ = 0;
+        stride_ = 0;
+        if (!executor.activate() ||
+            !data_.reserve(std::max<std::size_t>(dimension * stride, 1), executor) ||
+            !squared_norms_.reserve(std::max<std::size_t>(count, 1), executor)) {
+            return false;
+        }
+        dimension_ = dimension;
+        count_ = count;
+        stride_ = stride;
+        return true;
+    }
+
+    detail::CudaBuffer<value_type, false> data_;
+    detail::CudaBuffer<value_type, false> squared_norms_;
+    std::size_t dimension_ = 0;
+    std::size_t count_ = 0;
+    std::size_t stride_ = 0;
+};
+
+namespace detail {
+
+/// @brief What cuda_cross_products writes per entry
+enum class CudaProduct { inner_product, distance, comparable };
+
+/**
+ * @brief Shared tile pipeline of the CUDA pairwise_distances and cross_gram
+ *
+ * The lhs.size() × rhs.size() output is cut into tiles of at most
+ * tile_rows × tile_columns. Step j computes one tile on stream j % 2 with
+ * one gemm (-2 <x, y>, or <x, y>) and, for distances, two rank-one updates
+ * adding <y, y> and <x, x>; the tile is then copied into a page-locked
+ * buffer. Before a stream's buffer is reused, the host waits for it and
+ * unpacks the tile into out (clamping, and taking the root for distances),
+ * so unpacking of one tile overlaps the computation of the next.
+ */
+template <CudaDenseSpaceLike VS>
+void cuda_cross_products(const DeviceElementBatch<VS>& lhs, const DeviceElementBatch<VS>& rhs,
+                         std::span<typename VS::measure_type> out, CudaProduct product,
+                         CudaExecutor& executor) {
+    using T = typename VS::measure_type;
+    const std::size_t rows = lhs.size();
+    const std::size_t columns = rhs.size();
+    assert(out.size() >= rows * columns);
+    assert(lhs.empty() || rhs.empty() || lhs.dimension() == rhs.dimension());
+    if (rows == 0 || columns == 0 || !executor.activate()) {
+        return;
+    }
+    const std::size_t dimension = std::min(lhs.dimension(), rhs.dimension());
+    const std::size_t tile_rows = std::min(std::max<std::size_t>(executor.options().tile_rows, 1), rows);
+    const std::size_t tile_columns = std::min(std::max<std::size_t>(executor.options().tile_columns, 1), columns);
+    const bool distances = product != CudaProduct::inner_product;
+
+    struct Stage {
+        CudaBuffer<T, false> tile;
+        CudaBuffer<T, true> host;
+        std::size_t row_begin = 0, row_count = 0, column_begin = 0, column_count = 0;
+        bool pending = false;
+    };
+    Stage stages[CudaExecutor::pipeline_depth];
+    for (Stage& stage : stages) {
+        if (!stage.tile.reserve(tile_rows * tile_columns, executor) ||
+            !stage.host.reserve(tile_rows * tile_columns, executor)) {
+            return;
+        }
+    }
+    CudaBuffer<T, false> ones;
+    if (distances) {
+        const std::vector<T> host_ones(std::max(tile_rows, tile_columns), T(1));
+        if (!ones.reserve(host_ones.size(), executor) ||
+            !executor.check(cudaMemcpy(ones.data(), host_ones.data(), host_ones.size() * sizeof(T),
+                                       cudaMemcpyHostToDevice))) {
+            return;
+        }
+    }
+
+    auto unpack = [&](Stage& stage, cudaStream_t stream) {
+        stage.pending = false;
+        if (!executor.check(cudaStreamSynchronize(stream))) {
+            return;
+        }
+        for (std::size_t row = 0; row < stage.row_count; ++row) {
+            const T* source = stage.host.data() + row * stage.column_count;
+            T* target = out.data() + (stage.row_begin + row) * columns + stage.column_begin;
+            if (product == CudaProduct::inner_product) {
+                std::copy(source, source + stage.column_count, target);
+            } else if (product == CudaProduct::comparable) {
+                for (std::size_t column = 0; column < stage.column_count; ++column) {
+                    target[column] = std::max(source[column], T(0));
+                }
+            } else {
+                for (std::size_t column = 0; column < stage.column_count; ++column) {
+                    target[column] = std::sqrt(std::max(source[column], T(0)));
+                }
+            }
+        }
+    };
+
+    const T alpha = distances ? T(-2) : T(1);
+    const T zero(0);
+    const T one(1);
+    const cublasHandle_t handle = executor.blas_handle();
+    std::size_t step = 0;
+    for (std::size_t row_begin = 0; row_begin < rows && executor.ok(); row_begin += tile_rows) {
+        for (std::size_t column_begin = 0; column_begin < columns && executor.ok(); column_begin += tile_columns, ++step) {
+            Stage& stage = stages[step % CudaExecutor::pipeline_depth];
+            const cudaStream_t stream = executor.stream(step);
+            if (stage.pending) {
+                unpack(stage, stream);
+            }
+            stage.row_begin = row_begin;
+            stage.row_count = std::min(tile_rows, rows - row_begin);
+            stage.column_begin = column_begin;
+            stage.column_count = std::min(tile_columns, columns - column_begin);
+            const int m = static_cast<int>(stage.column_count);
+            const int n = static_cast<int>(stage.row_count);
+            // Column-major column_count × row_count is the row-major tile of out
+            executor.check(cublasSetStream(handle, stream));
+            executor.check(cuda_gemm(handle, CUBLAS_OP_N, CUBLAS_OP_T, m, n, static_cast<int>(dimension),
+                                     &alpha, rhs.data() + column_begin, static_cast<int>(rhs.stride()),
+                                     lhs.data() + row_begin, static_cast<int>(lhs.stride()),
+                                     &zero, stage.tile.data(), m));
+            if (distances) {
+                executor.check(cuda_ger(handle, m, n, &one, rhs.squared_norms() + column_begin, ones.data(),
+                                        stage.tile.data(), m));
+                executor.check(cuda_ger(handle, m, n, &one, ones.data(), lhs.squared_norms() + row_begin,
+                                        stage.tile.data(), m));
+            }
+            executor.check(cudaMemcpyAsync(stage.host.data(), stage.tile.data(),
+                                           stage.row_count * stage.column_count * sizeof(T),
+                                           cudaMemcpyDeviceToHost, stream));
+            stage.pending = true;
+        }
+    }
+    for (std::size_t index = 0; index < CudaExecutor::pipeline_depth; ++index) {
+        if (stages[index].pending) {
+            unpack(stages[index], executor.stream(index));
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Compute the distance matrix between two device batches on the GPU
+ *
+ * @param space The space (selects the overload; its operations run as cuBLAS calls)
+ * @param lhs The row elements
+ * @param rhs The column elements
+ * @param out Caller-provided host buffer of at least lhs.size() * rhs.size() measures
+ * @param options Only options.comparable is read (squared distances instead of distances)
+ * @param executor The device (check executor.ok() afterwards)
+ *
+ * Entries are sqrt(<x, x> + <y, y> - 2 <x, y>), the expansion the CPU path
+ * uses for inner product spaces, clamped at zero before the root; they
+ * agree with the CPU result up to rounding. Tiles are sized by
+ * executor.options() and pipelined as described in DeviceElementBatch.
+ */
+template <CudaDenseSpaceLike MS>
+void pairwise_distances(const MS& space,
+                        const DeviceElementBatch<MS>& lhs,
+                        const DeviceElementBatch<MS>& rhs,
+                        std::span<typename MS::measure_type> out,
+                        PairwiseOptions options,
+                        CudaExecutor& executor) {
+    (void)space;
+    detail::cuda_cross_products(lhs, rhs, out,
+                                options.comparable ? detail::CudaProduct::comparable
+                                                   : detail::CudaProduct::distance,
+                                executor);
+}
+
+/**
+ * @brief Compute the distance matrix between two host spans on the GPU
+ *
+ * Uploads both spans through pinned buffers (see DeviceElementBatch), then
+ * proceeds as the device-batch overload. Both sets must fit in device
+ * memory; keep a DeviceElementBatch of a reference set that is queried
+ * repeatedly instead of passing it as a span every time.
+ *
+ * @code{.cpp}
+ * kuukan::CudaExecutor gpu;
+ * kuukan::pairwise_distances(Space{}, std::span(queries), std::span(references), std::span(matrix), {}, gpu);
+ * @endcode
+ */
+template <CudaDenseSpaceLike MS>
+void pairwise_distances(const MS& space,
+                        std::span<const typename MS::element_type> lhs,
+                        std::span<const typename MS::element_type> rhs,
+                        std::span<typename MS::measure_type> out,
+                        PairwiseOptions options,
+                        CudaExecutor& executor) {
+    const DeviceElementBatch<MS> device_lhs(lhs, executor);
+    const DeviceElementBatch<MS> device_rhs(rhs, executor);
+    pairwise_distances(space, device_lhs, device_rhs, out, options, executor);
+}
+
+/**
+ * @brief Compute the cross Gram matrix out[i * rhs.size() + j] = <lhs_i, rhs_j> on the GPU
+ *
+ * One gemm per tile, pipelined like pairwise_distances.
+ */
+template <CudaDenseSpaceLike IPS>
+void cross_gram(const IPS& space,
+                const DeviceElementBatch<IPS>& lhs,
+                const DeviceElementBatch<IPS>& rhs,
+                std::span<typename IPS::measure_type> out,
+                CudaExecutor& executor) {
+    (void)space;
+    detail::cuda_cross_products(lhs, rhs, out, detail::CudaProduct::inner_product, executor);
+}
+
+/// @brief cross_gram of two host spans, uploaded first (see pairwise_distances)
+template <CudaDenseSpaceLike IPS>
+void cross_gram(const IPS& space,
+                std::span<const typename IPS::element_type> lhs,
+                std::span<const typename IPS::element_type> rhs,
+                std::span<typename IPS::measure_type> out,
+                CudaExecutor& executor) {
+    const DeviceElementBatch<IPS> device_lhs(lhs, executor);
+    const DeviceElementBatch<IPS> device_rhs(rhs, executor);
+    cross_gram(space, device_lhs, device_rhs, out, executor);
+}
+
+/**
+ * @brief Compute a_1 x_1 + ... + a_n x_n of a device batch on the GPU
+ *
+ * @param space The space (selects the overload)
+ * @param weights The coefficients a_i (same length as batch)
+ * @param batch The elements x_i
+ * @param executor The device (check executor.ok() afterwards)
+ * @return The weighted sum, or zero_supplier() for an empty batch
+ *
+ * One gemv over the batch. The result is deterministic for a given device
+ * and cuBLAS version but, unlike the CPU weighted_sum, not bitwise equal to
+ * it.
+ */
+template <CudaDenseSpaceLike VS>
+typename VS::element_type weighted_sum(const VS& space,
+                                       std::span<const typename VS::scalar_type> weights,
+                                       const DeviceElementBatch<VS>& batch,
+                                       CudaExecutor& executor) {
+    using T = typename VS::element_type::value_type;
+    assert(weights.size() == batch.size());
+    if (batch.empty() || batch.dimension() == 0 || !executor.activate()) {
+        return space.zero_supplier();
+    }
+    detail::CudaBuffer<T, false> device_weights;
+    detail::CudaBuffer<T, false> device_sum;
+    std::vector<T> host_weights(weights.begin(), weights.end());
+    std::vector<T> host_sum(batch.dimension());
+    const cudaStream_t stream = executor.stream(0);
+    const T one(1);
+    const T zero(0);
+    if (!device_weights.reserve(batch.size(), executor) || !device_sum.reserve(batch.dimension(), executor)) {
+        return space.zero_supplier();
+    }
+    executor.check(cudaMemcpyAsync(device_weights.data(), host_weights.data(), batch.size() * sizeof(T),
+                                   cudaMemcpyHostToDevice, stream));
+    executor.check(cublasSetStream(executor.blas_handle(), stream));
+    executor.check(detail::cuda_gemv(executor.blas_handle(), CUBLAS_OP_T,
+                                     static_cast<int>(batch.size()), static_cast<int>(batch.dimension()),
+                                     &one, batch.data(), static_cast<int>(batch.stride()),
+                                     device_weights.data(), &zero, device_sum.data()));
+    executor.check(cudaMemcpyAsync(host_sum.data(), device_sum.data(), batch.dimension() * sizeof(T),
+                                   cudaMemcpyDeviceToHost, stream));
+    executor.check(cudaStreamSynchronize(stream));
+    auto result = make_dense_element<typename VS::element_type>(batch.dimension());
+    for (std::size_t component = 0; component < host_sum.size(); ++component) {
+        result[component] = host_sum[component];
+    }
+    return result;
+}
+
+/// @brief Sum x_1 + ... + x_n of a device batch on the GPU (weighted_sum with unit weights)
+template <CudaDenseSpaceLike VS>
+typename VS::element_type reduce(const VS& space, const DeviceElementBatch<VS>& batch,
+                                 CudaExecutor& executor) {
+    const std::vector<typename VS::scalar_type> weights(batch.size(), typename VS::scalar_type(1));
+    return weighted_sum(space, std::span<const typename VS::scalar_type>(weights), batch, executor);
+}
+
+} // namespace kuukan
+
+#endif // KUUKAN_HAS_CUDA
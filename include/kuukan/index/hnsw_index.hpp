@@ -0,0 +1,642 @@
+/**
+ * @file hnsw_index.hpp
+ * @brief Hierarchical navigable small-world graph for approximate nearest-neighbour search
+ *
+ * This file provides HNSWIndex, a proximity graph over elements of any
+ * MetricSpaceLike structure. Unlike VPTree, whose pruning degrades when
+ * distances concentrate (as they do for high-dimensional embeddings), a
+ * graph search only follows edges towards the query, so its cost grows
+ * roughly logarithmically with the number of elements. Results are
+ * approximate; the beam width ef trades recall for latency per query.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/execution/executor.hpp"
+#include "kuukan/index/vp_tree.hpp"
+#include "kuukan/metric/metric_space.hpp"
+
+namespace kuukan {
+
+/// @brief Construction and search parameters of an HNSWIndex
+struct HNSWOptions {
+    /// @brief Neighbours kept per element on the upper layers (M); the bottom layer keeps 2 M
+    std::size_t max_neighbors = 16;
+
+    /// @brief Beam width of the searches that link a new element (larger: better graph, slower inserts)
+    std::size_t ef_construction = 200;
+
+    /// @brief Default beam width of queries (raised to k when smaller)
+    std::size_t ef_search = 64;
+
+    /// @brief Seed of the layer assignment; the graph is reproducible for sequential inserts
+    std::uint64_t seed = 0x853c49e6748fea9bull;
+
+    /// @brief Maximum tasks at once in bulk construction and knn_batch; 0 selects the executor's concurrency
+    std::size_t thread_count = 0;
+
+    /// @brief Bulk constructions and batches smaller than this run on the calling thread
+    std::size_t parallel_threshold = 1024;
+};
+
+/**
+ * @brief Approximate k-nearest-neighbour index over a metric space
+ *
+ * @tparam MS The metric space (must satisfy MetricSpaceLike)
+ *
+ * Every element is assigned a random top layer with geometrically
+ * decreasing probability and is linked, on each layer up to its top, to at
+ * most M near elements chosen by the neighbour-selection heuristic of
+ * Malkov and Yashunin (a candidate is skipped when it is closer to an
+ * already selected neighbour than to the new element, which keeps edges
+ * pointing in diverse directions). A query descends greedily through the
+ * sparse upper layers and finishes with a beam search of width ef on the
+ * bottom layer.
+ *
+ * Only MS::distance is required. All ranking is done on
+ * kuukan::comparable_distance, so spaces with a comparable surrogate (such
+ * as squared distances for dense L2 spaces) skip the root on every
+ * evaluation; returned distances are converted back with
+ * kuukan::comparable_to_distance.
+ *
+ * @section hnsw_layout Storage Layout
+ *
+ * The capacity is fixed at construction. Bottom-layer adjacency lists live
+ * in one flat array with a stride of 2 M + 1 (a count followed by the
+ * neighbour indices), so a search walks contiguous memory; the rarer upper
+ * layers of an element are stored together in one array per element.
+ * Elements are copied into an array indexed like the lists.
+ *
+ * @section hnsw_concurrency Concurrency
+ *
+ * insert may be called from several threads at once, also while other
+ * threads run queries; each adjacency list has its own lock and is copied
+ * out before it is traversed. size() only counts a prefix of completed
+ * inserts, while queries may already return elements whose insert has not
+ * returned yet; such an element is fully written before it becomes
+ * reachable. Search scratch space (visited marks and
+ * heaps) comes from a pool, so queries do not allocate per call.
+ *
+ * @section hnsw_usage Usage
+ *
+ * @code{.cpp}
+ * kuukan::HNSWOptions options;
+ * options.max_neighbors = 32;
+ * kuukan::HNSWIndex<MySpace> index{std::span<const MyPoint>(points), MySpace{}, options};
+ *
+ * auto fast    = index.knn(query, 10);        // default beam width
+ * auto precise = index.knn(query, 10, 400);   // higher recall, slower
+ * std::optional<std::size_t> added = index.insert(another_point);   // nullopt when full
+ * @endcode
+ *
+ * @note Element types must be default-initializable and copyable.
+ */
+template <MetricSpaceLike MS>
+requires std::default_initializable<typename MS::element_type>
+      && std::copyable<typename MS::element_type>
+class HNSWIndex {
+public:
+    /// @brief Type alias for the metric space
+    using space_type    = MS;
+
+    /// @brief Type alias for elements of the space
+    using element_type  = typename MS::element_type;
+
+    /// @brief Type alias for the distance measure type
+    using measure_type  = typename MS::measure_type;
+
+    /// @brief Type alias for query results
+    using neighbor_type = Neighbor<measure_type>;
+
+    /// @brief Construct an empty index without capacity
+    HNSWIndex() = default;
+
+    /**
+     * @brief Construct an empty index for up to capacity elements
+     *
+     * @param capacity The maximum number of elements
+     * @param space The metric space whose distance is used
+     * @param options Graph and search parameters
+     */
+    explicit HNSWIndex(std::size_t capacity, MS space = {}, HNSWOptions options = {})
+        : space_(std::move(space)),
+          options_(options),
+          capacity_(capacity),
+          bottom_stride_(2 * std::max<std::size_t>(options.max_neighbors, 2) + 1),
+          level_factor_(1.0 / std::log(static_cast<double>(std::max<std::size_t>(options.max_neighbors, 2)))),
+          elements_(capacity),
+          bottom_(capacity * bottom_stride_, 0),
+          upper_(capacity),
+          state_(std::make_unique<State>(capacity)) {
+        options_.max_neighbors = std::max<std::size_t>(options_.max_neighbors, 2);
+        assert(capacity < no_element);
+    }
+
+    /**
+     * @brief Build an index over copies of the given elements
+     *
+     * Element i of the span gets index i. Inserts run as concurrent tasks
+     * of the executor; with more than one task the graph depends on their
+     * interleaving.
+     *
+     * @param elements The elements to index (the capacity is their count)
+     * @param space The metric space whose distance is used
+     * @param options Graph and search parameters
+     * @param executor The executor running the inserts (default: default_executor())
+     */
+    template <ExecutorLike Executor = WorkStealingPool>
+    HNSWIndex(std::span<const element_type> elements, MS space = {}, HNSWOptions options = {},
+              Executor& executor = default_executor())
+        : HNSWIndex(elements.size(), std::move(space), options) {
+        const std::size_t count = elements.size();
+        run_parallel(executor, count, [&](std::size_t index, Workspace& workspace) {
+            link(static_cast<std::uint32_t>(index), elements[index], workspace);
+        });
+        state_->reserved.store(static_cast<std::uint32_t>(count), std::memory_order_relaxed);
+        state_->count.store(static_cast<std::uint32_t>(count), std::memory_order_release);
+    }
+
+    /**
+     * @brief Number of indexed elements
+     *
+     * Counts the longest run of ids 0, 1, ... whose inserts have returned,
+     * so element(i) for every i below size() is fully written. Inserts that
+     * are still running (or that finished after a smaller, still running
+     * id) are not counted yet.
+     */
+    std::size_t size() const noexcept {
+        return state_ ? state_->count.load(std::memory_order_acquire) : 0;
+    }
+
+    /// @brief Whether the index holds no elements
+    bool empty() const noexcept { return size() == 0; }
+
+    /// @brief The maximum number of elements
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    /// @brief The parameters the index was built with
+    const HNSWOptions& options() const noexcept { return options_; }
+
+    /// @brief The element with the given index (below size(), or returned by a query)
+    const element_type& element(std::size_t index) const noexcept {
+        assert(index < state_->reserved.load(std::memory_order_relaxed));
+        return elements_[index];
+    }
+
+    /**
+     * @brief Add a copy of an element (thread-safe)
+     *
+     * @param element The element to add
+     * @return The index of the element, as reported by later queries, or
+     *         std::nullopt when the index is full (nothing is added then)
+     */
+    std::optional<std::size_t> insert(const element_type& element) {
+        if (!state_) {
+            return std::nullopt;
+        }
+        // Claim an id only while one is free, so a full index is never written past
+        std::uint32_t id = state_->reserved.load(std::memory_order_relaxed);
+        do {
+            if (id >= capacity_) {
+                return std::nullopt;
+            }
+        } while (!state_->reserved.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+        {
+            WorkspaceLease workspace(*this);
+            link(id, element, *workspace);
+        }
+        publish(id);
+        return id;
+    }
+
+    /**
+     * @brief Find approximately the k nearest elements to a query (thread-safe)
+     *
+     * @param query The query element
+     * @param k The number of neighbours to return
+     * @param ef The beam width (0: options().ef_search); larger values raise recall and latency
+     * @return Up to k neighbours ordered by ascending distance
+     */
+    std::vector<neighbor_type> knn(const element_type& query, std::size_t k, std::size_t ef = 0) const {
+        std::vector<neighbor_type> result;
+        if (k == 0 || empty()) {
+            return result;
+        }
+        WorkspaceLease workspace(*this);
+        search(query, k, ef, *workspace, result);
+        return result;
+    }
+
+    /**
+     * @brief Run knn for each of a batch of queries
+     *
+     * Queries are shared out among the tasks of the executor, each reusing
+     * one set of scratch buffers for all its queries.
+     *
+     * @param queries The query elements
+     * @param k The number of neighbours per query
+     * @param ef The beam width (0: options().ef_search)
+     * @param executor The executor running the queries (default: default_executor())
+     * @return The neighbours of queries[i] at position i
+     */
+    template <ExecutorLike Executor = WorkStealingPool>
+    std::vector<std::vector<neighbor_type>> knn_batch(std::span<const element_type> queries,
+                                                      std::size_t k, std::size_t ef = 0,
+                                                      Executor& executor = default_executor()) const {
+        std::vector<std::vector<neighbor_type>> results(queries.size());
+        if (k == 0 || empty()) {
+            return results;
+        }
+        run_parallel(executor, queries.size(), [&](std::size_t index, Workspace& workspace) {
+            search(queries[index], k, ef, workspace, results[index]);
+        });
+        return results;
+    }
+
+private:
+    static constexpr std::uint32_t no_element = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t   max_level  = 31;
+
+    struct Candidate {
+        measure_type  distance;  // comparable_distance to the query
+        std::uint32_t id;
+    };
+
+    struct Closer {
+        bool operator()(const Candidate& left, const Candidate& right) const { return left.distance < right.distance; }
+    };
+
+    struct Farther {
+        bool operator()(const Candidate& left, const Candidate& right) const { return right.distance < left.distance; }
+    };
+
+    /// @brief Scratch space of one search; visited marks are reset by bumping an epoch
+    struct Workspace {
+        std::vector<std::uint32_t> visited;
+        std::uint32_t              epoch = 0;
+        std::vector<Candidate>     frontier;   // min-heap (Farther)
+        std::vector<Candidate>     best;       // max-heap (Closer), at most ef entries
+        std::vector<Candidate>     selected;
+        std::vector<Candidate>     pruned;     // candidates of a full list being re-selected
+        std::vector<Candidate>     kept;
+        std::vector<std::pair<std::size_t, Candidate>> edges;   // (layer, neighbour) of a new element
+        std::vector<std::uint32_t> links;
+        std::vector<std::uint32_t> fresh;
+
+        explicit Workspace(std::size_t capacity) : visited(capacity, 0) {}
+
+        void next_epoch() {
+            if (++epoch == 0) {
+                std::fill(visited.begin(), visited.end(), 0);
+                epoch = 1;
+            }
+        }
+
+        /// @brief Mark id as visited; true when it was not visited in this epoch yet
+        bool visit(std::uint32_t id) {
+            if (visited[id] == epoch) {
+                return false;
+            }
+            visited[id] = epoch;
+            return true;
+        }
+    };
+
+    /// @brief Synchronisation state and the workspace pool (held by pointer so the index stays movable)
+    struct State {
+        std::atomic<std::uint32_t>              reserved{0};   // ids handed out by insert
+        std::atomic<std::uint32_t>              count{0};      // ids below this are fully inserted
+        std::mutex                              publish_mutex;
+        std::vector<bool>                       inserted;      // ids at or above count whose insert returned
+        std::mutex                              entry_mutex;
+        std::uint32_t                           entry = no_element;
+        std::size_t                             top_level = 0;
+        std::unique_ptr<std::mutex[]>           node_mutexes;
+        std::mutex                              pool_mutex;
+        std::vector<std::unique_ptr<Workspace>> pool;
+
+        explicit State(std::size_t capacity)
+            : inserted(capacity, false), node_mutexes(std::make_unique<std::mutex[]>(capacity)) {}
+    };
+
+    /// @brief A workspace borrowed from the pool for the lifetime of the lease
+    class WorkspaceLease {
+    public:
+        explicit WorkspaceLease(const HNSWIndex& index) : state_(*index.state_) {
+            {
+                std::lock_guard lock(state_.pool_mutex);
+                if (!state_.pool.empty()) {
+                    workspace_ = std::move(state_.pool.back());
+                    state_.pool.pop_back();
+                }
+            }
+            if (!workspace_) {
+                workspace_ = std::make_unique<Workspace>(index.capacity_);
+            }
+        }
+
+        WorkspaceLease(const WorkspaceLease&) = delete;
+        WorkspaceLease& operator=(const WorkspaceLease&) = delete;
+
+        ~WorkspaceLease() {
+            std::lock_guard lock(state_.pool_mutex);
+            state_.pool.push_back(std::move(workspace_));
+        }
+
+        Workspace& operator*() const noexcept { return *workspace_; }
+
+    private:
+        State&                     state_;
+        std::unique_ptr<Workspace> workspace_;
+    };
+
+    measure_type comparable(const element_type& left, const element_type& right) const {
+        return kuukan::comparable_distance(space_, left, right);
+    }
+
+    std::size_t max_links(std::size_t level) const noexcept {
+        return level == 0 ? bottom_stride_ - 1 : options_.max_neighbors;
+    }
+
+    /// @brief The adjacency list of id on a layer: a count followed by max_links(level) slots
+    std::uint32_t* list(std::uint32_t id, std::size_t level) noexcept {
+        return level == 0 ? bottom_.data() + id * bottom_stride_
+                          : upper_[id].data() + (level - 1) * (options_.max_neighbors + 1);
+    }
+
+    const std::uint32_t* list(std::uint32_t id, std::size_t level) const noexcept {
+        return const_cast<HNSWIndex*>(this)->list(id, level);
+    }
+
+    /// @brief Copy the adjacency list of id on a layer into links, under its lock
+    void read_links(std::uint32_t id, std::size_t level, std::vector<std::uint32_t>& links) const {
+        std::lock_guard lock(state_->node_mutexes[id]);
+        const std::uint32_t* source = list(id, level);
+        links.assign(source + 1, source + 1 + source[0]);
+    }
+
+    /// @brief Top layer of an element: floor(-ln(u) / ln(M)) for u uniform in (0, 1], from a hash of its index
+    std::size_t random_level(std::uint32_t id) const noexcept {
+        std::uint64_t bits = options_.seed + (std::uint64_t(id) + 1) * 0x9e3779b97f4a7c15ull;
+        bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ull;
+        bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebull;
+        bits ^= bits >> 31;
+        const double uniform = (double(bits >> 11) + 1.0) * 0x1.0p-53;
+        return std::min(static_cast<std::size_t>(-std::log(uniform) * level_factor_), max_level);
+    }
+
+    /// @brief Move entry to its closest neighbour on a layer until no neighbour is closer
+    void greedy_descent(const element_type& query, Candidate& entry, std::size_t level, Workspace& workspace) const {
+        for (bool moved = true; moved;) {
+            moved = false;
+            read_links(entry.id, level, workspace.links);
+            for (const std::uint32_t neighbor : workspace.links) {
+                const measure_type distance = comparable(query, elements_[neighbor]);
+                if (distance < entry.distance) {
+                    entry = Candidate{distance, neighbor};
+                    moved = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Beam search of width ef on one layer, starting from entry
+     *
+     * Leaves the (at most ef) closest elements found in workspace.best,
+     * sorted by ascending distance.
+     */
+    void search_layer(const element_type& query, const Candidate& entry, std::size_t ef,
+                      std::size_t level, Workspace& workspace) const {
+        workspace.next_epoch();
+        workspace.visit(entry.id);
+        workspace.frontier.assign(1, entry);
+        workspace.best.assign(1, entry);
+
+        while (!workspace.frontier.empty()) {
+            std::pop_heap(workspace.frontier.begin(), workspace.frontier.end(), Farther{});
+            const Candidate current = workspace.frontier.back();
+            workspace.frontier.pop_back();
+            if (workspace.best.size() >= ef && workspace.best.front().distance < current.distance) {
+                break;
+            }
+
+            // Gather the unvisited neighbours first, then evaluate their distances in one sweep
+            read_links(current.id, level, workspace.links);
+            workspace.fresh.clear();
+            for (const std::uint32_t neighbor : workspace.links) {
+                if (workspace.visit(neighbor)) {
+                    workspace.fresh.push_back(neighbor);
+                }
+            }
+            for (const std::uint32_t neighbor : workspace.fresh) {
+                const measure_type distance = comparable(query, elements_[neighbor]);
+                if (workspace.best.size() < ef || distance < workspace.best.front().distance) {
+                    workspace.frontier.push_back(Candidate{distance, neighbor});
+                    std::push_heap(workspace.frontier.begin(), workspace.frontier.end(), Farther{});
+                    workspace.best.push_back(Candidate{distance, neighbor});
+                    std::push_heap(workspace.best.begin(), workspace.best.end(), Closer{});
+                    if (workspace.best.size() > ef) {
+                        std::pop_heap(workspace.best.begin(), workspace.best.end(), Closer{});
+                        workspace.best.pop_back();
+                    }
+                }
+            }
+        }
+        std::sort_heap(workspace.best.begin(), workspace.best.end(), Closer{});
+    }
+
+    /**
+     * @brief Neighbour-selection heuristic: keep candidates closer to the base than to any kept one
+     *
+     * @param candidates Candidates sorted by ascending distance to the base element
+     * @param limit The maximum number to keep
+     * @param selected Receives the kept candidates
+     */
+    void select_neighbors(std::span<const Candidate> candidates, std::size_t limit,
+                          std::vector<Candidate>& selected) const {
+        selected.clear();
+        for (const Candidate& candidate : candidates) {
+            if (selected.size() == limit) {
+                break;
+            }
+            bool diverse = true;
+            for (const Candidate& kept : selected) {
+                if (comparable(elements_[candidate.id], elements_[kept.id]) < candidate.distance) {
+                    diverse = false;
+                    break;
+                }
+            }
+            if (diverse) {
+                selected.push_back(candidate);
+            }
+        }
+    }
+
+    /// @brief Add the edge target -> id on a layer, re-selecting the list of target when it is full
+    void connect(std::uint32_t target, const Candidate& edge, std::size_t level, Workspace& workspace) {
+        std::lock_guard lock(state_->node_mutexes[target]);
+        std::uint32_t* links = list(target, level);
+        const std::size_t limit = max_links(level);
+        if (links[0] < limit) {
+            links[1 + links[0]] = edge.id;
+            ++links[0];
+            return;
+        }
+        workspace.pruned.assign(1, edge);
+        for (std::size_t slot = 1; slot <= links[0]; ++slot) {
+            workspace.pruned.push_back(Candidate{comparable(elements_[target], elements_[links[slot]]), links[slot]});
+        }
+        std::sort(workspace.pruned.begin(), workspace.pruned.end(), Closer{});
+        select_neighbors(workspace.pruned, limit, workspace.kept);
+        links[0] = static_cast<std::uint32_t>(workspace.kept.size());
+        for (std::size_t slot = 0; slot < workspace.kept.size(); ++slot) {
+            links[1 + slot] = workspace.kept[slot].id;
+        }
+    }
+
+    /// @brief Mark id as inserted and advance count over the completed prefix of ids
+    void publish(std::uint32_t id) {
+        std::lock_guard lock(state_->publish_mutex);
+        state_->inserted[id] = true;
+        std::uint32_t count = state_->count.load(std::memory_order_relaxed);
+        while (count < capacity_ && state_->inserted[count]) {
+            ++count;
+        }
+        state_->count.store(count, std::memory_order_release);
+    }
+
+    /// @brief Store element at id and link it into every layer up to its own top layer
+    void link(std::uint32_t id, const element_type& element, Workspace& workspace) {
+        // Written before id is published through any adjacency list (whose locks order the accesses)
+        elements_[id] = element;
+        const std::size_t level = random_level(id);
+        if (level > 0) {
+            upper_[id].assign(level * (options_.max_neighbors + 1), 0);
+        }
+
+        std::unique_lock entry_lock(state_->entry_mutex);
+        if (state_->entry == no_element) {
+            state_->entry = id;
+            state_->top_level = level;
+            return;
+        }
+        const std::size_t top_level = state_->top_level;
+        Candidate entry{measure_type{}, state_->entry};
+        // Keep the lock only when id becomes the new entry point
+        if (level <= top_level) {
+            entry_lock.unlock();
+        }
+
+        entry.distance = comparable(element, elements_[entry.id]);
+        for (std::size_t layer = top_level; layer > level; --layer) {
+            greedy_descent(element, entry, layer, workspace);
+        }
+        workspace.edges.clear();
+        for (std::size_t layer = std::min(level, top_level) + 1; layer-- > 0;) {
+            search_layer(element, entry, options_.ef_construction, layer, workspace);
+            select_neighbors(workspace.best, options_.max_neighbors, workspace.selected);
+            {
+                std::lock_guard lock(state_->node_mutexes[id]);
+                std::uint32_t* links = list(id, layer);
+                links[0] = static_cast<std::uint32_t>(workspace.selected.size());
+                for (std::size_t slot = 0; slot < workspace.selected.size(); ++slot) {
+                    links[1 + slot] = workspace.selected[slot].id;
+                }
+            }
+            for (const Candidate& neighbor : workspace.selected) {
+                workspace.edges.emplace_back(layer, neighbor);
+            }
+            entry = workspace.best.front();
+        }
+        // Make id reachable only once all its own lists are written, so that concurrent
+        // searches never descend into a layer where it has no edges yet
+        for (const auto& [layer, neighbor] : workspace.edges) {
+            connect(neighbor.id, Candidate{neighbor.distance, id}, layer, workspace);
+        }
+
+        if (level > top_level) {
+            state_->entry = id;
+            state_->top_level = level;
+        }
+    }
+
+    void search(const element_type& query, std::size_t k, std::size_t ef, Workspace& workspace,
+                std::vector<neighbor_type>& result) const {
+        result.clear();
+        Candidate entry;
+        std::size_t top_level;
+        {
+            std::lock_guard lock(state_->entry_mutex);
+            if (state_->entry == no_element) {
+                return;
+            }
+            entry.id = state_->entry;
+            top_level = state_->top_level;
+        }
+        entry.distance = comparable(query, elements_[entry.id]);
+        for (std::size_t layer = top_level; layer > 0; --layer) {
+            greedy_descent(query, entry, layer, workspace);
+        }
+        search_layer(query, entry, std::max(ef != 0 ? ef : options_.ef_search, k), 0, workspace);
+
+        const std::size_t count = std::min(k, workspace.best.size());
+        result.reserve(count);
+        for (std::size_t slot = 0; slot < count; ++slot) {
+            const Candidate& hit = workspace.best[slot];
+            result.push_back(neighbor_type{hit.id, kuukan::comparable_to_distance(space_, hit.distance)});
+        }
+    }
+
+    /// @brief Call task(index, workspace) for every index below count, in at most options().thread_count tasks
+    template <typename Executor, typename Task>
+    void run_parallel(Executor& executor, std::size_t count, Task task) const {
+        std::size_t task_count = options_.thread_count != 0
+            ? options_.thread_count
+            : std::max<std::size_t>(executor.concurrency(), 1);
+        task_count = std::min(task_count, count);
+        if (task_count <= 1 || count < options_.parallel_threshold) {
+            WorkspaceLease workspace(*this);
+            for (std::size_t index = 0; index < count; ++index) {
+                task(index, *workspace);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next{0};
+        executor.bulk(task_count, [&](std::size_t) {
+            WorkspaceLease workspace(*this);
+            for (std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+                 index < count;
+                 index = next.fetch_add(1, std::memory_order_relaxed)) {
+                task(index, *workspace);
+            }
+        });
+    }
+
+    [[no_unique_address]] MS                space_{};
+    HNSWOptions                             options_{};
+    std::size_t                             capacity_ = 0;
+    std::size_t                             bottom_stride_ = 0;
+    double                                  level_factor_ = 0;
+    std::vector<element_type>               elements_;
+    std::vector<std::uint32_t>              bottom_;
+    std::vector<std::vector<std::uint32_t>> upper_;
+    std::unique_ptr<State>                  state_;
+};
+
+} // namespace kuukan
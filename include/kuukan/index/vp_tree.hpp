@@ -0,0 +1,259 @@
+/**
+ * @file vp_tree.hpp
+ * @brief Vantage-point tree for exact nearest-neighbour and range search
+ *
+ * This file provides VPTree, a metric tree built once over a set of elements
+ * of any MetricSpaceLike structure. Queries prune whole subtrees with the
+ * triangle inequality, so they usually need far fewer distance evaluations
+ * than a linear scan.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <queue>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/metric/metric_space.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Result entry of a similarity search
+ *
+ * @tparam MeasureType The distance measure type
+ */
+template <typename MeasureType>
+struct Neighbor {
+    /// @brief Position of the element in the span the index was built from
+    std::size_t index;
+
+    /// @brief Distance from the query to the element
+    MeasureType distance;
+
+    friend constexpr bool operator<(const Neighbor& left, const Neighbor& right) {
+        return left.distance < right.distance;
+    }
+};
+
+/**
+ * @brief Vantage-point tree over a metric space
+ *
+ * @tparam MS The metric space (must satisfy MetricSpaceLike)
+ *
+ * Every node picks a vantage point v and the median distance mu of its
+ * remaining elements to v. Elements with distance <= mu go to the inside
+ * subtree, the others to the outside subtree. For a query q at distance d
+ * from v and a search radius tau, the triangle inequality of the metric
+ * guarantees that
+ * - the inside subtree can only contain hits if d <= mu + tau, and
+ * - the outside subtree can only contain hits if mu <= d + tau,
+ * so the other subtree is skipped. Only addition and comparison of
+ * measures are needed (see OrderedMeasure).
+ *
+ * @section vp_tree_layout Storage Layout
+ *
+ * Nodes live in one flat array in pre-order: the inside child of node i is
+ * node i + 1 and only the outside child is stored as an index. The elements
+ * are copied into a parallel array in the same order, so a descent touches
+ * contiguous memory.
+ *
+ * @section vp_tree_usage Usage
+ *
+ * @code{.cpp}
+ * kuukan::VPTree<MySpace> tree{std::span<const MyPoint>(points)};
+ *
+ * auto nearest = tree.knn(query, 5);     // 5 closest, ascending distance
+ * auto within  = tree.range(query, 0.5); // all with distance <= 0.5
+ * for (const auto& hit : nearest) {
+ *     use(points[hit.index], hit.distance);
+ * }
+ * @endcode
+ *
+ * @note Queries are exact provided MS::distance satisfies the metric axioms.
+ */
+template <MetricSpaceLike MS>
+class VPTree {
+public:
+    /// @brief Type alias for the metric space
+    using space_type    = MS;
+
+    /// @brief Type alias for elements of the space
+    using element_type  = typename MS::element_type;
+
+    /// @brief Type alias for the distance measure type
+    using measure_type  = typename MS::measure_type;
+
+    /// @brief Type alias for query results
+    using neighbor_type = Neighbor<measure_type>;
+
+    /// @brief Construct an empty tree
+    VPTree() = default;
+
+    /**
+     * @brief Build a tree over copies of the given elements
+     *
+     * Takes O(N log N) distance evaluations.
+     *
+     * @param elements The elements to index
+     * @param space The metric space whose distance is used
+     */
+    explicit VPTree(std::span<const element_type> elements, MS space = {})
+        : space_(std::move(space)) {
+        const std::size_t count = elements.size();
+        std::vector<std::pair<measure_type, std::size_t>> work(count);
+        for (std::size_t index = 0; index < count; ++index) {
+            work[index].second = index;
+        }
+        nodes_.reserve(count);
+        elements_.reserve(count);
+        if (count != 0) {
+            build(elements, work, 0, count);
+        }
+    }
+
+    /// @brief Number of indexed elements
+    std::size_t size() const noexcept { return nodes_.size(); }
+
+    /// @brief Whether the tree holds no elements
+    bool empty() const noexcept { return nodes_.empty(); }
+
+    /**
+     * @brief Find the k nearest elements to a query
+     *
+     * @param query The query element
+     * @param k The number of neighbours to return
+     * @return Up to k neighbours ordered by ascending distance
+     */
+    std::vector<neighbor_type> knn(const element_type& query, std::size_t k) const {
+        std::vector<neighbor_type> result;
+        if (k == 0 || nodes_.empty()) {
+            return result;
+        }
+        result.reserve(std::min(k, nodes_.size()) + 1);
+        std::priority_queue<neighbor_type, std::vector<neighbor_type>> heap(
+            std::less<neighbor_type>{}, std::move(result));
+        search_knn(0, query, k, heap);
+
+        result.resize(heap.size());
+        for (std::size_t slot = heap.size(); slot > 0; --slot) {
+            result[slot - 1] = heap.top();
+            heap.pop();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Find all elements within a radius of a query
+     *
+     * @param query The query element
+     * @param radius The search radius (inclusive)
+     * @return All neighbours with distance <= radius, by ascending distance
+     */
+    std::vector<neighbor_type> range(const element_type& query, const measure_type& radius) const {
+        std::vector<neighbor_type> result;
+        if (!nodes_.empty()) {
+            search_range(0, query, radius, result);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+private:
+    static constexpr std::size_t no_child = std::numeric_limits<std::size_t>::max();
+
+    struct Node {
+        std::size_t  index;      // position in the input span
+        measure_type threshold;  // median distance of the subtree to the vantage point
+        std::size_t  outside;    // node index of the outside child, or no_child
+        bool         has_inside;
+    };
+
+    void build(std::span<const element_type> elements,
+               std::vector<std::pair<measure_type, std::size_t>>& work,
+               std::size_t begin, std::size_t end) {
+        // The middle element is a cheap, deterministic vantage point that
+        // avoids the degenerate trees a fixed first choice gives on sorted input.
+        std::swap(work[begin], work[begin + (end - begin) / 2]);
+        const std::size_t node_index = nodes_.size();
+        const element_type& vantage = elements[work[begin].second];
+        nodes_.push_back(Node{work[begin].second, measure_type{}, no_child, false});
+        elements_.push_back(vantage);
+
+        const std::size_t first = begin + 1;
+        if (first == end) {
+            return;
+        }
+        for (std::size_t slot = first; slot < end; ++slot) {
+            work[slot].first = space_.distance(vantage, elements[work[slot].second]);
+        }
+        const std::size_t median = first + (end - first) / 2;
+        auto by_distance = [](const auto& left, const auto& right) { return left.first < right.first; };
+        std::nth_element(work.begin() + first, work.begin() + median, work.begin() + end, by_distance);
+        nodes_[node_index].threshold = work[median].first;
+
+        // Inside: [first, median] (distance <= threshold); outside: (median, end)
+        nodes_[node_index].has_inside = true;
+        build(elements, work, first, median + 1);
+        if (median + 1 < end) {
+            nodes_[node_index].outside = nodes_.size();
+            build(elements, work, median + 1, end);
+        }
+    }
+
+    template <typename Heap>
+    void search_knn(std::size_t node_index, const element_type& query, std::size_t k, Heap& heap) const {
+        const Node& node = nodes_[node_index];
+        const measure_type distance = space_.distance(query, elements_[node_index]);
+        if (heap.size() < k) {
+            heap.push(neighbor_type{node.index, distance});
+        } else if (distance < heap.top().distance) {
+            heap.pop();
+            heap.push(neighbor_type{node.index, distance});
+        }
+
+        const std::size_t inside = node.has_inside ? node_index + 1 : no_child;
+        // The radius shrinks as the heap fills, so descend the likelier side first
+        const bool inside_first = distance <= node.threshold;
+        const std::size_t near_child = inside_first ? inside : node.outside;
+        const std::size_t far_child  = inside_first ? node.outside : inside;
+
+        if (near_child != no_child) {
+            search_knn(near_child, query, k, heap);
+        }
+        if (far_child != no_child) {
+            const bool full = heap.size() == k;
+            const bool reachable = !full || (inside_first
+                ? node.threshold <= distance + heap.top().distance
+                : distance <= node.threshold + heap.top().distance);
+            if (reachable) {
+                search_knn(far_child, query, k, heap);
+            }
+        }
+    }
+
+    void search_range(std::size_t node_index, const element_type& query, const measure_type& radius,
+                      std::vector<neighbor_type>& result) const {
+        const Node& node = nodes_[node_index];
+        const measure_type distance = space_.distance(query, elements_[node_index]);
+        if (distance <= radius) {
+            result.push_back(neighbor_type{node.index, distance});
+        }
+        if (node.has_inside && distance <= node.threshold + radius) {
+            search_range(node_index + 1, query, radius, result);
+        }
+        if (node.outside != no_child && node.threshold <= distance + radius) {
+            search_range(node.outside, query, radius, result);
+        }
+    }
+
+    [[no_unique_address]] MS space_{};
+    std::vector<Node>         nodes_;
+    std::vector<element_type> elements_;
+};
+
+} // namespace kuukan
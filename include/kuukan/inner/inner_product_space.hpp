@@ -0,0 +1,345 @@
+/**
+ * @file inner_product_space.hpp
+ * @brief Inner product space interface that induces a norm and a metric
+ *
+ * This file provides the InnerProductSpace template, which defines an inner
+ * product space by extending a vector space with an inner product function.
+ * The inner product induces a norm, norm(v) = sqrt(<v, v>), which in turn
+ * induces a metric, exactly as NormedSpace induces its distance.
+ */
+
+#pragma once
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/metric/metric_space.hpp"
+#include "kuukan/norm/normed_space.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Inner product space that induces a normed space
+ *
+ * @tparam VS The base vector space (must satisfy StaticVectorSpaceLike)
+ * @tparam InnerProduct Functor type for the inner product:
+ *         (element_type, element_type) -> measure_type
+ * @tparam DifferenceNorm Optional fused functor for norm(left - right),
+ *         forwarded to NormedSpace (default: NotInjected)
+ * @tparam BoundedDifferenceNorm Optional early-exit functor, forwarded to
+ *         NormedSpace (default: NotInjected)
+ * @tparam ComparableDifferenceNorm Optional monotone surrogate of the distance,
+ *         forwarded to NormedSpace (default: NotInjected, which selects the
+ *         squared distance <left - right, left - right>)
+ *
+ * An inner product space is a vector space equipped with a (real) inner
+ * product, a function that is:
+ *
+ * 1. **Symmetric**: <u, v> = <v, u>
+ * 2. **Linear** in each argument: <a * u + w, v> = a * <u, v> + <w, v>
+ * 3. **Positive definite**: <v, v> > 0 for v != 0
+ *
+ * Your InnerProduct functor must satisfy these axioms; only its signature is
+ * checked at compile time.
+ *
+ * @section inner_induced Induced Structure
+ *
+ * The space provides:
+ * - `inner_product(u, v)` (static functor instance)
+ * - `norm(v) = sqrt(<v, v>)` through the nested InducedNorm functor
+ * - `distance`, `bounded_distance`, `comparable_distance` etc. of the induced
+ *   `normed_space = NormedSpace<VS, InducedNorm, ...>`
+ *
+ * @section inner_batched Batched Inner Products
+ *
+ * `gram(elements, out)` computes the Gram matrix and `project(x, basis)` the
+ * orthogonal projection onto the span of a basis. If the InnerProduct functor
+ * has static `gram(const element_type*, count, measure_type*)` and
+ * `cross(left, left_count, right, right_count, measure_type*)` kernels (the
+ * dense Euclidean inner product does, using BLAS when available), they are
+ * used; otherwise the inner product is evaluated pair by pair.
+ *
+ * @section inner_usage Usage
+ *
+ * @code{.cpp}
+ * using E = kuukan::InnerProductSpace<MyVectorSpace, MyDot>;
+ *
+ * double ip = E::inner_product(u, v);
+ * double n  = E::norm(u);              // sqrt(<u, u>)
+ * double d  = E::distance(u, v);       // norm(u - v)
+ *
+ * std::vector<double> g(basis.size() * basis.size());
+ * E::gram(std::span(basis), std::span(g));
+ * MyVector p = E::project(x, std::span(basis));
+ * @endcode
+ *
+ * @see NormedSpace
+ */
+template <StaticVectorSpaceLike VS, typename InnerProduct,
+          typename DifferenceNorm = NotInjected, typename BoundedDifferenceNorm = NotInjected,
+          typename ComparableDifferenceNorm = NotInjected>
+requires std::default_initializable<InnerProduct> &&
+         OrderedMeasure<std::invoke_result_t<InnerProduct,
+                                             const typename VS::element_type&,
+                                             const typename VS::element_type&>>
+struct InnerProductSpace : VS {
+    /// @brief Type alias for elements (inherited from vector space)
+    using element_type = typename VS::element_type;
+
+    /// @brief Type alias for scalars (inherited from vector space)
+    using scalar_type  = typename VS::scalar_type;
+
+    /// @brief Type alias for the value type of the inner product, norm and distance
+    using measure_type = std::invoke_result_t<InnerProduct, const element_type&, const element_type&>;
+
+    /// @brief Static instance of the inner product functor
+    static inline constexpr InnerProduct inner_product{};
+
+    /**
+     * @brief Internal functor for the norm induced by the inner product
+     *
+     * Implements norm(v) = sqrt(<v, v>).
+     */
+    struct InducedNorm {
+        constexpr measure_type operator()(const element_type& element) const {
+            using std::sqrt;
+            return sqrt(inner_product(element, element));
+        }
+    };
+
+    /**
+     * @brief Internal functor for the squared induced distance <l - r, l - r>
+     *
+     * Used as the comparable surrogate when none is injected.
+     */
+    struct InducedSquaredDistance {
+        constexpr measure_type operator()(const element_type& element_left,
+                                          const element_type& element_right) const {
+            const element_type delta = VS::difference(element_left, element_right);
+            return inner_product(delta, delta);
+        }
+
+        constexpr measure_type to_distance(const measure_type& comparable) const {
+            using std::sqrt;
+            return sqrt(comparable);
+        }
+
+        constexpr measure_type to_comparable(const measure_type& distance_value) const {
+            return distance_value * distance_value;
+        }
+    };
+
+    /// @brief Type alias for the normed space induced by this inner product
+    using normed_space = NormedSpace<VS, InducedNorm, DifferenceNorm, BoundedDifferenceNorm,
+                                     std::conditional_t<Injected<ComparableDifferenceNorm>,
+                                                        ComparableDifferenceNorm,
+                                                        InducedSquaredDistance>>;
+
+    /// @brief Type alias for the metric space induced by this inner product
+    using metric_space = typename normed_space::metric_space;
+
+    /// @brief Whether comparable_distance is the squared distance <l - r, l - r>
+    ///        (the default surrogate, or an injected one marked is_squared_distance)
+    static constexpr bool comparable_is_squared_distance =
+        !Injected<ComparableDifferenceNorm> || requires { requires ComparableDifferenceNorm::is_squared_distance; };
+
+    /// @brief Static instance of the induced norm functor
+    static inline constexpr InducedNorm norm{};
+
+    /// @brief Distance induced by the inner product: norm(left - right)
+    static constexpr measure_type distance(const element_type& element_left,
+                                           const element_type& element_right) {
+        return normed_space::distance(element_left, element_right);
+    }
+
+    /// @brief Exact distance if <= bound, otherwise a value > bound (see MetricSpace::bounded_distance)
+    static constexpr measure_type bounded_distance(const element_type& element_left,
+                                                   const element_type& element_right,
+                                                   const measure_type& bound) {
+        return normed_space::bounded_distance(element_left, element_right, bound);
+    }
+
+    /// @brief Whether distance(element_left, element_right) <= bound
+    static constexpr bool distance_within(const element_type& element_left,
+                                          const element_type& element_right,
+                                          const measure_type& bound) {
+        return normed_space::distance_within(element_left, element_right, bound);
+    }
+
+    /// @brief Value ordering pairs like their distance (the squared distance by default)
+    static constexpr measure_type comparable_distance(const element_type& element_left,
+                                                      const element_type& element_right) {
+        return normed_space::comparable_distance(element_left, element_right);
+    }
+
+    /// @brief Convert a comparable_distance value to the true distance
+    static constexpr measure_type to_distance(const measure_type& comparable) {
+        return normed_space::to_distance(comparable);
+    }
+
+    /// @brief Convert a true distance to the comparable scale
+    static constexpr measure_type to_comparable(const measure_type& distance_value) {
+        return normed_space::to_comparable(distance_value);
+    }
+
+    /**
+     * @brief Compute the Gram matrix of a set of elements
+     *
+     * Writes <elements[i], elements[j]> to out[i * n + j] for n = elements.size().
+     *
+     * @param elements The elements
+     * @param out Caller-provided buffer of at least n * n measures
+     */
+    static void gram(std::span<const element_type> elements, std::span<measure_type> out) {
+        const std::size_t count = elements.size();
+        if constexpr (requires(const element_type* values, std::size_t n, measure_type* result) {
+                          InnerProduct::gram(values, n, result);
+                      }) {
+            InnerProduct::gram(elements.data(), count, out.data());
+        } else {
+            for (std::size_t row = 0; row < count; ++row) {
+                for (std::size_t column = row; column < count; ++column) {
+                    const measure_type value = inner_product(elements[row], elements[column]);
+                    out[row * count + column] = value;
+                    out[column * count + row] = value;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the inner products of every element of left with every element of right
+     *
+     * Writes <left[i], right[j]> to out[i * right.size() + j].
+     *
+     * @param left The row elements
+     * @param right The column elements
+     * @param out Caller-provided buffer of at least left.size() * right.size() measures
+     */
+    static void cross_gram(std::span<const element_type> left, std::span<const element_type> right,
+                           std::span<measure_type> out) {
+        if constexpr (requires(const element_type* values, std::size_t n, measure_type* result) {
+                          InnerProduct::cross(values, n, values, n, result);
+                      }) {
+            InnerProduct::cross(left.data(), left.size(), right.data(), right.size(), out.data());
+        } else {
+            for (std::size_t row = 0; row < left.size(); ++row) {
+                for (std::size_t column = 0; column < right.size(); ++column) {
+                    out[row * right.size() + column] = inner_product(left[row], right[column]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Orthogonal projection onto the span of a basis
+     *
+     * Solves the normal equations G c = b, with the Gram matrix G of the basis
+     * and b_i = <basis_i, element>, by Cholesky factorization and returns
+     * sum_i c_i * basis_i through VS::linear_combination. Basis elements that
+     * are (numerically) linearly dependent on earlier ones get coefficient 0,
+     * so the result is still the projection onto the spanned subspace.
+     *
+     * @param element The element to project
+     * @param basis The spanning elements (need not be orthogonal)
+     * @return The element of span(basis) closest to element
+     */
+    static element_type project(const element_type& element, std::span<const element_type> basis)
+    requires std::convertible_to<measure_type, scalar_type> {
+        const std::size_t count = basis.size();
+        std::vector<measure_type> factor(count * count);
+        std::vector<measure_type> coefficients(count);
+        gram(basis, factor);
+        cross_gram(basis, std::span<const element_type>(&element, 1), coefficients);
+
+        // In-place lower Cholesky factor G = L L^T; dependent columns are zeroed
+        std::vector<bool> active(count, true);
+        for (std::size_t column = 0; column < count; ++column) {
+            const measure_type scale = factor[column * count + column];
+            measure_type pivot = scale;
+            for (std::size_t k = 0; k < column; ++k) {
+                pivot = pivot - factor[column * count + k] * factor[column * count + k];
+            }
+            if (!(dependence_tolerance * scale < pivot)) {
+                active[column] = false;
+                for (std::size_t row = column; row < count; ++row) {
+                    factor[row * count + column] = measure_type(0);
+                }
+                continue;
+            }
+            using std::sqrt;
+            const measure_type diagonal = sqrt(pivot);
+            factor[column * count + column] = diagonal;
+            for (std::size_t row = column + 1; row < count; ++row) {
+                measure_type value = factor[row * count + column];
+                for (std::size_t k = 0; k < column; ++k) {
+                    value = value - factor[row * count + k] * factor[column * count + k];
+                }
+                factor[row * count + column] = value / diagonal;
+            }
+        }
+
+        // Forward (L y = b) and backward (L^T c = y) substitution over the active columns
+        for (std::size_t row = 0; row < count; ++row) {
+            if (!active[row]) { coefficients[row] = measure_type(0); continue; }
+            measure_type value = coefficients[row];
+            for (std::size_t k = 0; k < row; ++k) {
+                value = value - factor[row * count + k] * coefficients[k];
+            }
+            coefficients[row] = value / factor[row * count + row];
+        }
+        for (std::size_t row = count; row-- > 0;) {
+            if (!active[row]) { continue; }
+            measure_type value = coefficients[row];
+            for (std::size_t k = row + 1; k < count; ++k) {
+                value = value - factor[k * count + row] * coefficients[k];
+            }
+            coefficients[row] = value / factor[row * count + row];
+        }
+
+        using term_type = typename VS::term_type;
+        std::vector<scalar_type> scalars(coefficients.begin(), coefficients.end());
+        std::vector<term_type> terms;
+        terms.reserve(count);
+        for (std::size_t index = 0; index < count; ++index) {
+            terms.push_back(term_type{scalars[index], basis[index]});
+        }
+        return VS::linear_combination(std::span<const term_type>(terms));
+    }
+
+private:
+    /// @brief Relative size of a Cholesky pivot below which a basis element counts as dependent
+    static constexpr measure_type dependence_tolerance =
+        measure_type(64) * std::numeric_limits<measure_type>::epsilon();
+};
+
+/**
+ * @brief Concept for metric spaces whose distance is induced by an inner product
+ *
+ * @tparam T The type to check
+ *
+ * A type satisfies InnerProductSpaceLike if it is MetricSpaceLike and has a
+ * `inner_product` function: (element_type, element_type) -> measure_type,
+ * such that distance(x, y) = sqrt(<x - y, x - y>).
+ *
+ * Algorithms may then use the expansion
+ *
+ *     distance(x, y)^2 = <x, x> + <y, y> - 2 <x, y>
+ *
+ * which reuses the squared norms of each element across many pairs.
+ *
+ * @note InnerProductSpace automatically satisfies this concept.
+ */
+template <typename T>
+concept InnerProductSpaceLike = MetricSpaceLike<T> &&
+    requires(const T& space, const typename T::element_type& element) {
+        { space.inner_product(element, element) } -> std::convertible_to<typename T::measure_type>;
+    };
+
+} // namespace kuukan
@@ -0,0 +1,797 @@
+/**
+ * @file instrumented.hpp
+ * @brief Per-operation call counts, latency histograms and allocation counts for spaces
+ *
+ * This file provides Instrumented<Space>, a drop-in replacement for a static
+ * space (VectorSpace, MetricSpace, NormedSpace, InnerProductSpace or any of
+ * the ready-made backends) whose operations record how often they are
+ * called, how long each call takes and, optionally, how many heap
+ * allocations each call makes. InstrumentedFunctor does the same for a
+ * single functor, e.g. a slot of a StatefulVectorSpace.
+ *
+ * Recording is compiled in only when `KUUKAN_ENABLE_INSTRUMENTATION` is
+ * defined (CMake option `KUUKAN_ENABLE_INSTRUMENTATION`). Without it every
+ * wrapper is a plain inline forwarding call and snapshots are empty, so
+ * instrumented spaces can stay in production code.
+ *
+ * @section instrumentation_counters Counters
+ *
+ * Every thread records into its own counters (one table per space type),
+ * which are written by that thread only, without read-modify-write atomics
+ * or locks. A snapshot sums the tables of all live threads plus those of
+ * threads that have exited. Timings are inclusive: a call that is made
+ * through another instrumented call is counted by both.
+ *
+ * @section instrumentation_allocations Allocation Counts
+ *
+ * Allocation counts come from the thread-local tally kept by
+ * note_allocation. Defining `KUUKAN_INSTRUMENT_GLOBAL_NEW` in exactly one
+ * translation unit before including this header replaces the global
+ * operator new and delete with versions that feed the tally, so every heap
+ * allocation made inside an instrumented call is attributed to it. Custom
+ * allocators may call note_allocation directly instead.
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kuukan/vector/vector_space.hpp"
+
+#if defined(KUUKAN_INSTRUMENT_GLOBAL_NEW)
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace kuukan {
+
+/// @brief Operations recorded by Instrumented and InstrumentedFunctor
+enum class SpaceOperation : std::uint8_t {
+    addition,
+    scalar_action,
+    negation,
+    zero_supplier,
+    equality,
+    difference,
+    add_assign,
+    scale_assign,
+    negate_in_place,
+    axpy,
+    linear_combination,
+    norm,
+    distance,
+    bounded_distance,
+    comparable_distance,
+    inner_product,
+    other
+};
+
+/// @brief Number of SpaceOperation values
+inline constexpr std::size_t space_operation_count = static_cast<std::size_t>(SpaceOperation::other) + 1;
+
+/// @brief Printable name of an operation
+constexpr const char* space_operation_name(SpaceOperation operation) noexcept {
+    constexpr std::array<const char*, space_operation_count> names{
+        "addition", "scalar_action", "negation", "zero_supplier", "equality", "difference",
+        "add_assign", "scale_assign", "negate_in_place", "axpy", "linear_combination",
+        "norm", "distance", "bounded_distance", "comparable_distance", "inner_product", "other"};
+    return names[static_cast<std::size_t>(operation)];
+}
+
+/// @brief Whether this build records anything (KUUKAN_ENABLE_INSTRUMENTATION)
+#if defined(KUUKAN_ENABLE_INSTRUMENTATION)
+inline constexpr bool instrumentation_enabled = true;
+#else
+inline constexpr bool instrumentation_enabled = false;
+#endif
+
+/**
+ * @brief Statistics of one operation
+ *
+ * Latencies are kept as a histogram with power-of-two buckets: bucket b
+ * counts calls that took [2^(b-1), 2^b) nanoseconds (bucket 0: under 1 ns).
+ */
+struct OperationStatistics {
+    /// @brief Number of latency buckets
+    static constexpr std::size_t latency_buckets = 40;
+
+    /// @brief Number of calls
+    std::uint64_t calls = 0;
+
+    /// @brief Total time spent in the calls
+    std::uint64_t nanoseconds = 0;
+
+    /// @brief Heap allocations made during the calls
+    std::uint64_t allocations = 0;
+
+    /// @brief Bytes allocated during the calls
+    std::uint64_t allocated_bytes = 0;
+
+    /// @brief Calls per latency bucket
+    std::array<std::uint64_t, latency_buckets> latency_histogram{};
+
+    /// @brief Mean latency of a call in nanoseconds (0 without calls)
+    double mean_nanoseconds() const noexcept {
+        return calls == 0 ? 0.0 : static_cast<double>(nanoseconds) / static_cast<double>(calls);
+    }
+
+    /**
+     * @brief Upper end of the bucket that contains the given latency quantile
+     *
+     * @param quantile A value in [0, 1], e.g. 0.99
+     * @return Nanoseconds by which at least that fraction of the calls had finished
+     */
+    std::uint64_t latency_quantile(double quantile) const noexcept {
+        const double rank = quantile * static_cast<double>(calls);
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < latency_buckets; ++bucket) {
+            seen += latency_histogram[bucket];
+            if (seen > 0 && static_cast<double>(seen) >= rank) {
+                return std::uint64_t(1) << bucket;
+            }
+        }
+        return calls == 0 ? 0 : std::uint64_t(1) << (latency_buckets - 1);
+    }
+
+    OperationStatistics& operator+=(const OperationStatistics& other) noexcept {
+        calls += other.calls;
+        nanoseconds += other.nanoseconds;
+        allocations += other.allocations;
+        allocated_bytes += other.allocated_bytes;
+        for (std::size_t bucket = 0; bucket < latency_buckets; ++bucket) {
+            latency_histogram[bucket] += other.latency_histogram[bucket];
+        }
+        return *this;
+    }
+
+    OperationStatistics& operator-=(const OperationStatistics& other) noexcept {
+        calls -= other.calls;
+        nanoseconds -= other.nanoseconds;
+        allocations -= other.allocations;
+        allocated_bytes -= other.allocated_bytes;
+        for (std::size_t bucket = 0; bucket < latency_buckets; ++bucket) {
+            latency_histogram[bucket] -= other.latency_histogram[bucket];
+        }
+        return *this;
+    }
+};
+
+/**
+ * @brief Statistics of every operation of one space, as returned by snapshot
+ */
+struct InstrumentationSnapshot {
+    /// @brief One entry per SpaceOperation
+    std::array<OperationStatistics, space_operation_count> operations{};
+
+    const OperationStatistics& operator[](SpaceOperation operation) const noexcept {
+        return operations[static_cast<std::size_t>(operation)];
+    }
+
+    OperationStatistics& operator[](SpaceOperation operation) noexcept {
+        return operations[static_cast<std::size_t>(operation)];
+    }
+
+    /// @brief Total number of recorded calls
+    std::uint64_t total_calls() const noexcept {
+        std::uint64_t total = 0;
+        for (const OperationStatistics& statistics : operations) {
+            total += statistics.calls;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Write one line per called operation
+     *
+     * Columns: calls, total milliseconds, mean / p50 / p99 nanoseconds,
+     * allocations and allocated bytes.
+     */
+    void dump(std::ostream& stream) const {
+        stream << std::left << std::setw(20) << "operation" << std::right
+               << std::setw(12) << "calls" << std::setw(12) << "total_ms"
+               << std::setw(10) << "mean_ns" << std::setw(10) << "p50_ns" << std::setw(10) << "p99_ns"
+               << std::setw(12) << "allocs" << std::setw(14) << "bytes" << '\n';
+        for (std::size_t index = 0; index < space_operation_count; ++index) {
+            const OperationStatistics& statistics = operations[index];
+            if (statistics.calls == 0) {
+                continue;
+            }
+            stream << std::left << std::setw(20) << space_operation_name(static_cast<SpaceOperation>(index))
+                   << std::right << std::setw(12) << statistics.calls
+                   << std::setw(12) << std::fixed << std::setprecision(3)
+                   << static_cast<double>(statistics.nanoseconds) * 1e-6
+                   << std::setw(10) << std::setprecision(1) << statistics.mean_nanoseconds()
+                   << std::setw(10) << statistics.latency_quantile(0.5)
+                   << std::setw(10) << statistics.latency_quantile(0.99)
+                   << std::setw(12) << statistics.allocations
+                   << std::setw(14) << statistics.allocated_bytes << '\n';
+        }
+        stream << std::defaultfloat;
+    }
+};
+
+namespace detail {
+
+/// @brief Allocations of the calling thread, as tallied by note_allocation
+struct AllocationTally {
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+};
+
+inline thread_local AllocationTally allocation_tally{};
+
+} // namespace detail
+
+/**
+ * @brief Count a heap allocation of the calling thread
+ *
+ * Called by the replacement operator new of `KUUKAN_INSTRUMENT_GLOBAL_NEW`;
+ * custom allocators may call it as well. Does nothing in uninstrumented
+ * builds.
+ */
+inline void note_allocation([[maybe_unused]] std::size_t bytes) noexcept {
+    if constexpr (instrumentation_enabled) {
+        ++detail::allocation_tally.count;
+        detail::allocation_tally.bytes += bytes;
+    }
+}
+
+namespace detail {
+
+/// @brief Counters of one operation, written by their owning thread only
+struct OperationCounters {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> allocated_bytes{0};
+    std::array<std::atomic<std::uint64_t>, OperationStatistics::latency_buckets> latency_histogram{};
+
+    /// @brief Single-writer increment: a relaxed load and store, no read-modify-write
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void record(std::uint64_t elapsed, std::uint64_t allocation_count, std::uint64_t allocation_bytes) noexcept {
+        bump(calls, 1);
+        bump(nanoseconds, elapsed);
+        bump(allocations, allocation_count);
+        bump(allocated_bytes, allocation_bytes);
+        const std::size_t bucket = std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(elapsed)),
+                                                         OperationStatistics::latency_buckets - 1);
+        bump(latency_histogram[bucket], 1);
+    }
+
+    void add_to(OperationStatistics& statistics) const noexcept {
+        statistics.calls += calls.load(std::memory_order_relaxed);
+        statistics.nanoseconds += nanoseconds.load(std::memory_order_relaxed);
+        statistics.allocations += allocations.load(std::memory_order_relaxed);
+        statistics.allocated_bytes += allocated_bytes.load(std::memory_order_relaxed);
+        for (std::size_t bucket = 0; bucket < OperationStatistics::latency_buckets; ++bucket) {
+            statistics.latency_histogram[bucket] += latency_histogram[bucket].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+class InstrumentationRegistry;
+
+/// @brief The counters of one thread for one space type
+struct ThreadCounters {
+    explicit ThreadCounters(InstrumentationRegistry& owner);
+    ~ThreadCounters();
+
+    ThreadCounters(const ThreadCounters&) = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+    void add_to(InstrumentationSnapshot& snapshot) const noexcept {
+        for (std::size_t index = 0; index < space_operation_count; ++index) {
+            operations[index].add_to(snapshot.operations[index]);
+        }
+    }
+
+    InstrumentationRegistry& registry;
+    std::array<OperationCounters, space_operation_count> operations;
+};
+
+/// @brief The live thread tables of one space type, plus the totals of exited threads
+class InstrumentationRegistry {
+public:
+    void attach(ThreadCounters* counters) {
+        std::lock_guard lock(mutex_);
+        live_.push_back(counters);
+    }
+
+    void detach(ThreadCounters* counters) {
+        std::lock_guard lock(mutex_);
+        counters->add_to(retired_);
+        std::erase(live_, counters);
+    }
+
+    InstrumentationSnapshot snapshot() const {
+        std::lock_guard lock(mutex_);
+        InstrumentationSnapshot result = retired_;
+        for (const ThreadCounters* counters : live_) {
+            counters->add_to(result);
+        }
+        for (std::size_t index = 0; index < space_operation_count; ++index) {
+            result.operations[index] -= baseline_.operations[index];
+        }
+        return result;
+    }
+
+    void reset() {
+        InstrumentationSnapshot current = snapshot();
+        std::lock_guard lock(mutex_);
+        for (std::size_t index = 0; index < space_operation_count; ++index) {
+            baseline_.operations[index] += current.operations[index];
+        }
+    }
+
+private:
+    mutable std::mutex            mutex_;
+    std::vector<ThreadCounters*>  live_;
+    InstrumentationSnapshot       retired_;
+    InstrumentationSnapshot       baseline_;
+};
+
+inline ThreadCounters::ThreadCounters(InstrumentationRegistry& owner) : registry(owner) {
+    registry.attach(this);
+}
+
+inline ThreadCounters::~ThreadCounters() {
+    registry.detach(this);
+}
+
+/**
+ * @brief The registry of the space (or tag) type Tag
+ *
+ * The registry is never destroyed: threads of a static pool such as
+ * default_executor() can exit after static destruction has begun, and
+ * their counters still detach from it then.
+ */
+template <typename Tag>
+InstrumentationRegistry& instrumentation_registry() {
+    static InstrumentationRegistry& registry = *new InstrumentationRegistry;
+    return registry;
+}
+
+/// @brief The calling thread's counters for Tag
+template <typename Tag>
+ThreadCounters& thread_counters() {
+    thread_local ThreadCounters counters(instrumentation_registry<Tag>());
+    return counters;
+}
+
+/// @brief Run call and record it as one Operation of Tag
+template <typename Tag, SpaceOperation Operation, typename Call>
+decltype(auto) record_call(Call&& call) {
+    struct Recorder {
+        OperationCounters& counters;
+        AllocationTally before;
+        std::chrono::steady_clock::time_point start;
+
+        ~Recorder() {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            counters.record(static_cast<std::uint64_t>(elapsed),
+                            allocation_tally.count - before.count, allocation_tally.bytes - before.bytes);
+        }
+    };
+    Recorder recorder{thread_counters<Tag>().operations[static_cast<std::size_t>(Operation)],
+                      allocation_tally, std::chrono::steady_clock::now()};
+    return std::forward<Call>(call)();
+}
+
+/// @brief Run call, recording it when instrumentation is enabled and the call is not constant-evaluated
+template <typename Tag, SpaceOperation Operation, typename Call>
+constexpr decltype(auto) instrumented_call(Call&& call) {
+    if constexpr (instrumentation_enabled) {
+        if (!std::is_constant_evaluated()) {
+            return record_call<Tag, Operation>(std::forward<Call>(call));
+        }
+    }
+    return std::forward<Call>(call)();
+}
+
+} // namespace detail
+
+/**
+ * @brief Functor wrapper that records every call as one Operation of Tag
+ *
+ * @tparam Operation The operation to record the calls as
+ * @tparam F The wrapped functor
+ * @tparam Tag The type whose statistics the calls count towards (default: F)
+ *
+ * For instance-based spaces, whose functors are not reachable statically:
+ *
+ * @code{.cpp}
+ * using Add = kuukan::InstrumentedFunctor<kuukan::SpaceOperation::addition, WeightedAddition, MySpaceTag>;
+ * kuukan::StatefulVectorSpace<Vec, double, Add, Scale, Negate, Zero, Equal> space(Add{WeightedAddition{w}}, ...);
+ * auto stats = kuukan::instrumentation_snapshot<MySpaceTag>();
+ * @endcode
+ */
+template <SpaceOperation Operation, typename F, typename Tag = F>
+struct InstrumentedFunctor {
+    /// @brief The wrapped functor
+    [[no_unique_address]] F functor{};
+
+    template <typename... Args>
+    requires std::invocable<const F&, Args...>
+    constexpr decltype(auto) operator()(Args&&... args) const {
+        return detail::instrumented_call<Tag, Operation>(
+            [&]() -> decltype(auto) { return functor(std::forward<Args>(args)...); });
+    }
+
+    /// @brief Forwarded surrogate conversion (see ComparableSurrogateLike)
+    template <typename M>
+    requires requires(const F& wrapped, const M& value) { wrapped.to_distance(value); }
+    constexpr auto to_distance(const M& comparable) const { return functor.to_distance(comparable); }
+
+    /// @brief Forwarded surrogate conversion (see ComparableSurrogateLike)
+    template <typename M>
+    requires requires(const F& wrapped, const M& value) { wrapped.to_comparable(value); }
+    constexpr auto to_comparable(const M& distance_value) const { return functor.to_comparable(distance_value); }
+};
+
+/// @brief Statistics recorded for Tag so far (since the last reset), summed over all threads
+template <typename Tag>
+InstrumentationSnapshot instrumentation_snapshot() {
+    if constexpr (instrumentation_enabled) {
+        return detail::instrumentation_registry<Tag>().snapshot();
+    } else {
+        return InstrumentationSnapshot{};
+    }
+}
+
+/// @brief Start counting Tag's statistics from zero
+template <typename Tag>
+void reset_instrumentation() {
+    if constexpr (instrumentation_enabled) {
+        detail::instrumentation_registry<Tag>().reset();
+    }
+}
+
+namespace detail {
+
+/// @brief Static access to the member of a space that implements an operation
+template <SpaceOperation Operation>
+struct SpaceOperationAccess;
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::addition> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::addition(std::forward<Args>(args)...)) {
+        return Space::addition(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::scalar_action> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::scalar_action(std::forward<Args>(args)...)) {
+        return Space::scalar_action(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::negation> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::negation(std::forward<Args>(args)...)) {
+        return Space::negation(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::zero_supplier> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::zero_supplier(std::forward<Args>(args)...)) {
+        return Space::zero_supplier(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::equality> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::equality(std::forward<Args>(args)...)) {
+        return Space::equality(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::difference> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::difference(std::forward<Args>(args)...)) {
+        return Space::difference(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::add_assign> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::add_assign(std::forward<Args>(args)...)) {
+        return Space::add_assign(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::scale_assign> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::scale_assign(std::forward<Args>(args)...)) {
+        return Space::scale_assign(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::negate_in_place> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::negate_in_place(std::forward<Args>(args)...)) {
+        return Space::negate_in_place(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::axpy> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::axpy(std::forward<Args>(args)...)) {
+        return Space::axpy(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::norm> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::norm(std::forward<Args>(args)...)) {
+        return Space::norm(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::distance> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::distance(std::forward<Args>(args)...)) {
+        return Space::distance(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::bounded_distance> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::bounded_distance(std::forward<Args>(args)...)) {
+        return Space::bounded_distance(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::comparable_distance> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::comparable_distance(std::forward<Args>(args)...)) {
+        return Space::comparable_distance(std::forward<Args>(args)...);
+    }
+};
+
+template <>
+struct SpaceOperationAccess<SpaceOperation::inner_product> {
+    template <typename Space, typename... Args>
+    static constexpr auto invoke(Args&&... args) -> decltype(Space::inner_product(std::forward<Args>(args)...)) {
+        return Space::inner_product(std::forward<Args>(args)...);
+    }
+};
+
+/// @brief Static wrapper of the Operation member of Space, recorded under Space
+template <typename Space, SpaceOperation Operation>
+struct InstrumentedOperation {
+    template <typename... Args>
+    requires requires(Args&&... args) {
+        SpaceOperationAccess<Operation>::template invoke<Space>(std::forward<Args>(args)...);
+    }
+    constexpr decltype(auto) operator()(Args&&... args) const {
+        return instrumented_call<Space, Operation>([&]() -> decltype(auto) {
+            return SpaceOperationAccess<Operation>::template invoke<Space>(std::forward<Args>(args)...);
+        });
+    }
+};
+
+/// @brief Static wrapper of Space::linear_combination (also accepts braced lists of terms)
+template <typename Space>
+struct InstrumentedLinearCombination {
+    using term_type = typename Space::term_type;
+
+    constexpr typename Space::element_type operator()(std::span<const term_type> terms) const {
+        return instrumented_call<Space, SpaceOperation::linear_combination>(
+            [&] { return Space::linear_combination(terms); });
+    }
+
+    template <std::size_t TermCount>
+    constexpr typename Space::element_type operator()(const term_type (&terms)[TermCount]) const {
+        return (*this)(std::span<const term_type>(terms, TermCount));
+    }
+};
+
+/// @brief Instrumented vector space operations
+template <typename Space>
+struct InstrumentedVectorPart {};
+
+template <StaticVectorSpaceLike Space>
+struct InstrumentedVectorPart<Space> {
+    using scalar_type = typename Space::scalar_type;
+
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::addition>        addition{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::scalar_action>   scalar_action{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::negation>        negation{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::zero_supplier>   zero_supplier{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::equality>        equality{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::difference>      difference{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::add_assign>      add_assign{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::scale_assign>    scale_assign{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::negate_in_place> negate_in_place{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::axpy>            axpy{};
+};
+
+/// @brief Instrumented linear combination, for spaces that name their term type
+template <typename Space>
+struct InstrumentedCombinationPart {};
+
+template <StaticVectorSpaceLike Space>
+requires requires { typename Space::term_type; }
+struct InstrumentedCombinationPart<Space> {
+    using term_type = typename Space::term_type;
+
+    static inline constexpr InstrumentedLinearCombination<Space> linear_combination{};
+};
+
+/// @brief Instrumented norm
+template <typename Space>
+struct InstrumentedNormPart {};
+
+template <typename Space>
+requires requires(const typename Space::element_type& element) { Space::norm(element); }
+struct InstrumentedNormPart<Space> {
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::norm> norm{};
+};
+
+/// @brief Instrumented distances and their conversions
+template <typename Space>
+struct InstrumentedMetricPart {};
+
+template <typename Space>
+requires requires(const typename Space::element_type& element) { Space::distance(element, element); }
+struct InstrumentedMetricPart<Space> {
+    using measure_type = typename Space::measure_type;
+
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::distance>            distance{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::bounded_distance>    bounded_distance{};
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::comparable_distance> comparable_distance{};
+
+    /// @brief Alias for distance
+    static constexpr measure_type dist(const typename Space::element_type& element_left,
+                                       const typename Space::element_type& element_right) {
+        return distance(element_left, element_right);
+    }
+
+    /// @brief bounded_distance(element_left, element_right, bound) <= bound
+    static constexpr bool distance_within(const typename Space::element_type& element_left,
+                                          const typename Space::element_type& element_right,
+                                          const measure_type& bound) {
+        if constexpr (requires { Space::bounded_distance(element_left, element_right, bound); }) {
+            return bounded_distance(element_left, element_right, bound) <= bound;
+        } else {
+            return distance(element_left, element_right) <= bound;
+        }
+    }
+
+    template <typename M = measure_type>
+    requires requires(const M& value) { Space::to_distance(value); }
+    static constexpr measure_type to_distance(const measure_type& comparable) {
+        return Space::to_distance(comparable);
+    }
+
+    template <typename M = measure_type>
+    requires requires(const M& value) { Space::to_comparable(value); }
+    static constexpr measure_type to_comparable(const measure_type& distance_value) {
+        return Space::to_comparable(distance_value);
+    }
+};
+
+/// @brief Instrumented inner product
+template <typename Space>
+struct InstrumentedInnerPart {};
+
+template <typename Space>
+requires requires(const typename Space::element_type& element) { Space::inner_product(element, element); }
+struct InstrumentedInnerPart<Space> {
+    static inline constexpr InstrumentedOperation<Space, SpaceOperation::inner_product> inner_product{};
+};
+
+} // namespace detail
+
+/**
+ * @brief Space decorator that records every operation call
+ *
+ * @tparam Space A static space: VectorSpace, MetricSpace, NormedSpace,
+ *         InnerProductSpace or a backend built on them
+ *
+ * Exposes the operations Space has (vector space operations, norm,
+ * distances, inner product) under the same names, each recording the call
+ * under Space before forwarding to it, so it satisfies the same concepts
+ * and can replace Space anywhere. Only calls made through the wrapper are
+ * counted: a fallback that Space derives internally (e.g. axpy from
+ * addition and scalar_action) counts once, as axpy.
+ *
+ * @code{.cpp}
+ * using Space = kuukan::Instrumented<kuukan::DenseNormedSpace<double, 3, kuukan::DenseL2Norm>>;
+ * kuukan::VPTree<Space> tree{std::span<const Space::element_type>(points)};
+ * auto nearest = tree.knn(query, 10);
+ * Space::snapshot().dump(std::cout);   // distance calls and latencies of build + query
+ * @endcode
+ *
+ * Batched kernels of the wrapped space (ElementBatch, Gram matrices) are
+ * bypassed, since they are not part of the operation interface.
+ */
+template <typename Space>
+struct Instrumented : detail::InstrumentedVectorPart<Space>,
+                      detail::InstrumentedCombinationPart<Space>,
+                      detail::InstrumentedNormPart<Space>,
+                      detail::InstrumentedMetricPart<Space>,
+                      detail::InstrumentedInnerPart<Space> {
+    /// @brief The wrapped space
+    using space_type   = Space;
+
+    /// @brief Type alias for elements of the space
+    using element_type = typename Space::element_type;
+
+    /// @brief Whether calls are recorded in this build
+    static constexpr bool enabled = instrumentation_enabled;
+
+    /// @brief Statistics recorded for Space so far (since the last reset), summed over all threads
+    static InstrumentationSnapshot snapshot() { return instrumentation_snapshot<Space>(); }
+
+    /// @brief Start counting from zero
+    static void reset() { reset_instrumentation<Space>(); }
+};
+
+} // namespace kuukan
+
+#if defined(KUUKAN_INSTRUMENT_GLOBAL_NEW)
+
+void* operator new(std::size_t bytes) {
+    kuukan::note_allocation(bytes);
+    if (void* pointer = std::malloc(bytes == 0 ? 1 : bytes)) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    kuukan::note_allocation(bytes);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = (std::max<std::size_t>(bytes, 1) + align - 1) / align * align;
+    if (void* pointer = std::aligned_alloc(align, rounded)) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+// GCC pairs the inlined replacements with malloc/free and reports a mismatch that is not one
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,833 @@
+/**
+ * @file mapped_element_store.hpp
+ * @brief Versioned on-disk format for reference sets, read through mmap
+ *
+ * This file provides the kuukan element store format, a writer for it and
+ * MappedElementStore, which maps a store file read-only and hands out
+ * element views without parsing or copying. A store holds the elements of
+ * one dense or sparse space:
+ *
+ * - a 64-byte MappedStoreHeader (magic, version, layout, component and
+ *   index types, count, dimension, section offsets);
+ * - page-aligned records: fixed-stride rows for dense elements, each row
+ *   aligned to simd::alignment, or index/value arrays for sparse elements;
+ * - for sparse stores, a table of (offset, nnz) pairs, one per element.
+ *
+ * All fields are little-endian as written by the host; a store written on a
+ * host of the other byte order is rejected, not converted.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/metric/metric_space.hpp"
+#include "kuukan/norm/normed_space.hpp"
+#include "kuukan/inner/inner_product_space.hpp"
+#include "kuukan/dense/dense_vector_space.hpp"
+#include "kuukan/sparse/sparse_vector_space.hpp"
+#include "kuukan/batch/element_batch.hpp"
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define KUUKAN_HAS_MMAP 1
+#endif
+
+namespace kuukan {
+
+/// @brief The version of the store format written by MappedElementStoreWriter
+inline constexpr std::uint32_t mapped_store_version = 1;
+
+/// @brief Alignment of the record section within a store file (one page on common hosts)
+inline constexpr std::size_t mapped_store_section_alignment = 4096;
+
+/// @brief Record layout of a store file
+enum class MappedStoreLayout : std::uint8_t {
+    dense  = 1,   ///< fixed-stride rows of dimension components
+    sparse = 2    ///< per-element index and value arrays, located through a table
+};
+
+/// @brief Outcome of opening or writing a store file
+enum class MappedStoreStatus {
+    ok,                    ///< the store is open (or was written)
+    closed,                ///< no file has been opened
+    open_failed,           ///< the file could not be opened or sized
+    map_failed,            ///< mmap failed, or the host has no mmap
+    bad_header,            ///< not a store file, or written with the other byte order
+    unsupported_version,   ///< written by a newer format version
+    type_mismatch,         ///< layout, component type, index type or extent differ from the space
+    truncated,             ///< the file is shorter than its header says
+    write_failed           ///< the output stream failed while writing
+};
+
+/**
+ * @brief The fixed 64-byte header at the start of every store file
+ */
+struct MappedStoreHeader {
+    char          magic[8];        ///< "KUUKANES"
+    std::uint32_t version;         ///< mapped_store_version at write time
+    std::uint8_t  layout;          ///< a MappedStoreLayout
+    std::uint8_t  value_code;      ///< component type: 1 float, 2 double, 3 float16, 4 bfloat16
+    std::uint8_t  value_size;      ///< sizeof of the component type
+    std::uint8_t  index_size;      ///< sizeof of the sparse index type (0 for dense stores)
+    std::uint64_t count;           ///< number of elements
+    std::uint64_t dimension;       ///< components per dense row; largest extent for sparse stores
+    std::uint64_t record_stride;   ///< bytes between dense rows (0 for sparse stores)
+    std::uint64_t data_offset;     ///< byte offset of the first record
+    std::uint64_t table_offset;    ///< byte offset of the sparse (offset, nnz) table (0 for dense stores)
+    std::uint32_t byte_order;      ///< 0x01020304 as written by the host
+    std::uint32_t header_size;     ///< sizeof(MappedStoreHeader)
+};
+
+static_assert(sizeof(MappedStoreHeader) == 64 && std::is_trivially_copyable_v<MappedStoreHeader>);
+
+namespace detail {
+
+inline constexpr char mapped_store_magic[8] = {'K', 'U', 'U', 'K', 'A', 'N', 'E', 'S'};
+inline constexpr std::uint32_t mapped_store_byte_order = 0x01020304;
+
+/// @brief Header code of a component type
+template <typename T>
+inline constexpr std::uint8_t mapped_value_code =
+    std::same_as<T, float> ? 1 : std::same_as<T, double> ? 2 :
+    std::same_as<T, float16> ? 3 : std::same_as<T, bfloat16> ? 4 : 0;
+
+constexpr std::size_t mapped_align_up(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/// @brief Location of one sparse record, relative to the start of the file
+struct MappedSparseEntry {
+    std::uint64_t offset;
+    std::uint64_t nnz;
+};
+
+} // namespace detail
+
+/**
+ * @brief How the elements of type E are laid out in a store, and what views of them look like
+ *
+ * Specialized for statically sized DenseVector (records are the elements
+ * themselves, so views are the elements), run-time sized DenseVector (views
+ * are `std::span<const T>` rows) and SparseVector (views are
+ * SparseVectorView).
+ */
+template <typename E>
+struct MappedElementTraits;
+
+template <DenseStorageType T, std::size_t Extent>
+requires (Extent != std::dynamic_extent)
+struct MappedElementTraits<DenseVector<T, Extent>> {
+    static constexpr MappedStoreLayout layout = MappedStoreLayout::dense;
+    static constexpr bool zero_copy = true;
+    using value_type = T;
+    using index_type = void;
+    using view_type  = DenseVector<T, Extent>;
+};
+
+template <DenseStorageType T, typename Allocator>
+struct MappedElementTraits<DenseVector<T, std::dynamic_extent, Allocator>> {
+    static constexpr MappedStoreLayout layout = MappedStoreLayout::dense;
+    static constexpr bool zero_copy = false;
+    using value_type = T;
+    using index_type = void;
+    using view_type  = std::span<const T>;
+};
+
+template <std::unsigned_integral Index, DenseStorageType T>
+struct MappedElementTraits<SparseVector<Index, T>> {
+    static constexpr MappedStoreLayout layout = MappedStoreLayout::sparse;
+    static constexpr bool zero_copy = false;
+    using value_type = T;
+    using index_type = Index;
+    using view_type  = SparseVectorView<Index, T>;
+};
+
+/// @brief Concept for element types a store can hold (those with MappedElementTraits)
+template <typename E>
+concept MappedElementLike = requires { MappedElementTraits<E>::layout; };
+
+namespace detail {
+
+/// @brief F if it measures two View operands (plus Extra), otherwise NotInjected
+template <typename F, typename View, typename... Extra>
+using view_slot_t = std::conditional_t<
+    std::is_invocable_v<const F&, const View&, const View&, const Extra&...>, F, NotInjected>;
+
+/// @brief The metric space over View induced by the fused difference norms of Space, if any
+template <typename Space, typename View>
+struct mapped_view_space {
+    using type = NotInjected;
+};
+
+template <typename VS, typename Norm, typename D, typename B, typename C, typename View>
+requires std::is_invocable_v<const D&, const View&, const View&>
+struct mapped_view_space<NormedSpace<VS, Norm, D, B, C>, View> {
+    using measure_type = std::invoke_result_t<const D&, const View&, const View&>;
+    using type = MetricSpace<View, D, view_slot_t<B, View, measure_type>, view_slot_t<C, View>>;
+};
+
+template <typename VS, typename InnerProduct, typename D, typename B, typename C, typename View>
+struct mapped_view_space<InnerProductSpace<VS, InnerProduct, D, B, C>, View>
+    : mapped_view_space<typename InnerProductSpace<VS, InnerProduct, D, B, C>::normed_space, View> {};
+
+} // namespace detail
+
+/**
+ * @brief Streaming writer of store files
+ *
+ * @tparam VS The space of the elements (its element type must satisfy MappedElementLike)
+ *
+ * Elements are appended one at a time and written straight through, so sets
+ * larger than memory can be converted in one pass; the header (and, for
+ * sparse stores, the record table) is written by finish().
+ *
+ * Dense rows hold dimension components, padded to simd::alignment bytes for
+ * run-time sized elements; empty dense elements are written as zero rows.
+ * For statically sized elements each record is the element object itself,
+ * which is what lets MappedElementStore hand them out in place.
+ *
+ * @code{.cpp}
+ * using Space = kuukan::DenseNormedSpace<float, std::dynamic_extent, kuukan::DenseL2Norm>;
+ * kuukan::MappedElementStoreWriter<Space> writer("refs.kes", 768);
+ * for (const auto& element : parsed_chunk) { writer.append(element); }
+ * if (writer.finish() != kuukan::MappedStoreStatus::ok) { ... }
+ * @endcode
+ */
+template <VectorSpaceLike VS>
+requires MappedElementLike<typename VS::element_type>
+class MappedElementStoreWriter {
+public:
+    /// @brief Type alias for elements
+    using element_type = typename VS::element_type;
+
+    /// @brief Layout and view types of element_type
+    using traits       = MappedElementTraits<element_type>;
+
+    /// @brief Type alias for the component type
+    using value_type   = typename traits::value_type;
+
+    /**
+     * @brief Create (or truncate) the store file at path
+     *
+     * @param path The output file
+     * @param dimension Components per run-time sized dense element (0: taken
+     *        from the first element); ignored otherwise
+     */
+    explicit MappedElementStoreWriter(const std::string& path, std::size_t dimension = 0)
+        : out_(path, std::ios::binary | std::ios::trunc) {
+        if constexpr (traits::layout == MappedStoreLayout::dense) {
+            if constexpr (traits::zero_copy) {
+                dimension_ = element_type::size();
+            } else {
+                dimension_ = dimension;
+            }
+        }
+        // Room for the header; records start at the next section boundary
+        write_zeros(mapped_store_section_alignment);
+    }
+
+    MappedElementStoreWriter(const MappedElementStoreWriter&) = delete;
+    MappedElementStoreWriter& operator=(const MappedElementStoreWriter&) = delete;
+
+    /// @brief Finishes the file if finish() was not called
+    ~MappedElementStoreWriter() {
+        if (!finished_) {
+            finish();
+        }
+    }
+
+    /// @brief Whether every write so far succeeded
+    bool good() const { return !finished_ && static_cast<bool>(out_); }
+
+    /// @brief Number of elements appended
+    std::size_t size() const noexcept { return count_; }
+
+    /// @brief Append one element
+    void append(const element_type& element) {
+        assert(!finished_);
+        if constexpr (traits::layout == MappedStoreLayout::dense) {
+            append_dense(element);
+        } else {
+            append_sparse(element);
+        }
+        ++count_;
+    }
+
+    /// @brief Append every element of a span, in order
+    void append(std::span<const element_type> elements) {
+        for (const element_type& element : elements) {
+            append(element);
+        }
+    }
+
+    /**
+     * @brief Write the header (and record table) and close the file
+     *
+     * @return MappedStoreStatus::ok, or write_failed if any write failed
+     */
+    MappedStoreStatus finish() {
+        assert(!finished_);
+        finished_ = true;
+        MappedStoreHeader header{};
+        std::memcpy(header.magic, detail::mapped_store_magic, sizeof(header.magic));
+        header.version = mapped_store_version;
+        header.layout = static_cast<std::uint8_t>(traits::layout);
+        header.value_code = detail::mapped_value_code<value_type>;
+        header.value_size = sizeof(value_type);
+        header.count = count_;
+        header.dimension = dimension_;
+        header.data_offset = mapped_store_section_alignment;
+        header.byte_order = detail::mapped_store_byte_order;
+        header.header_size = sizeof(MappedStoreHeader);
+        if constexpr (traits::layout == MappedStoreLayout::dense) {
+            header.record_stride = row_bytes();
+        } else {
+            header.index_size = sizeof(typename traits::index_type);
+            pad_to(alignof(detail::MappedSparseEntry));
+            header.table_offset = position_;
+            write(table_.data(), table_.size() * sizeof(detail::MappedSparseEntry));
+        }
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.close();
+        return out_ ? MappedStoreStatus::ok : MappedStoreStatus::write_failed;
+    }
+
+private:
+    std::size_t row_bytes() const {
+        if constexpr (traits::zero_copy) {
+            return sizeof(element_type);
+        } else {
+            return detail::mapped_align_up(dimension_ * sizeof(value_type), simd::alignment);
+        }
+    }
+
+    void append_dense(const element_type& element) {
+        if constexpr (!traits::zero_copy) {
+            if (dimension_ == 0 && count_ == 0) {
+                dimension_ = element.size();
+            }
+        }
+        assert(element.empty() || element.size() == dimension_);
+        if (element.size() != dimension_ && !element.empty()) {
+            out_.setstate(std::ios::failbit);
+            return;
+        }
+        row_.assign(row_bytes(), 0);
+        if (!element.empty()) {
+            std::memcpy(row_.data(), element.data(), dimension_ * sizeof(value_type));
+        }
+        write(row_.data(), row_.size());
+    }
+
+    void append_sparse(const element_type& element) {
+        using index_type = typename traits::index_type;
+        pad_to(std::max(alignof(index_type), alignof(value_type)));
+        table_.push_back({position_, element.nnz()});
+        write(element.indices().data(), element.nnz() * sizeof(index_type));
+        pad_to(alignof(value_type));
+        write(element.values().data(), element.nnz() * sizeof(value_type));
+        dimension_ = std::max(dimension_, element.extent());
+    }
+
+    void write(const void* bytes, std::size_t size) {
+        out_.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        position_ += size;
+    }
+
+    void write_zeros(std::size_t size) {
+        static constexpr char zeros[mapped_store_section_alignment] = {};
+        assert(size <= sizeof(zeros));
+        write(zeros, size);
+    }
+
+    void pad_to(std::size_t alignment) {
+        write_zeros(detail::mapped_align_up(position_, alignment) - position_);
+    }
+
+    std::ofstream out_;
+    std::uint64_t position_ = 0;
+    std::size_t count_ = 0;
+    std::size_t dimension_ = 0;
+    std::vector<unsigned char> row_;                 // one zero-padded dense record
+    std::vector<detail::MappedSparseEntry> table_;   // sparse record locations, written by finish()
+    bool finished_ = false;
+};
+
+/**
+ * @brief Write a span of elements to a store file in one call
+ *
+ * @param path The output file
+ * @param elements The elements, stored in order
+ * @param dimension See MappedElementStoreWriter
+ * @return MappedStoreStatus::ok, or write_failed
+ */
+template <VectorSpaceLike VS>
+requires MappedElementLike<typename VS::element_type>
+MappedStoreStatus write_element_store(const std::string& path,
+                                      std::span<const typename VS::element_type> elements,
+                                      std::size_t dimension = 0) {
+    MappedElementStoreWriter<VS> writer(path, dimension);
+    writer.append(elements);
+    return writer.finish();
+}
+
+/**
+ * @brief Read-only, memory-mapped store file with zero-copy element views
+ *
+ * @tparam VS The space of the elements (its element type must satisfy MappedElementLike)
+ *
+ * Opening a store maps the file and checks its header against VS; a dense
+ * store reads nothing else until an element is touched, so a set of
+ * hundreds of millions of elements opens in microseconds and occupies page
+ * cache rather than private memory. A sparse store also checks each entry
+ * of its record table once on open, so that no view can reach past the
+ * records. Pages are shared by every process that maps the same file.
+ *
+ * What a view is depends on the element type (see MappedElementTraits):
+ *
+ * - statically sized DenseVector: the records are the elements, and
+ *   elements() is a `std::span<const element_type>` over the mapping that
+ *   fits every algorithm and index of the library directly;
+ * - run-time sized DenseVector: view(i) is a `std::span<const T>` row,
+ *   aligned to simd::alignment;
+ * - SparseVector: view(i) is a SparseVectorView over the record.
+ *
+ * `view_space` is the metric space over view_type whose distance is the
+ * fused difference norm of VS (VS itself for static extents; NotInjected
+ * when VS has no fused difference norm), so pairwise_distances, VPTree and
+ * HNSWIndex run on views without materializing elements. ElementBatch and
+ * other VectorSpace algorithms take owning elements; batch() and
+ * materialize() copy a range into them.
+ *
+ * Sets larger than memory are processed with for_each_chunk, which hands
+ * out consecutive ranges of views and tells the kernel to prefetch the next
+ * range and drop the pages of the finished one.
+ *
+ * @note Errors are reported through status(); an unopened store is empty.
+ *       The file must not be modified while mapped.
+ *
+ * @code{.cpp}
+ * using Space = kuukan::DenseNormedSpace<float, std::dynamic_extent, kuukan::DenseL2Norm>;
+ * using Store = kuukan::MappedElementStore<Space>;
+ * Store store("refs.kes");
+ * if (!store.is_open()) { ... store.status() ... }
+ *
+ * std::vector<Store::view_type> rows;
+ * auto references = store.views(0, store.size(), rows);   // spans into the mapping
+ * kuukan::pairwise_distances(Store::view_space{}, queries, references, std::span(matrix));
+ *
+ * store.for_each_chunk(1 << 20, [&](std::size_t first, std::span<const Store::view_type> chunk) {
+ *     // resident memory stays around one chunk
+ * });
+ * @endcode
+ */
+template <VectorSpaceLike VS>
+requires MappedElementLike<typename VS::element_type>
+class MappedElementStore {
+public:
+    /// @brief The space of the stored elements
+    using space_type   = VS;
+
+    /// @brief Type alias for (owning) elements
+    using element_type = typename VS::element_type;
+
+    /// @brief Layout and view types of element_type
+    using traits       = MappedElementTraits<element_type>;
+
+    /// @brief Type alias for the component type
+    using value_type   = typename traits::value_type;
+
+    /// @brief Type alias for element views into the mapping
+    using view_type    = typename traits::view_type;
+
+    /// @brief Whether views are the elements themselves (statically sized dense elements)
+    static constexpr bool is_zero_copy = traits::zero_copy;
+
+    /// @brief Whether the records are dense rows
+    static constexpr bool is_dense = traits::layout == MappedStoreLayout::dense;
+
+    /// @brief Metric space measuring view_type operands with the distance of VS
+    using view_space = std::conditional_t<is_zero_copy, VS,
+                                          typename detail::mapped_view_space<VS, view_type>::type>;
+
+    /// @brief Construct a closed store
+    MappedElementStore() = default;
+
+    /// @brief Open the store file at path (check is_open() or status())
+    explicit MappedElementStore(const std::string& path) { open(path); }
+
+    MappedElementStore(const MappedElementStore&) = delete;
+    MappedElementStore& operator=(const MappedElementStore&) = delete;
+
+    MappedElementStore(MappedElementStore&& other) noexcept { *this = std::move(other); }
+
+    MappedElementStore& operator=(MappedElementStore&& other) noexcept {
+        if (this != &other) {
+            close();
+            base_ = std::exchange(other.base_, nullptr);
+            length_ = std::exchange(other.length_, 0);
+            header_ = std::exchange(other.header_, MappedStoreHeader{});
+            status_ = std::exchange(other.status_, MappedStoreStatus::closed);
+        }
+        return *this;
+    }
+
+    ~MappedElementStore() { close(); }
+
+    /**
+     * @brief Map the store file at path, closing any store already open
+     *
+     * @return MappedStoreStatus::ok, or the reason the file was rejected
+     */
+    MappedStoreStatus open(const std::string& path) {
+        close();
+        status_ = map(path);
+        if (status_ == MappedStoreStatus::ok) {
+            status_ = validate();
+        }
+        if (status_ != MappedStoreStatus::ok) {
+            const MappedStoreStatus reason = status_;
+            close();
+            status_ = reason;
+        }
+        return status_;
+    }
+
+    /// @brief Unmap the file; views handed out become dangling
+    void close() noexcept {
+#if defined(KUUKAN_HAS_MMAP)
+        if (base_ != nullptr) {
+            ::munmap(const_cast<unsigned char*>(base_), length_);
+        }
+#endif
+        base_ = nullptr;
+        length_ = 0;
+        header_ = MappedStoreHeader{};
+        status_ = MappedStoreStatus::closed;
+    }
+
+    /// @brief Whether a store is mapped
+    bool is_open() const noexcept { return status_ == MappedStoreStatus::ok; }
+
+    /// @brief The outcome of the last open()
+    MappedStoreStatus status() const noexcept { return status_; }
+
+    /// @brief The header of the mapped file
+    const MappedStoreHeader& header() const noexcept { return header_; }
+
+    /// @brief Number of elements
+    std::size_t size() const noexcept { return static_cast<std::size_t>(header_.count); }
+
+    /// @brief Whether the store holds no elements
+    bool empty() const noexcept { return size() == 0; }
+
+    /// @brief Components per dense row, or the largest extent of a sparse store
+    std::size_t dimension() const noexcept { return static_cast<std::size_t>(header_.dimension); }
+
+    /// @brief The elements in place (statically sized dense elements only)
+    std::span<const element_type> elements() const noexcept requires is_zero_copy {
+        return {reinterpret_cast<const element_type*>(base_ + header_.data_offset), size()};
+    }
+
+    /// @brief The components of dense element index, in place
+    std::span<const value_type> row(std::size_t index) const noexcept requires is_dense {
+        assert(index < size());
+        return {reinterpret_cast<const value_type*>(record(index)), dimension()};
+    }
+
+    /// @brief A view of element index
+    view_type view(std::size_t index) const noexcept {
+        assert(index < size());
+        if constexpr (is_zero_copy) {
+            return elements()[index];
+        } else if constexpr (is_dense) {
+            return row(index);
+        } else {
+            using index_type = typename traits::index_type;
+            const detail::MappedSparseEntry entry = sparse_entry(index);
+            const unsigned char* indices = base_ + entry.offset;
+            const unsigned char* values = indices +
+                detail::mapped_align_up(entry.nnz * sizeof(index_type), alignof(value_type));
+            // validate() checked that both arrays end at or before the table
+            return view_type({reinterpret_cast<const index_type*>(indices), entry.nnz},
+                             {reinterpret_cast<const value_type*>(values), entry.nnz});
+        }
+    }
+
+    /**
+     * @brief Views of elements [first, first + count)
+     *
+     * @param scratch Holds the views when they are not the records
+     *        themselves; reused across calls
+     * @return A span over the mapping (zero copy), or over scratch
+     */
+    std::span<const view_type> views(std::size_t first, std::size_t count,
+                                     std::vector<view_type>& scratch) const {
+        assert(first + count <= size());
+        if constexpr (is_zero_copy) {
+            (void)scratch;
+            return elements().subspan(first, count);
+        } else {
+            scratch.resize(count);
+            for (std::size_t offset = 0; offset < count; ++offset) {
+                scratch[offset] = view(first + offset);
+            }
+            return scratch;
+        }
+    }
+
+    /// @brief An owning copy of element index
+    element_type materialize(std::size_t index) const {
+        if constexpr (is_zero_copy) {
+            return elements()[index];
+        } else if constexpr (is_dense) {
+            return element_type(row(index));
+        } else {
+            return view(index).to_vector();
+        }
+    }
+
+    /// @brief Owning copies of elements [first, first + count), e.g. for VectorSpace algorithms
+    std::vector<element_type> materialize(std::size_t first, std::size_t count) const {
+        assert(first + count <= size());
+        std::vector<element_type> elements;
+        elements.reserve(count);
+        for (std::size_t index = first; index < first + count; ++index) {
+            elements.push_back(materialize(index));
+        }
+        return elements;
+    }
+
+    /// @brief Elements [first, first + count) transposed into an ElementBatch
+    auto batch(std::size_t first, std::size_t count) const requires is_dense {
+        assert(first + count <= size());
+        ElementBatch<VS> result(dimension(), count);
+        for (std::size_t offset = 0; offset < count; ++offset) {
+            const value_type* components = row(first + offset).data();
+            for (std::size_t component = 0; component < dimension(); ++component) {
+                result.row(component)[offset] = components[component];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Visit the store in consecutive chunks of views
+     *
+     * @param chunk_size Elements per chunk (the last chunk may be shorter)
+     * @param body Callable (first, std::span<const view_type> chunk) -> void
+     * @param release_pages Ask the kernel to prefetch the next chunk and to
+     *        drop the pages of each chunk once body returns, so resident
+     *        memory stays near one chunk for sets larger than memory
+     *
+     * Views into a released chunk stay valid; touching them again reads the
+     * pages back from the file.
+     */
+    template <typename Body>
+    void for_each_chunk(std::size_t chunk_size, Body&& body, bool release_pages = true) const {
+        assert(chunk_size > 0);
+        std::vector<view_type> scratch;
+        for (std::size_t first = 0; first < size(); first += chunk_size) {
+            const std::size_t count = std::min(chunk_size, size() - first);
+            if (release_pages && first + count < size()) {
+                advise(first + count, std::min(chunk_size, size() - first - count), false);
+            }
+            body(first, views(first, count, scratch));
+            if (release_pages) {
+                advise(first, count, true);
+            }
+        }
+    }
+
+private:
+    MappedStoreStatus map(const std::string& path) {
+#if defined(KUUKAN_HAS_MMAP)
+        const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0) {
+            return MappedStoreStatus::open_failed;
+        }
+        struct stat info {};
+        if (::fstat(descriptor, &info) != 0) {
+            ::close(descriptor);
+            return MappedStoreStatus::open_failed;
+        }
+        length_ = static_cast<std::size_t>(info.st_size);
+        if (length_ < sizeof(MappedStoreHeader)) {
+            ::close(descriptor);
+            length_ = 0;
+            return MappedStoreStatus::bad_header;
+        }
+        void* mapping = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, descriptor, 0);
+        ::close(descriptor);   // the mapping keeps the file alive
+        if (mapping == MAP_FAILED) {
+            length_ = 0;
+            return MappedStoreStatus::map_failed;
+        }
+        base_ = static_cast<const unsigned char*>(mapping);
+        std::memcpy(&header_, base_, sizeof(header_));
+        return MappedStoreStatus::ok;
+#else
+        (void)path;
+        return MappedStoreStatus::map_failed;
+#endif
+    }
+
+    MappedStoreStatus validate() const {
+        if (std::memcmp(header_.magic, detail::mapped_store_magic, sizeof(header_.magic)) != 0 ||
+            header_.byte_order != detail::mapped_store_byte_order ||
+            header_.header_size != sizeof(MappedStoreHeader)) {
+            return MappedStoreStatus::bad_header;
+        }
+        if (header_.version > mapped_store_version) {
+            return MappedStoreStatus::unsupported_version;
+        }
+        if (header_.layout != static_cast<std::uint8_t>(traits::layout) ||
+            header_.value_code != detail::mapped_value_code<value_type> ||
+            header_.value_size != sizeof(value_type)) {
+            return MappedStoreStatus::type_mismatch;
+        }
+        if (header_.data_offset % mapped_store_section_alignment != 0) {
+            return MappedStoreStatus::bad_header;
+        }
+        if constexpr (is_dense) {
+            // Checked before multiplying, so row_bytes (and the stride bounding it) cannot wrap to zero
+            if (header_.dimension > std::numeric_limits<std::uint64_t>::max() / sizeof(value_type)) {
+                return MappedStoreStatus::bad_header;
+            }
+            const std::uint64_t row_bytes = header_.dimension * sizeof(value_type);
+            if constexpr (is_zero_copy) {
+                if (header_.dimension != element_type::size() || header_.record_stride != sizeof(element_type)) {
+                    return MappedStoreStatus::type_mismatch;
+                }
+            } else if (header_.record_stride < row_bytes || header_.record_stride % alignof(value_type) != 0) {
+                return MappedStoreStatus::bad_header;
+            }
+            // count * record_stride must fit after data_offset; divide so that neither can overflow
+            if (header_.data_offset > length_ ||
+                (header_.count != 0 && (length_ - header_.data_offset) / header_.count < header_.record_stride)) {
+                return MappedStoreStatus::truncated;
+            }
+        } else {
+            if (header_.index_size != sizeof(typename traits::index_type)) {
+                return MappedStoreStatus::type_mismatch;
+            }
+            if (header_.table_offset % alignof(detail::MappedSparseEntry) != 0 ||
+                header_.table_offset < header_.data_offset) {
+                return MappedStoreStatus::bad_header;
+            }
+            if (header_.table_offset > length_ ||
+                (length_ - header_.table_offset) / sizeof(detail::MappedSparseEntry) < header_.count) {
+                return MappedStoreStatus::truncated;
+            }
+            for (std::size_t index = 0; index < size(); ++index) {
+                const MappedStoreStatus status = validate_entry(sparse_entry(index));
+                if (status != MappedStoreStatus::ok) {
+                    return status;
+                }
+            }
+        }
+        return MappedStoreStatus::ok;
+    }
+
+    /// @brief Check that the index and value arrays of a sparse record lie between data_offset and table_offset
+    MappedStoreStatus validate_entry(const detail::MappedSparseEntry& entry) const noexcept {
+        using index_type = typename traits::index_type;
+        if (entry.offset % std::max(alignof(index_type), alignof(value_type)) != 0 ||
+            entry.offset < header_.data_offset) {
+            return MappedStoreStatus::bad_header;
+        }
+        if (entry.offset > header_.table_offset) {
+            return MappedStoreStatus::truncated;
+        }
+        // Divide instead of multiplying nnz, so that a corrupted nnz cannot overflow
+        std::uint64_t available = header_.table_offset - entry.offset;
+        if (entry.nnz > available / sizeof(index_type)) {
+            return MappedStoreStatus::truncated;
+        }
+        const std::uint64_t index_bytes = detail::mapped_align_up(
+            static_cast<std::size_t>(entry.nnz * sizeof(index_type)), alignof(value_type));
+        if (index_bytes > available) {
+            return MappedStoreStatus::truncated;
+        }
+        available -= index_bytes;
+        if (entry.nnz > available / sizeof(value_type)) {
+            return MappedStoreStatus::truncated;
+        }
+        return MappedStoreStatus::ok;
+    }
+
+    const unsigned char* record(std::size_t index) const noexcept {
+        return base_ + header_.data_offset + index * header_.record_stride;
+    }
+
+    detail::MappedSparseEntry sparse_entry(std::size_t index) const noexcept {
+        detail::MappedSparseEntry entry;
+        std::memcpy(&entry, base_ + header_.table_offset + index * sizeof(entry), sizeof(entry));
+        return entry;
+    }
+
+    /// @brief Byte range [begin, end) of the records (and table entries) of elements [first, first + count)
+    std::pair<std::size_t, std::size_t> byte_range(std::size_t first, std::size_t count) const {
+        if constexpr (is_dense) {
+            const std::size_t begin = static_cast<std::size_t>(record(first) - base_);
+            return {begin, begin + count * header_.record_stride};
+        } else {
+            const std::size_t begin = sparse_entry(first).offset;
+            const std::size_t end = first + count < size() ? sparse_entry(first + count).offset
+                                                           : header_.table_offset;
+            return {begin, end};
+        }
+    }
+
+    /// @brief madvise the pages of elements [first, first + count): drop them, or prefetch them
+    void advise(std::size_t first, std::size_t count, bool drop) const {
+#if defined(KUUKAN_HAS_MMAP) && defined(MADV_DONTNEED) && defined(MADV_WILLNEED)
+        const auto [begin, end] = byte_range(first, count);
+        advise_bytes(begin, end, drop);
+        if constexpr (!is_dense) {
+            const std::size_t table_begin = header_.table_offset + first * sizeof(detail::MappedSparseEntry);
+            advise_bytes(table_begin, table_begin + count * sizeof(detail::MappedSparseEntry), drop);
+        }
+#else
+        (void)first;
+        (void)count;
+        (void)drop;
+#endif
+    }
+
+#if defined(KUUKAN_HAS_MMAP) && defined(MADV_DONTNEED) && defined(MADV_WILLNEED)
+    void advise_bytes(std::size_t begin, std::size_t end, bool drop) const {
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        // Drop only pages wholly inside the range; prefetch every page it touches
+        begin = drop ? detail::mapped_align_up(begin, page) : begin / page * page;
+        end = drop ? end / page * page : std::min(detail::mapped_align_up(end, page), length_);
+        if (begin < end) {
+            ::madvise(const_cast<unsigned char*>(base_) + begin, end - begin,
+                      drop ? MADV_DONTNEED : MADV_WILLNEED);
+        }
+    }
+#endif
+
+    const unsigned char* base_ = nullptr;
+    std::size_t length_ = 0;
+    MappedStoreHeader header_{};
+    MappedStoreStatus status_ = MappedStoreStatus::closed;
+};
+
+} // namespace kuukan
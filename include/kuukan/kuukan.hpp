@@ -43,9 +43,31 @@
  * @section structure_sec Library Structure
  * 
  * - **Concepts** (`concepts/core_concepts.hpp`): Type requirements (FieldLike, OrderedMeasure, etc.)
- * - **VectorSpace** (`vector/vector_space.hpp`): Abstract vector space interface
- * - **MetricSpace** (`metric/metric_space.hpp`): Abstract metric space interface
- * - **NormedSpace** (`norm/normed_space.hpp`): Normed space that induces a metric
+ * - **VectorSpace** (`vector/vector_space.hpp`): Abstract vector space interface (StatefulVectorSpace for functor instances)
+ * - **Lazy** (`vector/lazy.hpp`): Expression-template evaluation over a vector space
+ * - **MetricSpace** (`metric/metric_space.hpp`): Abstract metric space interface (StatefulMetricSpace for functor instances)
+ * - **NormedSpace** (`norm/normed_space.hpp`): Normed space that induces a metric (StatefulNormedSpace for functor instances)
+ * - **InnerProductSpace** (`inner/inner_product_space.hpp`): Inner product space that induces a norm
+ * - **NormCache** (`norm/norm_cache.hpp`): Per-element norms of a reference set with explicit invalidation
+ * - **DenseVectorSpace** (`dense/dense_vector_space.hpp`): SIMD backend for numeric arrays
+ * - **Precision** (`dense/precision.hpp`): float16 / bfloat16 storage with separate compute and accumulation types
+ * - **Arenas** (`memory/arena.hpp`): MonotonicArena, ArenaScope and ArenaAllocator for scoped temporaries
+ * - **SparseVectorSpace** (`sparse/sparse_vector_space.hpp`): Sorted index/value backend for sparse vectors
+ * - **ProductSpace** (`product/product_space.hpp`): Direct sums with componentwise operations and product norms
+ * - **CompiledFunctionSpace** (`function/compiled_function.hpp`): Function elements as shared expression programs
+ * - **ChebyshevSpace** (`function/chebyshev_space.hpp`): Functions as truncated Chebyshev expansions on an interval
+ * - **SupNorm / LpNorm** (`function/function_norms.hpp`): Adaptive sup and L^p norms on cached quadrature nodes (`function/quadrature.hpp`)
+ * - **SymbolTable** (`function/symbol_table.hpp`): Hash-consed symbolic identities with O(1) equality
+ * - **Executors** (`execution/executor.hpp`): ExecutorLike, WorkStealingPool and InlineExecutor for the parallel algorithms
+ * - **ElementBatch** (`batch/element_batch.hpp`): Structure-of-arrays batches with batched operations
+ * - **pairwise_distances** (`algorithm/pairwise_distances.hpp`): Tiled, multithreaded distance matrices
+ * - **reduce / weighted_sum** (`algorithm/reduce.hpp`): Deterministic parallel sums with optional compensation
+ * - **kmeans / kmedoids** (`algorithm/clustering.hpp`): k-means++ seeded clustering with Hamerly bounds
+ * - **VPTree** (`index/vp_tree.hpp`): Vantage-point tree for exact k-NN and range queries
+ * - **HNSWIndex** (`index/hnsw_index.hpp`): Graph index for approximate k-NN with concurrent inserts
+ * - **MappedElementStore** (`io/mapped_element_store.hpp`): Versioned on-disk reference sets, mmapped with zero-copy views
+ * - **CudaExecutor** (`gpu/cuda_backend.hpp`): Optional CUDA offload of batched dense distances, Gram matrices and sums
+ * - **Instrumented** (`instrument/instrumented.hpp`): Per-operation call counts, latency and allocation statistics
  * 
  * @version 0.1.0
  * @author kuukan contributors
@@ -56,5 +78,28 @@
 #include "version.hpp"
 #include "concepts/core_concepts.hpp"
 #include "vector/vector_space.hpp"
+#include "vector/lazy.hpp"
 #include "metric/metric_space.hpp"
 #include "norm/normed_space.hpp"
+#include "norm/norm_cache.hpp"
+#include "inner/inner_product_space.hpp"
+#include "memory/arena.hpp"
+#include "dense/dense_vector_space.hpp"
+#include "sparse/sparse_vector_space.hpp"
+#include "product/product_space.hpp"
+#include "function/domain.hpp"
+#include "function/compiled_function.hpp"
+#include "function/chebyshev_space.hpp"
+#include "function/quadrature.hpp"
+#include "function/function_norms.hpp"
+#include "function/symbol_table.hpp"
+#include "execution/executor.hpp"
+#include "batch/element_batch.hpp"
+#include "algorithm/pairwise_distances.hpp"
+#include "algorithm/reduce.hpp"
+#include "algorithm/clustering.hpp"
+#include "index/vp_tree.hpp"
+#include "index/hnsw_index.hpp"
+#include "instrument/instrumented.hpp"
+#include "io/mapped_element_store.hpp"
+#include "gpu/cuda_backend.hpp"
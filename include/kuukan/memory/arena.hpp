@@ -0,0 +1,327 @@
+/**
+ * @file arena.hpp
+ * @brief Monotonic arenas for the temporaries of vector space operations
+ *
+ * Operation functors are stateless static members, so an allocator cannot
+ * be passed to them as an argument. Instead, an ArenaScope installs a
+ * MonotonicArena as the current arena of the calling thread, and element
+ * types whose storage uses ArenaAllocator pick it up whenever they
+ * allocate. Every temporary created inside the scope is carved out of the
+ * arena by bumping a pointer, and all of them are released at once when
+ * the scope ends.
+ *
+ * @code{.cpp}
+ * using Space = kuukan::ArenaDenseVectorSpace<double>;
+ * kuukan::DenseVector<double> kept;
+ * {
+ *     kuukan::ArenaScope scope;   // the calling thread's arena
+ *     Space::element_type t = Space::axpy(2.0, Space::addition(a, b), c);
+ *     kept = kuukan::DenseVector<double>(std::span<const double>(t.data(), t.size()));
+ * }   // t and the intermediate sum are released in one step
+ * @endcode
+ *
+ * Storage obtained inside a scope must not outlive it: copy results that
+ * are kept into elements with ordinary storage before the scope ends.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kuukan/dense/simd.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Bump allocator over a list of reusable memory chunks
+ *
+ * Allocation advances a pointer through the current chunk and moves on to
+ * the next chunk (allocating one, twice as large as the last, when none is
+ * left) when the request does not fit. Memory is only returned through
+ * release_to and reset, which rewind to an earlier position and keep the
+ * chunks for reuse; the chunks are freed by the destructor.
+ *
+ * A MonotonicArena is not thread-safe. Each ArenaScope uses it from the
+ * thread that opened the scope only.
+ */
+class MonotonicArena {
+public:
+    /// @brief Position in the arena, as returned by mark
+    struct Marker {
+        std::size_t chunk  = 0;
+        std::size_t offset = 0;
+    };
+
+    /// @brief Default capacity of the first chunk in bytes
+    static constexpr std::size_t default_capacity = std::size_t(64) << 10;
+
+    /// @brief Alignment of every chunk (allocations may ask for more, at the cost of padding)
+    static constexpr std::size_t chunk_alignment = simd::alignment;
+
+    /// @brief Construct an arena whose first chunk holds initial_capacity bytes (allocated on first use)
+    explicit MonotonicArena(std::size_t initial_capacity = default_capacity) noexcept
+        : initial_capacity_(std::max(initial_capacity, chunk_alignment)) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        for (const Chunk& chunk : chunks_) {
+            ::operator delete(chunk.data, std::align_val_t{chunk_alignment});
+        }
+    }
+
+    /**
+     * @brief Allocate bytes of storage aligned to alignment
+     *
+     * @param bytes The size of the request
+     * @param alignment A power of two
+     * @return Uninitialized storage valid until the arena is rewound past it
+     */
+    [[nodiscard]] void* allocate(std::size_t bytes, std::size_t alignment) {
+        assert((alignment & (alignment - 1)) == 0);
+        while (current_ < chunks_.size()) {
+            const Chunk& chunk = chunks_[current_];
+            const std::size_t start = align_up(offset_, alignment);
+            if (start + bytes <= chunk.capacity) {
+                offset_ = start + bytes;
+                used_ = std::max(used_, used_before(current_) + offset_);
+                return chunk.data + start;
+            }
+            ++current_;
+            offset_ = 0;
+        }
+        const std::size_t previous = chunks_.empty() ? initial_capacity_ / 2 : chunks_.back().capacity;
+        const std::size_t capacity = std::max(2 * previous, align_up(bytes + alignment, chunk_alignment));
+        chunks_.push_back(Chunk{
+            static_cast<std::byte*>(::operator new(capacity, std::align_val_t{chunk_alignment})), capacity});
+        current_ = chunks_.size() - 1;
+        offset_ = 0;
+        return allocate(bytes, alignment);
+    }
+
+    /**
+     * @brief Give back storage obtained from allocate
+     *
+     * Rewinds when pointer is the most recent allocation of the current
+     * chunk, so that short-lived temporaries released in reverse order are
+     * reused at once; does nothing otherwise.
+     */
+    void deallocate(void* pointer, std::size_t bytes) noexcept {
+        if (current_ < chunks_.size() && static_cast<std::byte*>(pointer) + bytes == top()) {
+            offset_ = static_cast<std::size_t>(static_cast<std::byte*>(pointer) - chunks_[current_].data);
+        }
+    }
+
+    /// @brief The current position, for a later release_to
+    Marker mark() const noexcept { return Marker{current_, offset_}; }
+
+    /// @brief Release everything allocated since marker was taken
+    void release_to(const Marker& marker) noexcept {
+        current_ = marker.chunk;
+        offset_ = marker.offset;
+    }
+
+    /// @brief Release everything, keeping the chunks for reuse
+    void reset() noexcept { release_to(Marker{}); }
+
+    /// @brief Total capacity of the chunks in bytes
+    std::size_t capacity() const noexcept {
+        std::size_t total = 0;
+        for (const Chunk& chunk : chunks_) {
+            total += chunk.capacity;
+        }
+        return total;
+    }
+
+    /// @brief Largest number of bytes (including padding and skipped chunk tails) in use at once
+    std::size_t high_water_mark() const noexcept { return used_; }
+
+private:
+    struct Chunk {
+        std::byte*  data;
+        std::size_t capacity;
+    };
+
+    static constexpr std::size_t align_up(std::size_t value, std::size_t alignment) noexcept {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    std::byte* top() const noexcept { return chunks_[current_].data + offset_; }
+
+    std::size_t used_before(std::size_t chunk) const noexcept {
+        std::size_t total = 0;
+        for (std::size_t index = 0; index < chunk; ++index) {
+            total += chunks_[index].capacity;
+        }
+        return total;
+    }
+
+    std::vector<Chunk> chunks_;
+    std::size_t current_ = 0;
+    std::size_t offset_  = 0;
+    std::size_t used_    = 0;
+    std::size_t initial_capacity_;
+};
+
+namespace detail {
+
+/// @brief The arena installed by the innermost ArenaScope of this thread
+inline thread_local MonotonicArena* current_arena = nullptr;
+
+} // namespace detail
+
+/// @brief The arena of the innermost ArenaScope of the calling thread, or nullptr outside any scope
+inline MonotonicArena* current_arena() noexcept { return detail::current_arena; }
+
+/// @brief The calling thread's own arena, used by a default-constructed ArenaScope
+inline MonotonicArena& thread_arena() {
+    static thread_local MonotonicArena arena;
+    return arena;
+}
+
+/**
+ * @brief Makes an arena current for the calling thread until the end of the scope
+ *
+ * On exit the arena is rewound to where it stood on entry and the previous
+ * current arena is restored, so scopes nest: an inner scope releases only
+ * its own temporaries.
+ *
+ * @code{.cpp}
+ * kuukan::MonotonicArena arena(1 << 20);
+ * for (const auto& query : queries) {
+ *     kuukan::ArenaScope scope(arena);
+ *     handle(query);   // temporaries of the query come from arena
+ * }
+ * @endcode
+ */
+class ArenaScope {
+public:
+    /// @brief Open a scope on the calling thread's own arena
+    ArenaScope() : ArenaScope(thread_arena()) {}
+
+    /// @brief Open a scope on the given arena
+    explicit ArenaScope(MonotonicArena& arena) noexcept
+        : arena_(arena), marker_(arena.mark()), previous_(detail::current_arena) {
+        detail::current_arena = &arena;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope() {
+        arena_.release_to(marker_);
+        detail::current_arena = previous_;
+    }
+
+    /// @brief The arena of this scope
+    MonotonicArena& arena() const noexcept { return arena_; }
+
+private:
+    MonotonicArena&         arena_;
+    MonotonicArena::Marker  marker_;
+    MonotonicArena*         previous_;
+};
+
+/**
+ * @brief Allocator drawing from the current arena, or from the heap outside any scope
+ *
+ * @tparam T The value type
+ * @tparam Alignment The alignment of every allocation in bytes (a power of two)
+ *
+ * An ArenaAllocator binds to current_arena() when it is constructed, so a
+ * container picks up the arena of the scope it is created in. Copies of a
+ * container are bound to the arena current at the time of the copy, and
+ * assignment never changes the allocator of the target: assigning a
+ * scoped temporary to an element that was created outside every scope
+ * copies its values into heap storage.
+ *
+ * Like AlignedAllocator, construction without arguments default-initializes.
+ */
+template <typename T, std::size_t Alignment = simd::alignment>
+class ArenaAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+public:
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap            = std::false_type;
+    using is_always_equal                        = std::false_type;
+
+    /// @brief Rebind support required by the allocator requirements
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U, Alignment>;
+    };
+
+    /// @brief Bind to the current arena of the calling thread
+    ArenaAllocator() noexcept : arena_(current_arena()) {}
+
+    /// @brief Bind to the given arena (nullptr for the heap)
+    explicit ArenaAllocator(MonotonicArena* arena) noexcept : arena_(arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, Alignment>& other) noexcept : arena_(other.arena()) {}
+
+    /// @brief Copies of a container bind to the arena current at the time of the copy
+    ArenaAllocator select_on_container_copy_construction() const noexcept { return ArenaAllocator(); }
+
+    /// @brief The arena this allocator draws from, or nullptr for the heap
+    MonotonicArena* arena() const noexcept { return arena_; }
+
+    /**
+     * @brief Allocate storage for count objects
+     *
+     * @param count The number of objects
+     * @return Pointer to uninitialized storage aligned to Alignment
+     */
+    [[nodiscard]] T* allocate(std::size_t count) {
+        if (arena_ != nullptr) {
+            return static_cast<T*>(arena_->allocate(count * sizeof(T), Alignment));
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    /**
+     * @brief Release storage obtained from allocate
+     *
+     * @param pointer The storage to release
+     * @param count The number of objects it was allocated for
+     */
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        if (arena_ != nullptr) {
+            arena_->deallocate(pointer, count * sizeof(T));
+            return;
+        }
+        ::operator delete(pointer, count * sizeof(T), std::align_val_t{Alignment});
+    }
+
+    /// @brief Default-initialize an object (no zero-fill for trivial types)
+    template <typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    /// @brief Construct an object from the given arguments
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args) {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U, Alignment>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+
+private:
+    MonotonicArena* arena_;
+};
+
+} // namespace kuukan
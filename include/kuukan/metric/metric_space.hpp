@@ -19,6 +19,10 @@ namespace kuukan {
  * 
  * @tparam ElementType The type of elements in the metric space
  * @tparam DistanceFunction Functor type for distance: (ElementType, ElementType) -> MeasureType
+ * @tparam BoundedDistance Optional early-exit functor: (ElementType, ElementType, MeasureType) -> MeasureType
+ *         (default: NotInjected, see bounded_distance)
+ * @tparam ComparableDistance Optional monotone surrogate of the distance satisfying
+ *         ComparableSurrogateLike (default: NotInjected, see comparable_distance)
  * 
  * A metric space is a set equipped with a distance function (metric) that
  * satisfies the following axioms:
@@ -60,15 +64,44 @@ namespace kuukan {
  * double d = PointSpace::distance(p1, p2);  // d = 5.0
  * @endcode
  * 
+ * @section bounded_distance Bounded Distance
+ * 
+ * Pruning searches often only need to know whether a distance is below a
+ * bound. `bounded_distance(a, b, bound)` returns the exact distance when it
+ * is at most bound and otherwise any value greater than bound, which lets an
+ * injected BoundedDistance stop as soon as a partial result exceeds the
+ * bound. Without one, the full distance is computed. `distance_within`
+ * answers the yes/no question directly.
+ * 
+ * @section comparable_distance Comparable Distance
+ * 
+ * Ranking neighbours only needs the order of distances, which a monotone
+ * surrogate (e.g. the squared Euclidean distance) preserves while skipping
+ * the final `sqrt`/`pow`. `comparable_distance(a, b)` returns the surrogate
+ * of an injected ComparableDistance functor, or the distance itself;
+ * `to_distance` and `to_comparable` convert between both scales so only the
+ * winners of a ranking need converting back.
+ * 
  * @note This structure is very abstract and does not assume any particular
  *       representation of elements or computation method for distance.
  * 
  * @see NormedSpace for a metric space induced by a norm
  */
-template <typename ElementType, typename DistanceFunction>
+template <typename ElementType, typename DistanceFunction, typename BoundedDistance = NotInjected,
+          typename ComparableDistance = NotInjected>
 requires std::default_initializable<DistanceFunction> &&
          OrderedMeasure<std::invoke_result_t<DistanceFunction,
-                                             const ElementType&, const ElementType&>>
+                                             const ElementType&, const ElementType&>> &&
+         OptionallyCallableLike<BoundedDistance,
+                                std::invoke_result_t<DistanceFunction,
+                                                     const ElementType&, const ElementType&>,
+                                const ElementType&, const ElementType&,
+                                const std::invoke_result_t<DistanceFunction,
+                                                           const ElementType&, const ElementType&>&> &&
+         OptionallyComparableSurrogateLike<ComparableDistance,
+                                           std::invoke_result_t<DistanceFunction,
+                                                                const ElementType&, const ElementType&>,
+                                           const ElementType&, const ElementType&>
 struct MetricSpace {
     /// @brief Type alias for elements of this metric space
     using element_type = ElementType;
@@ -97,6 +130,203 @@ struct MetricSpace {
                                        const element_type& element_right) {
         return distance(element_left, element_right);
     }
+
+    /**
+     * @brief Compute a distance that only has to be exact up to a bound
+     * 
+     * Uses the injected BoundedDistance functor if present, otherwise the
+     * full distance.
+     * 
+     * @param element_left The first element
+     * @param element_right The second element
+     * @param bound The bound of interest
+     * @return The exact distance if it is <= bound, otherwise a value > bound
+     */
+    static constexpr measure_type bounded_distance(const element_type& element_left,
+                                                   const element_type& element_right,
+                                                   const measure_type& bound) {
+        if constexpr (Injected<BoundedDistance>) {
+            return BoundedDistance{}(element_left, element_right, bound);
+        } else {
+            return distance(element_left, element_right);
+        }
+    }
+
+    /**
+     * @brief Check whether two elements are at most bound apart
+     * 
+     * @param element_left The first element
+     * @param element_right The second element
+     * @param bound The bound
+     * @return distance(element_left, element_right) <= bound
+     */
+    static constexpr bool distance_within(const element_type& element_left,
+                                          const element_type& element_right,
+                                          const measure_type& bound) {
+        return bounded_distance(element_left, element_right, bound) <= bound;
+    }
+
+    /**
+     * @brief Compute a value that orders pairs like their distance
+     * 
+     * @param element_left The first element
+     * @param element_right The second element
+     * @return The injected surrogate, or distance(element_left, element_right)
+     */
+    static constexpr measure_type comparable_distance(const element_type& element_left,
+                                                      const element_type& element_right) {
+        if constexpr (Injected<ComparableDistance>) {
+            return ComparableDistance{}(element_left, element_right);
+        } else {
+            return distance(element_left, element_right);
+        }
+    }
+
+    /**
+     * @brief Convert a comparable_distance value to the true distance
+     * 
+     * @param comparable A value returned by comparable_distance
+     * @return The corresponding distance
+     */
+    static constexpr measure_type to_distance(const measure_type& comparable) {
+        if constexpr (Injected<ComparableDistance>) {
+            return ComparableDistance{}.to_distance(comparable);
+        } else {
+            return comparable;
+        }
+    }
+
+    /**
+     * @brief Convert a true distance (e.g. a search radius) to the comparable scale
+     * 
+     * @param distance_value A distance
+     * @return The corresponding comparable_distance value
+     */
+    static constexpr measure_type to_comparable(const measure_type& distance_value) {
+        if constexpr (Injected<ComparableDistance>) {
+            return ComparableDistance{}.to_comparable(distance_value);
+        } else {
+            return distance_value;
+        }
+    }
+};
+
+/**
+ * @brief Metric space structure that holds its distance functors as members
+ * 
+ * @tparam ElementType The type of elements in the metric space
+ * @tparam DistanceFunction, BoundedDistance, ComparableDistance The same slots as MetricSpace
+ * 
+ * The instance-based counterpart of MetricSpace. The functors need not be
+ * default constructible, so a distance can carry run-time configuration or
+ * preallocated scratch space that belongs to this space alone. The
+ * interface mirrors MetricSpace with member functions in place of static
+ * ones; functors are called through const references (see
+ * StatefulVectorSpace for the rules on mutable state).
+ * 
+ * @code{.cpp}
+ * struct WeightedDistance {
+ *     std::vector<double> weights;
+ *     double operator()(const Vec& a, const Vec& b) const;
+ * };
+ * 
+ * kuukan::StatefulMetricSpace<Vec, WeightedDistance> space(WeightedDistance{weights});
+ * double d = space.distance(a, b);
+ * kuukan::VPTree tree(std::span<const Vec>(points), space);   // the tree keeps a copy
+ * @endcode
+ * 
+ * @see MetricSpace for the static form
+ */
+template <typename ElementType, typename DistanceFunction, typename BoundedDistance = NotInjected,
+          typename ComparableDistance = NotInjected>
+requires OrderedMeasure<std::invoke_result_t<const DistanceFunction&,
+                                             const ElementType&, const ElementType&>> &&
+         OptionallyInstanceCallableLike<BoundedDistance,
+                                        std::invoke_result_t<const DistanceFunction&,
+                                                             const ElementType&, const ElementType&>,
+                                        const ElementType&, const ElementType&,
+                                        const std::invoke_result_t<const DistanceFunction&,
+                                                                   const ElementType&, const ElementType&>&> &&
+         OptionallyInstanceComparableSurrogateLike<ComparableDistance,
+                                                   std::invoke_result_t<const DistanceFunction&,
+                                                                        const ElementType&, const ElementType&>,
+                                                   const ElementType&, const ElementType&>
+struct StatefulMetricSpace {
+    /// @brief Type alias for elements of this metric space
+    using element_type = ElementType;
+    
+    /// @brief Type alias for the distance measure type
+    using measure_type =
+        std::invoke_result_t<const DistanceFunction&, const ElementType&, const ElementType&>;
+
+    /// @brief The distance functor
+    [[no_unique_address]] DistanceFunction distance{};
+
+    /// @brief Construct every functor by default (only for default constructible functors)
+    constexpr StatefulMetricSpace() = default;
+
+    /// @brief Construct the space from functor instances
+    constexpr explicit StatefulMetricSpace(DistanceFunction distance_functor,
+                                           BoundedDistance bounded_distance_functor = {},
+                                           ComparableDistance comparable_distance_functor = {})
+        : distance(std::move(distance_functor)),
+          bounded_distance_(std::move(bounded_distance_functor)),
+          comparable_distance_(std::move(comparable_distance_functor)) {}
+
+    /// @brief Alias for distance(element_left, element_right)
+    constexpr measure_type dist(const element_type& element_left, const element_type& element_right) const {
+        return distance(element_left, element_right);
+    }
+
+    /// @brief Exact distance if it is <= bound, otherwise a value > bound (see MetricSpace::bounded_distance)
+    constexpr measure_type bounded_distance(const element_type& element_left,
+                                            const element_type& element_right,
+                                            const measure_type& bound) const {
+        if constexpr (Injected<BoundedDistance>) {
+            return bounded_distance_(element_left, element_right, bound);
+        } else {
+            return distance(element_left, element_right);
+        }
+    }
+
+    /// @brief distance(element_left, element_right) <= bound
+    constexpr bool distance_within(const element_type& element_left,
+                                   const element_type& element_right,
+                                   const measure_type& bound) const {
+        return bounded_distance(element_left, element_right, bound) <= bound;
+    }
+
+    /// @brief The injected surrogate, or the distance (see MetricSpace::comparable_distance)
+    constexpr measure_type comparable_distance(const element_type& element_left,
+                                               const element_type& element_right) const {
+        if constexpr (Injected<ComparableDistance>) {
+            return comparable_distance_(element_left, element_right);
+        } else {
+            return distance(element_left, element_right);
+        }
+    }
+
+    /// @brief Convert a comparable_distance value to the true distance
+    constexpr measure_type to_distance(const measure_type& comparable) const {
+        if constexpr (Injected<ComparableDistance>) {
+            return comparable_distance_.to_distance(comparable);
+        } else {
+            return comparable;
+        }
+    }
+
+    /// @brief Convert a true distance (e.g. a search radius) to the comparable scale
+    constexpr measure_type to_comparable(const measure_type& distance_value) const {
+        if constexpr (Injected<ComparableDistance>) {
+            return comparable_distance_.to_comparable(distance_value);
+        } else {
+            return distance_value;
+        }
+    }
+
+private:
+    [[no_unique_address]] BoundedDistance    bounded_distance_{};
+    [[no_unique_address]] ComparableDistance comparable_distance_{};
 };
 
 /**
@@ -106,22 +336,121 @@ struct MetricSpace {
  * 
  * A type satisfies MetricSpaceLike if it has:
  * - `element_type` and `measure_type` type aliases
- * - A static `distance` function: (element_type, element_type) -> measure_type
+ * - A `distance` function: (element_type, element_type) -> measure_type
  * 
  * This concept allows template functions to work with any MetricSpace-like
- * structure, including custom implementations or extensions.
+ * structure, including custom implementations or extensions. `distance` is
+ * checked on an instance, so static spaces and instance-based ones (which
+ * carry run-time state) both qualify; algorithms take the space as an
+ * object and call `space.distance`.
  * 
- * @note MetricSpace automatically satisfies this concept.
+ * @note MetricSpace, StatefulMetricSpace, NormedSpace and StatefulNormedSpace
+ *       automatically satisfy this concept.
  * 
  * @see MetricSpace
  */
 template <typename T>
-concept MetricSpaceLike = requires {
+concept MetricSpaceLike = requires(const T& space, const typename T::element_type& element) {
     typename T::element_type;
     typename T::measure_type;
-    { T::distance(std::declval<const typename T::element_type&>(),
-                  std::declval<const typename T::element_type&>()) }
-        -> std::same_as<typename T::measure_type>;
+    { space.distance(element, element) } -> std::same_as<typename T::measure_type>;
 };
 
+/**
+ * @brief Distance that only has to be exact up to a bound, for any MetricSpaceLike
+ * 
+ * Calls `space.bounded_distance` when the space provides one (MetricSpace and
+ * NormedSpace do), otherwise computes the full distance.
+ * 
+ * @param space The metric space
+ * @param element_left The first element
+ * @param element_right The second element
+ * @param bound The bound of interest
+ * @return The exact distance if it is <= bound, otherwise a value > bound
+ */
+template <MetricSpaceLike MS>
+constexpr typename MS::measure_type bounded_distance(const MS& space,
+                                                     const typename MS::element_type& element_left,
+                                                     const typename MS::element_type& element_right,
+                                                     const typename MS::measure_type& bound) {
+    if constexpr (requires { space.bounded_distance(element_left, element_right, bound); }) {
+        return space.bounded_distance(element_left, element_right, bound);
+    } else {
+        return space.distance(element_left, element_right);
+    }
+}
+
+/**
+ * @brief Check whether two elements are at most bound apart, for any MetricSpaceLike
+ * 
+ * @param space The metric space
+ * @param element_left The first element
+ * @param element_right The second element
+ * @param bound The bound
+ * @return distance(element_left, element_right) <= bound
+ */
+template <MetricSpaceLike MS>
+constexpr bool distance_within(const MS& space,
+                               const typename MS::element_type& element_left,
+                               const typename MS::element_type& element_right,
+                               const typename MS::measure_type& bound) {
+    return kuukan::bounded_distance(space, element_left, element_right, bound) <= bound;
+}
+
+/**
+ * @brief Monotone surrogate of the distance, for any MetricSpaceLike
+ * 
+ * Calls `space.comparable_distance` when the space provides one (MetricSpace
+ * and NormedSpace do), otherwise the distance itself.
+ * 
+ * @param space The metric space
+ * @param element_left The first element
+ * @param element_right The second element
+ * @return A value that orders pairs like their distance
+ */
+template <MetricSpaceLike MS>
+constexpr typename MS::measure_type comparable_distance(const MS& space,
+                                                        const typename MS::element_type& element_left,
+                                                        const typename MS::element_type& element_right) {
+    if constexpr (requires { space.comparable_distance(element_left, element_right); }) {
+        return space.comparable_distance(element_left, element_right);
+    } else {
+        return space.distance(element_left, element_right);
+    }
+}
+
+/**
+ * @brief Convert a comparable_distance value of any MetricSpaceLike to the true distance
+ * 
+ * @param space The metric space
+ * @param comparable A value returned by kuukan::comparable_distance
+ * @return The corresponding distance
+ */
+template <MetricSpaceLike MS>
+constexpr typename MS::measure_type comparable_to_distance(const MS& space,
+                                                           const typename MS::measure_type& comparable) {
+    if constexpr (requires { space.to_distance(comparable); }) {
+        return space.to_distance(comparable);
+    } else {
+        return comparable;
+    }
+}
+
+/**
+ * @brief Convert a true distance of any MetricSpaceLike to the comparable scale
+ * 
+ * @param space The metric space
+ * @param distance_value A distance (e.g. a search radius)
+ * @return The corresponding kuukan::comparable_distance value
+ */
+template <MetricSpaceLike MS>
+constexpr typename MS::measure_type distance_to_comparable(const MS& space,
+                                                           const typename MS::measure_type& distance_value) {
+    if constexpr (requires { space.to_comparable(distance_value); }) {
+        return space.to_comparable(distance_value);
+    } else {
+        return distance_value;
+    }
+}
+
 } // namespace kuukan
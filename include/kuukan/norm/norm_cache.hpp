@@ -0,0 +1,238 @@
+/**
+ * @file norm_cache.hpp
+ * @brief Side table of per-element norms, computed once for a reference set
+ *
+ * This file provides NormCache, which stores norm(x_i) (and, for inner
+ * product spaces, <x_i, x_i>) for every element of a span. A reference set
+ * that is queried repeatedly pays for its norms once, at build time;
+ * pairwise_distances and caller-side indexes then read them instead of
+ * recomputing. Entries are invalidated explicitly when the corresponding
+ * elements are mutated and recomputed on the next refresh.
+ */
+
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/execution/executor.hpp"
+#include "kuukan/norm/normed_space.hpp"
+#include "kuukan/inner/inner_product_space.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Per-element norms of a span of elements, with explicit invalidation
+ *
+ * @tparam NS The normed space (must satisfy NormedSpaceLike)
+ *
+ * Entry i caches norm(elements[i]). When NS also satisfies
+ * InnerProductSpaceLike, entry i caches the squared norm <x_i, x_i> as
+ * well, and the norm is derived from it, so each element is read once.
+ *
+ * The cache does not own or reference the elements: it is indexed like the
+ * span it was built from and the caller keeps the two in step. After
+ * mutating elements[i], call invalidate(i) (or refresh(space, i, element)
+ * directly); after appending elements, call refresh(space, elements), which
+ * recomputes every stale or new entry in one parallel pass.
+ *
+ * Cached norms also give a cheap pruning test for indexes over the set: by
+ * the reverse triangle inequality, distance(q, x_i) >= |norm(q) - norm(x_i)|
+ * (see distance_lower_bound).
+ *
+ * @note Concurrent reads are safe; invalidation and refreshes must not run
+ *       concurrently with other accesses.
+ *
+ * @code{.cpp}
+ * using Space = kuukan::DenseInnerProductSpace<float>;
+ * kuukan::NormCache<Space> norms(Space{}, std::span(references));   // once, at index build time
+ *
+ * // Per query batch: reference norms are read, not recomputed
+ * kuukan::pairwise_distances(Space{}, std::span(queries), std::span(references), norms,
+ *                            std::span(matrix));
+ *
+ * references[7] = updated;
+ * norms.invalidate(7);
+ * norms.refresh(Space{}, std::span(references));
+ * @endcode
+ */
+template <NormedSpaceLike NS>
+class NormCache {
+public:
+    /// @brief The normed space the norms are taken in
+    using space_type   = NS;
+
+    /// @brief Type alias for elements
+    using element_type = typename NS::element_type;
+
+    /// @brief Type alias for norms and squared norms
+    using measure_type = typename NS::measure_type;
+
+    /// @brief Whether squared norms <x, x> are cached alongside the norms
+    static constexpr bool stores_squared_norms = InnerProductSpaceLike<NS>;
+
+    /// @brief Elements per task when norms are computed on an executor
+    static constexpr std::size_t grain_size = 256;
+
+    /// @brief Construct an empty cache
+    NormCache() = default;
+
+    /**
+     * @brief Compute the norms of every element
+     *
+     * @param space The space whose norm (and inner product) is used
+     * @param elements The reference set
+     * @param executor The executor computing the norms (default: default_executor())
+     */
+    template <ExecutorLike Executor = WorkStealingPool>
+    NormCache(const NS& space, std::span<const element_type> elements,
+              Executor& executor = default_executor()) {
+        assign(space, elements, executor);
+    }
+
+    /// @brief Discard every entry and compute the norms of elements
+    template <ExecutorLike Executor = WorkStealingPool>
+    void assign(const NS& space, std::span<const element_type> elements,
+                Executor& executor = default_executor()) {
+        resize(elements.size());
+        invalidate_all();
+        refresh(space, elements, executor);
+    }
+
+    /**
+     * @brief Bring the cache in step with elements
+     *
+     * Resizes the cache to elements.size(); entries past the old size start
+     * stale. Then recomputes every stale entry, in parallel on executor.
+     * Does nothing beyond the resize when no entry is stale.
+     */
+    template <ExecutorLike Executor = WorkStealingPool>
+    void refresh(const NS& space, std::span<const element_type> elements,
+                 Executor& executor = default_executor()) {
+        resize(elements.size());
+        if (stale_count_ == 0) {
+            return;
+        }
+        parallel_for(executor, elements.size(), grain_size, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                if (!valid_[index]) {
+                    compute(space, index, elements[index]);
+                    valid_[index] = 1;
+                }
+            }
+        });
+        stale_count_ = 0;
+    }
+
+    /// @brief Recompute entry index from its (mutated) element
+    void refresh(const NS& space, std::size_t index, const element_type& element) {
+        assert(index < size());
+        compute(space, index, element);
+        if (!valid_[index]) {
+            valid_[index] = 1;
+            --stale_count_;
+        }
+    }
+
+    /// @brief Mark entry index stale after its element was mutated
+    void invalidate(std::size_t index) {
+        assert(index < size());
+        if (valid_[index]) {
+            valid_[index] = 0;
+            ++stale_count_;
+        }
+    }
+
+    /// @brief Mark every entry stale
+    void invalidate_all() {
+        valid_.assign(valid_.size(), 0);
+        stale_count_ = valid_.size();
+    }
+
+    /// @brief Number of entries (the size of the span last refreshed)
+    std::size_t size() const { return norms_.size(); }
+
+    /// @brief Whether the cache has no entries
+    bool empty() const { return norms_.empty(); }
+
+    /// @brief Whether entry index is up to date
+    bool is_valid(std::size_t index) const {
+        assert(index < size());
+        return valid_[index] != 0;
+    }
+
+    /// @brief Whether every entry is up to date
+    bool is_current() const { return stale_count_ == 0; }
+
+    /// @brief norm(elements[index]); the entry must be valid
+    measure_type norm(std::size_t index) const {
+        assert(is_valid(index));
+        return norms_[index];
+    }
+
+    /// @brief <elements[index], elements[index]>; the entry must be valid
+    measure_type squared_norm(std::size_t index) const requires stores_squared_norms {
+        assert(is_valid(index));
+        return squared_norms_[index];
+    }
+
+    /// @brief All norms, indexed like the elements; stale entries hold old values
+    std::span<const measure_type> norms() const { return norms_; }
+
+    /// @brief All squared norms, indexed like the elements; stale entries hold old values
+    std::span<const measure_type> squared_norms() const requires stores_squared_norms {
+        return squared_norms_;
+    }
+
+    /**
+     * @brief Lower bound on distance(query, elements[index])
+     *
+     * @param index A valid entry
+     * @param query_norm norm(query), computed once per query
+     * @return |query_norm - norm(elements[index])|, by the reverse triangle inequality
+     *
+     * An index can skip an element whose bound already exceeds its current
+     * search radius without reading the element.
+     */
+    measure_type distance_lower_bound(std::size_t index, const measure_type& query_norm) const {
+        const measure_type cached = norm(index);
+        return query_norm < cached ? cached - query_norm : query_norm - cached;
+    }
+
+private:
+    void resize(std::size_t count) {
+        const std::size_t old_size = valid_.size();
+        if (count < old_size) {
+            for (std::size_t index = count; index < old_size; ++index) {
+                stale_count_ -= valid_[index] == 0;
+            }
+        } else {
+            stale_count_ += count - old_size;
+        }
+        norms_.resize(count);
+        if constexpr (stores_squared_norms) {
+            squared_norms_.resize(count);
+        }
+        valid_.resize(count, 0);
+    }
+
+    void compute(const NS& space, std::size_t index, const element_type& element) {
+        if constexpr (stores_squared_norms) {
+            using std::sqrt;
+            const measure_type squared = space.inner_product(element, element);
+            squared_norms_[index] = squared;
+            norms_[index] = sqrt(squared);
+        } else {
+            norms_[index] = space.norm(element);
+        }
+    }
+
+    std::vector<measure_type> norms_;
+    std::vector<measure_type> squared_norms_;   // empty unless stores_squared_norms
+    std::vector<unsigned char> valid_;          // bytes, not vector<bool>: refresh writes them in parallel
+    std::size_t stale_count_ = 0;
+};
+
+} // namespace kuukan
@@ -8,6 +8,7 @@
  */
 
 #pragma once
+#include <concepts>
 #include <type_traits>
 #include <utility>
 #include "kuukan/concepts/core_concepts.hpp"
@@ -19,8 +20,17 @@ namespace kuukan {
 /**
  * @brief Normed space that induces a metric space
  * 
- * @tparam VS The base vector space (must satisfy VectorSpaceLike)
+ * @tparam VS The base vector space (must satisfy StaticVectorSpaceLike)
  * @tparam NormFunction Functor type for norm: (element_type) -> measure_type
+ * @tparam DifferenceNorm Optional fused functor: (element_type, element_type) -> measure_type,
+ *         computing norm(left - right) without forming the difference (default: NotInjected)
+ * @tparam BoundedDifferenceNorm Optional early-exit functor:
+ *         (element_type, element_type, measure_type) -> measure_type, returning
+ *         norm(left - right) if it is <= bound and otherwise any value > bound
+ *         (default: NotInjected, see MetricSpace::bounded_distance)
+ * @tparam ComparableDifferenceNorm Optional monotone surrogate of norm(left - right)
+ *         satisfying ComparableSurrogateLike, e.g. the squared L2 distance
+ *         (default: NotInjected, see MetricSpace::comparable_distance)
  * 
  * A normed space is a vector space equipped with a norm function that assigns
  * a non-negative "length" or "size" to each vector. The norm must satisfy:
@@ -51,6 +61,10 @@ namespace kuukan {
  * that computes: norm(VS::difference(left, right)). This is equivalent to
  * norm(left - right) in mathematical notation.
  * 
+ * When a `DifferenceNorm` functor is injected, `InducedDistance` calls it
+ * instead, so that ||left - right|| can be computed in a single streaming
+ * pass without materializing the difference element.
+ * 
  * @section normed_space_usage Usage
  * 
  * @code{.cpp}
@@ -86,10 +100,28 @@ namespace kuukan {
  * @see VectorSpace for the base vector space structure
  * @see MetricSpace for the induced metric structure
  */
-template <VectorSpaceLike VS, typename NormFunction>
+template <StaticVectorSpaceLike VS, typename NormFunction, typename DifferenceNorm = NotInjected,
+          typename BoundedDifferenceNorm = NotInjected, typename ComparableDifferenceNorm = NotInjected>
 requires std::default_initializable<NormFunction> &&
          OrderedMeasure<std::invoke_result_t<NormFunction,
-                                             const typename VS::element_type&>>
+                                             const typename VS::element_type&>> &&
+         OptionallyCallableLike<DifferenceNorm,
+                                std::invoke_result_t<NormFunction,
+                                                     const typename VS::element_type&>,
+                                const typename VS::element_type&,
+                                const typename VS::element_type&> &&
+         OptionallyCallableLike<BoundedDifferenceNorm,
+                                std::invoke_result_t<NormFunction,
+                                                     const typename VS::element_type&>,
+                                const typename VS::element_type&,
+                                const typename VS::element_type&,
+                                const std::invoke_result_t<NormFunction,
+                                                           const typename VS::element_type&>&> &&
+         OptionallyComparableSurrogateLike<ComparableDifferenceNorm,
+                                           std::invoke_result_t<NormFunction,
+                                                                const typename VS::element_type&>,
+                                           const typename VS::element_type&,
+                                           const typename VS::element_type&>
 struct NormedSpace : VS {
     /// @brief Type alias for elements (inherited from vector space)
     using element_type = typename VS::element_type;
@@ -106,6 +138,7 @@ struct NormedSpace : VS {
      * This functor implements the standard metric induced by a norm:
      * distance(a, b) = norm(a - b)
      * 
+     * It prefers the injected DifferenceNorm functor when one is provided.
      * It is used internally to construct the metric_space type.
      */
     struct InducedDistance {
@@ -118,12 +151,17 @@ struct NormedSpace : VS {
          */
         constexpr measure_type operator()(const element_type& element_left,
                                           const element_type& element_right) const {
-            return norm( VS::difference(element_left, element_right) );
+            if constexpr (Injected<DifferenceNorm>) {
+                return DifferenceNorm{}(element_left, element_right);
+            } else {
+                return norm( VS::difference(element_left, element_right) );
+            }
         }
     };
 
     /// @brief Type alias for the metric space induced by this norm
-    using metric_space = MetricSpace<element_type, InducedDistance>;
+    using metric_space = MetricSpace<element_type, InducedDistance, BoundedDifferenceNorm,
+                                     ComparableDifferenceNorm>;
     
     /// @brief Alternative name for metric_space
     using metric_type  = metric_space;
@@ -144,6 +182,217 @@ struct NormedSpace : VS {
                                            const element_type& element_right) {
         return metric_space::dist(element_left, element_right);
     }
+
+    /**
+     * @brief Compute a distance that only has to be exact up to a bound
+     * 
+     * Uses the injected BoundedDifferenceNorm functor if present, otherwise
+     * the full induced distance.
+     * 
+     * @param element_left The first element
+     * @param element_right The second element
+     * @param bound The bound of interest
+     * @return The exact distance if it is <= bound, otherwise a value > bound
+     */
+    static constexpr measure_type bounded_distance(const element_type& element_left,
+                                                   const element_type& element_right,
+                                                   const measure_type& bound) {
+        return metric_space::bounded_distance(element_left, element_right, bound);
+    }
+
+    /**
+     * @brief Check whether two elements are at most bound apart
+     * 
+     * @param element_left The first element
+     * @param element_right The second element
+     * @param bound The bound
+     * @return distance(element_left, element_right) <= bound
+     */
+    static constexpr bool distance_within(const element_type& element_left,
+                                          const element_type& element_right,
+                                          const measure_type& bound) {
+        return metric_space::distance_within(element_left, element_right, bound);
+    }
+
+    /**
+     * @brief Compute a value that orders pairs like their distance
+     * 
+     * @param element_left The first element
+     * @param element_right The second element
+     * @return The injected surrogate, or distance(element_left, element_right)
+     */
+    static constexpr measure_type comparable_distance(const element_type& element_left,
+                                                      const element_type& element_right) {
+        return metric_space::comparable_distance(element_left, element_right);
+    }
+
+    /// @brief Convert a comparable_distance value to the true distance
+    static constexpr measure_type to_distance(const measure_type& comparable) {
+        return metric_space::to_distance(comparable);
+    }
+
+    /// @brief Convert a true distance (e.g. a search radius) to the comparable scale
+    static constexpr measure_type to_comparable(const measure_type& distance_value) {
+        return metric_space::to_comparable(distance_value);
+    }
+};
+
+/**
+ * @brief Normed space structure that holds its vector space and norm functors as members
+ * 
+ * @tparam VS The base vector space: a StatefulVectorSpace, or a static VectorSpace
+ * @tparam NormFunction, DifferenceNorm, BoundedDifferenceNorm, ComparableDifferenceNorm
+ *         The same slots as NormedSpace
+ * 
+ * The instance-based counterpart of NormedSpace. It derives from (and is
+ * constructed from) an instance of VS, so the vector space operations are
+ * available as `space.addition(x, y)` and so on, and it stores the norm
+ * functors. A norm can then own a quadrature table, a weight vector or a
+ * scratch buffer without any global state. The induced distance is
+ * norm(space.difference(left, right)), or the injected DifferenceNorm.
+ * 
+ * The interface mirrors NormedSpace with member functions in place of
+ * static ones, and satisfies MetricSpaceLike, so it can be handed to
+ * VPTree, pairwise_distances and the free distance helpers as is.
+ * 
+ * @code{.cpp}
+ * // One space per worker thread, each with its own preallocated workspace
+ * struct WorkspaceNorm {
+ *     mutable std::vector<double> scratch;   // owned by this space only
+ *     double operator()(const Vec& v) const;
+ * };
+ * 
+ * using Space = kuukan::StatefulNormedSpace<MyVectorSpace, WorkspaceNorm>;
+ * Space space(MyVectorSpace{}, WorkspaceNorm{std::vector<double>(4096)});
+ * double d = space.distance(a, b);
+ * @endcode
+ * 
+ * @see NormedSpace for the static form
+ */
+template <VectorSpaceLike VS, typename NormFunction, typename DifferenceNorm = NotInjected,
+          typename BoundedDifferenceNorm = NotInjected, typename ComparableDifferenceNorm = NotInjected>
+requires OrderedMeasure<std::invoke_result_t<const NormFunction&,
+                                             const typename VS::element_type&>> &&
+         OptionallyInstanceCallableLike<DifferenceNorm,
+                                        std::invoke_result_t<const NormFunction&,
+                                                             const typename VS::element_type&>,
+                                        const typename VS::element_type&,
+                                        const typename VS::element_type&> &&
+         OptionallyInstanceCallableLike<BoundedDifferenceNorm,
+                                        std::invoke_result_t<const NormFunction&,
+                                                             const typename VS::element_type&>,
+                                        const typename VS::element_type&,
+                                        const typename VS::element_type&,
+                                        const std::invoke_result_t<const NormFunction&,
+                                                                   const typename VS::element_type&>&> &&
+         OptionallyInstanceComparableSurrogateLike<ComparableDifferenceNorm,
+                                                   std::invoke_result_t<const NormFunction&,
+                                                                        const typename VS::element_type&>,
+                                                   const typename VS::element_type&,
+                                                   const typename VS::element_type&>
+struct StatefulNormedSpace : VS {
+    /// @brief Type alias for elements (inherited from vector space)
+    using element_type = typename VS::element_type;
+    
+    /// @brief Type alias for the norm measure type
+    using measure_type = std::invoke_result_t<const NormFunction&, const element_type&>;
+
+    /// @brief The norm functor
+    [[no_unique_address]] NormFunction norm{};
+
+    /// @brief Construct the vector space and every functor by default
+    constexpr StatefulNormedSpace() = default;
+
+    /// @brief Construct the space from a vector space and functor instances
+    constexpr explicit StatefulNormedSpace(VS vector_space, NormFunction norm_functor = {},
+                                           DifferenceNorm difference_norm_functor = {},
+                                           BoundedDifferenceNorm bounded_difference_norm_functor = {},
+                                           ComparableDifferenceNorm comparable_difference_norm_functor = {})
+        : VS(std::move(vector_space)),
+          norm(std::move(norm_functor)),
+          difference_norm_(std::move(difference_norm_functor)),
+          bounded_difference_norm_(std::move(bounded_difference_norm_functor)),
+          comparable_difference_norm_(std::move(comparable_difference_norm_functor)) {}
+
+    /// @brief The distance induced by the norm: norm(element_left - element_right)
+    constexpr measure_type distance(const element_type& element_left,
+                                    const element_type& element_right) const {
+        if constexpr (Injected<DifferenceNorm>) {
+            return difference_norm_(element_left, element_right);
+        } else {
+            return norm(this->difference(element_left, element_right));
+        }
+    }
+
+    /// @brief Exact distance if it is <= bound, otherwise a value > bound (see MetricSpace::bounded_distance)
+    constexpr measure_type bounded_distance(const element_type& element_left,
+                                            const element_type& element_right,
+                                            const measure_type& bound) const {
+        if constexpr (Injected<BoundedDifferenceNorm>) {
+            return bounded_difference_norm_(element_left, element_right, bound);
+        } else {
+            return distance(element_left, element_right);
+        }
+    }
+
+    /// @brief distance(element_left, element_right) <= bound
+    constexpr bool distance_within(const element_type& element_left,
+                                   const element_type& element_right,
+                                   const measure_type& bound) const {
+        return bounded_distance(element_left, element_right, bound) <= bound;
+    }
+
+    /// @brief The injected surrogate, or the distance (see MetricSpace::comparable_distance)
+    constexpr measure_type comparable_distance(const element_type& element_left,
+                                               const element_type& element_right) const {
+        if constexpr (Injected<ComparableDifferenceNorm>) {
+            return comparable_difference_norm_(element_left, element_right);
+        } else {
+            return distance(element_left, element_right);
+        }
+    }
+
+    /// @brief Convert a comparable_distance value to the true distance
+    constexpr measure_type to_distance(const measure_type& comparable) const {
+        if constexpr (Injected<ComparableDifferenceNorm>) {
+            return comparable_difference_norm_.to_distance(comparable);
+        } else {
+            return comparable;
+        }
+    }
+
+    /// @brief Convert a true distance (e.g. a search radius) to the comparable scale
+    constexpr measure_type to_comparable(const measure_type& distance_value) const {
+        if constexpr (Injected<ComparableDifferenceNorm>) {
+            return comparable_difference_norm_.to_comparable(distance_value);
+        } else {
+            return distance_value;
+        }
+    }
+
+private:
+    [[no_unique_address]] DifferenceNorm           difference_norm_{};
+    [[no_unique_address]] BoundedDifferenceNorm    bounded_difference_norm_{};
+    [[no_unique_address]] ComparableDifferenceNorm comparable_difference_norm_{};
 };
 
+/**
+ * @brief Concept for a metric space whose elements also have a norm
+ * 
+ * @tparam T The type to check
+ * 
+ * A type satisfies NormedSpaceLike if it is MetricSpaceLike and has a
+ * `norm` function: (element_type) -> measure_type. Algorithms may then use
+ * the reverse triangle inequality, |norm(x) - norm(y)| <= distance(x, y),
+ * with norms computed once per element (see NormCache).
+ * 
+ * @note NormedSpace, StatefulNormedSpace and InnerProductSpace automatically
+ *       satisfy this concept.
+ */
+template <typename T>
+concept NormedSpaceLike = MetricSpaceLike<T> &&
+    requires(const T& space, const typename T::element_type& element) {
+        { space.norm(element) } -> std::convertible_to<typename T::measure_type>;
+    };
+
 } // namespace kuukan
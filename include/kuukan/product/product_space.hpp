@@ -0,0 +1,800 @@
+/**
+ * @file product_space.hpp
+ * @brief Direct sums of vector spaces with componentwise operations and product norms
+ *
+ * This file provides ProductSpace, the vector space V_1 × ... × V_n whose
+ * elements are tuples of component elements and whose operations act on
+ * every component, and ProductNormedSpace, which equips it with the max,
+ * sum or Euclidean combination of the component norms.
+ *
+ * @section product_layout Element Layout
+ *
+ * When every component is a statically sized DenseVectorSpace (or a normed
+ * or inner product space over one) with the same scalar type, the product
+ * element is a DenseProductElement: one DenseVector holding all components
+ * back to back. Every operation is then a single SIMD kernel over the whole
+ * buffer, the element is DenseElementLike (so ElementBatch stores it in SoA
+ * layout with the dense lane kernels), and a Euclidean product of L2 norms
+ * (likewise a sum of L1 norms or a maximum of L-infinity norms) is the
+ * corresponding dense norm of the buffer, with its fused, bounded and
+ * comparable distances. Any other combination uses ProductElement, a tuple
+ * of component elements whose operations call the component spaces.
+ *
+ * Scalars fit the flat layout as one-component dense spaces, e.g.
+ * DenseNormedSpace<double, 1, DenseL2Norm>.
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/norm/normed_space.hpp"
+#include "kuukan/dense/dense_vector_space.hpp"
+#include "kuukan/dense/simd.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Element of a product of arbitrary spaces: a tuple of component elements
+ *
+ * @tparam Elements The component element types
+ *
+ * @code{.cpp}
+ * kuukan::ProductElement<Vec3, Function> state{{position, field}};
+ * const Vec3& p = state.get<0>();
+ * @endcode
+ */
+template <typename... Elements>
+struct ProductElement {
+    /// @brief The component elements
+    std::tuple<Elements...> components;
+
+    /// @brief Component I
+    template <std::size_t I>
+    constexpr auto& get() noexcept { return std::get<I>(components); }
+
+    /// @brief Component I
+    template <std::size_t I>
+    constexpr const auto& get() const noexcept { return std::get<I>(components); }
+};
+
+/**
+ * @brief Element of a product of statically sized dense spaces, stored in one buffer
+ *
+ * @tparam T The scalar type of the components
+ * @tparam Extents The sizes of the components
+ *
+ * A DenseVector of (Extents + ...) components, and usable as one (data(),
+ * size(), indexing and every dense kernel); get<I>() views component I.
+ *
+ * @code{.cpp}
+ * kuukan::DenseProductElement<double, 3, 1> state{{1.0, 2.0, 3.0, 0.5}};
+ * std::span<double, 3> position = state.get<0>();
+ * @endcode
+ */
+template <typename T, std::size_t... Extents>
+struct DenseProductElement : DenseVector<T, (Extents + ...)> {
+    /// @brief The number of components
+    static constexpr std::size_t component_count = sizeof...(Extents);
+
+    /// @brief The size of component I
+    template <std::size_t I>
+    static constexpr std::size_t component_extent = std::array<std::size_t, sizeof...(Extents)>{Extents...}[I];
+
+    /// @brief The position of the first scalar of component I in the buffer
+    template <std::size_t I>
+    static constexpr std::size_t component_offset = [] {
+        constexpr std::array<std::size_t, sizeof...(Extents)> extents{Extents...};
+        std::size_t offset = 0;
+        for (std::size_t index = 0; index < I; ++index) {
+            offset += extents[index];
+        }
+        return offset;
+    }();
+
+    /// @brief View of component I
+    template <std::size_t I>
+    constexpr std::span<T, component_extent<I>> get() noexcept {
+        return std::span<T, component_extent<I>>(this->data() + component_offset<I>, component_extent<I>);
+    }
+
+    /// @brief View of component I
+    template <std::size_t I>
+    constexpr std::span<const T, component_extent<I>> get() const noexcept {
+        return std::span<const T, component_extent<I>>(this->data() + component_offset<I>, component_extent<I>);
+    }
+};
+
+namespace detail {
+
+/// @brief Whether VS is a statically sized DenseVectorSpace (or a space derived from one)
+template <typename VS>
+constexpr bool is_static_dense_space() {
+    if constexpr (requires { { VS::extent } -> std::convertible_to<std::size_t>; }) {
+        if constexpr (VS::extent != std::dynamic_extent) {
+            return std::same_as<typename VS::element_type, DenseVector<typename VS::scalar_type, VS::extent>>;
+        }
+    }
+    return false;
+}
+
+/// @brief The scalar type of the first space
+template <typename... VS>
+using first_scalar_t = typename std::tuple_element_t<0, std::tuple<VS...>>::scalar_type;
+
+/// @brief Whether the product of VS... is stored in one dense buffer
+template <typename... VS>
+inline constexpr bool flat_product = (is_static_dense_space<VS>() && ...) &&
+                                     (std::same_as<typename VS::scalar_type, first_scalar_t<VS...>> && ...);
+
+/// @brief Call f(std::integral_constant<std::size_t, I>{}) for I = 0, ..., Count - 1
+template <std::size_t Count, typename F>
+constexpr void for_each_index(F&& f) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (f(std::integral_constant<std::size_t, I>{}), ...);
+    }(std::make_index_sequence<Count>{});
+}
+
+/**
+ * @brief Componentwise operation functors of a product stored as a tuple
+ *
+ * Each functor calls the matching operation of every component space, so
+ * in-place, fused and linear-combination kernels of the components are
+ * used where they exist.
+ */
+template <typename... VS>
+struct ProductOperations {
+    /// @brief Type alias for the element type
+    using element_type = ProductElement<typename VS::element_type...>;
+
+    /// @brief Type alias for the common scalar type
+    using scalar_type  = first_scalar_t<VS...>;
+
+    /// @brief Type alias for the terms of a linear combination
+    using term_type    = LinearTerm<scalar_type, element_type>;
+
+    /// @brief Component space I
+    template <std::size_t I>
+    using space = std::tuple_element_t<I, std::tuple<VS...>>;
+
+    /// @brief The element whose component I is f(std::integral_constant<std::size_t, I>{})
+    template <typename F>
+    static constexpr element_type generate(F&& f) {
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return element_type{{f(std::integral_constant<std::size_t, I>{})...}};
+        }(std::index_sequence_for<VS...>{});
+    }
+
+    /// @brief Componentwise addition
+    struct Addition {
+        constexpr element_type operator()(const element_type& left, const element_type& right) const {
+            return generate([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                return space<I>::addition(left.template get<I>(), right.template get<I>());
+            });
+        }
+    };
+
+    /// @brief Componentwise subtraction
+    struct Subtraction {
+        constexpr element_type operator()(const element_type& left, const element_type& right) const {
+            return generate([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                return space<I>::difference(left.template get<I>(), right.template get<I>());
+            });
+        }
+    };
+
+    /// @brief Componentwise multiplication by a scalar
+    struct ScalarAction {
+        constexpr element_type operator()(const scalar_type& scalar_value, const element_type& element) const {
+            return generate([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                return space<I>::scalar_action(scalar_value, element.template get<I>());
+            });
+        }
+    };
+
+    /// @brief Componentwise negation
+    struct Negation {
+        constexpr element_type operator()(const element_type& element) const {
+            return generate([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                return space<I>::negation(element.template get<I>());
+            });
+        }
+    };
+
+    /// @brief The tuple of component zeros
+    struct ZeroSupplier {
+        constexpr element_type operator()() const {
+            return generate([](auto index) { return space<decltype(index)::value>::zero_supplier(); });
+        }
+    };
+
+    /// @brief Equality of every component
+    struct Equality {
+        constexpr bool operator()(const element_type& left, const element_type& right) const {
+            bool equal = true;
+            for_each_index<sizeof...(VS)>([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                equal = equal && space<I>::equality(left.template get<I>(), right.template get<I>());
+            });
+            return equal;
+        }
+    };
+
+    /// @brief Componentwise scalar_value * x + y
+    struct Axpy {
+        constexpr element_type operator()(const scalar_type& scalar_value, const element_type& x,
+                                          const element_type& y) const {
+            return generate([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                return space<I>::axpy(scalar_value, x.template get<I>(), y.template get<I>());
+            });
+        }
+    };
+
+    /// @brief One linear_combination call per component space
+    struct LinearCombination {
+        element_type operator()(std::span<const term_type> terms) const {
+            return generate([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                using component_term = typename space<I>::term_type;
+                std::vector<component_term> components;
+                components.reserve(terms.size());
+                for (const term_type& term : terms) {
+                    components.push_back({term.coefficient, term.element.template get<I>()});
+                }
+                return space<I>::linear_combination(std::span<const component_term>(components));
+            });
+        }
+    };
+
+    /// @brief In-place target += right, per component
+    struct AddAssign {
+        constexpr void operator()(element_type& target, const element_type& right) const {
+            for_each_index<sizeof...(VS)>([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                space<I>::add_assign(target.template get<I>(), right.template get<I>());
+            });
+        }
+    };
+
+    /// @brief In-place target = scalar_value * target, per component
+    struct ScaleAssign {
+        constexpr void operator()(const scalar_type& scalar_value, element_type& target) const {
+            for_each_index<sizeof...(VS)>([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                space<I>::scale_assign(scalar_value, target.template get<I>());
+            });
+        }
+    };
+
+    /// @brief In-place target = -target, per component
+    struct NegateInPlace {
+        constexpr void operator()(element_type& target) const {
+            for_each_index<sizeof...(VS)>([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                space<I>::negate_in_place(target.template get<I>());
+            });
+        }
+    };
+};
+
+/**
+ * @brief Operation functors of a product of dense spaces stored in one buffer
+ *
+ * Componentwise operations of a direct sum of dense spaces are the dense
+ * operations of the concatenated buffer, so every functor is one kernel of
+ * `dense/simd.hpp` over (Extents + ...) scalars.
+ */
+template <typename T, std::size_t... Extents>
+struct DenseProductOperations {
+    /// @brief Type alias for the element type
+    using element_type = DenseProductElement<T, Extents...>;
+
+    /// @brief Type alias for the scalar type
+    using scalar_type  = T;
+
+    /// @brief Type alias for the terms of a linear combination
+    using term_type    = LinearTerm<T, element_type>;
+
+    /// @brief The number of scalars in the buffer
+    static constexpr std::size_t extent = (Extents + ...);
+
+    struct Addition {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            element_type result;
+            simd::add<T, extent>(left.data(), right.data(), result.data(), extent);
+            return result;
+        }
+    };
+
+    struct Subtraction {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            element_type result;
+            simd::subtract<T, extent>(left.data(), right.data(), result.data(), extent);
+            return result;
+        }
+    };
+
+    struct ScalarAction {
+        element_type operator()(const T& scalar_value, const element_type& element) const {
+            element_type result;
+            simd::scale<T, extent>(scalar_value, element.data(), result.data(), extent);
+            return result;
+        }
+    };
+
+    struct Negation {
+        element_type operator()(const element_type& element) const {
+            element_type result;
+            simd::negate<T, extent>(element.data(), result.data(), extent);
+            return result;
+        }
+    };
+
+    struct ZeroSupplier {
+        constexpr element_type operator()() const {
+            return element_type{};
+        }
+    };
+
+    struct Equality {
+        bool operator()(const element_type& left, const element_type& right) const {
+            return std::equal(left.begin(), left.end(), right.begin());
+        }
+    };
+
+    struct Axpy {
+        element_type operator()(const T& scalar_value, const element_type& x, const element_type& y) const {
+            element_type result;
+            simd::axpy<T, extent>(scalar_value, x.data(), y.data(), result.data(), extent);
+            return result;
+        }
+    };
+
+    /// @brief Fused linear combination in one pass over the whole buffer
+    struct LinearCombination {
+        element_type operator()(std::span<const term_type> terms) const {
+            if (terms.empty()) {
+                return element_type{};
+            }
+            constexpr std::size_t inline_capacity = 16;
+            std::array<T, inline_capacity> inline_coefficients;
+            std::array<const T*, inline_capacity> inline_elements;
+            std::vector<T> heap_coefficients;
+            std::vector<const T*> heap_elements;
+            T* coefficients = inline_coefficients.data();
+            const T** elements = inline_elements.data();
+            if (terms.size() > inline_capacity) {
+                heap_coefficients.resize(terms.size());
+                heap_elements.resize(terms.size());
+                coefficients = heap_coefficients.data();
+                elements = heap_elements.data();
+            }
+            for (std::size_t index = 0; index < terms.size(); ++index) {
+                coefficients[index] = terms[index].coefficient;
+                elements[index] = terms[index].element.data();
+            }
+            element_type result;
+            simd::linear_combination<T, extent>(coefficients, elements, terms.size(), result.data(), extent);
+            return result;
+        }
+    };
+
+    struct AddAssign {
+        void operator()(element_type& target, const element_type& right) const {
+            simd::add<T, extent>(target.data(), right.data(), target.data(), extent);
+        }
+    };
+
+    struct ScaleAssign {
+        void operator()(const T& scalar_value, element_type& target) const {
+            simd::scale<T, extent>(scalar_value, target.data(), target.data(), extent);
+        }
+    };
+
+    struct NegateInPlace {
+        void operator()(element_type& target) const {
+            simd::negate<T, extent>(target.data(), target.data(), extent);
+        }
+    };
+
+    /// @brief Wide-lane kernels for ElementBatch (the dense ones: every operation is componentwise)
+    using BatchKernels = typename DenseOperations<T, extent>::BatchKernels;
+};
+
+/// @brief The operation functors of the product of VS...
+template <typename... VS>
+struct ProductOperationsSelect {
+    using type = ProductOperations<VS...>;
+};
+
+template <typename... VS>
+requires flat_product<VS...>
+struct ProductOperationsSelect<VS...> {
+    using type = DenseProductOperations<first_scalar_t<VS...>, VS::extent...>;
+};
+
+/// @brief VectorSpace over the functors of Operations (with batch_kernels when Operations has them)
+template <typename Operations, bool = requires { typename Operations::BatchKernels; }>
+struct ProductVectorSpaceBase : VectorSpace<
+    typename Operations::element_type,
+    typename Operations::scalar_type,
+    typename Operations::Addition,
+    typename Operations::ScalarAction,
+    typename Operations::Negation,
+    typename Operations::ZeroSupplier,
+    typename Operations::Equality,
+    typename Operations::Axpy,
+    typename Operations::LinearCombination,
+    typename Operations::AddAssign,
+    typename Operations::ScaleAssign,
+    typename Operations::NegateInPlace,
+    typename Operations::Subtraction
+> {};
+
+template <typename Operations>
+struct ProductVectorSpaceBase<Operations, true> : ProductVectorSpaceBase<Operations, false> {
+    /// @brief Wide-lane kernels picked up by ElementBatch
+    using batch_kernels = typename Operations::BatchKernels;
+};
+
+} // namespace detail
+
+/**
+ * @brief Direct sum V_1 × ... × V_n of vector spaces over a common scalar type
+ *
+ * @tparam VS The component spaces (each must satisfy StaticVectorSpaceLike)
+ *
+ * All thirteen VectorSpace slots are generated componentwise: addition,
+ * scalar_action, negation, zero_supplier and equality, plus axpy,
+ * linear_combination, the in-place operations and subtraction, which call
+ * the fused or in-place operations of each component. The element type is
+ * a DenseProductElement (one buffer, see @ref product_layout) when every
+ * component is a statically sized dense space, and a ProductElement
+ * otherwise. Use make_element to assemble an element and get<I> to read a
+ * component either way.
+ *
+ * @code{.cpp}
+ * using R3 = kuukan::DenseVectorSpace<double, 3>;
+ * using R1 = kuukan::DenseVectorSpace<double, 1>;
+ * using State = kuukan::ProductSpace<R3, R1>;   // flat buffer of 4 doubles
+ *
+ * auto x = State::make_element(R3::element_type{1.0, 2.0, 3.0}, R1::element_type{0.5});
+ * auto y = State::axpy(2.0, x, x);   // one SIMD kernel over all 4 scalars
+ * double mass = State::get<1>(y)[0];   // 1.5
+ * @endcode
+ */
+template <StaticVectorSpaceLike... VS>
+requires (sizeof...(VS) > 0) &&
+         (std::same_as<typename VS::scalar_type, detail::first_scalar_t<VS...>> && ...)
+struct ProductSpace : detail::ProductVectorSpaceBase<typename detail::ProductOperationsSelect<VS...>::type> {
+    /// @brief Type alias for elements of the product
+    using element_type = typename detail::ProductOperationsSelect<VS...>::type::element_type;
+
+    /// @brief The number of component spaces
+    static constexpr std::size_t component_count = sizeof...(VS);
+
+    /// @brief Whether elements are stored in one dense buffer (see @ref product_layout)
+    static constexpr bool is_flat = detail::flat_product<VS...>;
+
+    /// @brief Component space I
+    template <std::size_t I>
+    using component_space = std::tuple_element_t<I, std::tuple<VS...>>;
+
+    /**
+     * @brief Assemble a product element from one element of every component space
+     *
+     * @param parts The components, in order
+     * @return The product element (a copy of the parts)
+     */
+    static constexpr element_type make_element(const typename VS::element_type&... parts) {
+        if constexpr (is_flat) {
+            element_type result;
+            detail::for_each_index<sizeof...(VS)>([&](auto index) {
+                constexpr std::size_t I = decltype(index)::value;
+                const auto& part = std::get<I>(std::forward_as_tuple(parts...));
+                std::copy_n(part.data(), part.size(), result.template get<I>().data());
+            });
+            return result;
+        } else {
+            return element_type{{parts...}};
+        }
+    }
+
+    /// @brief Component I of element: a reference, or a std::span view for flat elements
+    template <std::size_t I>
+    static constexpr decltype(auto) get(element_type& element) noexcept {
+        return element.template get<I>();
+    }
+
+    /// @brief Component I of element: a reference, or a std::span view for flat elements
+    template <std::size_t I>
+    static constexpr decltype(auto) get(const element_type& element) noexcept {
+        return element.template get<I>();
+    }
+};
+
+/**
+ * @brief How ProductNormedSpace combines the component norms n_i = ||x_i||
+ */
+enum class ProductNormKind {
+    /// @brief max_i n_i
+    max,
+
+    /// @brief sum_i n_i
+    sum,
+
+    /// @brief sqrt(sum_i n_i^2)
+    euclidean
+};
+
+namespace detail {
+
+/// @brief Add the component measure value to a running product norm accumulator
+template <ProductNormKind Kind, typename M>
+constexpr M product_accumulate(const M& accumulator, const M& value) {
+    if constexpr (Kind == ProductNormKind::max) {
+        return std::max(accumulator, value);
+    } else if constexpr (Kind == ProductNormKind::sum) {
+        return accumulator + value;
+    } else {
+        return accumulator + value * value;
+    }
+}
+
+/// @brief Turn a product norm accumulator into the norm
+template <ProductNormKind Kind, typename M>
+M product_finish(const M& accumulator) {
+    if constexpr (Kind == ProductNormKind::euclidean) {
+        using std::sqrt;
+        return sqrt(accumulator);
+    } else {
+        return accumulator;
+    }
+}
+
+/// @brief The component as an element of NS: itself, or a copy of a flat view
+template <typename NS, typename Component>
+decltype(auto) component_element(const Component& component) {
+    if constexpr (std::same_as<Component, typename NS::element_type>) {
+        return (component);
+    } else {
+        typename NS::element_type element;
+        std::copy_n(component.data(), component.size(), element.data());
+        return element;
+    }
+}
+
+/// @brief Measure type of the product of the normed spaces NS...
+template <typename... NS>
+using product_measure_t = std::common_type_t<typename NS::measure_type...>;
+
+} // namespace detail
+
+/**
+ * @brief Product norm: the Kind combination of the component norms
+ *
+ * @tparam Kind How the component norms are combined
+ * @tparam NS The component normed spaces
+ */
+template <ProductNormKind Kind, typename... NS>
+struct ProductNorm {
+    using space_type   = ProductSpace<NS...>;
+    using element_type = typename space_type::element_type;
+    using measure_type = detail::product_measure_t<NS...>;
+
+    measure_type operator()(const element_type& element) const {
+        measure_type accumulator(0);
+        detail::for_each_index<sizeof...(NS)>([&](auto index) {
+            constexpr std::size_t I = decltype(index)::value;
+            using component = typename space_type::template component_space<I>;
+            const measure_type value(component::norm(
+                detail::component_element<component>(space_type::template get<I>(element))));
+            accumulator = detail::product_accumulate<Kind>(accumulator, value);
+        });
+        return detail::product_finish<Kind>(accumulator);
+    }
+};
+
+/**
+ * @brief Fused product distance: the Kind combination of the component distances
+ *
+ * Each component uses its own (possibly fused) distance, so no product
+ * difference element is formed.
+ */
+template <ProductNormKind Kind, typename... NS>
+struct ProductDifferenceNorm {
+    using space_type   = ProductSpace<NS...>;
+    using element_type = typename space_type::element_type;
+    using measure_type = detail::product_measure_t<NS...>;
+
+    measure_type operator()(const element_type& left, const element_type& right) const {
+        measure_type accumulator(0);
+        detail::for_each_index<sizeof...(NS)>([&](auto index) {
+            constexpr std::size_t I = decltype(index)::value;
+            using component = typename space_type::template component_space<I>;
+            const measure_type value(component::distance(
+                detail::component_element<component>(space_type::template get<I>(left)),
+                detail::component_element<component>(space_type::template get<I>(right))));
+            accumulator = detail::product_accumulate<Kind>(accumulator, value);
+        });
+        return detail::product_finish<Kind>(accumulator);
+    }
+};
+
+/**
+ * @brief Early-exit product distance for the BoundedDifferenceNorm slot of NormedSpace
+ *
+ * Every component gets the budget still left under bound (the bound itself
+ * for max, bound minus the partial sum for sum, and sqrt(bound^2 - partial)
+ * for euclidean) through its bounded_distance, and the evaluation stops at
+ * the first component that exhausts it.
+ */
+template <ProductNormKind Kind, typename... NS>
+struct ProductBoundedDifferenceNorm {
+    using space_type   = ProductSpace<NS...>;
+    using element_type = typename space_type::element_type;
+    using measure_type = detail::product_measure_t<NS...>;
+
+    measure_type operator()(const element_type& left, const element_type& right,
+                            const measure_type& bound) const {
+        using std::sqrt;
+        const measure_type limit = Kind == ProductNormKind::euclidean ? bound * bound : bound;
+        measure_type accumulator(0);
+        bool exceeded = bound < measure_type(0);
+        detail::for_each_index<sizeof...(NS)>([&](auto index) {
+            constexpr std::size_t I = decltype(index)::value;
+            using component = typename space_type::template component_space<I>;
+            if (exceeded) {
+                return;
+            }
+            measure_type budget = bound;
+            if constexpr (Kind == ProductNormKind::sum) {
+                budget = bound - accumulator;
+            } else if constexpr (Kind == ProductNormKind::euclidean) {
+                budget = sqrt(std::max(limit - accumulator, measure_type(0)));
+            }
+            const auto& component_left = detail::component_element<component>(space_type::template get<I>(left));
+            const auto& component_right = detail::component_element<component>(space_type::template get<I>(right));
+            measure_type value;
+            if constexpr (requires { component::bounded_distance(component_left, component_right, budget); }) {
+                value = measure_type(component::bounded_distance(component_left, component_right, budget));
+            } else {
+                value = measure_type(component::distance(component_left, component_right));
+            }
+            accumulator = detail::product_accumulate<Kind>(accumulator, value);
+            exceeded = limit < accumulator;
+        });
+        const measure_type result = detail::product_finish<Kind>(accumulator);
+        // Rounding of bound^2 and sqrt can leave an early exit at or below bound; finish the sum then
+        if (exceeded && !(bound < result)) {
+            return ProductDifferenceNorm<Kind, NS...>{}(left, right);
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Sum of squared component distances, the comparable surrogate of the euclidean product distance
+ */
+template <typename... NS>
+struct ProductSquaredDifferenceNorm {
+    using space_type   = ProductSpace<NS...>;
+    using element_type = typename space_type::element_type;
+    using measure_type = detail::product_measure_t<NS...>;
+
+    measure_type operator()(const element_type& left, const element_type& right) const {
+        measure_type accumulator(0);
+        detail::for_each_index<sizeof...(NS)>([&](auto index) {
+            constexpr std::size_t I = decltype(index)::value;
+            using component = typename space_type::template component_space<I>;
+            const measure_type value(component::distance(
+                detail::component_element<component>(space_type::template get<I>(left)),
+                detail::component_element<component>(space_type::template get<I>(right))));
+            accumulator += value * value;
+        });
+        return accumulator;
+    }
+
+    /// @brief Squared distance -> distance
+    measure_type to_distance(const measure_type& comparable) const {
+        using std::sqrt;
+        return sqrt(comparable);
+    }
+
+    /// @brief Distance -> squared distance
+    measure_type to_comparable(const measure_type& distance) const { return distance * distance; }
+};
+
+namespace detail {
+
+/// @brief The dense norm whose value on a flat buffer is the Kind combination of the same norm on its parts
+template <ProductNormKind Kind>
+struct ProductDenseNorm;
+
+template <>
+struct ProductDenseNorm<ProductNormKind::max> {
+    template <typename T, std::size_t Extent>
+    using type = DenseLinfNorm<T, Extent>;
+};
+
+template <>
+struct ProductDenseNorm<ProductNormKind::sum> {
+    template <typename T, std::size_t Extent>
+    using type = DenseL1Norm<T, Extent>;
+};
+
+template <>
+struct ProductDenseNorm<ProductNormKind::euclidean> {
+    template <typename T, std::size_t Extent>
+    using type = DenseL2Norm<T, Extent>;
+};
+
+/// @brief The NormedSpace of ProductNormedSpace: generic product functors
+template <ProductNormKind Kind, typename... NS>
+struct ProductNormedSpaceSelect {
+    using type = NormedSpace<ProductSpace<NS...>,
+                             ProductNorm<Kind, NS...>,
+                             ProductDifferenceNorm<Kind, NS...>,
+                             ProductBoundedDifferenceNorm<Kind, NS...>,
+                             std::conditional_t<Kind == ProductNormKind::euclidean,
+                                                ProductSquaredDifferenceNorm<NS...>, NotInjected>>;
+};
+
+/// @brief Flat products whose components all carry the dense norm matching Kind: the dense norm of the buffer
+template <ProductNormKind Kind, typename... NS>
+requires flat_product<NS...> &&
+         (std::same_as<std::remove_cvref_t<decltype(NS::norm)>,
+                       typename ProductDenseNorm<Kind>::template type<typename NS::scalar_type, NS::extent>> && ...)
+struct ProductNormedSpaceSelect<Kind, NS...> {
+    using norm = typename ProductDenseNorm<Kind>::template type<first_scalar_t<NS...>, (NS::extent + ...)>;
+    using type = NormedSpace<ProductSpace<NS...>, norm,
+                             typename norm::difference_norm,
+                             typename norm::bounded_difference_norm,
+                             typename norm::comparable_difference_norm>;
+};
+
+} // namespace detail
+
+/**
+ * @brief ProductSpace of normed spaces with a product norm
+ *
+ * @tparam Kind How the component norms are combined (max, sum or euclidean)
+ * @tparam NS The component normed spaces (static, e.g. NormedSpace or DenseNormedSpace)
+ *
+ * The norm is the Kind combination of the component norms, and the induced
+ * distance the same combination of the component distances, each computed
+ * with the component's own fused distance. The bounded distance hands every
+ * component the remaining budget, and the euclidean product has the sum of
+ * squared component distances as its comparable surrogate.
+ *
+ * For flat products whose components all use the dense norm that matches
+ * Kind (L-infinity for max, L1 for sum, L2 for euclidean) the product norm
+ * equals that norm of the whole buffer, so the space is the dense normed
+ * space of the buffer: distances, bounded and comparable distances and the
+ * ElementBatch norm kernels each make one pass over all components.
+ *
+ * @code{.cpp}
+ * using Position = kuukan::DenseNormedSpace<double, 3, kuukan::DenseL2Norm>;
+ * using Velocity = kuukan::DenseNormedSpace<double, 3, kuukan::DenseL2Norm>;
+ * using Phase = kuukan::ProductNormedSpace<kuukan::ProductNormKind::euclidean, Position, Velocity>;
+ * double d = Phase::distance(a, b);   // one fused L2 pass over 6 doubles
+ * @endcode
+ */
+template <ProductNormKind Kind, typename... NS>
+using ProductNormedSpace = typename detail::ProductNormedSpaceSelect<Kind, NS...>::type;
+
+} // namespace kuukan
@@ -0,0 +1,806 @@
+/**
+ * @file sparse_vector_space.hpp
+ * @brief Vector space backend for sparse numeric vectors
+ *
+ * This file provides SparseVector, an element type storing only the nonzero
+ * components of a vector as sorted index/value arrays, and SparseVectorSpace,
+ * a VectorSpace over it whose operations work on the stored entries only.
+ * It also provides sparse L1, L2 and L-infinity norms with fused difference
+ * norms, and distances between a sparse and a dense vector.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+#include "kuukan/norm/normed_space.hpp"
+#include "kuukan/dense/simd.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Sparse vector stored as sorted index/value arrays
+ *
+ * @tparam Index The unsigned index type of the components
+ * @tparam T The scalar type of the components
+ *
+ * Only nonzero components are stored, with strictly increasing indices.
+ * Components that are not stored are zero; there is no fixed dimension, so
+ * the default-constructed (empty) vector is the zero vector of every space.
+ *
+ * @code{.cpp}
+ * kuukan::SparseVector<std::uint32_t, double> v{{3, 1.5}, {10, -2.0}};
+ * double x = v[10];   // -2.0
+ * double y = v[4];    //  0.0
+ * @endcode
+ */
+template <std::unsigned_integral Index, typename T>
+struct SparseOperations;
+
+template <std::unsigned_integral Index, typename T>
+class SparseVector {
+public:
+    /// @brief Type alias for component indices
+    using index_type = Index;
+
+    /// @brief Type alias for component values
+    using value_type = T;
+
+    /// @brief Construct the zero vector (no allocation)
+    SparseVector() = default;
+
+    /**
+     * @brief Construct from index/value pairs in any order
+     *
+     * Entries with equal indices are summed; zero values are dropped.
+     *
+     * @param entries The (index, value) pairs
+     */
+    SparseVector(std::initializer_list<std::pair<Index, T>> entries) {
+        std::vector<std::pair<Index, T>> sorted(entries);
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const auto& left, const auto& right) { return left.first < right.first; });
+        reserve(sorted.size());
+        for (std::size_t position = 0; position < sorted.size();) {
+            const Index index = sorted[position].first;
+            T value = sorted[position].second;
+            for (++position; position < sorted.size() && sorted[position].first == index; ++position) {
+                value = value + sorted[position].second;
+            }
+            if (value != T{}) {
+                push_back(index, value);
+            }
+        }
+    }
+
+    /**
+     * @brief Construct from index and value arrays
+     *
+     * @param indices Strictly increasing component indices
+     * @param values The values of those components (same length)
+     */
+    SparseVector(std::vector<Index> indices, std::vector<T> values)
+        : indices_(std::move(indices)), values_(std::move(values)) {
+        assert(indices_.size() == values_.size());
+        assert(std::adjacent_find(indices_.begin(), indices_.end(),
+                                  [](Index left, Index right) { return !(left < right); }) == indices_.end());
+    }
+
+    /**
+     * @brief Construct from a dense array, keeping its nonzero components
+     *
+     * @param dense The dense components
+     * @return The sparse representation of dense
+     */
+    static SparseVector from_dense(std::span<const T> dense) {
+        SparseVector result;
+        for (std::size_t index = 0; index < dense.size(); ++index) {
+            if (dense[index] != T{}) {
+                result.push_back(static_cast<Index>(index), dense[index]);
+            }
+        }
+        return result;
+    }
+
+    /// @brief Number of stored (nonzero) components
+    std::size_t nnz() const noexcept { return indices_.size(); }
+
+    /// @brief Whether no component is stored (the vector is zero)
+    bool empty() const noexcept { return indices_.empty(); }
+
+    /// @brief Smallest dense size that holds every stored component
+    std::size_t extent() const noexcept {
+        return indices_.empty() ? 0 : static_cast<std::size_t>(indices_.back()) + 1;
+    }
+
+    /// @brief The stored indices in increasing order
+    std::span<const Index> indices() const noexcept { return indices_; }
+
+    /// @brief The stored values, parallel to indices()
+    std::span<const T> values() const noexcept { return values_; }
+    std::span<T>       values() noexcept       { return values_; }
+
+    /// @brief The value of a component (zero if not stored); O(log nnz)
+    T operator[](Index index) const {
+        const auto found = std::lower_bound(indices_.begin(), indices_.end(), index);
+        if (found == indices_.end() || *found != index) {
+            return T{};
+        }
+        return values_[static_cast<std::size_t>(found - indices_.begin())];
+    }
+
+    /// @brief Reserve room for entry_count stored components
+    void reserve(std::size_t entry_count) {
+        indices_.reserve(entry_count);
+        values_.reserve(entry_count);
+    }
+
+    /// @brief Append a component whose index exceeds every stored index
+    void push_back(Index index, const T& value) {
+        assert(indices_.empty() || indices_.back() < index);
+        indices_.push_back(index);
+        values_.push_back(value);
+    }
+
+    /// @brief Remove all components (keeps the capacity)
+    void clear() noexcept {
+        indices_.clear();
+        values_.clear();
+    }
+
+    /**
+     * @brief Write the stored components into a zero-filled dense buffer
+     *
+     * @param out The dense buffer
+     * @param dimension Its size (at least extent())
+     */
+    void scatter(T* out, std::size_t dimension) const {
+        assert(extent() <= dimension);
+        (void)dimension;
+        for (std::size_t entry = 0; entry < indices_.size(); ++entry) {
+            out[indices_[entry]] = values_[entry];
+        }
+    }
+
+private:
+    // The in-place operations rewrite both arrays while merging
+    friend struct SparseOperations<Index, T>;
+
+    std::vector<Index> indices_;
+    std::vector<T>     values_;
+};
+
+/**
+ * @brief Non-owning view of sparse components
+ *
+ * @tparam Index The unsigned index type of the components
+ * @tparam T The scalar type of the components
+ *
+ * Two spans over sorted index/value arrays held elsewhere, e.g. the records
+ * of a MappedElementStore. The fused sparse difference norms measure views
+ * and SparseVector alike (see SparseComponentsOf).
+ */
+template <std::unsigned_integral Index, typename T>
+class SparseVectorView {
+public:
+    /// @brief Type alias for component indices
+    using index_type = Index;
+
+    /// @brief Type alias for component values
+    using value_type = T;
+
+    /// @brief View of the zero vector
+    constexpr SparseVectorView() = default;
+
+    /// @brief View of strictly increasing indices and their values (same length)
+    constexpr SparseVectorView(std::span<const Index> indices, std::span<const T> values) noexcept
+        : indices_(indices), values_(values) {
+        assert(indices_.size() == values_.size());
+    }
+
+    /// @brief View of the components of vector
+    SparseVectorView(const SparseVector<Index, T>& vector) noexcept
+        : indices_(vector.indices()), values_(vector.values()) {}
+
+    /// @brief Number of stored (nonzero) components
+    constexpr std::size_t nnz() const noexcept { return indices_.size(); }
+
+    /// @brief Whether no component is stored (the vector is zero)
+    constexpr bool empty() const noexcept { return indices_.empty(); }
+
+    /// @brief Smallest dense size that holds every stored component
+    constexpr std::size_t extent() const noexcept {
+        return indices_.empty() ? 0 : static_cast<std::size_t>(indices_.back()) + 1;
+    }
+
+    /// @brief The stored indices in increasing order
+    constexpr std::span<const Index> indices() const noexcept { return indices_; }
+
+    /// @brief The stored values, parallel to indices()
+    constexpr std::span<const T> values() const noexcept { return values_; }
+
+    /// @brief Copy the viewed components into an owning SparseVector
+    SparseVector<Index, T> to_vector() const {
+        return SparseVector<Index, T>(std::vector<Index>(indices_.begin(), indices_.end()),
+                                      std::vector<T>(values_.begin(), values_.end()));
+    }
+
+private:
+    std::span<const Index> indices_;
+    std::span<const T>     values_;
+};
+
+/**
+ * @brief Concept for read-only sparse component arrays with the given index and value types
+ *
+ * SparseVector and SparseVectorView qualify.
+ */
+template <typename E, typename Index, typename T>
+concept SparseComponentsOf = requires(const E& element) {
+    { element.indices() } -> std::convertible_to<std::span<const Index>>;
+    { element.values() } -> std::convertible_to<std::span<const T>>;
+};
+
+/**
+ * @brief Operation functors on SparseVector<Index, T>
+ *
+ * Binary operations merge the sorted index arrays in a single linear pass;
+ * entries that cancel to zero are dropped. Unary operations keep the
+ * sparsity pattern. The in-place forms reuse the existing storage, and
+ * in-place addition reallocates only when right stores an index that left
+ * lacks and that precedes left's last index.
+ */
+template <std::unsigned_integral Index, typename T>
+struct SparseOperations {
+    /// @brief Type alias for the element type
+    using element_type = SparseVector<Index, T>;
+
+    /**
+     * @brief Merge two sparse vectors entry by entry
+     *
+     * @param both Callable (left_value, right_value) -> T for shared indices
+     * @param only_left Callable (left_value) -> T for indices only in left
+     * @param only_right Callable (right_value) -> T for indices only in right
+     * @return The merged vector without zero entries
+     */
+    template <typename Both, typename OnlyLeft, typename OnlyRight>
+    static element_type merge(const element_type& left, const element_type& right,
+                              Both&& both, OnlyLeft&& only_left, OnlyRight&& only_right) {
+        const auto left_indices = left.indices();
+        const auto right_indices = right.indices();
+        const auto left_values = left.values();
+        const auto right_values = right.values();
+        element_type result;
+        result.reserve(left.nnz() + right.nnz());
+        std::size_t l = 0;
+        std::size_t r = 0;
+        auto emit = [&](Index index, const T& value) {
+            if (value != T{}) {
+                result.push_back(index, value);
+            }
+        };
+        while (l < left_indices.size() && r < right_indices.size()) {
+            if (left_indices[l] < right_indices[r]) {
+                emit(left_indices[l], only_left(left_values[l]));
+                ++l;
+            } else if (right_indices[r] < left_indices[l]) {
+                emit(right_indices[r], only_right(right_values[r]));
+                ++r;
+            } else {
+                emit(left_indices[l], both(left_values[l], right_values[r]));
+                ++l;
+                ++r;
+            }
+        }
+        for (; l < left_indices.size(); ++l) { emit(left_indices[l], only_left(left_values[l])); }
+        for (; r < right_indices.size(); ++r) { emit(right_indices[r], only_right(right_values[r])); }
+        return result;
+    }
+
+    /**
+     * @brief Visit the component pairs of two sparse vectors in index order
+     *
+     * Calls visit(left_value, right_value) once per index stored in either
+     * vector (the missing side is zero). Stops early when visit returns false.
+     */
+    template <SparseComponentsOf<Index, T> Left, SparseComponentsOf<Index, T> Right, typename Visit>
+    static void for_each_pair(const Left& left, const Right& right, Visit&& visit) {
+        const auto left_indices = left.indices();
+        const auto right_indices = right.indices();
+        const auto left_values = left.values();
+        const auto right_values = right.values();
+        std::size_t l = 0;
+        std::size_t r = 0;
+        while (l < left_indices.size() || r < right_indices.size()) {
+            bool keep_going;
+            if (r == right_indices.size() || (l < left_indices.size() && left_indices[l] < right_indices[r])) {
+                keep_going = visit(left_values[l++], T{});
+            } else if (l == left_indices.size() || right_indices[r] < left_indices[l]) {
+                keep_going = visit(T{}, right_values[r++]);
+            } else {
+                keep_going = visit(left_values[l++], right_values[r++]);
+            }
+            if (!keep_going) {
+                return;
+            }
+        }
+    }
+
+    /// @brief Componentwise sum (linear-time merge)
+    struct Addition {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            return merge(left, right,
+                         [](const T& a, const T& b) { return a + b; },
+                         [](const T& a) { return a; },
+                         [](const T& b) { return b; });
+        }
+    };
+
+    /// @brief Componentwise difference (linear-time merge)
+    struct Subtraction {
+        element_type operator()(const element_type& left, const element_type& right) const {
+            return merge(left, right,
+                         [](const T& a, const T& b) { return a - b; },
+                         [](const T& a) { return a; },
+                         [](const T& b) { return -b; });
+        }
+    };
+
+    /// @brief Scalar multiplication; keeps the pattern (multiplying by zero gives the empty vector)
+    struct ScalarAction {
+        element_type operator()(const T& scalar_value, const element_type& element) const {
+            if (scalar_value == T{}) {
+                return element_type{};
+            }
+            element_type result = element;
+            for (T& value : result.values()) {
+                value = scalar_value * value;
+            }
+            return result;
+        }
+    };
+
+    /// @brief Negation; keeps the pattern
+    struct Negation {
+        element_type operator()(const element_type& element) const {
+            element_type result = element;
+            for (T& value : result.values()) {
+                value = -value;
+            }
+            return result;
+        }
+    };
+
+    /// @brief The empty vector; O(1) and allocation-free
+    struct ZeroSupplier {
+        element_type operator()() const { return element_type{}; }
+    };
+
+    /// @brief Componentwise equality (missing components are zero)
+    struct Equality {
+        bool operator()(const element_type& left, const element_type& right) const {
+            bool equal = true;
+            for_each_pair(left, right, [&](const T& a, const T& b) {
+                equal = a == b;
+                return equal;
+            });
+            return equal;
+        }
+    };
+
+    /// @brief Fused a * x + y in one merge
+    struct Axpy {
+        element_type operator()(const T& scalar_value, const element_type& x, const element_type& y) const {
+            return merge(x, y,
+                         [&](const T& a, const T& b) { return scalar_value * a + b; },
+                         [&](const T& a) { return scalar_value * a; },
+                         [](const T& b) { return b; });
+        }
+    };
+
+    /// @brief In-place addition; reuses left's storage when right's pattern is contained in left's
+    struct AddAssign {
+        void operator()(element_type& left, const element_type& right) const {
+            add_in_place(left, right);
+        }
+    };
+
+    /// @brief In-place scalar multiplication; never reallocates
+    struct ScaleAssign {
+        void operator()(const T& scalar_value, element_type& element) const {
+            if (scalar_value == T{}) {
+                element.clear();
+                return;
+            }
+            for (T& value : element.values()) {
+                value = scalar_value * value;
+            }
+        }
+    };
+
+    /// @brief In-place negation; never reallocates
+    struct NegateInPlace {
+        void operator()(element_type& element) const {
+            for (T& value : element.values()) {
+                value = -value;
+            }
+        }
+    };
+
+private:
+    /**
+     * @brief left += right in one merge pass, dropping entries that cancel
+     *
+     * While every index of right is also stored in left, the sums are
+     * written back over left's arrays (compacting out zeros as they appear),
+     * so nothing is allocated. At the first index of right that left lacks,
+     * the finished prefix and the remaining entries of both are merged into
+     * new storage instead.
+     */
+    static void add_in_place(element_type& left, const element_type& right) {
+        std::vector<Index>& indices = left.indices_;
+        std::vector<T>& values = left.values_;
+        const auto right_indices = right.indices();
+        const auto right_values = right.values();
+        const std::size_t left_count = indices.size();
+        std::size_t l = 0;
+        std::size_t r = 0;
+        std::size_t kept = 0;
+        while (l < left_count && r < right_indices.size() && !(right_indices[r] < indices[l])) {
+            T value = values[l];
+            if (indices[l] == right_indices[r]) {
+                value = value + right_values[r++];
+            }
+            if (value != T{}) {
+                indices[kept] = indices[l];
+                values[kept] = value;
+                ++kept;
+            }
+            ++l;
+        }
+        if (l == left_count || r == right_indices.size()) {
+            // Either right is exhausted, or its remaining indices all follow left's
+            if (kept != l) {
+                const auto indices_end = std::copy(indices.begin() + static_cast<std::ptrdiff_t>(l), indices.end(),
+                                                   indices.begin() + static_cast<std::ptrdiff_t>(kept));
+                const auto values_end = std::copy(values.begin() + static_cast<std::ptrdiff_t>(l), values.end(),
+                                                  values.begin() + static_cast<std::ptrdiff_t>(kept));
+                indices.erase(indices_end, indices.end());
+                values.erase(values_end, values.end());
+            }
+            for (; r < right_indices.size(); ++r) {
+                left.push_back(right_indices[r], right_values[r]);
+            }
+            return;
+        }
+
+        element_type result;
+        result.reserve(kept + (left_count - l) + (right_indices.size() - r));
+        for (std::size_t entry = 0; entry < kept; ++entry) {
+            result.push_back(indices[entry], values[entry]);
+        }
+        auto emit = [&](Index index, const T& value) {
+            if (value != T{}) {
+                result.push_back(index, value);
+            }
+        };
+        while (l < left_count && r < right_indices.size()) {
+            if (indices[l] < right_indices[r]) {
+                emit(indices[l], values[l]);
+                ++l;
+            } else if (right_indices[r] < indices[l]) {
+                emit(right_indices[r], right_values[r]);
+                ++r;
+            } else {
+                emit(indices[l], values[l] + right_values[r]);
+                ++l;
+                ++r;
+            }
+        }
+        for (; l < left_count; ++l) { emit(indices[l], values[l]); }
+        for (; r < right_indices.size(); ++r) { emit(right_indices[r], right_values[r]); }
+        left = std::move(result);
+    }
+};
+
+/**
+ * @brief Vector space of sparse vectors
+ *
+ * @tparam Index The unsigned index type of the components
+ * @tparam T The scalar type of the components
+ *
+ * All optional slots of VectorSpace are filled: merge-based Subtraction and
+ * Axpy, and in-place AddAssign / ScaleAssign / NegateInPlace that reuse the
+ * existing storage.
+ *
+ * @code{.cpp}
+ * using S = kuukan::SparseVectorSpace<std::uint32_t, double>;
+ * S::element_type x{{0, 1.0}, {1000, 2.0}}, y{{1000, -2.0}};
+ * S::element_type z = S::addition(x, y);   // {{0, 1.0}}
+ * @endcode
+ */
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseVectorSpace : VectorSpace<
+    SparseVector<Index, T>, T,
+    typename SparseOperations<Index, T>::Addition,
+    typename SparseOperations<Index, T>::ScalarAction,
+    typename SparseOperations<Index, T>::Negation,
+    typename SparseOperations<Index, T>::ZeroSupplier,
+    typename SparseOperations<Index, T>::Equality,
+    typename SparseOperations<Index, T>::Axpy,
+    NotInjected,
+    typename SparseOperations<Index, T>::AddAssign,
+    typename SparseOperations<Index, T>::ScaleAssign,
+    typename SparseOperations<Index, T>::NegateInPlace,
+    typename SparseOperations<Index, T>::Subtraction> {};
+
+/**
+ * @brief Distances between a sparse and a dense vector
+ *
+ * The dense vector is read in contiguous gaps between the stored indices of
+ * the sparse one, so the gaps run on the SIMD kernels. Components beyond the
+ * dense size are treated as zero. The functors accept the operands in either
+ * order and any contiguous dense storage (e.g. DenseVector).
+ */
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseDenseL1Distance {
+    T operator()(const SparseVector<Index, T>& sparse, std::span<const T> dense) const {
+        return sparse_dense_reduce(sparse, dense,
+            [](const T* gap, std::size_t count) { return simd::sum_abs<T>(gap, count); },
+            [](T acc, T value) { return acc + simd::scalar_abs(value); },
+            [](T acc, T partial) { return acc + partial; });
+    }
+    T operator()(std::span<const T> dense, const SparseVector<Index, T>& sparse) const {
+        return (*this)(sparse, dense);
+    }
+
+    /// @brief Shared gap/entry traversal of the sparse-dense distances
+    template <typename Gap, typename Entry, typename Combine>
+    static T sparse_dense_reduce(const SparseVector<Index, T>& sparse, std::span<const T> dense,
+                                 Gap&& gap, Entry&& entry, Combine&& combine) {
+        const auto indices = sparse.indices();
+        const auto values = sparse.values();
+        T result{};
+        std::size_t position = 0;
+        for (std::size_t stored = 0; stored < indices.size(); ++stored) {
+            const std::size_t index = indices[stored];
+            if (index >= dense.size()) {
+                for (; stored < indices.size(); ++stored) {
+                    result = entry(result, values[stored]);
+                }
+                break;
+            }
+            result = combine(result, gap(dense.data() + position, index - position));
+            result = entry(result, values[stored] - dense[index]);
+            position = index + 1;
+        }
+        if (position < dense.size()) {
+            result = combine(result, gap(dense.data() + position, dense.size() - position));
+        }
+        return result;
+    }
+};
+
+/// @brief Euclidean distance between a sparse and a dense vector (see SparseDenseL1Distance)
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseDenseL2Distance {
+    T operator()(const SparseVector<Index, T>& sparse, std::span<const T> dense) const {
+        return std::sqrt(SparseDenseL1Distance<Index, T>::sparse_dense_reduce(sparse, dense,
+            [](const T* gap, std::size_t count) { return simd::sum_squares<T>(gap, count); },
+            [](T acc, T value) { return acc + value * value; },
+            [](T acc, T partial) { return acc + partial; }));
+    }
+    T operator()(std::span<const T> dense, const SparseVector<Index, T>& sparse) const {
+        return (*this)(sparse, dense);
+    }
+};
+
+/// @brief L-infinity distance between a sparse and a dense vector (see SparseDenseL1Distance)
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseDenseLinfDistance {
+    T operator()(const SparseVector<Index, T>& sparse, std::span<const T> dense) const {
+        return SparseDenseL1Distance<Index, T>::sparse_dense_reduce(sparse, dense,
+            [](const T* gap, std::size_t count) { return simd::max_abs<T>(gap, count); },
+            [](T acc, T value) { return simd::scalar_max(acc, simd::scalar_abs(value)); },
+            [](T acc, T partial) { return simd::scalar_max(acc, partial); });
+    }
+    T operator()(std::span<const T> dense, const SparseVector<Index, T>& sparse) const {
+        return (*this)(sparse, dense);
+    }
+};
+
+/// @brief Fused sparse L1 distance: one merge, no temporary (like every fused sparse
+///        difference norm below, it takes SparseVector and SparseVectorView operands)
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseL1DifferenceNorm {
+    template <SparseComponentsOf<Index, T> E>
+    T operator()(const E& left, const E& right) const {
+        T sum{};
+        SparseOperations<Index, T>::for_each_pair(left, right, [&](const T& a, const T& b) {
+            sum += simd::scalar_abs(a - b);
+            return true;
+        });
+        return sum;
+    }
+};
+
+/// @brief Squared sparse L2 distance, the comparable surrogate of SparseL2Norm distances
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseL2SquaredDifferenceNorm {
+    template <SparseComponentsOf<Index, T> E>
+    T operator()(const E& left, const E& right) const {
+        T sum{};
+        SparseOperations<Index, T>::for_each_pair(left, right, [&](const T& a, const T& b) {
+            sum += (a - b) * (a - b);
+            return true;
+        });
+        return sum;
+    }
+
+    /// @brief Squared distance -> distance
+    T to_distance(const T& comparable) const { return std::sqrt(comparable); }
+
+    /// @brief Distance -> squared distance
+    T to_comparable(const T& distance) const { return distance * distance; }
+};
+
+/// @brief Fused sparse L2 distance: one merge, no temporary
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseL2DifferenceNorm {
+    template <SparseComponentsOf<Index, T> E>
+    T operator()(const E& left, const E& right) const {
+        return std::sqrt(SparseL2SquaredDifferenceNorm<Index, T>{}(left, right));
+    }
+};
+
+/// @brief Fused sparse L-infinity distance: one merge, no temporary
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseLinfDifferenceNorm {
+    template <SparseComponentsOf<Index, T> E>
+    T operator()(const E& left, const E& right) const {
+        T result{};
+        SparseOperations<Index, T>::for_each_pair(left, right, [&](const T& a, const T& b) {
+            result = simd::scalar_max(result, simd::scalar_abs(a - b));
+            return true;
+        });
+        return result;
+    }
+};
+
+/// @brief Early-exit sparse L1 distance for the BoundedDifferenceNorm slot of NormedSpace
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseL1BoundedDifferenceNorm {
+    template <SparseComponentsOf<Index, T> E>
+    T operator()(const E& left, const E& right, const T& bound) const {
+        T sum{};
+        SparseOperations<Index, T>::for_each_pair(left, right, [&](const T& a, const T& b) {
+            sum += simd::scalar_abs(a - b);
+            return !(bound < sum);
+        });
+        return sum;
+    }
+};
+
+/// @brief Early-exit sparse L2 distance for the BoundedDifferenceNorm slot of NormedSpace
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseL2BoundedDifferenceNorm {
+    template <SparseComponentsOf<Index, T> E>
+    T operator()(const E& left, const E& right, const T& bound) const {
+        // Every distance exceeds a negative bound, so any partial sum may be returned then
+        const T squared_bound = bound < T(0) ? T(0) : bound * bound;
+        T sum{};
+        SparseOperations<Index, T>::for_each_pair(left, right, [&](const T& a, const T& b) {
+            sum += (a - b) * (a - b);
+            return !(squared_bound < sum);
+        });
+        const T result = std::sqrt(sum);
+        // Rounding of bound^2 and sqrt can leave an early exit at or below bound; finish the sum then
+        if (squared_bound < sum && !(bound < result)) {
+            return SparseL2DifferenceNorm<Index, T>{}(left, right);
+        }
+        return result;
+    }
+};
+
+/// @brief Early-exit sparse L-infinity distance for the BoundedDifferenceNorm slot of NormedSpace
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseLinfBoundedDifferenceNorm {
+    template <SparseComponentsOf<Index, T> E>
+    T operator()(const E& left, const E& right, const T& bound) const {
+        T result{};
+        SparseOperations<Index, T>::for_each_pair(left, right, [&](const T& a, const T& b) {
+            result = simd::scalar_max(result, simd::scalar_abs(a - b));
+            return !(bound < result);
+        });
+        return result;
+    }
+};
+
+/**
+ * @brief Sparse L1 norm: sum of |v_i| over the stored components
+ *
+ * `difference_norm`, `bounded_difference_norm` and `comparable_difference_norm`
+ * name the matching functors for NormedSpace; `mixed_distance` measures a
+ * sparse vector against a dense one.
+ */
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseL1Norm {
+    using difference_norm = SparseL1DifferenceNorm<Index, T>;
+    using bounded_difference_norm = SparseL1BoundedDifferenceNorm<Index, T>;
+    using comparable_difference_norm = NotInjected;
+    using mixed_distance = SparseDenseL1Distance<Index, T>;
+
+    T operator()(const SparseVector<Index, T>& element) const {
+        const auto values = element.values();
+        return simd::sum_abs<T>(values.data(), values.size());
+    }
+};
+
+/**
+ * @brief Sparse L2 norm: sqrt of the sum of v_i^2 over the stored components
+ *
+ * See SparseL1Norm for the member aliases.
+ */
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseL2Norm {
+    using difference_norm = SparseL2DifferenceNorm<Index, T>;
+    using bounded_difference_norm = SparseL2BoundedDifferenceNorm<Index, T>;
+    using comparable_difference_norm = SparseL2SquaredDifferenceNorm<Index, T>;
+    using mixed_distance = SparseDenseL2Distance<Index, T>;
+
+    T operator()(const SparseVector<Index, T>& element) const {
+        const auto values = element.values();
+        return std::sqrt(simd::sum_squares<T>(values.data(), values.size()));
+    }
+};
+
+/**
+ * @brief Sparse L-infinity norm: max of |v_i| over the stored components
+ *
+ * See SparseL1Norm for the member aliases.
+ */
+template <std::unsigned_integral Index, std::floating_point T>
+struct SparseLinfNorm {
+    using difference_norm = SparseLinfDifferenceNorm<Index, T>;
+    using bounded_difference_norm = SparseLinfBoundedDifferenceNorm<Index, T>;
+    using comparable_difference_norm = NotInjected;
+    using mixed_distance = SparseDenseLinfDistance<Index, T>;
+
+    T operator()(const SparseVector<Index, T>& element) const {
+        const auto values = element.values();
+        return simd::max_abs<T>(values.data(), values.size());
+    }
+};
+
+/**
+ * @brief Normed space over SparseVectorSpace with fused, merge-based distances
+ *
+ * @tparam Index The unsigned index type of the components
+ * @tparam T The scalar type of the components
+ * @tparam Norm One of SparseL1Norm, SparseL2Norm or SparseLinfNorm
+ *
+ * @code{.cpp}
+ * using S = kuukan::SparseNormedSpace<std::uint32_t, double, kuukan::SparseL2Norm>;
+ * double d = S::distance(x, y);   // one merge, no temporary
+ *
+ * kuukan::SparseL2Norm<std::uint32_t, double>::mixed_distance to_dense;
+ * double m = to_dense(x, dense_point);   // sparse vs dense
+ * @endcode
+ */
+template <std::unsigned_integral Index, std::floating_point T,
+          template <typename, typename> class Norm>
+using SparseNormedSpace = NormedSpace<SparseVectorSpace<Index, T>,
+                                      Norm<Index, T>,
+                                      typename Norm<Index, T>::difference_norm,
+                                      typename Norm<Index, T>::bounded_difference_norm,
+                                      typename Norm<Index, T>::comparable_difference_norm>;
+
+} // namespace kuukan
@@ -0,0 +1,398 @@
+/**
+ * @file lazy.hpp
+ * @brief Expression-template layer that defers vector space operations
+ *
+ * This file provides the Lazy template, an opt-in wrapper around any
+ * VectorSpaceLike structure. Instead of evaluating each operation eagerly,
+ * Lazy records additions, scalar multiplications, negations and differences
+ * as a compile-time expression tree and evaluates the whole tree at once as
+ * a single linear combination.
+ */
+
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "kuukan/concepts/core_concepts.hpp"
+#include "kuukan/vector/vector_space.hpp"
+
+namespace kuukan {
+
+/**
+ * @brief Concept for expression nodes recorded by Lazy
+ *
+ * @tparam E The type to check
+ *
+ * Every node type of Lazy<VS> exposes the space it belongs to as
+ * `lazy_space` and the number of leaves of its subtree as `term_count`.
+ * The arithmetic operators below are restricted to such types.
+ */
+template <typename E>
+concept LazyExpression = requires {
+    typename E::lazy_space;
+    { E::term_count } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * @brief Deferred (expression-template) view of a vector space
+ *
+ * @tparam VS The underlying vector space (must satisfy StaticVectorSpaceLike)
+ *
+ * Lazy mirrors the operation names of VS, but `addition`, `scalar_action`,
+ * `negation` and `difference` return lightweight expression nodes instead of
+ * elements. Since every expression built from these operations is a linear
+ * combination of its leaves, evaluation flattens the tree into
+ * coefficient/element terms and hands them to VS::linear_combination in one
+ * call. With a fused LinearCombination functor injected into VS, an
+ * expression such as `a*x + b*y - z` is therefore computed in a single pass
+ * with no intermediate elements.
+ *
+ * @section lazy_evaluation Evaluation
+ *
+ * An expression is evaluated when:
+ * - it is converted to `element_type` (e.g. assigned to an element),
+ * - it is passed to `Lazy::evaluate`, or
+ * - it is passed to `Lazy::norm` (only when VS is normed). A plain
+ *   difference `x - y` is forwarded to VS::distance, so an injected
+ *   DifferenceNorm applies. Norms with a fused combination_norm kernel
+ *   (the dense norms) measure any other expression in one pass without a
+ *   temporary; other norms measure the evaluated element.
+ *
+ * @section lazy_usage Usage
+ *
+ * @code{.cpp}
+ * using L = kuukan::Lazy<MyNormedSpace>;
+ *
+ * // Operator form
+ * MyVector r = 2.0 * L::ref(x) + 3.0 * L::ref(y) - L::ref(z);
+ *
+ * // Same names as the underlying space
+ * MyVector s = L::addition(L::scalar_action(2.0, f), L::negation(g));
+ *
+ * // Measured in one pass for dense norms, otherwise evaluated once, then measured
+ * double n = L::norm(2.0 * L::ref(x) - L::ref(y));
+ * @endcode
+ *
+ * @warning Leaves refer to their elements; an expression must not outlive
+ *          the elements it was built from. Prefer converting to element_type
+ *          over storing an expression in an `auto` variable.
+ *
+ * @see VectorSpace::linear_combination
+ */
+template <StaticVectorSpaceLike VS>
+requires std::default_initializable<typename VS::scalar_type> &&
+         std::constructible_from<typename VS::scalar_type, int>
+struct Lazy {
+    /// @brief Type alias for elements of the underlying space
+    using element_type = typename VS::element_type;
+
+    /// @brief Type alias for scalars of the underlying space
+    using scalar_type  = typename VS::scalar_type;
+
+    /// @brief Type alias for the flattened terms handed to linear_combination
+    using term_type    = LinearTerm<scalar_type, element_type>;
+
+    /**
+     * @brief Common base of all expression nodes
+     *
+     * Provides the implicit conversion that triggers evaluation.
+     *
+     * @tparam Derived The concrete node type
+     */
+    template <typename Derived>
+    struct expression {
+        /// @brief The space the expression belongs to
+        using lazy_space = Lazy;
+
+        /// @brief Evaluate the expression into an element
+        constexpr operator element_type() const {
+            return Lazy::evaluate(static_cast<const Derived&>(*this));
+        }
+    };
+
+    /// @brief Leaf node referring to an existing element
+    struct terminal : expression<terminal> {
+        static constexpr std::size_t term_count = 1;
+
+        const element_type& element;
+
+        constexpr explicit terminal(const element_type& element_value)
+            : element(element_value) {}
+
+        constexpr void collect(const scalar_type& coefficient,
+                               scalar_type* coefficients,
+                               const element_type** elements) const {
+            coefficients[0] = coefficient;
+            elements[0] = &element;
+        }
+    };
+
+    /// @brief Node for left + right
+    template <typename Left, typename Right>
+    struct sum : expression<sum<Left, Right>> {
+        static constexpr std::size_t term_count = Left::term_count + Right::term_count;
+
+        Left  left;
+        Right right;
+
+        constexpr sum(Left left_value, Right right_value)
+            : left(left_value), right(right_value) {}
+
+        constexpr void collect(const scalar_type& coefficient,
+                               scalar_type* coefficients,
+                               const element_type** elements) const {
+            left.collect(coefficient, coefficients, elements);
+            right.collect(coefficient,
+                          coefficients + Left::term_count,
+                          elements + Left::term_count);
+        }
+    };
+
+    /// @brief Node for left - right
+    template <typename Left, typename Right>
+    struct difference_node : expression<difference_node<Left, Right>> {
+        static constexpr std::size_t term_count = Left::term_count + Right::term_count;
+
+        Left  left;
+        Right right;
+
+        constexpr difference_node(Left left_value, Right right_value)
+            : left(left_value), right(right_value) {}
+
+        constexpr void collect(const scalar_type& coefficient,
+                               scalar_type* coefficients,
+                               const element_type** elements) const {
+            left.collect(coefficient, coefficients, elements);
+            right.collect(negate_scalar(coefficient),
+                          coefficients + Left::term_count,
+                          elements + Left::term_count);
+        }
+    };
+
+    /// @brief Node for scalar * operand
+    template <typename Operand>
+    struct scaled : expression<scaled<Operand>> {
+        static constexpr std::size_t term_count = Operand::term_count;
+
+        scalar_type factor;
+        Operand     operand;
+
+        constexpr scaled(const scalar_type& factor_value, Operand operand_value)
+            : factor(factor_value), operand(operand_value) {}
+
+        constexpr void collect(const scalar_type& coefficient,
+                               scalar_type* coefficients,
+                               const element_type** elements) const {
+            operand.collect(coefficient * factor, coefficients, elements);
+        }
+    };
+
+    /// @brief Node for -operand
+    template <typename Operand>
+    struct negated : expression<negated<Operand>> {
+        static constexpr std::size_t term_count = Operand::term_count;
+
+        Operand operand;
+
+        constexpr explicit negated(Operand operand_value)
+            : operand(operand_value) {}
+
+        constexpr void collect(const scalar_type& coefficient,
+                               scalar_type* coefficients,
+                               const element_type** elements) const {
+            operand.collect(negate_scalar(coefficient), coefficients, elements);
+        }
+    };
+
+    /**
+     * @brief Wrap an element as a leaf of an expression
+     *
+     * @param element_value The element to refer to
+     * @return A terminal node referring to element_value
+     */
+    static constexpr terminal ref(const element_type& element_value) {
+        return terminal(element_value);
+    }
+
+    /// @brief Deferred addition; operands may be elements or expressions
+    template <typename Left, typename Right>
+    static constexpr auto addition(const Left& left, const Right& right) {
+        return sum<decltype(as_expression(left)), decltype(as_expression(right))>(
+            as_expression(left), as_expression(right));
+    }
+
+    /// @brief Deferred scalar multiplication; the operand may be an element or an expression
+    template <typename Operand>
+    static constexpr auto scalar_action(const scalar_type& scalar_value, const Operand& operand) {
+        return scaled<decltype(as_expression(operand))>(scalar_value, as_expression(operand));
+    }
+
+    /// @brief Deferred negation; the operand may be an element or an expression
+    template <typename Operand>
+    static constexpr auto negation(const Operand& operand) {
+        return negated<decltype(as_expression(operand))>(as_expression(operand));
+    }
+
+    /// @brief Deferred difference; operands may be elements or expressions
+    template <typename Left, typename Right>
+    static constexpr auto difference(const Left& left, const Right& right) {
+        return difference_node<decltype(as_expression(left)), decltype(as_expression(right))>(
+            as_expression(left), as_expression(right));
+    }
+
+    /**
+     * @brief Evaluate an expression into an element of VS
+     *
+     * The expression tree is flattened into term_count coefficient/element
+     * pairs and combined with VS::linear_combination, which runs in a single
+     * pass when VS has a fused LinearCombination functor. Spaces without
+     * linear_combination are evaluated with scalar_action and addition.
+     *
+     * @param expr The expression to evaluate
+     * @return The resulting element
+     */
+    template <LazyExpression E>
+    requires std::same_as<typename E::lazy_space, Lazy>
+    static constexpr element_type evaluate(const E& expr) {
+        constexpr std::size_t term_count = E::term_count;
+        std::array<scalar_type, term_count> coefficients{};
+        std::array<const element_type*, term_count> elements{};
+        expr.collect(scalar_type(1), coefficients.data(), elements.data());
+
+        if constexpr (requires(std::span<const term_type> terms) { VS::linear_combination(terms); }) {
+            const auto terms = [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+                return std::array<term_type, term_count>{
+                    term_type{coefficients[Index], *elements[Index]}...};
+            }(std::make_index_sequence<term_count>{});
+            return VS::linear_combination(std::span<const term_type>(terms));
+        } else {
+            element_type result = VS::scalar_action(coefficients[0], *elements[0]);
+            for (std::size_t index = 1; index < term_count; ++index) {
+                result = VS::addition(result, VS::scalar_action(coefficients[index], *elements[index]));
+            }
+            return result;
+        }
+    }
+
+    /**
+     * @brief Compute the norm of an expression
+     *
+     * Available when VS is a normed space. A difference of two leaves,
+     * `ref(x) - ref(y)`, is forwarded to VS::distance so that an injected
+     * DifferenceNorm is used and no element is materialized.
+     *
+     * When the norm functor of VS has a static `combination_norm(coefficients,
+     * data, term_count, size)` kernel over contiguous elements (the dense
+     * L1, L2 and L-infinity norms of float and double spaces do), any other
+     * expression is measured in the same single pass: each component of the
+     * linear combination is formed in registers and accumulated into the
+     * norm without being stored. Otherwise the expression is evaluated into
+     * a temporary element, which VS::norm then reads in a second pass.
+     *
+     * @param expr The expression to measure
+     * @return The norm of the expression
+     */
+    template <LazyExpression E>
+    requires std::same_as<typename E::lazy_space, Lazy> &&
+             requires(const element_type& element) { VS::norm(element); }
+    static constexpr auto norm(const E& expr) {
+        using measure_type = decltype(VS::norm(std::declval<const element_type&>()));
+        if constexpr (std::same_as<E, difference_node<terminal, terminal>> &&
+                      requires(const element_type& element) { VS::distance(element, element); }) {
+            return VS::distance(expr.left.element, expr.right.element);
+        } else if constexpr (requires(const scalar_type* coefficients, const scalar_type* const* data,
+                                      const element_type& element) {
+                                 std::remove_cvref_t<decltype(VS::norm)>::combination_norm(
+                                     coefficients, data, std::size_t{}, std::size_t{});
+                                 { element.data() } -> std::convertible_to<const scalar_type*>;
+                                 { element.size() } -> std::convertible_to<std::size_t>;
+                             }) {
+            constexpr std::size_t term_count = E::term_count;
+            std::array<scalar_type, term_count> coefficients{};
+            std::array<const element_type*, term_count> elements{};
+            expr.collect(scalar_type(1), coefficients.data(), elements.data());
+
+            // Empty run-time sized elements are the zero element and contribute nothing
+            std::array<const scalar_type*, term_count> data{};
+            std::size_t used = 0;
+            std::size_t size = 0;
+            for (std::size_t index = 0; index < term_count; ++index) {
+                const std::size_t element_size = static_cast<std::size_t>(elements[index]->size());
+                if (element_size == 0) {
+                    continue;
+                }
+                assert(used == 0 || element_size == size);
+                size = element_size;
+                coefficients[used] = coefficients[index];
+                data[used] = elements[index]->data();
+                ++used;
+            }
+            if (used == 0) {
+                return VS::norm(VS::zero_supplier());
+            }
+            return static_cast<measure_type>(std::remove_cvref_t<decltype(VS::norm)>::combination_norm(
+                coefficients.data(), data.data(), used, size));
+        } else {
+            return VS::norm(evaluate(expr));
+        }
+    }
+
+private:
+    static constexpr scalar_type negate_scalar(const scalar_type& scalar_value) {
+        if constexpr (requires { -scalar_value; }) {
+            return -scalar_value;
+        } else {
+            return scalar_type(0) - scalar_value;
+        }
+    }
+
+    template <typename Operand>
+    static constexpr auto as_expression(const Operand& operand) {
+        if constexpr (LazyExpression<Operand>) {
+            static_assert(std::same_as<typename Operand::lazy_space, Lazy>,
+                          "expressions of different spaces cannot be combined");
+            return operand;
+        } else {
+            return terminal(operand);
+        }
+    }
+};
+
+/// @brief Deferred addition of two expressions of the same space
+template <LazyExpression Left, LazyExpression Right>
+requires std::same_as<typename Left::lazy_space, typename Right::lazy_space>
+constexpr auto operator+(const Left& left, const Right& right) {
+    return Left::lazy_space::addition(left, right);
+}
+
+/// @brief Deferred difference of two expressions of the same space
+template <LazyExpression Left, LazyExpression Right>
+requires std::same_as<typename Left::lazy_space, typename Right::lazy_space>
+constexpr auto operator-(const Left& left, const Right& right) {
+    return Left::lazy_space::difference(left, right);
+}
+
+/// @brief Deferred negation of an expression
+template <LazyExpression Operand>
+constexpr auto operator-(const Operand& operand) {
+    return Operand::lazy_space::negation(operand);
+}
+
+/// @brief Deferred scalar multiplication of an expression (scalar on the left)
+template <LazyExpression Operand>
+constexpr auto operator*(const typename Operand::lazy_space::scalar_type& scalar_value,
+                         const Operand& operand) {
+    return Operand::lazy_space::scalar_action(scalar_value, operand);
+}
+
+/// @brief Deferred scalar multiplication of an expression (scalar on the right)
+template <LazyExpression Operand>
+constexpr auto operator*(const Operand& operand,
+                         const typename Operand::lazy_space::scalar_type& scalar_value) {
+    return Operand::lazy_space::scalar_action(scalar_value, operand);
+}
+
+} // namespace kuukan
@@ -9,12 +9,35 @@
  */
 
 #pragma once
+#include <cstddef>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include "kuukan/concepts/core_concepts.hpp"
 
 namespace kuukan {
 
+/**
+ * @brief One coefficient/element pair of a linear combination
+ * 
+ * @tparam ScalarType The scalar type of the vector space
+ * @tparam ElementType The element type of the vector space
+ * 
+ * LinearTerm only refers to its operands, so a list of terms can be built
+ * without copying any element. It is the argument type of
+ * VectorSpace::linear_combination and of injected LinearCombination functors.
+ * 
+ * @warning The referenced coefficient and element must outlive the term.
+ */
+template <typename ScalarType, typename ElementType>
+struct LinearTerm {
+    /// @brief The scalar coefficient a_i
+    const ScalarType&  coefficient;
+
+    /// @brief The element x_i
+    const ElementType& element;
+};
+
 /**
  * @brief Abstract vector space structure using operation injection
  * 
@@ -25,6 +48,19 @@ namespace kuukan {
  * @tparam Negation Functor type for negation: (ElementType) -> ElementType
  * @tparam ZeroSupplier Functor type for zero element: () -> ElementType
  * @tparam Equality Functor type for equality: (ElementType, ElementType) -> bool
+ * @tparam Axpy Optional fused functor: (ScalarType, ElementType, ElementType) -> ElementType,
+ *         computing a * x + y in a single operation (default: NotInjected)
+ * @tparam LinearCombination Optional fused functor:
+ *         (std::span<const LinearTerm<ScalarType, ElementType>>) -> ElementType,
+ *         computing a_1 * x_1 + ... + a_n * x_n in a single operation (default: NotInjected)
+ * @tparam AddAssign Optional in-place functor: (ElementType&, ElementType) -> void,
+ *         computing x += y (default: NotInjected)
+ * @tparam ScaleAssign Optional in-place functor: (ScalarType, ElementType&) -> void,
+ *         computing x *= a (default: NotInjected)
+ * @tparam NegateInPlace Optional in-place functor: (ElementType&) -> void,
+ *         computing x = -x (default: NotInjected)
+ * @tparam Subtraction Optional functor: (ElementType, ElementType) -> ElementType,
+ *         computing x - y directly (default: NotInjected)
  * 
  * VectorSpace is a compile-time structure that represents a mathematical vector space
  * by composing operation functors. Instead of requiring elements to have specific
@@ -47,10 +83,31 @@ namespace kuukan {
  * - Define multiple vector space structures over the same element type
  * - Use symbolic or lazy evaluation without modifying element types
  * 
+ * @section fused_operations Fused Operations
+ * 
+ * Update loops such as `x = addition(x, scalar_action(a, y))` create one
+ * intermediate element per call. The optional `Axpy` and `LinearCombination`
+ * slots let a backend compute such expressions in one pass without
+ * intermediates. The static `axpy` and `linear_combination` functions use the
+ * injected functors when present and otherwise compose `addition` and
+ * `scalar_action`, so spaces that only provide the five required functors
+ * keep working unchanged.
+ * 
+ * @section in_place_operations In-Place Operations
+ * 
+ * The required functors return fresh elements, which costs one allocation per
+ * operation for heap-backed element types. The optional `AddAssign`,
+ * `ScaleAssign` and `NegateInPlace` slots mutate an existing element instead.
+ * The static `add_assign`, `scale_assign` and `negate_in_place` functions use
+ * them when present and otherwise assign the result of the value-returning
+ * operation. The derived operations (`difference`, `axpy`,
+ * `linear_combination`) also use them to avoid intermediates.
+ * 
  * @section type_requirements Type Requirements
  * 
  * All functor types must be:
- * - Default constructible (they will be instantiated as static members)
+ * - Default constructible (they will be instantiated as static members;
+ *   StatefulVectorSpace holds functors with state as members instead)
  * - Regular invocable (same inputs produce same outputs)
  * - Have the exact signatures specified in the template parameters
  * 
@@ -97,7 +154,13 @@ template <
     typename ScalarAction,
     typename Negation,
     typename ZeroSupplier,
-    typename Equality
+    typename Equality,
+    typename Axpy = NotInjected,
+    typename LinearCombination = NotInjected,
+    typename AddAssign = NotInjected,
+    typename ScaleAssign = NotInjected,
+    typename NegateInPlace = NotInjected,
+    typename Subtraction = NotInjected
 >
 requires std::default_initializable<Addition> &&
          std::default_initializable<ScalarAction> &&
@@ -108,7 +171,15 @@ requires std::default_initializable<Addition> &&
          CallableLike<ScalarAction, ElementType, const ScalarType&,  const ElementType&> &&
          CallableLike<Negation,     ElementType, const ElementType&> &&
          CallableLike<ZeroSupplier, ElementType> &&
-         CallableLike<Equality,     bool,        const ElementType&, const ElementType&>
+         CallableLike<Equality,     bool,        const ElementType&, const ElementType&> &&
+         OptionallyCallableLike<Axpy, ElementType,
+                                const ScalarType&, const ElementType&, const ElementType&> &&
+         OptionallyCallableLike<LinearCombination, ElementType,
+                                std::span<const LinearTerm<ScalarType, ElementType>>> &&
+         OptionallyInPlaceCallableLike<AddAssign,     ElementType&, const ElementType&> &&
+         OptionallyInPlaceCallableLike<ScaleAssign,   const ScalarType&, ElementType&> &&
+         OptionallyInPlaceCallableLike<NegateInPlace, ElementType&> &&
+         OptionallyCallableLike<Subtraction, ElementType, const ElementType&, const ElementType&>
 struct VectorSpace {
     /// @brief Type alias for elements of this vector space
     using element_type = ElementType;
@@ -116,6 +187,9 @@ struct VectorSpace {
     /// @brief Type alias for scalars of this vector space
     using scalar_type  = ScalarType;
 
+    /// @brief Type alias for the terms accepted by linear_combination
+    using term_type    = LinearTerm<ScalarType, ElementType>;
+
     /// @brief Static instance of the addition functor
     static inline constexpr Addition      addition{};
     
@@ -134,20 +208,369 @@ struct VectorSpace {
     /**
      * @brief Compute the difference of two elements
      * 
-     * Computes element_left - element_right using addition and negation.
-     * This is equivalent to: addition(element_left, negation(element_right))
+     * Computes element_left - element_right with the injected Subtraction
+     * functor when one is provided. Otherwise it is derived from addition and
+     * negation: addition(element_left, negation(element_right))
      * 
      * @param element_left The left operand
      * @param element_right The right operand
      * @return The difference element_left - element_right
      * 
-     * @note This is a convenience function. The difference operation is
-     *       automatically derived from addition and negation.
+     * @note The derived form materializes the negated element. If AddAssign
+     *       is injected, that element is reused as the result; injecting
+     *       Subtraction avoids it entirely.
      */
     static constexpr element_type difference(const element_type& element_left,
                                              const element_type& element_right) {
-        return addition(element_left, negation(element_right));
+        if constexpr (Injected<Subtraction>) {
+            return Subtraction{}(element_left, element_right);
+        } else if constexpr (Injected<AddAssign>) {
+            element_type result = negation(element_right);
+            AddAssign{}(result, element_left);
+            return result;
+        } else {
+            return addition(element_left, negation(element_right));
+        }
+    }
+
+    /**
+     * @brief Add element_right to element_target in place
+     * 
+     * Uses the injected AddAssign functor when one is provided. Otherwise this
+     * is equivalent to: element_target = addition(element_target, element_right)
+     * 
+     * @param element_target The element to update
+     * @param element_right The element to add
+     */
+    static constexpr void add_assign(element_type& element_target,
+                                     const element_type& element_right) {
+        if constexpr (Injected<AddAssign>) {
+            AddAssign{}(element_target, element_right);
+        } else {
+            element_target = addition(element_target, element_right);
+        }
+    }
+
+    /**
+     * @brief Multiply element_target by scalar_value in place
+     * 
+     * Uses the injected ScaleAssign functor when one is provided. Otherwise
+     * this is equivalent to: element_target = scalar_action(scalar_value, element_target)
+     * 
+     * @param scalar_value The scalar multiplier
+     * @param element_target The element to update
+     */
+    static constexpr void scale_assign(const scalar_type& scalar_value,
+                                       element_type& element_target) {
+        if constexpr (Injected<ScaleAssign>) {
+            ScaleAssign{}(scalar_value, element_target);
+        } else {
+            element_target = scalar_action(scalar_value, element_target);
+        }
+    }
+
+    /**
+     * @brief Negate element_target in place
+     * 
+     * Uses the injected NegateInPlace functor when one is provided. Otherwise
+     * this is equivalent to: element_target = negation(element_target)
+     * 
+     * @param element_target The element to update
+     */
+    static constexpr void negate_in_place(element_type& element_target) {
+        if constexpr (Injected<NegateInPlace>) {
+            NegateInPlace{}(element_target);
+        } else {
+            element_target = negation(element_target);
+        }
+    }
+
+    /**
+     * @brief Compute scalar_value * element_x + element_y
+     * 
+     * Uses the injected Axpy functor when one is provided. Otherwise this is
+     * equivalent to: addition(scalar_action(scalar_value, element_x), element_y)
+     * 
+     * @param scalar_value The coefficient applied to element_x
+     * @param element_x The scaled operand
+     * @param element_y The added operand
+     * @return The element scalar_value * element_x + element_y
+     */
+    static constexpr element_type axpy(const scalar_type& scalar_value,
+                                       const element_type& element_x,
+                                       const element_type& element_y) {
+        if constexpr (Injected<Axpy>) {
+            return Axpy{}(scalar_value, element_x, element_y);
+        } else if constexpr (Injected<AddAssign>) {
+            element_type result = scalar_action(scalar_value, element_x);
+            AddAssign{}(result, element_y);
+            return result;
+        } else {
+            return addition(scalar_action(scalar_value, element_x), element_y);
+        }
+    }
+
+    /**
+     * @brief Compute the linear combination a_1 * x_1 + ... + a_n * x_n
+     * 
+     * Uses the injected LinearCombination functor when one is provided.
+     * Otherwise the first term is scaled and the remaining ones are
+     * accumulated into it, with axpy if Axpy is injected and with AddAssign
+     * otherwise (falling back to addition when neither is available).
+     * An empty list of terms yields the zero element.
+     * 
+     * @param terms The coefficient/element pairs to combine
+     * @return The combined element
+     */
+    static constexpr element_type linear_combination(std::span<const term_type> terms) {
+        if constexpr (Injected<LinearCombination>) {
+            return LinearCombination{}(terms);
+        } else {
+            if (terms.empty()) {
+                return zero_supplier();
+            }
+            element_type result = scalar_action(terms[0].coefficient, terms[0].element);
+            for (std::size_t index = 1; index < terms.size(); ++index) {
+                if constexpr (Injected<Axpy> || !Injected<AddAssign>) {
+                    result = axpy(terms[index].coefficient, terms[index].element, result);
+                } else {
+                    AddAssign{}(result, scalar_action(terms[index].coefficient,
+                                                     terms[index].element));
+                }
+            }
+            return result;
+        }
+    }
+
+    /**
+     * @brief Compute a linear combination written as a braced list of terms
+     * 
+     * The number of terms is deduced at compile time, so the call reads like
+     * the mathematical expression:
+     * 
+     * @code{.cpp}
+     * auto r = MyVectorSpace::linear_combination({{a, x}, {b, y}, {c, z}});
+     * @endcode
+     * 
+     * @tparam TermCount The number of terms (deduced)
+     * @param terms The coefficient/element pairs to combine
+     * @return The combined element
+     */
+    template <std::size_t TermCount>
+    static constexpr element_type linear_combination(const term_type (&terms)[TermCount]) {
+        return linear_combination(std::span<const term_type>(terms, TermCount));
+    }
+};
+
+/**
+ * @brief Vector space structure that holds its operation functors as members
+ * 
+ * @tparam ElementType The type of elements in the vector space
+ * @tparam ScalarType The scalar type (must satisfy FieldLike concept)
+ * @tparam Addition, ScalarAction, Negation, ZeroSupplier, Equality, Axpy,
+ *         LinearCombination, AddAssign, ScaleAssign, NegateInPlace, Subtraction
+ *         The same slots as VectorSpace
+ * 
+ * VectorSpace instantiates every functor as a static member, so functors
+ * must be default constructible and anything they need (weights, lookup
+ * tables, scratch buffers, pool handles) has to live in globals.
+ * StatefulVectorSpace keeps the same slots, but a space is an object
+ * constructed from functor instances. Each space (e.g. one per thread) owns
+ * its functors' state, and hot loops only touch that space's memory.
+ * 
+ * The interface mirrors VectorSpace, with the static members and functions
+ * turned into members: `space.addition(x, y)`, `space.axpy(a, x, y)`, and
+ * so on. Generic code written against an instance (`const VS& space`) works
+ * with both. Functors are called through const references. State that a
+ * functor changes during a call (a scratch buffer) is `mutable` in the
+ * functor, and the space must then not be shared between threads.
+ * 
+ * Stateless functors are stored with `[[no_unique_address]]`, so a space of
+ * only stateless functors is an empty object, and the calls inline exactly
+ * like the static ones.
+ * 
+ * @code{.cpp}
+ * struct WeightedAddition {
+ *     std::vector<double> weights;
+ *     Vec operator()(const Vec& x, const Vec& y) const;   // uses weights
+ * };
+ * 
+ * using Space = kuukan::StatefulVectorSpace<Vec, double, WeightedAddition, Scale, Negate, Zero, Equal>;
+ * Space space(WeightedAddition{load_weights()}, {}, {}, {}, {});
+ * Vec z = space.addition(x, y);
+ * @endcode
+ * 
+ * @see VectorSpace for the static form
+ */
+template <
+    typename ElementType,
+    FieldLike ScalarType,
+    typename Addition,
+    typename ScalarAction,
+    typename Negation,
+    typename ZeroSupplier,
+    typename Equality,
+    typename Axpy = NotInjected,
+    typename LinearCombination = NotInjected,
+    typename AddAssign = NotInjected,
+    typename ScaleAssign = NotInjected,
+    typename NegateInPlace = NotInjected,
+    typename Subtraction = NotInjected
+>
+requires CallableLike<const Addition&,     ElementType, const ElementType&, const ElementType&> &&
+         CallableLike<const ScalarAction&, ElementType, const ScalarType&,  const ElementType&> &&
+         CallableLike<const Negation&,     ElementType, const ElementType&> &&
+         CallableLike<const ZeroSupplier&, ElementType> &&
+         CallableLike<const Equality&,     bool,        const ElementType&, const ElementType&> &&
+         OptionallyInstanceCallableLike<Axpy, ElementType,
+                                        const ScalarType&, const ElementType&, const ElementType&> &&
+         OptionallyInstanceCallableLike<LinearCombination, ElementType,
+                                        std::span<const LinearTerm<ScalarType, ElementType>>> &&
+         OptionallyInstanceInPlaceCallableLike<AddAssign,     ElementType&, const ElementType&> &&
+         OptionallyInstanceInPlaceCallableLike<ScaleAssign,   const ScalarType&, ElementType&> &&
+         OptionallyInstanceInPlaceCallableLike<NegateInPlace, ElementType&> &&
+         OptionallyInstanceCallableLike<Subtraction, ElementType, const ElementType&, const ElementType&>
+struct StatefulVectorSpace {
+    /// @brief Type alias for elements of this vector space
+    using element_type = ElementType;
+    
+    /// @brief Type alias for scalars of this vector space
+    using scalar_type  = ScalarType;
+
+    /// @brief Type alias for the terms accepted by linear_combination
+    using term_type    = LinearTerm<ScalarType, ElementType>;
+
+    /// @brief The addition functor
+    [[no_unique_address]] Addition      addition{};
+    
+    /// @brief The scalar multiplication functor
+    [[no_unique_address]] ScalarAction  scalar_action{};
+    
+    /// @brief The negation functor
+    [[no_unique_address]] Negation      negation{};
+    
+    /// @brief The zero element supplier functor
+    [[no_unique_address]] ZeroSupplier  zero_supplier{};
+    
+    /// @brief The equality functor
+    [[no_unique_address]] Equality      equality{};
+
+    /// @brief Construct every functor by default (only for default constructible functors)
+    constexpr StatefulVectorSpace() = default;
+
+    /**
+     * @brief Construct the space from functor instances
+     * 
+     * The optional functors default to value-initialized instances, which
+     * is all NotInjected slots need.
+     */
+    constexpr StatefulVectorSpace(Addition addition_functor, ScalarAction scalar_action_functor,
+                                  Negation negation_functor, ZeroSupplier zero_supplier_functor,
+                                  Equality equality_functor, Axpy axpy_functor = {},
+                                  LinearCombination linear_combination_functor = {},
+                                  AddAssign add_assign_functor = {}, ScaleAssign scale_assign_functor = {},
+                                  NegateInPlace negate_in_place_functor = {},
+                                  Subtraction subtraction_functor = {})
+        : addition(std::move(addition_functor)),
+          scalar_action(std::move(scalar_action_functor)),
+          negation(std::move(negation_functor)),
+          zero_supplier(std::move(zero_supplier_functor)),
+          equality(std::move(equality_functor)),
+          axpy_(std::move(axpy_functor)),
+          linear_combination_(std::move(linear_combination_functor)),
+          add_assign_(std::move(add_assign_functor)),
+          scale_assign_(std::move(scale_assign_functor)),
+          negate_in_place_(std::move(negate_in_place_functor)),
+          subtraction_(std::move(subtraction_functor)) {}
+
+    /// @brief element_left - element_right (see VectorSpace::difference)
+    constexpr element_type difference(const element_type& element_left,
+                                      const element_type& element_right) const {
+        if constexpr (Injected<Subtraction>) {
+            return subtraction_(element_left, element_right);
+        } else if constexpr (Injected<AddAssign>) {
+            element_type result = negation(element_right);
+            add_assign_(result, element_left);
+            return result;
+        } else {
+            return addition(element_left, negation(element_right));
+        }
+    }
+
+    /// @brief element_target += element_right (see VectorSpace::add_assign)
+    constexpr void add_assign(element_type& element_target, const element_type& element_right) const {
+        if constexpr (Injected<AddAssign>) {
+            add_assign_(element_target, element_right);
+        } else {
+            element_target = addition(element_target, element_right);
+        }
+    }
+
+    /// @brief element_target *= scalar_value (see VectorSpace::scale_assign)
+    constexpr void scale_assign(const scalar_type& scalar_value, element_type& element_target) const {
+        if constexpr (Injected<ScaleAssign>) {
+            scale_assign_(scalar_value, element_target);
+        } else {
+            element_target = scalar_action(scalar_value, element_target);
+        }
+    }
+
+    /// @brief element_target = -element_target (see VectorSpace::negate_in_place)
+    constexpr void negate_in_place(element_type& element_target) const {
+        if constexpr (Injected<NegateInPlace>) {
+            negate_in_place_(element_target);
+        } else {
+            element_target = negation(element_target);
+        }
+    }
+
+    /// @brief scalar_value * element_x + element_y (see VectorSpace::axpy)
+    constexpr element_type axpy(const scalar_type& scalar_value, const element_type& element_x,
+                                const element_type& element_y) const {
+        if constexpr (Injected<Axpy>) {
+            return axpy_(scalar_value, element_x, element_y);
+        } else if constexpr (Injected<AddAssign>) {
+            element_type result = scalar_action(scalar_value, element_x);
+            add_assign_(result, element_y);
+            return result;
+        } else {
+            return addition(scalar_action(scalar_value, element_x), element_y);
+        }
+    }
+
+    /// @brief a_1 * x_1 + ... + a_n * x_n (see VectorSpace::linear_combination)
+    constexpr element_type linear_combination(std::span<const term_type> terms) const {
+        if constexpr (Injected<LinearCombination>) {
+            return linear_combination_(terms);
+        } else {
+            if (terms.empty()) {
+                return zero_supplier();
+            }
+            element_type result = scalar_action(terms[0].coefficient, terms[0].element);
+            for (std::size_t index = 1; index < terms.size(); ++index) {
+                if constexpr (Injected<Axpy> || !Injected<AddAssign>) {
+                    result = axpy(terms[index].coefficient, terms[index].element, result);
+                } else {
+                    add_assign_(result, scalar_action(terms[index].coefficient, terms[index].element));
+                }
+            }
+            return result;
+        }
     }
+
+    /// @brief Linear combination written as a braced list of terms
+    template <std::size_t TermCount>
+    constexpr element_type linear_combination(const term_type (&terms)[TermCount]) const {
+        return linear_combination(std::span<const term_type>(terms, TermCount));
+    }
+
+private:
+    [[no_unique_address]] Axpy              axpy_{};
+    [[no_unique_address]] LinearCombination linear_combination_{};
+    [[no_unique_address]] AddAssign         add_assign_{};
+    [[no_unique_address]] ScaleAssign       scale_assign_{};
+    [[no_unique_address]] NegateInPlace     negate_in_place_{};
+    [[no_unique_address]] Subtraction       subtraction_{};
 };
 
 /**
@@ -157,25 +580,44 @@ struct VectorSpace {
  * 
  * A type satisfies VectorSpaceLike if it has:
  * - `element_type` and `scalar_type` type aliases
- * - Static members: `addition`, `scalar_action`, `negation`, `zero_supplier`, `equality`
- * - A static `difference` function with the correct signature
+ * - Members `addition`, `scalar_action`, `negation`, `zero_supplier`, `equality`
+ * - A `difference` function with the correct signature
  * 
- * This concept allows template functions to work with any VectorSpace-like
- * structure, including custom implementations or extensions.
+ * The members are checked on an instance, so both the static VectorSpace
+ * and the instance-based StatefulVectorSpace qualify. Generic code should
+ * take the space as an object (`const VS& space`) and call `space.addition`
+ * and so on.
  * 
- * @note VectorSpace automatically satisfies this concept.
+ * @note VectorSpace and StatefulVectorSpace automatically satisfy this concept.
  * 
  * @see VectorSpace
+ * @see StaticVectorSpaceLike for structures that call the operations statically
  */
 template <typename T>
-concept VectorSpaceLike = requires {
+concept VectorSpaceLike = requires(const T& space, const typename T::element_type& element) {
     typename T::element_type;
     typename T::scalar_type;
-    { T::addition }      ;
-    { T::scalar_action } ;
-    { T::negation }      ;
-    { T::zero_supplier } ;
-    { T::equality }      ;
+    { space.addition }      ;
+    { space.scalar_action } ;
+    { space.negation }      ;
+    { space.zero_supplier } ;
+    { space.equality }      ;
+    { space.difference(element, element) } -> std::same_as<typename T::element_type>;
+};
+
+/**
+ * @brief Concept for VectorSpaceLike types whose operations are static
+ * 
+ * @tparam T The type to check
+ * 
+ * Required by the structures that are themselves static and call
+ * `VS::difference` and the other operations without an instance
+ * (NormedSpace, InnerProductSpace, Lazy expressions, ElementBatch).
+ * 
+ * @note VectorSpace automatically satisfies this concept.
+ */
+template <typename T>
+concept StaticVectorSpaceLike = VectorSpaceLike<T> && requires {
     { T::difference(std::declval<const typename T::element_type&>(),
                     std::declval<const typename T::element_type&>()) }
         -> std::same_as<typename T::element_type>;